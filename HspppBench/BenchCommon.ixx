@@ -0,0 +1,60 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/BenchCommon.ixx
+// ベンチマーク共通モジュール: 計測ループと結果の収集
+
+export module hsppp_bench;
+
+import <chrono>;
+import <string>;
+import <string_view>;
+import <vector>;
+
+export namespace hsppp_bench {
+
+    /// @brief 1項目分の計測結果
+    struct BenchResult {
+        std::string name;
+        double nsPerOp;     // 1操作あたりのナノ秒
+    };
+
+    /// @brief 収集済みの計測結果
+    inline std::vector<BenchResult>& results() {
+        static std::vector<BenchResult> s_results;
+        return s_results;
+    }
+
+    /// @brief 計測結果を登録
+    inline void report(std::string_view name, double nsPerOp) {
+        results().push_back({ std::string(name), nsPerOp });
+    }
+
+    /// @brief 最適化による計算の除去を防ぐ
+    template<typename T>
+    inline void do_not_optimize(const T& value) {
+        static volatile const void* s_sink;
+        s_sink = &value;
+    }
+
+    /// @brief func を iterations 回実行して1回あたりの時間を登録
+    /// @details 計測前に 1/10 回のウォームアップを行う
+    template<typename Func>
+    double measure(std::string_view name, int64_t iterations, Func&& func) {
+        for (int64_t i = 0; i < iterations / 10; ++i) {
+            func(i);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (int64_t i = 0; i < iterations; ++i) {
+            func(i);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+        report(name, ns);
+        return ns;
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,71 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/BenchMain.cpp
+// ═══════════════════════════════════════════════════════════════════
+// HSPPP ベンチマークランナー
+// Release 構成でビルドし、結果は画面表示と bench_results.txt に出力する
+// ═══════════════════════════════════════════════════════════════════
+
+import hsppp;
+import hsppp_bench;
+using namespace hsppp;
+
+// 各ベンチマークファイルからインポート
+namespace hsppp_bench {
+    void run_string_bench();
+    void run_sort_bench();
+    void run_easing_bench();
+    void run_tween_bench();
+    void run_random_bench();
+    void run_color_bench();
+    void run_vecmath_bench();
+    void run_collision_bench();
+    void run_file_bench();
+}
+
+// ユーザーのエントリーポイント（ベンチマーク実行用）
+void hspMain() {
+    auto resultWin = screen({.width = 640, .height = 480, .title = "HSPPP Benchmark"});
+    resultWin.color(240, 240, 240).boxf();
+    resultWin.color(0, 0, 0);
+    resultWin.pos(20, 20);
+    resultWin.mes("Running benchmarks...");
+    redraw(1);
+
+    hsppp_bench::run_string_bench();
+    hsppp_bench::run_sort_bench();
+    hsppp_bench::run_easing_bench();
+    hsppp_bench::run_tween_bench();
+    hsppp_bench::run_random_bench();
+    hsppp_bench::run_color_bench();
+    hsppp_bench::run_vecmath_bench();
+    hsppp_bench::run_collision_bench();
+    hsppp_bench::run_file_bench();
+
+    // 結果を表示・保存
+    resultWin.color(240, 240, 240).boxf();
+    resultWin.color(0, 0, 0);
+
+    NotePad report;
+    int y = 20;
+    for (const auto& r : hsppp_bench::results()) {
+        std::string line = strf("%-40s %12.2f ns/op", r.name, r.nsPerOp);
+        resultWin.pos(20, y);
+        resultWin.mes(line);
+        logmes(line);
+        report.add(line);
+        y += 18;
+    }
+    (void)report.save("bench_results.txt");
+
+    y += 10;
+    resultWin.color(128, 128, 128);
+    resultWin.pos(20, y);
+    resultWin.mes("Saved to bench_results.txt. Close window to exit...");
+
+    stop();
+}
@@ -0,0 +1,162 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/CollisionBench.cpp
+// 当たり判定のベンチマーク（1千〜100万ボディ、1フレーム = 移動 + 全組の検出、1ボディあたりの時間）
+// およびピクセル単位の判定（64x64 のスプライト同士、1組あたりの時間）
+
+import hsppp;
+import hsppp_bench;
+import <algorithm>;
+import <cmath>;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        constexpr float kBodySize = 16.0f;
+        constexpr float kCellSize = 32.0f;
+        constexpr size_t kNaiveLimit = 10'000;      // 総当たりはこの数まで
+
+        // 1ボディあたり 40x40 ピクセル程度の密度で散らばった 16x16 のスプライト
+        struct Scene {
+            std::vector<Vec2> positions;
+            std::vector<Vec2> velocities;
+            std::vector<Aabb> boxes;
+
+            explicit Scene(size_t count) : positions(count), velocities(count), boxes(count) {
+                RandomStream random("collision", 0);
+                const double world = std::sqrt(static_cast<double>(count)) * 40.0;
+                for (size_t i = 0; i < count; ++i) {
+                    positions[i] = Vec2(static_cast<float>(random.rndf() * world), static_cast<float>(random.rndf() * world));
+                    velocities[i] = Vec2(static_cast<float>(random.rndf() * 4.0 - 2.0), static_cast<float>(random.rndf() * 4.0 - 2.0));
+                    boxes[i] = Aabb::from_size(positions[i], { kBodySize, kBodySize });
+                }
+            }
+
+            void step(int64_t frame) {
+                // 往復させて散らばり具合を保つ
+                const float direction = (frame / 32) % 2 == 0 ? 1.0f : -1.0f;
+                for (size_t i = 0; i < positions.size(); ++i) {
+                    positions[i] += velocities[i] * direction;
+                }
+            }
+        };
+
+        int64_t iterationsFor(size_t count) {
+            return count <= 1'000 ? 2000 : count <= 10'000 ? 200 : count <= 100'000 ? 20 : 10;
+        }
+
+        constexpr int kSpriteSize = 64;
+        constexpr int64_t kMaskIterations = 200'000;
+
+        // 円形のスプライト（外側は透明）
+        std::vector<uint32_t> circlePixels() {
+            std::vector<uint32_t> pixels(kSpriteSize * kSpriteSize);
+            const float r = kSpriteSize * 0.5f;
+            for (int y = 0; y < kSpriteSize; ++y) {
+                for (int x = 0; x < kSpriteSize; ++x) {
+                    const Vec2 d(x + 0.5f - r, y + 0.5f - r);
+                    pixels[y * kSpriteSize + x] = d.length_sq() < r * r ? 0xFFFF8040u : 0x00000000u;
+                }
+            }
+            return pixels;
+        }
+
+        void run_mask_bench() {
+            const std::vector<uint32_t> pixels = circlePixels();
+            const PixelMask mask = PixelMask::from_bgra(pixels, kSpriteSize, kSpriteSize);
+
+            // 従来の書き方（矩形が重なる範囲の画素を1つずつ調べる）
+            auto naiveOverlaps = [&](int dx, int dy) {
+                for (int y = std::max(0, dy); y < std::min(kSpriteSize, kSpriteSize + dy); ++y) {
+                    for (int x = std::max(0, dx); x < std::min(kSpriteSize, kSpriteSize + dx); ++x) {
+                        if ((pixels[y * kSpriteSize + x] >> 24) >= 128 &&
+                            (pixels[(y - dy) * kSpriteSize + (x - dx)] >> 24) >= 128) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            };
+
+            // 角同士が近いだけで当たっていない配置（矩形では当たり、全画素を調べることになる）
+            constexpr int kCornerOffset = 50;
+            measure("pixel overlap naive (corner miss)", kMaskIterations / 10, [&](int64_t i) {
+                do_not_optimize(naiveOverlaps(kCornerOffset + static_cast<int>(i & 1), kCornerOffset));
+            });
+            measure("PixelMask overlaps (corner miss)", kMaskIterations, [&](int64_t i) {
+                do_not_optimize(mask.overlaps(0, 0, mask, kCornerOffset + static_cast<int>(i & 1), kCornerOffset));
+            });
+            measure("PixelMask overlaps (hit)", kMaskIterations, [&](int64_t i) {
+                do_not_optimize(mask.overlaps(0, 0, mask, 20 + static_cast<int>(i & 7), 10));
+            });
+            measure("PixelMask from_bgra 64x64", kMaskIterations / 10, [&](int64_t) {
+                do_not_optimize(PixelMask::from_bgra(pixels, kSpriteSize, kSpriteSize));
+            });
+        }
+    }
+
+    void run_collision_bench() {
+        for (size_t count : { size_t(1'000), size_t(10'000), size_t(100'000), size_t(1'000'000) }) {
+            Scene scene(count);
+            const int64_t iterations = iterationsFor(count);
+            const double perBody = static_cast<double>(count);
+            std::vector<CollisionPair> pairs;
+
+            // 従来の書き方（全組を総当たり）
+            if (count <= kNaiveLimit) {
+                double ns = measure(strf("naive O(n^2) %d bodies (per body)", static_cast<int>(count)), iterations / 10 + 1, [&](int64_t frame) {
+                    scene.step(frame);
+                    pairs.clear();
+                    for (size_t i = 0; i < count; ++i) {
+                        const Aabb a = Aabb::from_size(scene.positions[i], { kBodySize, kBodySize });
+                        for (size_t j = i + 1; j < count; ++j) {
+                            if (a.overlaps(Aabb::from_size(scene.positions[j], { kBodySize, kBodySize }))) {
+                                pairs.push_back({ static_cast<uint32_t>(i), static_cast<uint32_t>(j) });
+                            }
+                        }
+                    }
+                    do_not_optimize(pairs);
+                });
+                results().back().nsPerOp = ns / perBody;
+            }
+
+            SpatialHash hash(kCellSize);
+            hash.insert(scene.boxes);
+            double ns = measure(strf("SpatialHash %d bodies (per body)", static_cast<int>(count)), iterations, [&](int64_t frame) {
+                scene.step(frame);
+                hash.move_to(scene.positions);
+                hash.find_pairs(pairs);
+                do_not_optimize(pairs);
+            });
+            results().back().nsPerOp = ns / perBody;
+
+            SweepAndPrune sweep;
+            sweep.insert(scene.boxes);
+            ns = measure(strf("SweepAndPrune %d bodies (per body)", static_cast<int>(count)), iterations, [&](int64_t frame) {
+                scene.step(frame);
+                sweep.move_to(scene.positions);
+                sweep.find_pairs(pairs);
+                do_not_optimize(pairs);
+            });
+            results().back().nsPerOp = ns / perBody;
+
+            // 画面内の敵を探すような小さな範囲の検索
+            std::vector<uint32_t> found;
+            const Aabb area = Aabb::from_center(scene.positions[0], { 256.0f, 256.0f });
+            measure(strf("SpatialHash query 256px %d bodies", static_cast<int>(count)), iterations * 10, [&](int64_t) {
+                hash.query(area, found);
+                do_not_optimize(found);
+            });
+        }
+
+        run_mask_bench();
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,114 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/ColorBench.cpp
+// 色変換のベンチマーク（1要素あたりの時間）
+
+import hsppp;
+import hsppp_bench;
+import <cstdint>;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        // 1回の計測で変換する要素数（1フレームで色付けするプリミティブ数を想定）
+        constexpr size_t kColorCount = 4096;
+        constexpr int64_t kColorIterations = 2'000;
+    }
+
+    void run_color_bench() {
+        std::vector<int> hue(kColorCount), sat(kColorCount), val(kColorCount);
+        for (size_t i = 0; i < kColorCount; ++i) {
+            hue[i] = static_cast<int>((i * 7) % 192);
+            sat[i] = static_cast<int>((i * 13) % 256);
+            val[i] = static_cast<int>(255 - (i * 5) % 128);
+        }
+        std::vector<int> rgb(kColorCount);
+        std::vector<uint32_t> bgra(kColorCount);
+        const double perElement = static_cast<double>(kColorCount);
+
+        // 従来の使い方（1色ずつ hsvcolor で設定して読み戻す）
+        double ns = measure("hsvcolor + ginfo (per call)", kColorIterations / 10, [&](int64_t) {
+            for (size_t i = 0; i < kColorCount; ++i) {
+                hsvcolor(hue[i], sat[i], val[i]);
+                rgb[i] = (ginfo_r() << 16) | (ginfo_g() << 8) | ginfo_b();
+            }
+            do_not_optimize(rgb);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("hsv_to_rgb (batch)", kColorIterations, [&](int64_t) {
+            hsv_to_rgb(hue, sat, val, rgb);
+            do_not_optimize(rgb);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        const auto palette = hsv_palette(255, 255);
+        ns = measure("hsv_palette (lookup)", kColorIterations, [&](int64_t) {
+            for (size_t i = 0; i < kColorCount; ++i) {
+                rgb[i] = palette[hue[i]];
+            }
+            do_not_optimize(rgb);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("rgb_to_hsv (batch)", kColorIterations, [&](int64_t) {
+            rgb_to_hsv(rgb, hue, sat, val);
+            do_not_optimize(hue);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("rgb_to_bgra (batch)", kColorIterations, [&](int64_t) {
+            rgb_to_bgra(rgb, bgra, 200);
+            do_not_optimize(bgra);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("bgra_to_rgb (batch)", kColorIterations, [&](int64_t) {
+            bgra_to_rgb(bgra, rgb);
+            do_not_optimize(rgb);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        // 乗算済みアルファ（比較用に成分ごとの除算で計算する素朴な実装）
+        std::vector<uint32_t> pixels(kColorCount);
+        for (size_t i = 0; i < kColorCount; ++i) {
+            pixels[i] = bgra[i] | (static_cast<uint32_t>(i % 256) << 24);
+        }
+        std::vector<uint32_t> work(kColorCount);
+        ns = measure("premultiply (naive division)", kColorIterations, [&](int64_t) {
+            for (size_t i = 0; i < kColorCount; ++i) {
+                const uint32_t p = pixels[i];
+                const uint32_t a = p >> 24;
+                const uint32_t b = ((p & 0xFF) * a + 127) / 255;
+                const uint32_t g = (((p >> 8) & 0xFF) * a + 127) / 255;
+                const uint32_t r = (((p >> 16) & 0xFF) * a + 127) / 255;
+                work[i] = (a << 24) | (r << 16) | (g << 8) | b;
+            }
+            do_not_optimize(work);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("premultiply_bgra (batch)", kColorIterations, [&](int64_t) {
+            work = pixels;
+            premultiply_bgra(work);
+            do_not_optimize(work);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        premultiply_bgra(pixels);
+        ns = measure("unpremultiply_bgra (batch)", kColorIterations, [&](int64_t) {
+            work = pixels;
+            unpremultiply_bgra(work);
+            do_not_optimize(work);
+        });
+        results().back().nsPerOp = ns / perElement;
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,96 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/EasingBench.cpp
+// イージング関数のベンチマーク（曲線ごとの1要素あたりの時間）
+
+import hsppp;
+import hsppp_bench;
+import <array>;
+import <string_view>;
+import <utility>;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        // 1回の計測で評価する要素数（スプライト数を想定）
+        constexpr size_t kEaseCount = 4096;
+        constexpr int64_t kEaseIterations = 2'000;
+        constexpr int kEaseMax = 4096;
+
+        constexpr std::array<std::pair<int, std::string_view>, 16> kCurves = { {
+            { ease_linear, "linear" },
+            { ease_quad_in, "quad_in" },
+            { ease_quad_out, "quad_out" },
+            { ease_quad_inout, "quad_inout" },
+            { ease_cubic_in, "cubic_in" },
+            { ease_cubic_out, "cubic_out" },
+            { ease_cubic_inout, "cubic_inout" },
+            { ease_quartic_in, "quartic_in" },
+            { ease_quartic_out, "quartic_out" },
+            { ease_quartic_inout, "quartic_inout" },
+            { ease_bounce_in, "bounce_in" },
+            { ease_bounce_out, "bounce_out" },
+            { ease_bounce_inout, "bounce_inout" },
+            { ease_shake_in, "shake_in" },
+            { ease_shake_out, "shake_out" },
+            { ease_shake_inout, "shake_inout" },
+        } };
+    }
+
+    // 計測値は1要素あたりに換算
+    void run_easing_bench() {
+        std::vector<double> t(kEaseCount);
+        std::vector<int> progress(kEaseCount);
+        for (size_t i = 0; i < kEaseCount; ++i) {
+            progress[i] = static_cast<int>((i * 7919) % (kEaseMax + 1));
+            t[i] = static_cast<double>(progress[i]) / kEaseMax;
+        }
+        std::vector<double> out(kEaseCount);
+        std::vector<int> outInt(kEaseCount);
+        const double perElement = static_cast<double>(kEaseCount);
+
+        for (const auto& [type, name] : kCurves) {
+            const Easing easing(0.0, 640.0, type);
+
+            setease(0.0, 640.0, type);
+            double ns = measure(format("geteasef {} (per call)", name), kEaseIterations, [&](int64_t) {
+                for (size_t i = 0; i < kEaseCount; ++i) {
+                    out[i] = geteasef(t[i]);
+                }
+                do_not_optimize(out);
+            });
+            results().back().nsPerOp = ns / perElement;
+
+            ns = measure(format("Easing::evaluate {} (batch)", name), kEaseIterations, [&](int64_t) {
+                easing.evaluate(t, out);
+                do_not_optimize(out);
+            });
+            results().back().nsPerOp = ns / perElement;
+
+            ns = measure(format("getease {} (per call)", name), kEaseIterations, [&](int64_t) {
+                for (size_t i = 0; i < kEaseCount; ++i) {
+                    outInt[i] = getease(progress[i], kEaseMax);
+                }
+                do_not_optimize(outInt);
+            });
+            results().back().nsPerOp = ns / perElement;
+
+            const EasingTable table(easing, kEaseMax);
+            ns = measure(format("EasingTable {} (lookup)", name), kEaseIterations, [&](int64_t) {
+                for (size_t i = 0; i < kEaseCount; ++i) {
+                    outInt[i] = table(progress[i]);
+                }
+                do_not_optimize(outInt);
+            });
+            results().back().nsPerOp = ns / perElement;
+        }
+    }
+
+}  // namespace hsppp_bench
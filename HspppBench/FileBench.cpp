@@ -0,0 +1,632 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/FileBench.cpp
+// ファイル読み込みのベンチマーク（1MB〜1GB、読み込み + 全バイトの走査、1MBあたりの時間）
+// bload はバッファの確保・ゼロ埋め・コピーを含み、bmap はマップとページフォールトを含む
+// および非同期の保存・読み込み（呼び出し側のスレッドが止まる時間と、キューの待ち時間・完了までの時間）
+// および保存方法ごとの bsave（置き換え保存・ディスクへの書き込み待ち・1フレーム分の書き込みのまとめ）
+// およびパックファイル（packopen の時間と、1000個の小さなファイルの exist / bload を個別のファイルと pack:// で比較）
+// およびディレクトリの再帰走査（dirlist を再帰で呼ぶ場合と dirwalk の1スレッド・既定のスレッド数を比較）
+// およびファイルの変更の検出（毎フレーム exist で調べる場合の1フレームの時間と、filewatch の保存から通知までの時間）
+// および LZ4 フレーム形式の圧縮・展開（レベル・スレッド数ごとの 1MB あたりの時間と圧縮後の大きさ）
+// およびファイルのコピー（コピー方法ごとの 1MB あたりの時間と、bcopy_async で呼び出し側のスレッドが止まる時間）
+// およびファイル情報の一括取得（exist を繰り返す場合と exist_many、filewatch の下でキャッシュから返す場合）
+// およびバイナリの解析（lpeek・memcpy で1フィールドずつ読む場合と BufferReader、1レコードあたりの時間）
+
+import hsppp;
+import hsppp_bench;
+import <cstring>;
+import <span>;
+import <string>;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        constexpr int64_t kMegabyte = 1024 * 1024;
+        const std::string kBenchFile = "hsppp_bench_file.bin";
+
+        // 内容をその場で解析する処理の代わり（全バイトを読む）
+        uint64_t checksum(std::span<const uint8_t> bytes) {
+            uint64_t sum = 0;
+            for (uint8_t b : bytes) {
+                sum += b;
+            }
+            return sum;
+        }
+
+        int64_t iterationsFor(int64_t megabytes) {
+            return megabytes <= 1 ? 200 : megabytes <= 16 ? 20 : 3;
+        }
+
+        constexpr int64_t kAsyncIterations = 64;
+
+        std::string asyncFile(int64_t i) {
+            return strf("hsppp_bench_async_%d.bin", static_cast<int>(i));
+        }
+
+        void run_async_bench() {
+            const std::vector<uint8_t> saveData(static_cast<size_t>(kMegabyte), 0x5A);
+
+            // 従来の書き方（保存が終わるまでゲームループが止まる）
+            measure("bsave 1MB (caller blocked)", kAsyncIterations, [&](int64_t i) {
+                bsave(asyncFile(i), saveData);
+            });
+
+            // 投入だけを計測（内容のコピーを含む）。投入した要求はまとめて待つ
+            // 同じファイルへの書き込みが重ならないように、要求ごとに別のファイルにする
+            std::vector<FileRequest> inFlight;
+            int64_t nextFile = kAsyncIterations;
+            fileio_reset_stats();
+            measure("bsave_async 1MB (caller blocked)", kAsyncIterations, [&](int64_t) {
+                inFlight.push_back(bsave_async(asyncFile(nextFile++), saveData));
+            });
+            for (FileRequest& request : inFlight) {
+                request.wait();
+            }
+            FileIoStats stats = fileio_stats();
+            report("bsave_async queue wait (avg)", stats.average_wait_ms * 1e6);
+            report("bsave_async latency (avg)", stats.average_latency_ms * 1e6);
+            report("bsave_async latency (max)", stats.max_latency_ms * 1e6);
+            report("bsave_async peak queue depth", static_cast<double>(stats.peak_pending));
+
+            // 複数ファイルの読み込み（順番に bload / まとめて投入して全完了を待つ）
+            measure(strf("bload x%d sequential", static_cast<int>(kAsyncIterations)), 5, [&](int64_t) {
+                for (int64_t i = 0; i < kAsyncIterations; ++i) {
+                    std::vector<uint8_t> buffer;
+                    bload(asyncFile(i), buffer);
+                    do_not_optimize(buffer);
+                }
+            });
+            measure(strf("bload_async x%d all", static_cast<int>(kAsyncIterations)), 5, [&](int64_t) {
+                inFlight.clear();
+                for (int64_t i = 0; i < kAsyncIterations; ++i) {
+                    inFlight.push_back(bload_async(asyncFile(i)));
+                }
+                for (FileRequest& request : inFlight) {
+                    request.wait();
+                }
+                do_not_optimize(inFlight);
+            });
+
+            for (int64_t i = 0; i < nextFile; ++i) {
+                deletefile(asyncFile(i));
+            }
+        }
+
+        constexpr int kSlotCount = 64;
+        constexpr int64_t kSlotSize = 4096;
+        constexpr int64_t kSaveIterations = 50;
+
+        void run_save_bench() {
+            const std::string saveFile = "hsppp_bench_save.bin";
+            const std::vector<uint8_t> saveData(static_cast<size_t>(kMegabyte), 0x3C);
+
+            measure("bsave 1MB", kSaveIterations, [&](int64_t) {
+                bsave(saveFile, saveData);
+            });
+            measure("bsave 1MB atomic", kSaveIterations, [&](int64_t) {
+                bsave(saveFile, saveData, {}, {}, SaveParams{ .atomic = true });
+            });
+            measure("bsave 1MB atomic + flush", kSaveIterations, [&](int64_t) {
+                bsave(saveFile, saveData, {}, {}, SaveParams{ .atomic = true, .flush = true });
+            });
+
+            // 1フレームに全スロットを更新する場合（従来はスロットごとにファイルを開いて書き込む）
+            const std::vector<uint8_t> slot(static_cast<size_t>(kSlotSize), 0x7E);
+            bsave(saveFile, std::vector<uint8_t>(static_cast<size_t>(kSlotSize * kSlotCount)));
+            measure(strf("bsave %d slots (per frame)", kSlotCount), kSaveIterations, [&](int64_t) {
+                for (int i = 0; i < kSlotCount; ++i) {
+                    bsave(saveFile, slot, {}, i * kSlotSize);
+                }
+            });
+            measure(strf("bsave %d slots deferred + bflush (per frame)", kSlotCount), kSaveIterations, [&](int64_t) {
+                for (int i = 0; i < kSlotCount; ++i) {
+                    bsave(saveFile, slot, {}, i * kSlotSize, SaveParams{ .deferred = true });
+                }
+                bflush();
+            });
+
+            deletefile(saveFile);
+        }
+
+        constexpr int kPackFileCount = 1000;
+        constexpr int64_t kPackFileSize = 4096;
+        const std::string kPackDir = "hsppp_bench_pack";
+
+        std::string packFileName(int i) {
+            return strf("sprite_%04d.dat", i);
+        }
+
+        void run_pack_bench() {
+            // 圧縮が効く程度に規則的な内容の小さなファイル
+            mkdir(kPackDir);
+            std::vector<uint8_t> data(static_cast<size_t>(kPackFileSize));
+            for (int i = 0; i < kPackFileCount; ++i) {
+                for (size_t j = 0; j < data.size(); ++j) {
+                    data[j] = static_cast<uint8_t>((j / 16) * 7 + i);
+                }
+                bsave(kPackDir + "/" + packFileName(i), data);
+            }
+            const std::string packed = "hsppp_bench_pack.hpk";
+            const std::string stored = "hsppp_bench_pack_store.hpk";
+            measure(strf("packbuild %d files", kPackFileCount), 3, [&](int64_t) {
+                packbuild(packed, kPackDir);
+            });
+            packbuild(stored, kPackDir, PackParams{ .compress = false });
+
+            measure(strf("packopen + packclose %d files", kPackFileCount), 200, [&](int64_t) {
+                packopen(packed);
+                packclose(packed);
+            });
+
+            std::vector<std::string> loose;
+            std::vector<std::string> inPack;
+            for (int i = 0; i < kPackFileCount; ++i) {
+                loose.push_back(kPackDir + "/" + packFileName(i));
+                inPack.push_back("pack://" + packFileName(i));
+            }
+
+            // 従来の書き方（ファイルごとに開く）
+            std::vector<uint8_t> buffer;
+            double ns = measure(strf("exist loose x%d (per file)", kPackFileCount), 20, [&](int64_t) {
+                for (const std::string& name : loose) {
+                    do_not_optimize(exist(name));
+                }
+            });
+            results().back().nsPerOp = ns / kPackFileCount;
+            ns = measure(strf("bload loose x%d (per file)", kPackFileCount), 20, [&](int64_t) {
+                for (const std::string& name : loose) {
+                    bload(name, buffer);
+                    do_not_optimize(checksum(buffer));
+                }
+            });
+            results().back().nsPerOp = ns / kPackFileCount;
+
+            packopen(stored);
+            ns = measure(strf("exist pack:// x%d (per file)", kPackFileCount), 20, [&](int64_t) {
+                for (const std::string& name : inPack) {
+                    do_not_optimize(exist(name));
+                }
+            });
+            results().back().nsPerOp = ns / kPackFileCount;
+            ns = measure(strf("bload pack:// stored x%d (per file)", kPackFileCount), 20, [&](int64_t) {
+                for (const std::string& name : inPack) {
+                    bload(name, buffer);
+                    do_not_optimize(checksum(buffer));
+                }
+            });
+            results().back().nsPerOp = ns / kPackFileCount;
+            ns = measure(strf("bmap pack:// stored x%d (per file)", kPackFileCount), 20, [&](int64_t) {
+                for (const std::string& name : inPack) {
+                    const MappedFile mapped = bmap(name);
+                    do_not_optimize(checksum(mapped.data()));
+                }
+            });
+            results().back().nsPerOp = ns / kPackFileCount;
+            packclose(stored);
+
+            packopen(packed);
+            ns = measure(strf("bload pack:// lz4 x%d (per file)", kPackFileCount), 20, [&](int64_t) {
+                for (const std::string& name : inPack) {
+                    bload(name, buffer);
+                    do_not_optimize(checksum(buffer));
+                }
+            });
+            results().back().nsPerOp = ns / kPackFileCount;
+            packclose();
+
+            for (const std::string& name : loose) {
+                deletefile(name);
+            }
+            deletefile(packed);
+            deletefile(stored);
+        }
+
+        constexpr int kWalkDirCount = 64;
+        constexpr int kWalkFilesPerDir = 128;
+        const std::string kWalkDir = "hsppp_bench_walk";
+
+        // 従来の書き方（ディレクトリごとに dirlist を2回呼び、サブディレクトリをたどる）
+        void walkWithDirlist(const std::string& dir, std::vector<std::string>& out) {
+            for (const std::string& name : dirlist(dir + "/*", 1)) {
+                out.push_back(dir + "/" + name);
+            }
+            for (const std::string& name : dirlist(dir + "/*", 5)) {
+                walkWithDirlist(dir + "/" + name, out);
+            }
+        }
+
+        void run_dirwalk_bench() {
+            // 2階層に分けた小さなファイル（kWalkDirCount * kWalkFilesPerDir 個）
+            mkdir(kWalkDir);
+            std::vector<std::string> created;
+            for (int d = 0; d < kWalkDirCount; ++d) {
+                const std::string group = strf("%s/group_%02d", kWalkDir, d % 8);
+                const std::string dir = strf("%s/dir_%03d", group, d);
+                mkdir(group);
+                mkdir(dir);
+                for (int f = 0; f < kWalkFilesPerDir; ++f) {
+                    created.push_back(strf("%s/file_%04d.%s", dir, f, (f % 4 == 0) ? "png" : "dat"));
+                    bsave(created.back(), std::string("x"));
+                }
+            }
+            const int total = kWalkDirCount * kWalkFilesPerDir;
+
+            std::vector<std::string> names;
+            double ns = measure(strf("dirlist recursive %d files (per file)", total), 20, [&](int64_t) {
+                names.clear();
+                walkWithDirlist(kWalkDir, names);
+                do_not_optimize(names.size());
+            });
+            results().back().nsPerOp = ns / total;
+            ns = measure(strf("dirwalk 1 thread %d files (per file)", total), 20, [&](int64_t) {
+                do_not_optimize(dirwalk(kWalkDir, DirWalkParams{ .mode = 1, .threads = 1 }).size());
+            });
+            results().back().nsPerOp = ns / total;
+            ns = measure(strf("dirwalk %d files (per file)", total), 20, [&](int64_t) {
+                do_not_optimize(dirwalk(kWalkDir, DirWalkParams{ .mode = 1 }).size());
+            });
+            results().back().nsPerOp = ns / total;
+            // 条件に合わないエントリーは変換も stat もせずに捨てる
+            ns = measure(strf("dirwalk *.png of %d files (per file)", total), 20, [&](int64_t) {
+                int64_t count = dirwalk(kWalkDir, [](const DirEntry&) { return true; }, { .mode = 1, .pattern = "*.png" });
+                do_not_optimize(count);
+            });
+            results().back().nsPerOp = ns / total;
+
+            for (const std::string& name : created) {
+                deletefile(name);
+            }
+        }
+
+        constexpr int kWatchFileCount = 256;
+        const std::string kWatchDir = "hsppp_bench_watch";
+
+        void run_filewatch_bench() {
+            mkdir(kWatchDir);
+            std::vector<std::string> files;
+            for (int i = 0; i < kWatchFileCount; ++i) {
+                files.push_back(strf("%s/asset_%03d.dat", kWatchDir, i));
+                bsave(files.back(), std::string("x"));
+            }
+
+            // 従来の書き方（変更を見つけるため、毎フレーム全ファイルのサイズを調べる）
+            std::vector<int64_t> sizes(files.size());
+            measure(strf("exist poll x%d (per frame)", kWatchFileCount), 200, [&](int64_t) {
+                for (size_t i = 0; i < files.size(); ++i) {
+                    sizes[i] = exist(files[i]);
+                }
+                do_not_optimize(sizes.data());
+            });
+
+            // 監視は別のスレッドで行うため、フレームごとの負担はない。保存してから通知が届くまでの時間を計測する
+            int64_t delivered = 0;
+            FileWatch watch = filewatch(kWatchDir, [&](std::span<const FileChange> changes) {
+                delivered += static_cast<int64_t>(changes.size());
+            }, { .debounce_ms = 0, .reload = false });
+            measure("filewatch bsave -> callback", 50, [&](int64_t i) {
+                const int64_t before = delivered;
+                bsave(files[static_cast<size_t>(i) % files.size()], strf("%d", static_cast<int>(i)));
+                while (delivered == before) {
+                    await(1);
+                }
+            });
+            watch.close();
+
+            for (const std::string& name : files) {
+                deletefile(name);
+            }
+        }
+
+        constexpr int64_t kCopyMegabytes = 256;
+        const std::string kCopyFile = "hsppp_bench_copy.bin";
+
+        void run_copy_bench() {
+            {
+                std::vector<uint8_t> data(static_cast<size_t>(kCopyMegabytes * kMegabyte));
+                for (size_t i = 0; i < data.size(); ++i) {
+                    data[i] = static_cast<uint8_t>(i * 31);
+                }
+                bsave(kBenchFile, data);
+            }
+            const double perMegabyte = static_cast<double>(kCopyMegabytes);
+
+            struct Setting {
+                const char* name;
+                CopyParams params;
+            };
+            // 既定（ReFS・Dev Drive ではブロック複製）/ CopyFile2 のみ / 作業スレッドでの読み書き
+            const Setting settings[] = {
+                { "default", {} },
+                { "clone=false", { .clone = false } },
+                { "native=false", { .clone = false, .native = false } },
+            };
+            for (const Setting& setting : settings) {
+                const double ns = measure(strf("bcopy %dMB %s (per MB)", static_cast<int>(kCopyMegabytes), setting.name), 3,
+                                          [&](int64_t) {
+                    bcopy(kBenchFile, kCopyFile, setting.params);
+                });
+                results().back().nsPerOp = ns / perMegabyte;
+            }
+
+            // 投入だけを計測し、進捗の通知を受けながら完了を待つ
+            int64_t progressCalls = 0;
+            FileRequest request;
+            measure(strf("bcopy_async %dMB (caller blocked)", static_cast<int>(kCopyMegabytes)), 1, [&](int64_t) {
+                request = bcopy_async(kBenchFile, kCopyFile, nullptr, [&](FileRequest&) { ++progressCalls; });
+            });
+            request.wait();
+            report("bcopy_async latency", request.latency_ms() * 1e6);
+            report("bcopy_async progress callbacks", static_cast<double>(progressCalls));
+
+            deletefile(kBenchFile);
+            deletefile(kCopyFile);
+        }
+
+        constexpr int kStatFileCount = 4096;
+        const std::string kStatDir = "hsppp_bench_stat";
+
+        void run_stat_bench() {
+            // 素材の確認を想定し、1/8 は存在しないパスにする
+            mkdir(kStatDir);
+            std::vector<std::string> paths;
+            for (int i = 0; i < kStatFileCount; ++i) {
+                paths.push_back(strf("%s/asset_%04d.dat", kStatDir, i));
+                if (i % 8 != 0) {
+                    bsave(paths.back(), std::string("x"));
+                }
+            }
+            const double perFile = static_cast<double>(kStatFileCount);
+
+            double ns = measure(strf("exist x%d (per file)", kStatFileCount), 20, [&](int64_t) {
+                int64_t total = 0;
+                for (const std::string& path : paths) {
+                    total += exist(path);
+                }
+                do_not_optimize(total);
+            });
+            results().back().nsPerOp = ns / perFile;
+
+            std::vector<FileStat> stats;
+            ns = measure(strf("exist_many %d (per file)", kStatFileCount), 20, [&](int64_t) {
+                exist_many(paths, stats);
+                do_not_optimize(stats.data());
+            });
+            results().back().nsPerOp = ns / perFile;
+
+            // 監視の下では2回目からファイルシステムに問い合わせない
+            FileWatch watch = filewatch(kStatDir, nullptr, { .reload = false, .cache_stats = true });
+            exist_many(paths, stats);
+            ns = measure(strf("exist_many %d cached (per file)", kStatFileCount), 20, [&](int64_t) {
+                exist_many(paths, stats);
+                do_not_optimize(stats.data());
+            });
+            results().back().nsPerOp = ns / perFile;
+            ns = measure(strf("exist x%d cached (per file)", kStatFileCount), 20, [&](int64_t) {
+                int64_t total = 0;
+                for (const std::string& path : paths) {
+                    total += exist(path);
+                }
+                do_not_optimize(total);
+            });
+            results().back().nsPerOp = ns / perFile;
+            watch.close();
+
+            for (int i = 0; i < kStatFileCount; ++i) {
+                if (i % 8 != 0) {
+                    deletefile(paths[static_cast<size_t>(i)]);
+                }
+            }
+        }
+
+        constexpr int kRecordCount = 1000000;
+
+        // リプレイの1フレームを想定したレコード（16 バイト）
+        struct ReplayRecord {
+            int32_t frame;
+            float x;
+            float y;
+            uint16_t keys;
+            uint16_t flags;
+        };
+
+        void run_buffer_bench() {
+            std::vector<uint8_t> data;
+            BufferWriter writer(data);
+            for (int i = 0; i < kRecordCount; ++i) {
+                writer.write(ReplayRecord{ i, static_cast<float>(i % 640), static_cast<float>(i % 480),
+                                           static_cast<uint16_t>(i * 7), static_cast<uint16_t>(i & 3) });
+            }
+            const double perRecord = static_cast<double>(kRecordCount);
+
+            // 従来の書き方（lpeek / wpeek で1フィールドずつ。浮動小数点数は読めないため整数のみ）
+            double ns = measure(strf("lpeek fields x%d (per record)", kRecordCount), 5, [&](int64_t) {
+                int64_t sum = 0;
+                for (int64_t offset = 0; offset < static_cast<int64_t>(data.size()); offset += 16) {
+                    sum += lpeek(data, offset) + wpeek(data, offset + 12) + wpeek(data, offset + 14);
+                }
+                do_not_optimize(sum);
+            });
+            results().back().nsPerOp = ns / perRecord;
+
+            ns = measure(strf("memcpy fields x%d (per record)", kRecordCount), 20, [&](int64_t) {
+                int64_t sum = 0;
+                for (size_t offset = 0; offset < data.size(); offset += sizeof(ReplayRecord)) {
+                    ReplayRecord record;
+                    std::memcpy(&record, data.data() + offset, sizeof(record));
+                    sum += record.frame + record.keys + static_cast<int64_t>(record.x);
+                }
+                do_not_optimize(sum);
+            });
+            results().back().nsPerOp = ns / perRecord;
+
+            ns = measure(strf("BufferReader fields x%d (per record)", kRecordCount), 20, [&](int64_t) {
+                BufferReader reader(data);
+                int64_t sum = 0;
+                while (!reader.eof()) {
+                    const int32_t frame = reader.read<int32_t>();
+                    const float x = reader.read<float>();
+                    reader.skip(4);
+                    sum += frame + reader.read<uint16_t>() + static_cast<int64_t>(x);
+                    reader.skip(2);
+                }
+                do_not_optimize(sum);
+            });
+            results().back().nsPerOp = ns / perRecord;
+
+            std::vector<ReplayRecord> records;
+            ns = measure(strf("BufferReader read_array x%d (per record)", kRecordCount), 20, [&](int64_t) {
+                BufferReader reader(data);
+                reader.read_array(records, static_cast<size_t>(kRecordCount));
+                do_not_optimize(records.data());
+            });
+            results().back().nsPerOp = ns / perRecord;
+
+            // バイト順を入れ替える場合（ビッグエンディアンの形式）
+            std::vector<int32_t> words;
+            ns = measure(strf("BufferReader read_array big endian x%d (per record)", kRecordCount), 20, [&](int64_t) {
+                BufferReader reader(data, std::endian::big);
+                reader.read_array(words, data.size() / sizeof(int32_t));
+                do_not_optimize(words.data());
+            });
+            results().back().nsPerOp = ns / perRecord;
+
+            // 可変長整数（フレーム番号の差分などの小さな値）
+            std::vector<uint8_t> packed;
+            BufferWriter varints(packed);
+            for (int i = 0; i < kRecordCount; ++i) {
+                varints.write_varint(static_cast<uint64_t>(i % 300));
+            }
+            ns = measure(strf("read_varint x%d (per value)", kRecordCount), 20, [&](int64_t) {
+                BufferReader reader(packed);
+                uint64_t sum = 0;
+                while (!reader.eof()) {
+                    sum += reader.read_varint();
+                }
+                do_not_optimize(sum);
+            });
+            results().back().nsPerOp = ns / perRecord;
+        }
+
+        constexpr int64_t kCompressMegabytes = 16;
+
+        void run_compress_bench() {
+            // ゲームのセーブデータやログに近い、繰り返しの多いテキスト
+            std::string text;
+            for (int i = 0; text.size() < static_cast<size_t>(kCompressMegabytes * kMegabyte); ++i) {
+                text += strf("{\"id\":%d,\"name\":\"enemy_%d\",\"x\":%d,\"y\":%d,\"hp\":%d}\n",
+                             i, i % 97, (i * 37) % 640, (i * 101) % 480, 100 - i % 50);
+            }
+            const std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+            const double perMegabyte = static_cast<double>(text.size()) / static_cast<double>(kMegabyte);
+
+            struct Setting {
+                const char* name;
+                CompressParams params;
+                int64_t iterations;
+            };
+            const Setting settings[] = {
+                { "level 1", { .level = 1 }, 10 },
+                { "level 1, threads 0", { .level = 1, .threads = 0 }, 10 },
+                { "level 9", { .level = 9 }, 3 },
+                { "level 9, threads 0", { .level = 9, .threads = 0 }, 3 },
+            };
+            std::vector<uint8_t> packed;
+            for (const Setting& setting : settings) {
+                const double ns = measure(strf("compress %s (per MB)", setting.name), setting.iterations, [&](int64_t) {
+                    packed = compress(data, setting.params);
+                    do_not_optimize(packed.data());
+                });
+                results().back().nsPerOp = ns / perMegabyte;
+                report(strf("compress %s size (%% of input)", setting.name),
+                       100.0 * static_cast<double>(packed.size()) / static_cast<double>(data.size()));
+            }
+
+            // 展開の速さはレベルによらない（最後の level 9 のデータを展開する）
+            std::vector<uint8_t> restored;
+            double ns = measure("decompress (per MB)", 10, [&](int64_t) {
+                restored.clear();
+                Decompressor(packed).read_all(restored);
+                do_not_optimize(restored.data());
+            });
+            results().back().nsPerOp = ns / perMegabyte;
+
+            // ファイルからの展開（先に内容の大きさを確保し、読み込みながら展開する）
+            bsave_compressed(kBenchFile, text);
+            ns = measure("bload_compressed (per MB)", 10, [&](int64_t) {
+                bload_compressed(kBenchFile, restored);
+                do_not_optimize(checksum(restored));
+            });
+            results().back().nsPerOp = ns / perMegabyte;
+            deletefile(kBenchFile);
+        }
+    }
+
+    void run_file_bench() {
+        // bload の自動確保は 2GB が上限のため、比較は 1GB まで
+        for (int64_t megabytes : { int64_t(1), int64_t(16), int64_t(256), int64_t(1024) }) {
+            {
+                std::vector<uint8_t> data(static_cast<size_t>(megabytes * kMegabyte));
+                for (size_t i = 0; i < data.size(); ++i) {
+                    data[i] = static_cast<uint8_t>(i * 31);
+                }
+                bsave(kBenchFile, data);
+            }
+            const int64_t iterations = iterationsFor(megabytes);
+            const double perMegabyte = static_cast<double>(megabytes);
+
+            // 従来の書き方（毎回新しいバッファに読み込む）
+            double ns = measure(strf("bload %dMB (per MB)", static_cast<int>(megabytes)), iterations, [&](int64_t) {
+                std::vector<uint8_t> buffer;
+                bload(kBenchFile, buffer);
+                do_not_optimize(checksum(buffer));
+            });
+            results().back().nsPerOp = ns / perMegabyte;
+
+            // バッファを使い回す場合（確保とゼロ埋めはなく、コピーのみ）
+            std::vector<uint8_t> reused(static_cast<size_t>(megabytes * kMegabyte));
+            ns = measure(strf("bload reuse %dMB (per MB)", static_cast<int>(megabytes)), iterations, [&](int64_t) {
+                bload(kBenchFile, reused);
+                do_not_optimize(checksum(reused));
+            });
+            results().back().nsPerOp = ns / perMegabyte;
+
+            ns = measure(strf("bmap %dMB (per MB)", static_cast<int>(megabytes)), iterations, [&](int64_t) {
+                const MappedFile mapped = bmap(kBenchFile);
+                do_not_optimize(checksum(mapped.data()));
+            });
+            results().back().nsPerOp = ns / perMegabyte;
+        }
+
+        // 大きなファイルの一部だけを読む場合（先頭から 64KB）
+        measure("bload 64KB of 1GB", 2000, [&](int64_t) {
+            std::vector<uint8_t> buffer;
+            bload(kBenchFile, buffer, 64 * 1024);
+            do_not_optimize(checksum(buffer));
+        });
+        measure("bmap 64KB of 1GB", 2000, [&](int64_t) {
+            const MappedFile mapped = bmap(kBenchFile, {}, 64 * 1024);
+            do_not_optimize(checksum(mapped.data()));
+        });
+
+        deletefile(kBenchFile);
+
+        run_async_bench();
+        run_save_bench();
+        run_pack_bench();
+        run_dirwalk_bench();
+        run_filewatch_bench();
+        run_compress_bench();
+        run_copy_bench();
+        run_stat_bench();
+        run_buffer_bench();
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,89 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/Portable/FileCopyBench.cpp
+// ファイルのコピーのベンチマーク（ウィンドウを使わない単体の実行ファイル）
+// HspppBench の run_copy_bench と同じ 256MB のファイルを、FileCopy.cpp の CopyFileFast を直接使ってコピー方法ごとに計測する
+// 引数でコピー元・コピー先を置くディレクトリを指定できる（既定はカレントディレクトリ）
+//
+// ビルド（リポジトリの最上位で）:
+//   g++ -std=c++23 -O2 -IHspppLib/src/core HspppBench/Portable/FileCopyBench.cpp HspppLib/src/core/FileCopy.cpp -o copybench
+//   cl /std:c++latest /O2 /EHsc /IHspppLib\src\core HspppBench\Portable\FileCopyBench.cpp HspppLib\src\core\FileCopy.cpp HspppLib\src\core\Transcode.cpp
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "FileCopy.h"
+
+using namespace hsppp::internal;
+
+namespace {
+
+    constexpr size_t kMegabyte = 1024 * 1024;
+    constexpr size_t kCopyMegabytes = 256;
+
+    const char* methodName(FileCopyMethod method) {
+        switch (method) {
+            case FileCopyMethod::Clone: return "clone";
+            case FileCopyMethod::Native: return "native";
+            case FileCopyMethod::ReadWrite: return "read/write";
+            default: return "none";
+        }
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const std::filesystem::path dir = (argc > 1) ? std::filesystem::path(argv[1]) : std::filesystem::path(".");
+    const std::string src = (dir / "hsppp_bench_file.bin").string();
+    const std::string dest = (dir / "hsppp_bench_copy.bin").string();
+    {
+        std::vector<char> data(kCopyMegabytes * kMegabyte);
+        for (size_t i = 0; i < data.size(); ++i) {
+            data[i] = static_cast<char>(i * 31);
+        }
+        std::ofstream(src, std::ios::binary).write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    struct Setting {
+        const char* name;
+        FileCopyOptions options;
+    };
+    // 既定（対応するファイルシステムではブロック複製）/ OS のコピー機能のみ / 読み書き
+    const Setting settings[] = {
+        { "default", {} },
+        { "clone=false", { .clone = false } },
+        { "native=false", { .clone = false, .native = false } },
+    };
+    int exitCode = 0;
+    for (const Setting& setting : settings) {
+        constexpr int kIterations = 3;
+        FileCopyResult result;
+        CopyFileFast(src, dest, setting.options, nullptr);     // ウォームアップ
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kIterations; ++i) {
+            result = CopyFileFast(src, dest, setting.options, nullptr);
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                          kIterations / static_cast<double>(kCopyMegabytes);
+        if (result.status != FileCopyStatus::Ok || result.bytes != kCopyMegabytes * kMegabyte) {
+            std::printf("%-28s failed (status %d, error %u)\n", setting.name, static_cast<int>(result.status), result.systemError);
+            exitCode = 1;
+            continue;
+        }
+        std::printf("copy %zuMB %-14s %12.0f ns/MB  %8.0f MB/s  (%s)\n", kCopyMegabytes, setting.name, ns, 1e9 / ns,
+                    methodName(result.method));
+    }
+
+    std::error_code ec;
+    std::filesystem::remove(src, ec);
+    std::filesystem::remove(dest, ec);
+    return exitCode;
+}
@@ -0,0 +1,129 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/Portable/Lz4Bench.cpp
+// LZ4 フレーム形式の圧縮・展開のベンチマーク（ウィンドウを使わない単体の実行ファイル）
+// HspppBench の run_compress_bench と同じ 16MB のテキストを、Lz4.cpp / Lz4Frame.cpp を直接使って圧縮・展開する
+// 圧縮は1スレッド（CompressParams::threads の並列化は hsppp_file.inl 側のため対象外）
+//
+// ビルド（リポジトリの最上位で）:
+//   g++ -std=c++23 -O2 -IHspppLib/src/core HspppBench/Portable/Lz4Bench.cpp HspppLib/src/core/Lz4.cpp HspppLib/src/core/Lz4Frame.cpp -o lz4bench
+//   cl /std:c++latest /O2 /EHsc /IHspppLib\src\core HspppBench\Portable\Lz4Bench.cpp HspppLib\src\core\Lz4.cpp HspppLib\src\core\Lz4Frame.cpp
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Lz4Frame.h"
+
+using namespace hsppp::internal;
+
+namespace {
+
+    constexpr size_t kMegabyte = 1024 * 1024;
+    constexpr size_t kCompressMegabytes = 16;
+    constexpr size_t kBlockSize = 256 * 1024;   // CompressParams の既定と同じ
+
+    // ゲームのセーブデータやログに近い、繰り返しの多いテキスト（run_compress_bench と同じ）
+    std::string makeText() {
+        std::string text;
+        char line[128];
+        for (int i = 0; text.size() < kCompressMegabytes * kMegabyte; ++i) {
+            const int length = std::snprintf(line, sizeof(line), "{\"id\":%d,\"name\":\"enemy_%d\",\"x\":%d,\"y\":%d,\"hp\":%d}\n",
+                                             i, i % 97, (i * 37) % 640, (i * 101) % 480, 100 - i % 50);
+            text.append(line, static_cast<size_t>(length));
+        }
+        return text;
+    }
+
+    // Compressor と同じ順にフレームを書き出す（ヘッダー・ブロック・終端と内容のチェックサム）
+    std::vector<uint8_t> compressFrame(std::span<const uint8_t> data, int level) {
+        Lz4FrameHeader header;
+        header.blockSize = kBlockSize;
+        header.contentSize = static_cast<int64_t>(data.size());
+        std::vector<uint8_t> out(kLz4FrameMaxHeaderSize + kLz4FrameMaxEndSize +
+                                 (data.size() / kBlockSize + 1) * Lz4FrameBlockBound(kBlockSize));
+        size_t used = Lz4FrameWriteHeader(header, out.data());
+        for (size_t offset = 0; offset < data.size(); offset += kBlockSize) {
+            const size_t size = (std::min)(kBlockSize, data.size() - offset);
+            used += Lz4FrameWriteBlock(data.data() + offset, size, level, out.data() + used);
+        }
+        used += Lz4FrameWriteEnd(true, Xxh32::Hash(data.data(), data.size()), out.data() + used);
+        out.resize(used);
+        return out;
+    }
+
+    // Decompressor::read_all と同じく、展開したブロックを順に追加する
+    bool decompressFrame(std::span<const uint8_t> input, std::vector<uint8_t>& out) {
+        out.clear();
+        Lz4FrameDecoder decoder;
+        std::span<const uint8_t> block;
+        while (true) {
+            switch (decoder.decode(input, block)) {
+                case Lz4FrameStatus::Block:
+                    out.insert(out.end(), block.begin(), block.end());
+                    break;
+                case Lz4FrameStatus::FrameEnd:
+                    break;
+                case Lz4FrameStatus::NeedInput:
+                    return decoder.atFrameBoundary();
+                default:
+                    return false;
+            }
+        }
+    }
+
+    // func を iterations 回実行して 1MB あたりのナノ秒を表示する（1/10 回のウォームアップを行う）
+    template<typename Func>
+    void measure(const char* name, int iterations, double megabytes, Func&& func) {
+        for (int i = 0; i < iterations / 10; ++i) {
+            func();
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            func();
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+                          static_cast<double>(iterations) / megabytes;
+        std::printf("%-36s %12.0f ns/MB  %8.0f MB/s\n", name, ns, 1e9 / ns);
+    }
+
+}  // namespace
+
+int main() {
+    const std::string text = makeText();
+    const std::span<const uint8_t> data(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    const double megabytes = static_cast<double>(text.size()) / static_cast<double>(kMegabyte);
+
+    struct Setting {
+        const char* name;
+        int level;
+        int iterations;
+    };
+    const Setting settings[] = {
+        { "compress level 1 (per MB)", 1, 10 },
+        { "compress level 9 (per MB)", 9, 3 },
+    };
+    std::vector<uint8_t> packed;
+    for (const Setting& setting : settings) {
+        measure(setting.name, setting.iterations, megabytes, [&] { packed = compressFrame(data, setting.level); });
+        std::printf("%-36s %12.2f %%\n", "  size (% of input)",
+                    100.0 * static_cast<double>(packed.size()) / static_cast<double>(data.size()));
+    }
+
+    // 展開の速さはレベルによらない（最後の level 9 のデータを展開する）
+    std::vector<uint8_t> restored;
+    restored.reserve(data.size());
+    measure("decompress (per MB)", 10, megabytes, [&] { decompressFrame(packed, restored); });
+    if (restored.size() != data.size() || !std::equal(restored.begin(), restored.end(), data.begin())) {
+        std::printf("round trip mismatch\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/RandomBench.cpp
+// 乱数のベンチマーク（1要素あたりの時間）
+
+import hsppp;
+import hsppp_bench;
+import <random>;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        constexpr size_t kRandomCount = 100'000;
+        constexpr int64_t kRandomIterations = 200;
+    }
+
+    void run_random_bench() {
+        std::vector<int> out(kRandomCount);
+        std::vector<double> outDouble(kRandomCount);
+        const double perElement = static_cast<double>(kRandomCount);
+
+        // 従来実装相当（mt19937 + 呼び出しごとの分布オブジェクト）
+        std::mt19937 mt(0);
+        double ns = measure("mt19937 + uniform_int_distribution (baseline)", kRandomIterations, [&](int64_t) {
+            for (int& v : out) {
+                std::uniform_int_distribution<int> dist(0, 999);
+                v = dist(mt);
+            }
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        randomize(0);
+        ns = measure("rnd(1000)", kRandomIterations, [&](int64_t) {
+            for (int& v : out) {
+                v = rnd(1000);
+            }
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("rnd_fill(int, 1000)", kRandomIterations, [&](int64_t) {
+            rnd_fill(out, 1000);
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        ns = measure("rnd_fill(double)", kRandomIterations, [&](int64_t) {
+            rnd_fill(outDouble);
+            do_not_optimize(outDouble);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        rndmode(rndmode_hsp);
+        ns = measure("rnd(1000) rndmode_hsp", kRandomIterations, [&](int64_t) {
+            for (int& v : out) {
+                v = rnd(1000);
+            }
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perElement;
+        rndmode(rndmode_fast);
+
+        RandomStream stream(0);
+        RandomState snapshot{};
+        ns = measure("RandomStream save+restore", kRandomIterations, [&](int64_t) {
+            for (size_t i = 0; i < kRandomCount; ++i) {
+                snapshot = stream.save();
+                (void)stream.rnd(1000);
+                stream.restore(snapshot);
+            }
+            do_not_optimize(snapshot);
+        });
+        results().back().nsPerOp = ns / perElement;
+
+        Xoshiro256 engine(0);
+        uint64_t sink = 0;
+        ns = measure("Xoshiro256 raw 64-bit", kRandomIterations, [&](int64_t) {
+            for (size_t i = 0; i < kRandomCount; ++i) {
+                sink += engine();
+            }
+            do_not_optimize(sink);
+        });
+        results().back().nsPerOp = ns / perElement;
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,116 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/SortBench.cpp
+// ソート関数のベンチマーク（1e3 〜 1e8 要素）
+
+import hsppp;
+import hsppp_bench;
+import <algorithm>;
+import <random>;
+import <string>;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        // 従来実装相当（インデックス配列を比較ソート → 新しい配列へ移動）
+        template<typename T>
+        void indexSortBaseline(std::vector<T>& arr, std::vector<int>& indices) {
+            const size_t n = arr.size();
+            indices.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                indices[i] = static_cast<int>(i);
+            }
+            std::sort(indices.begin(), indices.end(),
+                [&arr](int a, int b) { return arr[a] < arr[b]; });
+            std::vector<T> sorted;
+            sorted.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                sorted.push_back(std::move(arr[indices[i]]));
+            }
+            arr = std::move(sorted);
+        }
+
+        // 1回あたりの要素数に応じて、合計がおよそ 1e7 要素になる回数
+        int64_t sortIterations(size_t n) {
+            return std::max<int64_t>(1, static_cast<int64_t>(10'000'000 / n));
+        }
+    }
+
+    // 各計測は入力配列のコピーを含む（ベースラインも同条件）
+    void run_sort_bench() {
+        std::mt19937 rng(12345);
+        std::vector<int> baselineIndices;
+
+        for (size_t n : { size_t{ 1'000 }, size_t{ 100'000 }, size_t{ 1'000'000 }, size_t{ 10'000'000 }, size_t{ 100'000'000 } }) {
+            std::vector<int> source(n);
+            for (int& v : source) {
+                v = static_cast<int>(rng());
+            }
+            std::vector<int> work;
+            const int64_t iterations = sortIterations(n);
+
+            // 1e8 要素のベースラインは時間がかかりすぎるため省略
+            if (n <= 10'000'000) {
+                measure(format("sortval int n={} (index sort baseline)", n), iterations, [&](int64_t) {
+                    work = source;
+                    indexSortBaseline(work, baselineIndices);
+                    do_not_optimize(work);
+                });
+            }
+            measure(format("sortval int n={}", n), iterations, [&](int64_t) {
+                work = source;
+                sortval(work);
+                do_not_optimize(work);
+            });
+        }
+
+        for (size_t n : { size_t{ 1'000 }, size_t{ 100'000 }, size_t{ 1'000'000 }, size_t{ 10'000'000 } }) {
+            std::uniform_real_distribution<double> dist(-1e6, 1e6);
+            std::vector<double> source(n);
+            for (double& v : source) {
+                v = dist(rng);
+            }
+            std::vector<double> work;
+            const int64_t iterations = sortIterations(n);
+
+            measure(format("sortval double n={} (index sort baseline)", n), iterations, [&](int64_t) {
+                work = source;
+                indexSortBaseline(work, baselineIndices);
+                do_not_optimize(work);
+            });
+            measure(format("sortval double n={}", n), iterations, [&](int64_t) {
+                work = source;
+                sortval(work);
+                do_not_optimize(work);
+            });
+        }
+
+        for (size_t n : { size_t{ 1'000 }, size_t{ 100'000 }, size_t{ 1'000'000 } }) {
+            std::vector<std::string> source(n);
+            for (std::string& v : source) {
+                v = "item_" + std::to_string(rng());
+            }
+            std::vector<std::string> work;
+            const int64_t iterations = sortIterations(n * 10);
+
+            measure(format("sortstr n={} (index sort baseline)", n), iterations, [&](int64_t) {
+                work = source;
+                indexSortBaseline(work, baselineIndices);
+                do_not_optimize(work);
+            });
+            measure(format("sortstr n={}", n), iterations, [&](int64_t) {
+                work = source;
+                sortstr(work);
+                do_not_optimize(work);
+            });
+        }
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,138 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/StringBench.cpp
+// 文字列関数のベンチマーク
+
+import hsppp;
+import hsppp_bench;
+import <cstdio>;
+import <string>;
+import <stdexcept>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        // 従来実装相当（snprintf でサイズ計測 → 確保 → 整形）
+        template<typename... Args>
+        std::string snprintfTwice(const char* fmt, Args... args) {
+            int size = std::snprintf(nullptr, 0, fmt, args...);
+            if (size < 0) return "";
+            std::string result(static_cast<size_t>(size) + 1, '\0');
+            std::snprintf(result.data(), result.size(), fmt, args...);
+            result.resize(static_cast<size_t>(size));
+            return result;
+        }
+
+        // 従来実装相当（stoi + 例外で失敗を判定）
+        int stoiWithCatch(const std::string& s) {
+            try {
+                return std::stoi(s);
+            } catch (const std::invalid_argument&) {
+                return 0;
+            } catch (const std::out_of_range&) {
+                return 0;
+            }
+        }
+    }
+
+    void run_string_bench() {
+        constexpr int64_t N = 1'000'000;
+
+        // --- strf: HUD でよく使う書式 ---
+        measure("strf HUD (snprintf x2 baseline)", N, [](int64_t i) {
+            do_not_optimize(snprintfTwice("Score: %d  HP: %d/%d", static_cast<int>(i), static_cast<int>(i & 255), 255));
+        });
+        measure("strf HUD (literal)", N, [](int64_t i) {
+            do_not_optimize(strf("Score: %d  HP: %d/%d", static_cast<int>(i), static_cast<int>(i & 255), 255));
+        });
+
+        const std::string runtimeFormat = "Score: %d  HP: %d/%d";
+        measure("strf HUD (runtime format, cached)", N, [&](int64_t i) {
+            do_not_optimize(strf(runtimeFormat, static_cast<int>(i), static_cast<int>(i & 255), 255));
+        });
+
+        std::string hud;
+        measure("strf_into HUD (reused buffer)", N, [&](int64_t i) {
+            strf_into(hud, "Score: %d  HP: %d/%d", static_cast<int>(i), static_cast<int>(i & 255), 255);
+            do_not_optimize(hud);
+        });
+
+        measure("strf FPS %.1f (snprintf x2 baseline)", N, [](int64_t i) {
+            do_not_optimize(snprintfTwice("FPS: %.1f", static_cast<double>(i) * 0.01));
+        });
+        measure("strf FPS %.1f", N, [](int64_t i) {
+            do_not_optimize(strf("FPS: %.1f", static_cast<double>(i) * 0.01));
+        });
+
+        const std::string name = "Player";
+        measure("strf %s x %d (snprintf x2 baseline)", N, [&](int64_t i) {
+            do_not_optimize(snprintfTwice("%s x %d", name.c_str(), static_cast<int>(i)));
+        });
+        measure("strf %s x %d", N, [&](int64_t i) {
+            do_not_optimize(strf("%s x %d", name, static_cast<int>(i)));
+        });
+
+        // --- toInt / str: 数値変換 ---
+        const std::string validNumber = "  123456";
+        const std::string invalidNumber = "abc";
+        measure("toInt valid (stoi baseline)", N, [&](int64_t) {
+            do_not_optimize(stoiWithCatch(validNumber));
+        });
+        measure("toInt valid", N, [&](int64_t) {
+            do_not_optimize(toInt(validNumber));
+        });
+        measure("toInt invalid (stoi + catch baseline)", N / 10, [&](int64_t) {
+            do_not_optimize(stoiWithCatch(invalidNumber));
+        });
+        measure("toInt invalid", N, [&](int64_t) {
+            do_not_optimize(toInt(invalidNumber));
+        });
+        measure("str(double) (to_string baseline)", N, [](int64_t i) {
+            do_not_optimize(std::to_string(static_cast<double>(i) * 0.5));
+        });
+        measure("str(double)", N, [](int64_t i) {
+            do_not_optimize(str(static_cast<double>(i) * 0.5));
+        });
+        std::string numBuf;
+        measure("str_into(int)", N, [&](int64_t i) {
+            do_not_optimize(str_into(numBuf, static_cast<int>(i)));
+        });
+
+        // --- cnv*: 文字コード変換（約4KBのテキスト） ---
+        std::string asciiText;
+        std::string japaneseText;
+        while (asciiText.size() < 4096) {
+            asciiText += "The quick brown fox jumps over the lazy dog. ";
+            japaneseText += reinterpret_cast<const char*>(u8"吾輩は猫である。名前はまだ無い。HSP ");
+        }
+        constexpr int64_t M = 20'000;
+        measure("cnvstow 4KB ASCII", M, [&](int64_t) {
+            do_not_optimize(cnvstow(asciiText));
+        });
+        measure("cnvstow 4KB Japanese", M, [&](int64_t) {
+            do_not_optimize(cnvstow(japaneseText));
+        });
+        std::u16string wideBuf;
+        measure("cnvstow_into 4KB Japanese", M, [&](int64_t) {
+            do_not_optimize(cnvstow_into(wideBuf, japaneseText));
+        });
+        std::string narrowBuf;
+        measure("cnvwtos_into 4KB Japanese", M, [&](int64_t) {
+            do_not_optimize(cnvwtos_into(narrowBuf, wideBuf));
+        });
+        const std::string sjisText = cnvstoa(japaneseText);
+        measure("cnvstoa_into 4KB Japanese", M, [&](int64_t) {
+            do_not_optimize(cnvstoa_into(narrowBuf, japaneseText));
+        });
+        measure("cnvatos_into 4KB Japanese", M, [&](int64_t) {
+            do_not_optimize(cnvatos_into(narrowBuf, sjisText));
+        });
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,79 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/TweenBench.cpp
+// Timeline のベンチマーク（10万トゥイーンの1フレーム更新）
+
+import hsppp;
+import hsppp_bench;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        constexpr size_t kTweenCount = 100'000;
+        constexpr int64_t kTweenFrames = 600;
+        constexpr double kFrameTime = 1.0 / 60.0;
+    }
+
+    void run_tween_bench() {
+        std::vector<double> x(kTweenCount);
+
+        // 同じ作業を毎フレーム geteasef で手書きした場合
+        {
+            std::vector<double> elapsed(kTweenCount, 0.0);
+            setease(0.0, 640.0, ease_quad_out);
+            measure("tween 100k geteasef loop (per frame)", kTweenFrames, [&](int64_t) {
+                for (size_t i = 0; i < kTweenCount; ++i) {
+                    elapsed[i] += kFrameTime;
+                    x[i] = geteasef(elapsed[i], 2.0);
+                }
+                do_not_optimize(x);
+            });
+        }
+
+        // 単一の曲線（繰り返し再生で完了させない）
+        {
+            Timeline timeline;
+            for (size_t i = 0; i < kTweenCount; ++i) {
+                timeline.add(&x[i], 0.0, 640.0, 2.0, ease_quad_out, { .repeat = -1 });
+            }
+            measure("Timeline::update 100k quad_out (per frame)", kTweenFrames, [&](int64_t) {
+                timeline.update(kFrameTime);
+                do_not_optimize(x);
+            });
+        }
+
+        // 全タイプ混在（ease_loop を含む）
+        {
+            Timeline timeline;
+            for (size_t i = 0; i < kTweenCount; ++i) {
+                const int type = static_cast<int>(i % (ease_shake_inout + 1)) | (i % 5 == 0 ? ease_loop : 0);
+                timeline.add(&x[i], 0.0, 640.0, 1.0 + static_cast<double>(i % 97) * 0.1, type, { .repeat = -1 });
+            }
+            measure("Timeline::update 100k mixed (per frame)", kTweenFrames, [&](int64_t) {
+                timeline.update(kFrameTime);
+                do_not_optimize(x);
+            });
+        }
+
+        // 短いトゥイーンの完了とスロット再利用
+        {
+            Timeline timeline;
+            int completed = 0;
+            measure("Timeline add+complete 1k/frame (per frame)", kTweenFrames, [&](int64_t) {
+                for (size_t i = 0; i < 1'000; ++i) {
+                    timeline.add(&x[i], 0.0, 1.0, kFrameTime, ease_linear, { .on_complete = [&completed] { ++completed; } });
+                }
+                timeline.update(kFrameTime);
+                do_not_optimize(completed);
+            });
+        }
+    }
+
+}  // namespace hsppp_bench
@@ -0,0 +1,81 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppBench/VecMathBench.cpp
+// ベクトル演算のベンチマーク（100万点の変換、1点あたりの時間）
+
+import hsppp;
+import hsppp_bench;
+import <vector>;
+
+using namespace hsppp;
+
+namespace hsppp_bench {
+
+    namespace {
+        constexpr size_t kPointCount = 1'000'000;
+        constexpr size_t kQuadCount = kPointCount / Quad::vertex_count;
+        constexpr int64_t kVecIterations = 50;
+    }
+
+    void run_vecmath_bench() {
+        std::vector<Vec2> points(kPointCount);
+        std::vector<Point2i> ipoints(kPointCount);
+        for (size_t i = 0; i < kPointCount; ++i) {
+            const int x = static_cast<int>((i * 7919) % 1280) - 640;
+            const int y = static_cast<int>((i * 104729) % 960) - 480;
+            points[i] = Vec2(static_cast<float>(x), static_cast<float>(y));
+            ipoints[i] = Point2i(x, y);
+        }
+        std::vector<Vec2> out(kPointCount);
+        std::vector<Point2i> iout(kPointCount);
+        const double perPoint = static_cast<double>(kPointCount);
+        const double angle = 0.7;
+        const Mat3 m = Mat3::translation(320.0f, 240.0f) * Mat3::rotation(angle) * Mat3::scaling(1.5f, 1.5f);
+
+        // 従来の書き方（点ごとに sin / cos を使って手で回転・拡大・移動）
+        double ns = measure("hand-written rotate (per point)", kVecIterations, [&](int64_t) {
+            for (size_t i = 0; i < kPointCount; ++i) {
+                const double c = cos(angle);
+                const double s = sin(angle);
+                const double x = points[i].x * 1.5;
+                const double y = points[i].y * 1.5;
+                out[i] = Vec2(static_cast<float>(x * c - y * s + 320.0), static_cast<float>(x * s + y * c + 240.0));
+            }
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perPoint;
+
+        ns = measure("Mat3::transform_point (per point)", kVecIterations, [&](int64_t) {
+            for (size_t i = 0; i < kPointCount; ++i) {
+                out[i] = m.transform_point(points[i]);
+            }
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perPoint;
+
+        ns = measure("transform Vec2 (batch)", kVecIterations, [&](int64_t) {
+            transform(m, points, out);
+            do_not_optimize(out);
+        });
+        results().back().nsPerOp = ns / perPoint;
+
+        ns = measure("transform Point2i (batch)", kVecIterations, [&](int64_t) {
+            transform(m, ipoints, iout);
+            do_not_optimize(iout);
+        });
+        results().back().nsPerOp = ns / perPoint;
+
+        std::vector<Quad> quads(kQuadCount, Quad(-8, -8, 8, -8, 8, 8, -8, 8));
+        std::vector<Quad> qout(kQuadCount);
+        ns = measure("transform Quad (batch, per vertex)", kVecIterations, [&](int64_t) {
+            transform(m, quads, qout);
+            do_not_optimize(qout);
+        });
+        results().back().nsPerOp = ns / perPoint;
+    }
+
+}  // namespace hsppp_bench
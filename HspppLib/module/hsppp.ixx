@@ -21,6 +21,9 @@ export import :screen;
 export import :drawing;
 export import :input;
 export import :math;
+export import :tween;
+export import :vecmath;
+export import :collision;
 export import :string;
 export import :file;
 export import :interrupt;
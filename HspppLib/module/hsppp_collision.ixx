@@ -0,0 +1,308 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/module/hsppp_collision.ixx
+// 当たり判定モジュール: 矩形（AABB）の広域判定（空間ハッシュ / ソート＆スイープ）とピクセル単位の判定
+//
+// 使用例:
+//   SpatialHash world(64.0f);
+//   for (auto& e : enemies) world.insert(cel_hitbox(enemyCel, e.x, e.y));
+//   std::vector<CollisionPair> hits;
+//   while (true) {
+//       world.move_to(enemyPositions);   // 位置だけ毎フレーム更新（大きさは保持）
+//       world.find_pairs(hits);          // 重なっている組をまとめて取得
+//       ...
+//   }
+
+export module hsppp:collision;
+
+import :types;
+import :vecmath;
+
+import <cstdint>;
+import <source_location>;
+import <span>;
+import <string_view>;
+import <vector>;
+
+export namespace hsppp {
+
+    // ============================================================
+    // Aabb - 軸に平行な矩形
+    // ============================================================
+
+    /// @brief 軸に平行な矩形（左上を含み、右下を含まない）
+    struct Aabb {
+        float left = 0.0f;
+        float top = 0.0f;
+        float right = 0.0f;
+        float bottom = 0.0f;
+
+        constexpr Aabb() noexcept = default;
+        constexpr Aabb(float l, float t, float r, float b) noexcept : left(l), top(t), right(r), bottom(b) {}
+
+        /// @brief 左上の位置と大きさから作成
+        [[nodiscard]] static constexpr Aabb from_size(Vec2 position, Vec2 size) noexcept {
+            return { position.x, position.y, position.x + size.x, position.y + size.y };
+        }
+
+        /// @brief 中心と大きさから作成
+        [[nodiscard]] static constexpr Aabb from_center(Vec2 center, Vec2 size) noexcept {
+            return from_size(center - size * 0.5f, size);
+        }
+
+        [[nodiscard]] constexpr Vec2 position() const noexcept { return { left, top }; }
+        [[nodiscard]] constexpr Vec2 size() const noexcept { return { right - left, bottom - top }; }
+        [[nodiscard]] constexpr Vec2 center() const noexcept { return { (left + right) * 0.5f, (top + bottom) * 0.5f }; }
+
+        /// @brief 平行移動した矩形
+        [[nodiscard]] constexpr Aabb moved(Vec2 delta) const noexcept {
+            return { left + delta.x, top + delta.y, right + delta.x, bottom + delta.y };
+        }
+
+        /// @brief 重なっているか（辺が接しているだけの場合は重ならない）
+        [[nodiscard]] constexpr bool overlaps(const Aabb& other) const noexcept {
+            return left < other.right && other.left < right && top < other.bottom && other.top < bottom;
+        }
+
+        /// @brief 点を含むか
+        [[nodiscard]] constexpr bool contains(Vec2 p) const noexcept {
+            return left <= p.x && p.x < right && top <= p.y && p.y < bottom;
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const Aabb&, const Aabb&) noexcept = default;
+    };
+
+    /// @brief Cel の1セル分の大きさの当たり判定（celput と同じく x, y が左上）
+    /// @param inset 四辺を内側に縮める量（ピクセル。見た目より小さい当たり判定用）
+    /// @details 大きさは Cel::cell_width / cell_height（divide / celdiv の分割後の大きさ）
+    [[nodiscard]] Aabb cel_hitbox(const Cel& cel, float x, float y, float inset = 0.0f,
+                                  const std::source_location& location = std::source_location::current());
+
+    /// @brief 重なっている組（find_pairs では a < b のボディ番号、複数範囲の query では a が範囲の番号）
+    struct CollisionPair {
+        uint32_t a = 0;
+        uint32_t b = 0;
+
+        [[nodiscard]] friend constexpr bool operator==(const CollisionPair&, const CollisionPair&) noexcept = default;
+    };
+
+    // ============================================================
+    // AabbList - 矩形の構造体配列（SoA）
+    // ============================================================
+
+    /// @brief 番号付きの矩形の集合（left / top / right / bottom を別々の配列で保持）
+    /// @details ボディ番号は insert した順の 0 からの連番。clear() しても確保済みの容量は保持するため、
+    ///          毎フレーム同じ数を入れ直してもメモリ確保は起きない
+    class AabbList {
+    public:
+        AabbList() = default;
+
+        /// @brief 矩形を追加し、ボディ番号を返す
+        uint32_t insert(const Aabb& box);
+
+        /// @brief 矩形をまとめて追加（番号は size() から連番）
+        void insert(std::span<const Aabb> boxes);
+
+        /// @brief 矩形を置き換える
+        void update(uint32_t body, const Aabb& box,
+                    const std::source_location& location = std::source_location::current());
+
+        /// @brief first 番から順に矩形をまとめて置き換える
+        void update(std::span<const Aabb> boxes, uint32_t first = 0,
+                    const std::source_location& location = std::source_location::current());
+
+        /// @brief first 番から順に左上の位置をまとめて設定（大きさは保持）
+        void move_to(std::span<const Vec2> positions, uint32_t first = 0,
+                     const std::source_location& location = std::source_location::current());
+
+        /// @brief 全ボディを削除（容量は保持）
+        void clear() noexcept;
+
+        /// @brief 容量を確保
+        void reserve(size_t count);
+
+        [[nodiscard]] Aabb operator[](uint32_t body) const noexcept {
+            return { m_left[body], m_top[body], m_right[body], m_bottom[body] };
+        }
+        [[nodiscard]] size_t size() const noexcept { return m_left.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_left.empty(); }
+
+        [[nodiscard]] std::span<const float> lefts() const noexcept { return m_left; }
+        [[nodiscard]] std::span<const float> tops() const noexcept { return m_top; }
+        [[nodiscard]] std::span<const float> rights() const noexcept { return m_right; }
+        [[nodiscard]] std::span<const float> bottoms() const noexcept { return m_bottom; }
+
+    protected:
+        std::vector<float> m_left;
+        std::vector<float> m_top;
+        std::vector<float> m_right;
+        std::vector<float> m_bottom;
+        bool m_dirty = true;    // 前回の検索以降に変更があったか（派生クラスが索引を作り直す）
+
+    private:
+        void checkRange(const char* name, size_t first, size_t count, const std::source_location& location) const;
+    };
+
+    // ============================================================
+    // SpatialHash - 一様グリッドの空間ハッシュ
+    // ============================================================
+
+    /// @brief 一様グリッドによる広域判定（空間ハッシュ）
+    /// @details 各ボディを左上の角を含むセルに1回だけ登録し、隣り合うセルのボディ同士だけを調べる。
+    ///          登録はセルの行・列の順に並べるため、検索はほぼ連続したメモリの走査で済む。
+    ///          大きさのそろった多数のスプライトに向く（セルの一辺は代表的なボディの大きさ以上にする）。
+    ///          縦横どちらかが2セルを超えて覆うボディは大きなボディとして全ボディと総当たりで調べる。
+    ///          索引は変更後の最初の検索で作り直す（確保済みの領域を再利用する）。スレッドセーフではない
+    class SpatialHash : public AabbList {
+    public:
+        /// @param cellSize セルの一辺（0 より大きい値）
+        explicit SpatialHash(float cellSize = 64.0f,
+                             const std::source_location& location = std::source_location::current());
+
+        /// @brief area と重なるボディ番号を out に格納（out の内容は置き換える。順序は不定）
+        void query(const Aabb& area, std::vector<uint32_t>& out);
+
+        /// @brief 複数の範囲をまとめて検索（a = areas の番号、b = ボディ番号）
+        void query(std::span<const Aabb> areas, std::vector<CollisionPair>& out);
+
+        /// @brief 重なっているボディの組をすべて out に格納（a < b、各組は1回だけ。順序は不定）
+        void find_pairs(std::vector<CollisionPair>& out);
+
+        [[nodiscard]] float cell_size() const noexcept { return m_cellSize; }
+
+    private:
+        // グリッドへの登録（矩形を写しておき、走査時にボディの配列を参照しない）
+        struct Entry {
+            int32_t cellX;
+            int32_t cellY;
+            uint32_t body;
+            float left;
+            float top;
+            float right;
+            float bottom;
+        };
+
+        void rebuild();
+        void queryInto(const Aabb& area, uint32_t areaIndex, std::vector<uint32_t>* bodies, std::vector<CollisionPair>* pairs);
+
+        float m_cellSize;
+        float m_invCellSize;
+        std::vector<Entry> m_entries;           // セルの (行, 列) の順に並べた登録
+        std::vector<Entry> m_scratch;           // 基数ソートの作業領域
+        std::vector<uint32_t> m_large;          // グリッドに登録しない大きなボディ（昇順）
+    };
+
+    // ============================================================
+    // SweepAndPrune - ソート＆スイープ
+    // ============================================================
+
+    /// @brief x 方向に並べ替えて走査する広域判定
+    /// @details 大きさがまちまちのボディや、広い範囲に疎に散らばる場合に向く。
+    ///          並び順は前回の結果から挿入ソートで更新するため、少しずつ動く場合は毎フレーム O(n) に近い。
+    ///          索引は変更後の最初の検索で作り直す（確保済みの領域を再利用する）。スレッドセーフではない
+    class SweepAndPrune : public AabbList {
+    public:
+        SweepAndPrune() = default;
+
+        /// @brief area と重なるボディ番号を out に格納（out の内容は置き換える。順序は不定）
+        void query(const Aabb& area, std::vector<uint32_t>& out);
+
+        /// @brief 複数の範囲をまとめて検索（a = areas の番号、b = ボディ番号）
+        void query(std::span<const Aabb> areas, std::vector<CollisionPair>& out);
+
+        /// @brief 重なっているボディの組をすべて out に格納（a < b、各組は1回だけ。順序は不定）
+        void find_pairs(std::vector<CollisionPair>& out);
+
+    private:
+        void rebuild();
+        void queryInto(const Aabb& area, uint32_t areaIndex, std::vector<uint32_t>* bodies, std::vector<CollisionPair>* pairs);
+
+        std::vector<uint32_t> m_order;          // left の昇順に並べたボディ番号（前回の結果を引き継ぐ）
+        std::vector<float> m_sortedLeft;        // m_order の順に並べた矩形（走査時に連続して読む）
+        std::vector<float> m_sortedTop;
+        std::vector<float> m_sortedRight;
+        std::vector<float> m_sortedBottom;
+        float m_maxWidth = 0.0f;                // 最も幅の広いボディの幅（検索範囲の絞り込み用）
+    };
+
+    // ============================================================
+    // PixelMask - ピクセル単位の当たり判定
+    // ============================================================
+
+    /// @brief 1ピクセル1ビットの当たり判定マスク
+    /// @details 各行を 64bit ワードに詰めて保持する（x 列目は x / 64 番目のワードの x % 64 ビット目）。
+    ///          立っているビットの外接矩形を持ち、判定は外接矩形が重なる場合だけ行を比較する。
+    ///          広域判定（SpatialHash 等）で絞り込んだ組の詳細判定に使う
+    class PixelMask {
+    public:
+        PixelMask() = default;
+
+        /// @brief BGRA の画素（width * height 要素、行の順）から作成
+        [[nodiscard]] static PixelMask from_bgra(std::span<const uint32_t> pixels, int width, int height,
+                                                 const MaskParams& params = {},
+                                                 const std::source_location& location = std::source_location::current());
+
+        /// @brief 詰めたビット列（words_per_row() * height 要素）から作成
+        [[nodiscard]] static PixelMask from_bits(int width, int height, std::vector<uint64_t> bits,
+                                                 const std::source_location& location = std::source_location::current());
+
+        [[nodiscard]] int width() const noexcept { return m_width; }
+        [[nodiscard]] int height() const noexcept { return m_height; }
+        [[nodiscard]] size_t words_per_row() const noexcept { return m_wordsPerRow; }
+
+        /// @brief 当たりの画素が1つもないか
+        [[nodiscard]] bool empty() const noexcept { return m_left >= m_right; }
+
+        /// @brief (x, y) が当たりか（範囲外は false）
+        [[nodiscard]] bool test(int x, int y) const noexcept {
+            if (x < 0 || y < 0 || x >= m_width || y >= m_height) {
+                return false;
+            }
+            return (m_bits[static_cast<size_t>(y) * m_wordsPerRow + static_cast<size_t>(x) / 64] >> (x % 64)) & 1;
+        }
+
+        /// @brief y 行目のビット列
+        [[nodiscard]] std::span<const uint64_t> row(int y) const noexcept {
+            return std::span<const uint64_t>(m_bits).subspan(static_cast<size_t>(y) * m_wordsPerRow, m_wordsPerRow);
+        }
+
+        /// @brief 当たりの画素の外接矩形（マスクの左上が原点。cel_hitbox の代わりに AabbList へ登録できる）
+        [[nodiscard]] Aabb bounds() const noexcept {
+            return { static_cast<float>(m_left), static_cast<float>(m_top),
+                     static_cast<float>(m_right), static_cast<float>(m_bottom) };
+        }
+
+        /// @brief 自身を (x, y)、other を (otherX, otherY) に置いたときに当たりの画素が重なるか
+        [[nodiscard]] bool overlaps(int x, int y, const PixelMask& other, int otherX, int otherY) const noexcept;
+
+    private:
+        void updateBounds() noexcept;
+
+        int m_width = 0;
+        int m_height = 0;
+        size_t m_wordsPerRow = 0;
+        std::vector<uint64_t> m_bits;
+        int m_left = 0;         // 当たりの画素の外接矩形（right / bottom は含まない）
+        int m_top = 0;
+        int m_right = 0;
+        int m_bottom = 0;
+    };
+
+    /// @brief 画像ファイルから当たり判定マスクを作成（ウィンドウ・描画デバイスなしでも動作）
+    [[nodiscard]] PixelMask load_mask(std::string_view filename, const MaskParams& params = {},
+                                      const std::source_location& location = std::source_location::current());
+
+    /// @brief Cel の1セル分の当たり判定マスク（マスクを指定した loadCel で読み込んだ Cel のみ）
+    /// @details divide / celdiv の分割後のセルを切り出す。毎フレームではなく読み込み後に1回作って保持する
+    [[nodiscard]] PixelMask cel_mask(const Cel& cel, int cellIndex,
+                                     const std::source_location& location = std::source_location::current());
+
+    /// @brief Cel の全セルの当たり判定マスク（セル番号の順）
+    [[nodiscard]] std::vector<PixelMask> cel_masks(const Cel& cel,
+                                                   const std::source_location& location = std::source_location::current());
+
+}  // namespace hsppp
@@ -11,6 +11,9 @@ export module hsppp:drawing;
 
 import :types;
 
+import <array>;
+import <cstdint>;
+import <span>;
 import <string_view>;
 import <source_location>;
 import <utility>;
@@ -121,6 +124,46 @@ export namespace hsppp {
     /// @brief システムカラーを設定する
     void syscolor(int p1, const std::source_location& location = std::source_location::current());
 
+    // ============================================================
+    // 色変換（配列の一括処理）
+    // ============================================================
+    // RGB は 0xRRGGBB（rgbcolor と同じ）、BGRA はメモリ上 B,G,R,A の順の 32bit（0xAARRGGBB）
+    // 変換は SSE2 で複数要素ずつ処理する。出力配列は入力と同じ要素数であること
+
+    /// @brief HSV を RGB にまとめて変換する
+    /// @param h 色相（0～191）
+    /// @param s 彩度（0～255）
+    /// @param v 明度（0～255）
+    /// @param rgb 出力（0xRRGGBB）
+    /// @details 結果は hsvcolor で設定される色と一致する。範囲外の値はエラーにせず丸め込む
+    void hsv_to_rgb(std::span<const int> h, std::span<const int> s, std::span<const int> v, std::span<int> rgb,
+                    const std::source_location& location = std::source_location::current());
+
+    /// @brief RGB を HSV（hsvcolor と同じ範囲）にまとめて変換する
+    /// @details 色相は 192 段階の最も近い値に丸める（無彩色は 0）
+    void rgb_to_hsv(std::span<const int> rgb, std::span<int> h, std::span<int> s, std::span<int> v,
+                    const std::source_location& location = std::source_location::current());
+
+    /// @brief 彩度・明度を固定した 192 段階の色相テーブルを作成する
+    /// @return 要素 h が hsvcolor(h, s, v) の色（0xRRGGBB）
+    [[nodiscard]] std::array<int, 192> hsv_palette(int s, int v,
+                                                   const std::source_location& location = std::source_location::current());
+
+    /// @brief RGB を BGRA にまとめて変換する
+    /// @param alpha 全要素に設定するアルファ値（0～255）
+    void rgb_to_bgra(std::span<const int> rgb, std::span<uint32_t> bgra, int alpha = 255,
+                     const std::source_location& location = std::source_location::current());
+
+    /// @brief BGRA を RGB にまとめて変換する（アルファは捨てる）
+    void bgra_to_rgb(std::span<const uint32_t> bgra, std::span<int> rgb,
+                     const std::source_location& location = std::source_location::current());
+
+    /// @brief BGRA の各成分にアルファを掛けて乗算済みアルファ形式にする（その場で変換）
+    void premultiply_bgra(std::span<uint32_t> pixels) noexcept;
+
+    /// @brief 乗算済みアルファ形式の BGRA を通常の形式に戻す（その場で変換。アルファ 0 の画素は 0 になる）
+    void unpremultiply_bgra(std::span<uint32_t> pixels) noexcept;
+
     // ============================================================
     // print - mes別名
     // ============================================================
@@ -5,7 +5,7 @@
 // SPDX-License-Identifier: BSL-1.0
 
 // HspppLib/module/hsppp_file.ixx
-// ファイル操作モジュール: exist, bload, bsave, dirlist 等
+// ファイル操作モジュール: exist, exist_many, bload, peek, BufferReader, bsave, bmap, bload_async, bcopy_async, dirlist, dirwalk, filewatch, Compressor 等
 
 export module hsppp:file;
 
@@ -17,6 +17,10 @@ import <vector>;
 import <source_location>;
 import <functional>;
 import <memory>;
+import <span>;
+import <bit>;
+import <cstring>;
+import <type_traits>;
 
 export namespace hsppp {
 
@@ -49,13 +53,59 @@ export namespace hsppp {
     /// @brief ファイルのコピー
     void bcopy(const std::string& src, const std::string& dest, const std::source_location& location = std::source_location::current());
 
+    /// @brief コピー方法を指定してファイルをコピー
+    void bcopy(const std::string& src, const std::string& dest, const CopyParams& params,
+               const std::source_location& location = std::source_location::current());
+
     /// @brief ファイルのサイズ取得
     [[nodiscard]] int64_t exist(const std::string& filename, const std::source_location& location = std::source_location::current());
 
+    /// @brief exist_many で取得したファイルの情報
+    struct FileStat {
+        int64_t size = -1;          ///< ファイルサイズ（ディレクトリは 0、存在しない場合は -1）
+        int64_t mtime = 0;          ///< 最終更新時刻（1970-01-01 UTC からのミリ秒。pack:// は 0）
+        bool directory = false;     ///< ディレクトリか
+
+        /// @brief ファイル・ディレクトリが存在するか
+        [[nodiscard]] bool exists() const noexcept { return size >= 0; }
+    };
+
+    /// @brief 複数のファイルの情報をまとめて取得
+    /// @details 多数のパスは作業スレッドで並列に取得する。結果は filenames と同じ順。
+    ///          pattern を指定しない filewatch の下のパスは、変更が通知されるまで前回の結果を返す（exist も同じ）
+    [[nodiscard]] std::vector<FileStat> exist_many(std::span<const std::string> filenames,
+                                                   const std::source_location& location = std::source_location::current());
+
+    /// @brief 複数のファイルの情報をまとめて取得（結果の vector を再利用する版）
+    void exist_many(std::span<const std::string> filenames, std::vector<FileStat>& result,
+                    const std::source_location& location = std::source_location::current());
+
     /// @brief ディレクトリ一覧を取得
     [[nodiscard]] std::vector<std::string> dirlist(const std::string& filemask, OptInt mode = {},
                                       const std::source_location& location = std::source_location::current());
 
+    /// @brief dirwalk で見つけたファイル・ディレクトリ
+    struct DirEntry {
+        std::string path;           ///< 起点からの相対パス（区切りは '/'）
+        int64_t size = 0;           ///< ファイルサイズ（ディレクトリは 0）
+        int64_t mtime = 0;          ///< 最終更新時刻（1970-01-01 UTC からのミリ秒）
+        bool directory = false;     ///< ディレクトリか
+        bool hidden = false;        ///< 隠し属性・システム属性か
+    };
+
+    /// @brief dirwalk のエントリーごとに呼ばれる関数（false を返すと走査をやめる）
+    using DirWalkCallback = std::function<bool(const DirEntry&)>;
+
+    /// @brief ディレクトリ以下を作業スレッドで並列に走査し、見つけた順に callback に渡す
+    /// @details callback は呼び出し元のスレッドで呼ばれる。順序は不定。シンボリックリンク・ジャンクションの先はたどらない
+    /// @return callback に渡したエントリーの数
+    int64_t dirwalk(const std::string& root, const DirWalkCallback& callback, const DirWalkParams& params = {},
+                    const std::source_location& location = std::source_location::current());
+
+    /// @brief ディレクトリ以下を並列に走査し、パスの順に並べて返す
+    [[nodiscard]] std::vector<DirEntry> dirwalk(const std::string& root, const DirWalkParams& params = {},
+                                                const std::source_location& location = std::source_location::current());
+
     /// @brief バッファにファイルをロード（string版）
     int64_t bload(const std::string& filename, std::string& buffer, OptInt64 size = {}, OptInt64 offset = {},
                   const std::source_location& location = std::source_location::current());
@@ -72,6 +122,867 @@ export namespace hsppp {
     int64_t bsave(const std::string& filename, const std::vector<uint8_t>& buffer, OptInt64 size = {}, OptInt64 offset = {},
                   const std::source_location& location = std::source_location::current());
 
+    /// @brief 保存方法を指定してバッファをファイルにセーブ（string版）
+    /// @return 書き込んだ（deferred では書き込む予定の）バイト数
+    int64_t bsave(const std::string& filename, const std::string& buffer, OptInt64 size, OptInt64 offset,
+                  const SaveParams& params,
+                  const std::source_location& location = std::source_location::current());
+
+    /// @brief 保存方法を指定してバッファをファイルにセーブ（vector版）
+    int64_t bsave(const std::string& filename, const std::vector<uint8_t>& buffer, OptInt64 size, OptInt64 offset,
+                  const SaveParams& params,
+                  const std::source_location& location = std::source_location::current());
+
+    /// @brief SaveParams::deferred で遅らせた書き込みをすべて実行する
+    void bflush(const std::source_location& location = std::source_location::current());
+
+    // ============================================================
+    // バイナリの読み書き
+    // ============================================================
+
+    /// @brief バッファの index バイト目を取得（HSP の peek。0〜255）
+    [[nodiscard]] int peek(const std::vector<uint8_t>& buffer, int64_t index,
+                           const std::source_location& location = std::source_location::current());
+    [[nodiscard]] int peek(const std::string& buffer, int64_t index,
+                           const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファの index バイト目から 2 バイトを符号なし整数として取得（HSP の wpeek。リトルエンディアン）
+    [[nodiscard]] int wpeek(const std::vector<uint8_t>& buffer, int64_t index,
+                            const std::source_location& location = std::source_location::current());
+    [[nodiscard]] int wpeek(const std::string& buffer, int64_t index,
+                            const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファの index バイト目から 4 バイトを整数として取得（HSP の lpeek。リトルエンディアン）
+    [[nodiscard]] int lpeek(const std::vector<uint8_t>& buffer, int64_t index,
+                            const std::source_location& location = std::source_location::current());
+    [[nodiscard]] int lpeek(const std::string& buffer, int64_t index,
+                            const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファの index バイト目に value の下位 8 ビットを書き込む（HSP の poke）
+    void poke(std::vector<uint8_t>& buffer, int64_t index, int value,
+              const std::source_location& location = std::source_location::current());
+    void poke(std::string& buffer, int64_t index, int value,
+              const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファの index バイト目に文字列の内容を書き込む（HSP の poke p1,p2,"文字列"。終端の 0 は書き込まない）
+    void poke(std::vector<uint8_t>& buffer, int64_t index, std::string_view text,
+              const std::source_location& location = std::source_location::current());
+    void poke(std::string& buffer, int64_t index, std::string_view text,
+              const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファの index バイト目に value の下位 16 ビットを書き込む（HSP の wpoke。リトルエンディアン）
+    void wpoke(std::vector<uint8_t>& buffer, int64_t index, int value,
+               const std::source_location& location = std::source_location::current());
+    void wpoke(std::string& buffer, int64_t index, int value,
+               const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファの index バイト目に value を 4 バイトで書き込む（HSP の lpoke。リトルエンディアン）
+    void lpoke(std::vector<uint8_t>& buffer, int64_t index, int value,
+               const std::source_location& location = std::source_location::current());
+    void lpoke(std::string& buffer, int64_t index, int value,
+               const std::source_location& location = std::source_location::current());
+
+    namespace detail {
+        /// @brief BufferReader / BufferWriter の範囲外の読み書きの例外を送出（ERR_BUFFER_OVERFLOW）
+        [[noreturn]] void throw_buffer_range(size_t position, size_t count, size_t size,
+                                             const std::source_location& location);
+
+        /// @brief 64 ビットに収まらない可変長整数の例外を送出（ERR_OUT_OF_RANGE）
+        [[noreturn]] void throw_varint_overflow(size_t position, const std::source_location& location);
+
+        template<typename T>
+        inline constexpr bool is_span_v = false;
+        template<typename T, size_t N>
+        inline constexpr bool is_span_v<std::span<T, N>> = true;
+
+        /// @brief BufferReader / BufferWriter で読み書きできる型（メモリ上の表現をそのまま写せる値。ポインタ・配列・ビューは除く）
+        template<typename T>
+        concept BufferValue = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+                              && !std::is_pointer_v<T> && !std::is_array_v<T> && !is_span_v<T>
+                              && !std::is_same_v<T, std::string_view>;
+
+        /// @brief 整数・浮動小数点数・列挙型のバイト順を入れ替えるか（1 バイトの型と構造体はそのまま写す）
+        template<typename T>
+        inline constexpr bool is_byte_ordered_v = (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+                                                  && (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+        template<typename T>
+        [[nodiscard]] constexpr T byteswap_value(T value) noexcept {
+            if constexpr (!is_byte_ordered_v<T>) {
+                return value;
+            } else if constexpr (sizeof(T) == 2) {
+                return std::bit_cast<T>(std::byteswap(std::bit_cast<uint16_t>(value)));
+            } else if constexpr (sizeof(T) == 4) {
+                return std::bit_cast<T>(std::byteswap(std::bit_cast<uint32_t>(value)));
+            } else {
+                return std::bit_cast<T>(std::byteswap(std::bit_cast<uint64_t>(value)));
+            }
+        }
+    }
+
+    /// @brief バイト列から値を順に読み出すカーソル（bload・bmap の内容の解析用）
+    /// @details 読み出す前に範囲を確認する（範囲外は ERR_BUFFER_OVERFLOW で、位置は変わらない）。
+    ///          整数・浮動小数点数・列挙型は order のバイト順で解釈し、構造体はメモリ上の表現をそのまま写す。
+    ///          bool は 0 以外のバイトを true として読む（構造体のメンバーの bool は 0 / 1 である必要がある）。
+    ///          元のバッファは BufferReader より長く生存している必要がある
+    class BufferReader {
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+        size_t m_pos = 0;
+        std::endian m_order = std::endian::little;
+
+        // count バイトを読み出す位置を返し、読み出し位置を進める
+        const uint8_t* take(size_t count, const std::source_location& location) {
+            if (count > m_size - m_pos) {
+                detail::throw_buffer_range(m_pos, count, m_size, location);
+            }
+            const uint8_t* p = m_data + m_pos;
+            m_pos += count;
+            return p;
+        }
+
+        template<typename T>
+        [[nodiscard]] T fromOrder(T value) const noexcept {
+            if constexpr (detail::is_byte_ordered_v<T>) {
+                if (m_order != std::endian::native) {
+                    return detail::byteswap_value(value);
+                }
+            }
+            return value;
+        }
+
+        // p から値を1つ写す。bool は 0 以外を true にする（0・1 以外のバイトを bool に写すと未定義動作）
+        template<typename T>
+        [[nodiscard]] T load(const uint8_t* p) const noexcept {
+            if constexpr (std::is_same_v<T, bool>) {
+                return *p != 0;
+            } else {
+                T value;
+                std::memcpy(&value, p, sizeof(T));
+                return fromOrder(value);
+            }
+        }
+
+    public:
+        /// @brief デフォルトコンストラクタ（空のリーダー）
+        BufferReader() = default;
+
+        /// @brief バイト列を参照して構築
+        explicit BufferReader(std::span<const uint8_t> data, std::endian order = std::endian::little) noexcept
+            : m_data(data.data()), m_size(data.size()), m_order(order) {}
+
+        /// @brief バイト配列を参照して構築
+        explicit BufferReader(const std::vector<uint8_t>& data, std::endian order = std::endian::little) noexcept
+            : BufferReader(std::span<const uint8_t>(data), order) {}
+
+        /// @brief 文字列の内容を参照して構築（bload の string 版のバッファ用）
+        explicit BufferReader(std::string_view data, std::endian order = std::endian::little) noexcept
+            : BufferReader(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size()), order) {}
+
+        explicit BufferReader(const std::string& data, std::endian order = std::endian::little) noexcept
+            : BufferReader(std::string_view(data), order) {}
+
+        /// @brief 一時オブジェクトの参照は禁止（ダングリング防止）
+        explicit BufferReader(std::vector<uint8_t>&&, std::endian = std::endian::little) = delete;
+        explicit BufferReader(std::string&&, std::endian = std::endian::little) = delete;
+
+        /// @brief 値を1つ読み出す
+        template<detail::BufferValue T>
+        [[nodiscard]] T read(const std::source_location& location = std::source_location::current()) {
+            return load<T>(take(sizeof(T), location));
+        }
+
+        /// @brief 値を1つ読み出して value に設定する
+        template<detail::BufferValue T>
+        BufferReader& read(T& value, const std::source_location& location = std::source_location::current()) {
+            value = read<T>(location);
+            return *this;
+        }
+
+        /// @brief values の要素数だけ読み出す（まとめて写してから、必要ならバイト順を入れ替える）
+        template<detail::BufferValue T>
+        BufferReader& read_array(std::span<T> values, const std::source_location& location = std::source_location::current()) {
+            if constexpr (std::is_same_v<T, bool>) {
+                const uint8_t* src = take(values.size(), location);
+                for (size_t i = 0; i < values.size(); ++i) {
+                    values[i] = src[i] != 0;
+                }
+            } else if (!values.empty()) {
+                std::memcpy(values.data(), take(values.size_bytes(), location), values.size_bytes());
+            }
+            if constexpr (detail::is_byte_ordered_v<T>) {
+                if (m_order != std::endian::native) {
+                    for (T& value : values) {
+                        value = detail::byteswap_value(value);
+                    }
+                }
+            }
+            return *this;
+        }
+
+        /// @brief count 個の値を values に読み出す（values の容量を再利用する）
+        template<detail::BufferValue T>
+        BufferReader& read_array(std::vector<T>& values, size_t count,
+                                 const std::source_location& location = std::source_location::current()) {
+            if (count > remaining() / sizeof(T)) {
+                detail::throw_buffer_range(m_pos, count * sizeof(T), m_size, location);
+            }
+            values.resize(count);
+            return read_array(std::span<T>(values), location);
+        }
+
+        /// @brief index バイト目の値を読み出す（読み出し位置は変わらない）
+        template<detail::BufferValue T>
+        [[nodiscard]] T read_at(size_t index, const std::source_location& location = std::source_location::current()) const {
+            if (index > m_size || sizeof(T) > m_size - index) {
+                detail::throw_buffer_range(index, sizeof(T), m_size, location);
+            }
+            return load<T>(m_data + index);
+        }
+
+        /// @brief count バイトをコピーせずに参照する（元のバッファが有効な間だけ使える）
+        [[nodiscard]] std::span<const uint8_t> read_bytes(size_t count,
+                                                          const std::source_location& location = std::source_location::current()) {
+            return std::span<const uint8_t>(take(count, location), count);
+        }
+
+        /// @brief length バイトを文字列としてコピーせずに参照する
+        [[nodiscard]] std::string_view read_string(size_t length,
+                                                   const std::source_location& location = std::source_location::current()) {
+            return std::string_view(reinterpret_cast<const char*>(take(length, location)), length);
+        }
+
+        /// @brief 符号なしの可変長整数（ULEB128）を読み出す
+        [[nodiscard]] uint64_t read_varint(const std::source_location& location = std::source_location::current()) {
+            size_t pos = m_pos;
+            uint64_t value = 0;
+            for (unsigned shift = 0;; shift += 7) {
+                if (pos >= m_size) {
+                    detail::throw_buffer_range(m_pos, pos - m_pos + 1, m_size, location);
+                }
+                const uint8_t byte = m_data[pos++];
+                // 10 バイト目は最下位ビットだけが使える
+                if (shift == 63 && byte > 1) {
+                    detail::throw_varint_overflow(m_pos, location);
+                }
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) {
+                    m_pos = pos;
+                    return value;
+                }
+            }
+        }
+
+        /// @brief 符号付きの可変長整数（SLEB128）を読み出す
+        [[nodiscard]] int64_t read_svarint(const std::source_location& location = std::source_location::current()) {
+            size_t pos = m_pos;
+            uint64_t value = 0;
+            unsigned shift = 0;
+            uint8_t byte = 0;
+            do {
+                if (pos >= m_size) {
+                    detail::throw_buffer_range(m_pos, pos - m_pos + 1, m_size, location);
+                }
+                byte = m_data[pos++];
+                // 10 バイト目は符号の拡張（0x00 か 0x7F）だけが使える
+                if (shift == 63 && byte != 0x00 && byte != 0x7F) {
+                    detail::throw_varint_overflow(m_pos, location);
+                }
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            if (shift < 64 && (byte & 0x40) != 0) {
+                value |= ~uint64_t{ 0 } << shift;
+            }
+            m_pos = pos;
+            return static_cast<int64_t>(value);
+        }
+
+        /// @brief 読み出し位置を移動（size() まで）
+        BufferReader& seek(size_t position, const std::source_location& location = std::source_location::current()) {
+            if (position > m_size) {
+                detail::throw_buffer_range(position, 0, m_size, location);
+            }
+            m_pos = position;
+            return *this;
+        }
+
+        /// @brief count バイト読み飛ばす
+        BufferReader& skip(size_t count, const std::source_location& location = std::source_location::current()) {
+            (void)take(count, location);
+            return *this;
+        }
+
+        /// @brief 現在の読み出し位置（先頭からのバイトオフセット）
+        [[nodiscard]] size_t position() const noexcept { return m_pos; }
+
+        /// @brief 全体のバイト数
+        [[nodiscard]] size_t size() const noexcept { return m_size; }
+
+        /// @brief 残りのバイト数
+        [[nodiscard]] size_t remaining() const noexcept { return m_size - m_pos; }
+
+        /// @brief 終端に達したか
+        [[nodiscard]] bool eof() const noexcept { return m_pos >= m_size; }
+
+        /// @brief 整数・浮動小数点数のバイト順
+        [[nodiscard]] std::endian order() const noexcept { return m_order; }
+    };
+
+    /// @brief バイト配列に値を順に書き込むカーソル（bsave する内容の組み立て用）
+    /// @details 書き込み位置は dest の末尾から始まり、末尾を越える書き込みでは dest を広げる。
+    ///          seek で戻って書き込んだ部分は上書きする（先頭のヘッダーに後から大きさを書く場合など）。
+    ///          値の表現は BufferReader と同じ。dest は BufferWriter より長く生存している必要がある
+    class BufferWriter {
+    private:
+        std::vector<uint8_t>* m_dest = nullptr;
+        size_t m_pos = 0;
+        std::endian m_order = std::endian::little;
+
+        // count バイトを書き込む位置を返し、書き込み位置を進める
+        uint8_t* place(size_t count) {
+            if (count > m_dest->size() - m_pos) {
+                m_dest->resize(m_pos + count);
+            }
+            uint8_t* p = m_dest->data() + m_pos;
+            m_pos += count;
+            return p;
+        }
+
+        template<typename T>
+        [[nodiscard]] T toOrder(T value) const noexcept {
+            if constexpr (detail::is_byte_ordered_v<T>) {
+                if (m_order != std::endian::native) {
+                    return detail::byteswap_value(value);
+                }
+            }
+            return value;
+        }
+
+    public:
+        /// @brief dest の末尾に書き込む
+        explicit BufferWriter(std::vector<uint8_t>& dest, std::endian order = std::endian::little) noexcept
+            : m_dest(&dest), m_pos(dest.size()), m_order(order) {}
+
+        /// @brief 一時オブジェクトへの書き込みは禁止
+        explicit BufferWriter(std::vector<uint8_t>&&, std::endian = std::endian::little) = delete;
+
+        /// @brief 値を1つ書き込む
+        template<detail::BufferValue T>
+        BufferWriter& write(const T& value) {
+            const T ordered = toOrder(value);
+            std::memcpy(place(sizeof(T)), &ordered, sizeof(T));
+            return *this;
+        }
+
+        /// @brief values をまとめて書き込む
+        template<detail::BufferValue T>
+        BufferWriter& write_array(std::span<const T> values) {
+            uint8_t* dest = place(values.size_bytes());
+            if constexpr (detail::is_byte_ordered_v<T>) {
+                if (m_order != std::endian::native) {
+                    for (const T& value : values) {
+                        const T ordered = detail::byteswap_value(value);
+                        std::memcpy(dest, &ordered, sizeof(T));
+                        dest += sizeof(T);
+                    }
+                    return *this;
+                }
+            }
+            if (!values.empty()) {
+                std::memcpy(dest, values.data(), values.size_bytes());
+            }
+            return *this;
+        }
+
+        template<detail::BufferValue T>
+        BufferWriter& write_array(const std::vector<T>& values) {
+            return write_array(std::span<const T>(values));
+        }
+
+        /// @brief バイト列をそのまま書き込む
+        BufferWriter& write_bytes(std::span<const uint8_t> bytes) {
+            if (!bytes.empty()) {
+                std::memcpy(place(bytes.size()), bytes.data(), bytes.size());
+            }
+            return *this;
+        }
+
+        /// @brief 文字列の内容を書き込む（長さ・終端の 0 は書き込まない）
+        BufferWriter& write_string(std::string_view text) {
+            return write_bytes(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(text.data()), text.size()));
+        }
+
+        /// @brief 符号なしの可変長整数（ULEB128、1〜10 バイト）を書き込む
+        BufferWriter& write_varint(uint64_t value) {
+            uint8_t bytes[10];
+            size_t count = 0;
+            while (value >= 0x80) {
+                bytes[count++] = static_cast<uint8_t>(value | 0x80);
+                value >>= 7;
+            }
+            bytes[count++] = static_cast<uint8_t>(value);
+            std::memcpy(place(count), bytes, count);
+            return *this;
+        }
+
+        /// @brief 符号付きの可変長整数（SLEB128、1〜10 バイト）を書き込む
+        BufferWriter& write_svarint(int64_t value) {
+            uint8_t bytes[10];
+            size_t count = 0;
+            for (;;) {
+                const uint8_t byte = static_cast<uint8_t>(value & 0x7F);
+                value >>= 7;    // 算術シフト（符号を保つ）
+                if ((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0)) {
+                    bytes[count++] = byte;
+                    break;
+                }
+                bytes[count++] = static_cast<uint8_t>(byte | 0x80);
+            }
+            std::memcpy(place(count), bytes, count);
+            return *this;
+        }
+
+        /// @brief index バイト目の値を上書きする（書き込み位置は変わらない。size() を越える場合は ERR_BUFFER_OVERFLOW）
+        template<detail::BufferValue T>
+        BufferWriter& write_at(size_t index, const T& value,
+                               const std::source_location& location = std::source_location::current()) {
+            if (index > m_dest->size() || sizeof(T) > m_dest->size() - index) {
+                detail::throw_buffer_range(index, sizeof(T), m_dest->size(), location);
+            }
+            const T ordered = toOrder(value);
+            std::memcpy(m_dest->data() + index, &ordered, sizeof(T));
+            return *this;
+        }
+
+        /// @brief 書き込み位置を移動（size() まで）
+        BufferWriter& seek(size_t position, const std::source_location& location = std::source_location::current()) {
+            if (position > m_dest->size()) {
+                detail::throw_buffer_range(position, 0, m_dest->size(), location);
+            }
+            m_pos = position;
+            return *this;
+        }
+
+        /// @brief 現在の書き込み位置（先頭からのバイトオフセット）
+        [[nodiscard]] size_t position() const noexcept { return m_pos; }
+
+        /// @brief dest のバイト数
+        [[nodiscard]] size_t size() const noexcept { return m_dest->size(); }
+
+        /// @brief 整数・浮動小数点数のバイト順
+        [[nodiscard]] std::endian order() const noexcept { return m_order; }
+    };
+
+    // ============================================================
+    // メモリマップ
+    // ============================================================
+
+    /// @brief 読み取り専用でメモリマップしたファイルの範囲（bmap の戻り値）
+    /// @details バッファへのコピーやゼロ埋めをせずに、ファイルの内容をその場で参照する。
+    ///          破棄されるとマップを解除する。コピーした場合はマップを共有する
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = default;
+        MappedFile& operator=(const MappedFile&) = default;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        /// @brief ファイルの offset バイト目から size バイトをマップする（bmap と同じ）
+        [[nodiscard]] static MappedFile open(const std::string& filename, OptInt64 offset = {}, OptInt64 size = {},
+                                             const std::source_location& location = std::source_location::current());
+
+        /// @brief マップした範囲のバイト列
+        [[nodiscard]] std::span<const uint8_t> data() const noexcept { return m_data; }
+        /// @brief マップした範囲を文字列として参照
+        [[nodiscard]] std::string_view view() const noexcept {
+            return { reinterpret_cast<const char*>(m_data.data()), m_data.size() };
+        }
+        [[nodiscard]] size_t size() const noexcept { return m_data.size(); }
+        [[nodiscard]] bool empty() const noexcept { return m_data.empty(); }
+        /// @brief 範囲の先頭のファイル内の位置
+        [[nodiscard]] int64_t offset() const noexcept { return m_offset; }
+        /// @brief ファイル全体のサイズ
+        [[nodiscard]] int64_t file_size() const noexcept { return m_fileSize; }
+
+        [[nodiscard]] const uint8_t* begin() const noexcept { return m_data.data(); }
+        [[nodiscard]] const uint8_t* end() const noexcept { return m_data.data() + m_data.size(); }
+        [[nodiscard]] uint8_t operator[](size_t index) const noexcept { return m_data[index]; }
+
+        /// @brief マップを解除する（他のコピーが残っている間は解除されない）
+        void close() noexcept;
+
+    private:
+        std::shared_ptr<void> m_mapping;    // ビューの所有（破棄時に解除）
+        std::span<const uint8_t> m_data;
+        int64_t m_offset = 0;
+        int64_t m_fileSize = 0;
+    };
+
+    /// @brief ファイルを読み取り専用でメモリマップする
+    /// @param offset 先頭のオフセット（省略時は 0）
+    /// @param size マップするバイト数（省略時はファイル末尾まで。末尾を超える分は切り詰める）
+    [[nodiscard]] MappedFile bmap(const std::string& filename, OptInt64 offset = {}, OptInt64 size = {},
+                                  const std::source_location& location = std::source_location::current());
+
+    // ============================================================
+    // 非同期ファイル操作
+    // ============================================================
+
+    // FileRequest::stat の戻り値
+    inline constexpr int fileio_none    = 0;    ///< 要求なし（既定構築のハンドル）
+    inline constexpr int fileio_pending = 1;    ///< 実行待ち・実行中
+    inline constexpr int fileio_done    = 2;    ///< 完了
+    inline constexpr int fileio_error   = 3;    ///< 失敗
+
+    class FileRequest;
+
+    /// @brief 非同期ファイル操作の完了時に呼ばれる関数
+    /// @details 成功・失敗のどちらでも、メインスレッドの割り込み処理（await / vwait / stop / wait 中）で呼ばれる
+    using FileCallback = std::function<void(FileRequest&)>;
+
+    /// @brief bload_async / bsave_async / bcopy_async の要求ハンドル
+    /// @details 読み書きは入出力用の作業スレッドで行う。コピーは同じ要求を参照する。
+    ///          ハンドルを破棄しても操作は中断されない
+    class FileRequest {
+    public:
+        FileRequest() = default;
+
+        /// @brief ファイルを非同期に読み込む（bload_async と同じ）
+        [[nodiscard]] static FileRequest load(const std::string& filename, OptInt64 size = {}, OptInt64 offset = {},
+                                              FileCallback callback = nullptr,
+                                              const std::source_location& location = std::source_location::current());
+
+        /// @brief バッファを非同期にファイルへ保存する（bsave_async と同じ）
+        [[nodiscard]] static FileRequest save(const std::string& filename, std::vector<uint8_t> buffer,
+                                              OptInt64 size = {}, OptInt64 offset = {},
+                                              FileCallback callback = nullptr,
+                                              const std::source_location& location = std::source_location::current());
+
+        /// @brief ファイルを非同期にコピーする（bcopy_async と同じ）
+        [[nodiscard]] static FileRequest copy(const std::string& src, const std::string& dest,
+                                              FileCallback callback = nullptr, FileCallback progress = nullptr,
+                                              const CopyParams& params = {},
+                                              const std::source_location& location = std::source_location::current());
+
+        /// @brief 状態を取得（fileio_none / fileio_pending / fileio_done / fileio_error）
+        [[nodiscard]] int stat() const noexcept;
+
+        /// @brief 完了または失敗したか
+        [[nodiscard]] bool ready() const noexcept;
+
+        /// @brief 完了まで待つ（待機中もメッセージと割り込みを処理する）
+        /// @return 読み書きしたバイト数。失敗した場合は操作のエラーを送出する
+        int64_t wait(const std::source_location& location = std::source_location::current());
+
+        /// @brief 読み書きしたバイト数（完了前は 0）
+        [[nodiscard]] int64_t size() const noexcept;
+
+        /// @brief 読み込んだ内容（load の完了後のみ有効）
+        [[nodiscard]] std::span<const uint8_t> data() const noexcept;
+
+        /// @brief 読み込んだ内容を文字列として参照
+        [[nodiscard]] std::string_view view() const noexcept;
+
+        /// @brief 読み込んだ内容を取り出す（以降 data() は空になる）
+        [[nodiscard]] std::vector<uint8_t> take() noexcept;
+
+        /// @brief 失敗時のエラーコード（成功時は 0）
+        [[nodiscard]] int error_code() const noexcept;
+
+        /// @brief 失敗時のエラーメッセージ
+        [[nodiscard]] std::string error_message() const;
+
+        /// @brief 対象のファイル名
+        [[nodiscard]] std::string filename() const;
+
+        /// @brief 要求から完了までの時間（ミリ秒、完了前は 0）
+        [[nodiscard]] double latency_ms() const noexcept;
+
+        /// @brief これまでに処理したバイト数（コピーは途中経過、読み書きは完了時に size() と同じ値）
+        [[nodiscard]] int64_t processed() const noexcept;
+
+        /// @brief 処理する全体のバイト数（コピーは開始後、読み書きは完了後に分かる。それまでは 0）
+        [[nodiscard]] int64_t total() const noexcept;
+
+        /// @brief 中止を要求する（実行前の要求とコピーの途中で有効。中止した要求は ERR_FILE_IO で失敗する）
+        void cancel() noexcept;
+
+    private:
+        class State;
+        std::shared_ptr<State> m_state;
+    };
+
+    /// @brief ファイルを非同期に読み込む
+    /// @param size 読み込むバイト数（省略時はファイル末尾まで）
+    /// @param offset 読み込み開始位置（省略時は 0）
+    /// @param callback 完了時に呼ぶ関数（省略可）
+    [[nodiscard]] FileRequest bload_async(const std::string& filename, OptInt64 size = {}, OptInt64 offset = {},
+                                          FileCallback callback = nullptr,
+                                          const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファを非同期にファイルへ保存する（vector版、内容はムーブまたはコピーして保持する）
+    FileRequest bsave_async(const std::string& filename, std::vector<uint8_t> buffer, OptInt64 size = {}, OptInt64 offset = {},
+                            FileCallback callback = nullptr,
+                            const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファを非同期にファイルへ保存する（文字列版、内容はコピーして保持する）
+    FileRequest bsave_async(const std::string& filename, std::string_view buffer, OptInt64 size = {}, OptInt64 offset = {},
+                            FileCallback callback = nullptr,
+                            const std::source_location& location = std::source_location::current());
+
+    /// @brief ファイルを非同期にコピーする（コピー先は置き換える）
+    /// @param callback 完了時に呼ぶ関数（省略可）
+    /// @param progress chunk_size ごとに進捗を通知する関数（省略可、メインスレッドの割り込み処理で呼ばれる）
+    FileRequest bcopy_async(const std::string& src, const std::string& dest,
+                            FileCallback callback = nullptr, FileCallback progress = nullptr,
+                            const CopyParams& params = {},
+                            const std::source_location& location = std::source_location::current());
+
+    /// @brief 非同期ファイル操作のキューの統計
+    struct FileIoStats {
+        int64_t submitted = 0;              ///< 投入した要求の数
+        int64_t completed = 0;              ///< 終了した要求の数（失敗を含む）
+        int pending = 0;                    ///< 未完了の要求の数（キューの深さ）
+        int peak_pending = 0;               ///< pending の最大値
+        int threads = 0;                    ///< 作業スレッドの数
+        double average_wait_ms = 0.0;       ///< 投入から実行開始までの平均時間
+        double max_wait_ms = 0.0;           ///< 投入から実行開始までの最大時間
+        double average_latency_ms = 0.0;    ///< 投入から完了までの平均時間
+        double max_latency_ms = 0.0;        ///< 投入から完了までの最大時間
+    };
+
+    /// @brief 非同期ファイル操作のキューの統計を取得
+    [[nodiscard]] FileIoStats fileio_stats();
+
+    /// @brief 非同期ファイル操作のキューの統計をリセット（未完了の数は保持）
+    void fileio_reset_stats();
+
+    // ============================================================
+    // パックファイル
+    // ============================================================
+
+    /// @brief ディレクトリ以下のファイルをまとめたパックファイルを作成する
+    /// @param archive 作成するパックファイル（既存のファイルは置き換える）
+    /// @param directory まとめるディレクトリ（サブディレクトリを含む。名前はこのディレクトリからの相対パス）
+    /// @return 格納したファイル数
+    int packbuild(const std::string& archive, const std::string& directory, const PackParams& params = {},
+                  const std::source_location& location = std::source_location::current());
+
+    /// @brief パックファイルを登録し、中のファイルを "pack://名前" で読めるようにする
+    /// @details bload / bmap / exist / noteload / celload / mmload などのファイル名に指定できる。
+    ///          同じ名前が複数のパックにある場合は、後から登録したパックを優先する
+    void packopen(const std::string& archive,
+                  const std::source_location& location = std::source_location::current());
+
+    /// @brief パックファイルの登録を解除する（省略時はすべて）
+    /// @details 読み込み済みの MappedFile などが参照している間は、パックファイルのマップは残る
+    void packclose(const std::string& archive = {},
+                   const std::source_location& location = std::source_location::current());
+
+    // ============================================================
+    // ファイルの変更監視
+    // ============================================================
+
+    // FileChange::action
+    inline constexpr int filechange_added    = 1;   ///< 作成された（名前の変更・移動で現れた場合を含む）
+    inline constexpr int filechange_modified = 2;   ///< 内容が変更された（削除して作り直した場合を含む）
+    inline constexpr int filechange_removed  = 3;   ///< 削除された（名前の変更・移動で消えた場合を含む）
+    inline constexpr int filechange_overflow = 4;   ///< 変更が多すぎて取りこぼした（path は空。すべてを調べ直すこと）
+
+    /// @brief filewatch が通知する変更
+    struct FileChange {
+        std::string path;           ///< 監視するディレクトリからの相対パス（区切りは '/'）
+        int action = 0;             ///< filechange_added 等
+    };
+
+    /// @brief まとめた変更を受け取る関数
+    /// @details メインスレッドの割り込み処理（await / vwait / stop / wait 中）で呼ばれる
+    using FileWatchCallback = std::function<void(std::span<const FileChange>)>;
+
+    /// @brief filewatch の監視ハンドル
+    /// @details 監視は専用のスレッドで行う。コピーは同じ監視を参照し、最後のハンドルを破棄すると監視を止める
+    class FileWatch {
+    public:
+        FileWatch() = default;
+
+        /// @brief ディレクトリの監視を始める（filewatch と同じ）
+        [[nodiscard]] static FileWatch open(const std::string& directory, FileWatchCallback callback = nullptr,
+                                            const WatchParams& params = {},
+                                            const std::source_location& location = std::source_location::current());
+
+        /// @brief 監視を止める（配送待ちの変更は捨てる）
+        void close() noexcept;
+
+        /// @brief 監視中か
+        /// @details 監視するディレクトリが削除された等で監視を続けられなくなった場合も false
+        [[nodiscard]] bool active() const noexcept;
+
+        /// @brief 監視するディレクトリ
+        [[nodiscard]] std::string directory() const;
+
+        /// @brief これまでに通知した変更の数
+        [[nodiscard]] int64_t change_count() const noexcept;
+
+        /// @brief これまでに読み直した素材の数（cel・mmload の WAV のバッファ単位。次の mmplay で開き直す形式は含まない）
+        [[nodiscard]] int64_t reload_count() const noexcept;
+
+    private:
+        class State;
+        std::shared_ptr<State> m_state;
+    };
+
+    /// @brief ディレクトリの変更を監視する
+    /// @details 保存1回で届く複数の通知は debounce_ms の間まとめてから、callback に1回で渡す。
+    ///          params.reload の場合は、変更されたファイルから読み込んだ素材を入出力用の作業スレッドで読み直し、
+    ///          割り込み処理で差し替える（描画のループを止めない）
+    /// @param directory 監視するディレクトリ
+    /// @param callback 変更を受け取る関数（省略可。素材の読み直しだけを行う場合）
+    [[nodiscard]] FileWatch filewatch(const std::string& directory, FileWatchCallback callback = nullptr,
+                                      const WatchParams& params = {},
+                                      const std::source_location& location = std::source_location::current());
+
+    // ============================================================
+    // 圧縮
+    // ============================================================
+
+    /// @brief データを少しずつ LZ4 フレーム形式に圧縮する
+    /// @details 書き込んだデータを block_size ごとに圧縮して出力先に追記する。
+    ///          出力は lz4 コマンドなどが読み書きする LZ4 フレーム形式と互換。コピーは禁止（ムーブは可）
+    class Compressor {
+    public:
+        /// @brief 空の Compressor（open するまで書き込めない）
+        Compressor() noexcept;
+
+        /// @brief output の末尾に追記する（finish まで output を破棄しないこと）
+        explicit Compressor(std::vector<uint8_t>& output, const CompressParams& params = {},
+                            const std::source_location& location = std::source_location::current());
+
+        /// @brief 一時オブジェクトへの追記は禁止（ダングリング防止）
+        explicit Compressor(std::vector<uint8_t>&&, const CompressParams& = {},
+                            const std::source_location& = std::source_location::current()) = delete;
+
+        /// @brief finish していない場合は finish する（失敗は無視する）
+        ~Compressor();
+
+        Compressor(const Compressor&) = delete;
+        Compressor& operator=(const Compressor&) = delete;
+        Compressor(Compressor&& other) noexcept;
+        Compressor& operator=(Compressor&& other) noexcept;
+
+        /// @brief ファイルに書き出す（既存のファイルは置き換える）
+        Compressor& open(const std::string& filename, const CompressParams& params = {},
+                         const std::source_location& location = std::source_location::current());
+
+        /// @brief データを追加する（ブロック単位にたまるたびに圧縮して書き出す）
+        void write(std::span<const uint8_t> data, const std::source_location& location = std::source_location::current());
+
+        /// @brief 文字列を追加する
+        void write(std::string_view data, const std::source_location& location = std::source_location::current());
+
+        /// @brief 残りを圧縮してフレームを閉じる（ファイルの場合はファイルも閉じる）
+        void finish(const std::source_location& location = std::source_location::current());
+
+        /// @brief 書き込める状態か（finish の前か）
+        [[nodiscard]] bool is_open() const noexcept;
+
+        /// @brief これまでに書き込んだ（圧縮前の）バイト数
+        [[nodiscard]] int64_t bytes_in() const noexcept;
+
+        /// @brief これまでに出力した（圧縮後の）バイト数
+        [[nodiscard]] int64_t bytes_out() const noexcept;
+
+    private:
+        class State;
+        std::unique_ptr<State> m_state;
+    };
+
+    /// @brief LZ4 フレーム形式のデータを少しずつ展開する
+    /// @details 前のブロックに依存するブロック・ブロックのチェックサム・連結したフレームにも対応する。
+    ///          チェックサムが一致しない・壊れている場合は ERR_FILE_IO。コピーは禁止（ムーブは可）
+    class Decompressor {
+    public:
+        /// @brief 空の Decompressor（open するまで読めない）
+        Decompressor() noexcept;
+
+        /// @brief メモリ上の圧縮データを参照する（読み終えるまで input を破棄しないこと）
+        explicit Decompressor(std::span<const uint8_t> input);
+
+        /// @brief バイト配列を参照する
+        explicit Decompressor(const std::vector<uint8_t>& input)
+            : Decompressor(std::span<const uint8_t>(input)) {}
+
+        /// @brief 一時オブジェクトの参照は禁止（ダングリング防止）
+        explicit Decompressor(std::vector<uint8_t>&&) = delete;
+
+        ~Decompressor();
+
+        Decompressor(const Decompressor&) = delete;
+        Decompressor& operator=(const Decompressor&) = delete;
+        Decompressor(Decompressor&& other) noexcept;
+        Decompressor& operator=(Decompressor&& other) noexcept;
+
+        /// @brief ファイルを開いて少しずつ読み進める（pack:// も可）
+        Decompressor& open(const std::string& filename, const std::source_location& location = std::source_location::current());
+
+        /// @brief 展開した内容を dest に最大 dest.size() バイト読み出す
+        /// @return 読み出したバイト数（終端では 0）
+        size_t read(std::span<uint8_t> dest, const std::source_location& location = std::source_location::current());
+
+        /// @brief 展開した次の範囲をコピーせずに参照する（次の読み出しまで有効）
+        /// @return 終端に達していた場合 false
+        bool next(std::span<const uint8_t>& data, const std::source_location& location = std::source_location::current());
+
+        /// @brief 残りをすべて展開して output の末尾に追記する
+        /// @return 追記したバイト数
+        int64_t read_all(std::vector<uint8_t>& output, const std::source_location& location = std::source_location::current());
+
+        /// @brief 残りをすべて展開して文字列の末尾に追記する
+        int64_t read_all(std::string& output, const std::source_location& location = std::source_location::current());
+
+        /// @brief 終端に達したか
+        [[nodiscard]] bool eof() const noexcept;
+
+        /// @brief これまでに読んだ（圧縮後の）バイト数
+        [[nodiscard]] int64_t bytes_in() const noexcept;
+
+        /// @brief これまでに読み出した（展開後の）バイト数
+        [[nodiscard]] int64_t bytes_out() const noexcept;
+
+    private:
+        class State;
+        std::unique_ptr<State> m_state;
+    };
+
+    /// @brief data を LZ4 フレーム形式に圧縮する
+    [[nodiscard]] std::vector<uint8_t> compress(std::span<const uint8_t> data, const CompressParams& params = {},
+                                                const std::source_location& location = std::source_location::current());
+
+    /// @brief LZ4 フレーム形式のデータを展開する
+    [[nodiscard]] std::vector<uint8_t> decompress(std::span<const uint8_t> data,
+                                                  const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファを圧縮してファイルに保存する（vector版）
+    /// @param save 保存方法（bsave と同じ）
+    /// @return 書き込んだ（圧縮後の）バイト数
+    int64_t bsave_compressed(const std::string& filename, const std::vector<uint8_t>& buffer, const CompressParams& params = {},
+                             const SaveParams& save = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief バッファを圧縮してファイルに保存する（string版）
+    int64_t bsave_compressed(const std::string& filename, std::string_view buffer, const CompressParams& params = {},
+                             const SaveParams& save = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 圧縮したファイルを展開してバッファに読み込む（vector版、内容を置き換える）
+    /// @return 展開後のバイト数
+    int64_t bload_compressed(const std::string& filename, std::vector<uint8_t>& buffer,
+                             const std::source_location& location = std::source_location::current());
+
+    /// @brief 圧縮したファイルを展開してバッファに読み込む（string版、内容を置き換える）
+    int64_t bload_compressed(const std::string& filename, std::string& buffer,
+                             const std::source_location& location = std::source_location::current());
+
     // ============================================================
     // ダイアログ命令
     // ============================================================
@@ -11,11 +11,18 @@ export module hsppp:math;
 
 import :types;
 
+import <bit>;
 import <cmath>;
+import <cstdint>;
 import <numbers>;
 import <source_location>;
 import <vector>;
+import <span>;
 import <string>;
+import <string_view>;
+import <type_traits>;
+import <utility>;
+import <tuple>;
 
 export namespace hsppp {
 
@@ -114,15 +121,221 @@ export namespace hsppp {
     // 乱数
     // ============================================================
 
+    /// @brief 乱数生成器の保存用の状態（32 バイト、トリビアルコピー可能）
+    /// @details そのままバイナリとして保存・送信できる（エンディアンはマシン依存）
+    struct RandomState {
+        uint64_t words[4] = {};
+
+        [[nodiscard]] friend constexpr bool operator==(const RandomState&, const RandomState&) noexcept = default;
+    };
+
+    /// @brief xoshiro256** 乱数生成器（状態 32 バイト）
+    /// @details std::uniform_random_bit_generator を満たすため <random> の分布と組み合わせられる。
+    ///          jump() / split() でスレッドごとに重ならない乱数列を作れる
+    class Xoshiro256 {
+    public:
+        using result_type = uint64_t;
+
+        [[nodiscard]] static constexpr result_type min() noexcept { return 0; }
+        [[nodiscard]] static constexpr result_type max() noexcept { return UINT64_MAX; }
+
+        /// @param seed シード（splitmix64 で 256 ビットの状態に展開）
+        constexpr explicit Xoshiro256(uint64_t seed = 0) noexcept { this->seed(seed); }
+
+        constexpr void seed(uint64_t seed) noexcept {
+            for (uint64_t& word : m_state) {
+                seed += 0x9E3779B97F4A7C15ull;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                word = z ^ (z >> 31);
+            }
+        }
+
+        constexpr result_type operator()() noexcept {
+            const uint64_t result = std::rotl(m_state[1] * 5, 7) * 9;
+            const uint64_t t = m_state[1] << 17;
+            m_state[2] ^= m_state[0];
+            m_state[3] ^= m_state[1];
+            m_state[1] ^= m_state[2];
+            m_state[0] ^= m_state[3];
+            m_state[2] ^= t;
+            m_state[3] = std::rotl(m_state[3], 45);
+            return result;
+        }
+
+        /// @brief 0 以上 range 未満の一様な整数（Lemire の方法、偏りなし・除算はほぼ不要）
+        constexpr uint32_t bounded(uint32_t range) noexcept {
+            uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * range;
+            uint32_t low = static_cast<uint32_t>(m);
+            if (low < range) {
+                const uint32_t threshold = (0u - range) % range;
+                while (low < threshold) {
+                    m = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * range;
+                    low = static_cast<uint32_t>(m);
+                }
+            }
+            return static_cast<uint32_t>(m >> 32);
+        }
+
+        /// @brief [0.0, 1.0) の一様な実数（53 ビット精度）
+        constexpr double uniform() noexcept {
+            return static_cast<double>((*this)() >> 11) * 0x1.0p-53;
+        }
+
+        /// @brief 2^128 回分進める（2^128 個の重ならない乱数列を作れる）
+        constexpr void jump() noexcept {
+            constexpr uint64_t kJump[] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+            jumpBy(kJump);
+        }
+
+        /// @brief 2^192 回分進める（jump() で分けた乱数列をさらに分ける上位の単位）
+        constexpr void long_jump() noexcept {
+            constexpr uint64_t kLongJump[] = { 0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull };
+            jumpBy(kLongJump);
+        }
+
+        /// @brief 現在の乱数列を子として返し、自身は jump() で先へ進める
+        [[nodiscard]] constexpr Xoshiro256 split() noexcept {
+            Xoshiro256 child = *this;
+            jump();
+            return child;
+        }
+
+        /// @brief 現在の状態を取得
+        [[nodiscard]] constexpr RandomState state() const noexcept {
+            return RandomState{ { m_state[0], m_state[1], m_state[2], m_state[3] } };
+        }
+
+        /// @brief 状態を復元（すべて 0 の状態は生成器として無効なため seed(0) と同じにする）
+        constexpr void set_state(const RandomState& state) noexcept {
+            if ((state.words[0] | state.words[1] | state.words[2] | state.words[3]) == 0) {
+                seed(0);
+                return;
+            }
+            for (int i = 0; i < 4; ++i) {
+                m_state[i] = state.words[i];
+            }
+        }
+
+        [[nodiscard]] friend constexpr bool operator==(const Xoshiro256&, const Xoshiro256&) noexcept = default;
+
+    private:
+        constexpr void jumpBy(const uint64_t (&polynomial)[4]) noexcept {
+            uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (uint64_t word : polynomial) {
+                for (int b = 0; b < 64; ++b) {
+                    if (word & (uint64_t{ 1 } << b)) {
+                        s0 ^= m_state[0];
+                        s1 ^= m_state[1];
+                        s2 ^= m_state[2];
+                        s3 ^= m_state[3];
+                    }
+                    (*this)();
+                }
+            }
+            m_state[0] = s0;
+            m_state[1] = s1;
+            m_state[2] = s2;
+            m_state[3] = s3;
+        }
+
+        uint64_t m_state[4] = {};
+    };
+
+    /// @brief 独立した乱数列（ゲームロジック・パーティクル・AI など用途ごとに持つ）
+    /// @details rnd / randomize のグローバルな状態とは独立しており、他のコードの rnd 呼び出しの影響を受けない。
+    ///          save() / restore() は 32 バイトのコピーのみで、毎フレームのスナップショットに使える
+    class RandomStream {
+    public:
+        /// @param seed シード（同じシードの randomize 後の rnd と同じ乱数列になる）
+        constexpr explicit RandomStream(uint64_t seed = 0) noexcept : m_engine(seed) {}
+
+        /// @brief 名前とシードから乱数列を作る（同じシードからでも名前ごとに別の乱数列になる）
+        constexpr RandomStream(std::string_view name, uint64_t seed) noexcept : m_engine(seed ^ nameHash(name)) {}
+
+        /// @brief 保存した状態から乱数列を再開
+        constexpr explicit RandomStream(const RandomState& state) noexcept { m_engine.set_state(state); }
+
+        constexpr void seed(uint64_t seed) noexcept { m_engine.seed(seed); }
+
+        /// @brief 0 から (range-1) までの乱数（rnd と同じ。range が 0 以下なら 0）
+        constexpr int rnd(int range) noexcept {
+            return range <= 0 ? 0 : static_cast<int>(m_engine.bounded(static_cast<uint32_t>(range)));
+        }
+
+        /// @brief [0.0, 1.0) の一様な実数
+        constexpr double rndf() noexcept { return m_engine.uniform(); }
+
+        /// @brief 配列を乱数で埋める（rnd(range) を要素数だけ呼んだ場合と同じ値）
+        constexpr void fill(std::span<int> dest, int range) noexcept {
+            for (int& v : dest) {
+                v = rnd(range);
+            }
+        }
+
+        /// @brief 配列を [0.0, 1.0) の一様な実数で埋める
+        constexpr void fill(std::span<double> dest) noexcept {
+            for (double& v : dest) {
+                v = m_engine.uniform();
+            }
+        }
+
+        /// @brief 現在の状態を保存（メモリ確保なし）
+        [[nodiscard]] constexpr RandomState save() const noexcept { return m_engine.state(); }
+
+        /// @brief 保存した状態に戻す（メモリ確保なし）
+        constexpr void restore(const RandomState& state) noexcept { m_engine.set_state(state); }
+
+        /// @brief 重ならない子の乱数列を作る（自身は 2^128 回分先へ進む）
+        [[nodiscard]] constexpr RandomStream split() noexcept { return RandomStream(m_engine.split()); }
+
+        /// @brief 内部の生成器（<random> の分布と組み合わせる場合）
+        [[nodiscard]] constexpr Xoshiro256& engine() noexcept { return m_engine; }
+
+        [[nodiscard]] friend constexpr bool operator==(const RandomStream&, const RandomStream&) noexcept = default;
+
+    private:
+        constexpr explicit RandomStream(const Xoshiro256& engine) noexcept : m_engine(engine) {}
+
+        // FNV-1a（64ビット）
+        static constexpr uint64_t nameHash(std::string_view name) noexcept {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for (char c : name) {
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ull;
+            }
+            return hash;
+        }
+
+        Xoshiro256 m_engine;
+    };
+
+    // rnd の生成方式（rndmode の引数）
+    inline constexpr int rndmode_fast = 0;   // xoshiro256**（既定）
+    inline constexpr int rndmode_hsp  = 1;   // HSP互換（C ランタイム rand() と同じ線形合同法、rand() % p1）
+
     /// @brief 乱数を発生
     /// @param p1 乱数の範囲（1〜32768）
     /// @return 0から(p1-1)までの乱数
     [[nodiscard]] int rnd(int p1);
 
+    /// @brief 配列を乱数で埋める（rnd(range) を要素数だけ呼んだ場合と同じ値）
+    /// @param dest 格納先
+    /// @param range 乱数の範囲（0以下の場合は 0 で埋める）
+    void rnd_fill(std::span<int> dest, int range);
+
+    /// @brief 配列を [0.0, 1.0) の一様な実数で埋める
+    void rnd_fill(std::span<double> dest);
+
     /// @brief 乱数発生の初期化
     /// @param p1 乱数シード（省略時は時刻ベース）
     void randomize(OptInt p1 = {}, const std::source_location& location = std::source_location::current());
 
+    /// @brief rnd の生成方式を設定（スレッドごと）
+    /// @param p1 rndmode_fast / rndmode_hsp
+    /// @details どちらの方式も randomize で同時に初期化されるため、切り替えても同じシードの乱数列を再現できる
+    void rndmode(int p1, const std::source_location& location = std::source_location::current());
+
     // ============================================================
     // 範囲制限
     // ============================================================
@@ -165,10 +378,157 @@ export namespace hsppp {
     /// @brief イージング値を実数で取得
     [[nodiscard]] double geteasef(double p1, OptDouble p2 = {}, const std::source_location& location = std::source_location::current());
 
+    /// @brief イージング曲線（開始値・終了値・タイプを持つ値オブジェクト）
+    /// @details setease/getease と異なりグローバル状態を使わない。
+    ///          複数の曲線を同時に扱う場合や、複数スレッドから評価する場合に使用する
+    class Easing {
+    public:
+        constexpr Easing() noexcept = default;
+
+        /// @param minValue 開始値（setease の p1）
+        /// @param maxValue 終了値（setease の p2）
+        /// @param type イージングタイプ（ease_* 定数、ease_loop と組み合わせ可）
+        constexpr Easing(double minValue, double maxValue, int type = ease_linear) noexcept
+            : m_min(minValue), m_max(maxValue), m_type(type) {}
+
+        [[nodiscard]] constexpr double min_value() const noexcept { return m_min; }
+        [[nodiscard]] constexpr double max_value() const noexcept { return m_max; }
+        [[nodiscard]] constexpr int type() const noexcept { return m_type; }
+
+        /// @brief 1点を評価
+        /// @param t 正規化された進行値（0.0〜1.0、ease_loop 時は範囲外も可）
+        [[nodiscard]] double evaluate(double t) const noexcept;
+        [[nodiscard]] double operator()(double t) const noexcept { return evaluate(t); }
+
+        /// @brief 配列をまとめて評価（タイプごとに特殊化したSIMDカーネルを使用）
+        /// @param t 正規化された進行値の配列
+        /// @param out 結果の格納先（t と同じ要素数。t と同じ配列を指定可）
+        void evaluate(std::span<const double> t, std::span<double> out,
+                      const std::source_location& location = std::source_location::current()) const;
+
+    private:
+        double m_min = 0.0;
+        double m_max = 1.0;
+        int m_type = ease_linear;
+    };
+
+    /// @brief getease 相当の整数値を事前計算した参照テーブル
+    /// @details 進行値 0〜maxValue（ease_loop 時は 1周期分）の結果を保持する。
+    ///          同じ曲線を毎フレーム大量に評価する場合に使用する
+    class EasingTable {
+    public:
+        EasingTable() = default;
+
+        /// @param easing 元になる曲線
+        /// @param maxValue 進行値の最大値（getease の p2、1〜16777216）
+        explicit EasingTable(const Easing& easing, int maxValue = 4096,
+                             const std::source_location& location = std::source_location::current());
+
+        /// @brief getease(p1, maxValue) と同じ値を返す
+        /// @note ease_loop 時の2周期目以降は表を周期で引くため、丸めにより getease と1異なる場合がある
+        [[nodiscard]] int operator()(int p1) const noexcept {
+            if (!m_loop) {
+                return m_values[static_cast<size_t>(p1 < 0 ? 0 : (p1 > m_maxValue ? m_maxValue : p1))];
+            }
+            if (p1 >= 0) {
+                return m_values[static_cast<size_t>(p1 % (m_maxValue * 2))];
+            }
+            return evaluate_direct(p1);
+        }
+
+        [[nodiscard]] const Easing& easing() const noexcept { return m_easing; }
+        [[nodiscard]] int max_value() const noexcept { return m_maxValue; }
+        [[nodiscard]] const std::vector<int>& values() const noexcept { return m_values; }
+
+    private:
+        // 負の進行値（ease_loop 時）はテーブルを使わず直接計算
+        [[nodiscard]] int evaluate_direct(int p1) const noexcept;
+
+        Easing m_easing;
+        std::vector<int> m_values = std::vector<int>(1, 0);
+        int m_maxValue = 0;
+        bool m_loop = false;
+    };
+
     // ============================================================
     // ソート関数
     // ============================================================
 
+    // ソート順（order 引数）
+    inline constexpr int sort_ascending  = 0;
+    inline constexpr int sort_descending = 1;
+
+    namespace detail {
+        struct SortAccess;
+
+        /// @brief sort_by_key の配列の要素数が一致しなければ例外を送出
+        void check_sort_by_key_size(size_t keySize, size_t valueSize, const std::source_location& location = std::source_location::current());
+
+        /// @brief ソート並び替え情報を指定しないことを表すタグ
+        struct SortUntrackedTag {
+            explicit constexpr SortUntrackedTag() noexcept = default;
+        };
+    }
+
+    /// @brief 並び替え情報を記録しないソートを指定（sortget の結果も変化しない）
+    inline constexpr detail::SortUntrackedTag sort_untracked{};
+
+    /// @brief ソートの並び替え情報（ソート後 i 番目の要素のソート前インデックス）
+    /// @details sortget と異なり呼び出しごとに独立しているため、複数スレッドで並行してソートできる
+    class SortPermutation {
+    public:
+        SortPermutation() = default;
+
+        /// @brief 要素数
+        [[nodiscard]] size_t size() const noexcept { return m_indices.size(); }
+
+        /// @brief 空かどうか
+        [[nodiscard]] bool empty() const noexcept { return m_indices.empty(); }
+
+        /// @brief ソート後 index 番目の要素のソート前インデックス（範囲チェックなし）
+        [[nodiscard]] int operator[](size_t index) const noexcept { return m_indices[index]; }
+
+        /// @brief ソート後 index 番目の要素のソート前インデックス（sortget相当）
+        [[nodiscard]] int get(int index, const std::source_location& location = std::source_location::current()) const;
+
+        /// @brief ソート前インデックスの一覧
+        [[nodiscard]] const std::vector<int>& indices() const noexcept { return m_indices; }
+
+        /// @brief 配列をソート結果と同じ順序に並べ替える
+        /// @details 複数の配列を渡した場合は1回の巡回で同時に並べ替える。
+        ///          各配列の要素数はソートした配列と同じであること
+        template<typename... Ts>
+        void apply(std::vector<Ts>&... arrays) const {
+            (check_size(arrays.size()), ...);
+            const size_t n = m_indices.size();
+            std::vector<bool> placed(n, false);
+            for (size_t i = 0; i < n; ++i) {
+                if (placed[i] || static_cast<size_t>(m_indices[i]) == i) continue;
+
+                // i から始まる巡回置換を1要素ずつ辿る
+                std::tuple<Ts...> held{ std::move(arrays[i])... };
+                size_t j = i;
+                while (true) {
+                    placed[j] = true;
+                    const size_t from = static_cast<size_t>(m_indices[j]);
+                    if (from == i) {
+                        std::apply([&](auto&... values) { ((arrays[j] = std::move(values)), ...); }, held);
+                        break;
+                    }
+                    ((arrays[j] = std::move(arrays[from])), ...);
+                    j = from;
+                }
+            }
+        }
+
+    private:
+        friend struct detail::SortAccess;
+
+        std::vector<int> m_indices;
+
+        void check_size(size_t size, const std::source_location& location = std::source_location::current()) const;
+    };
+
     /// @brief 配列変数を数値でソート（int版）
     void sortval(std::vector<int>& arr, OptInt order = {}, const std::source_location& location = std::source_location::current());
 
@@ -184,6 +544,54 @@ export namespace hsppp {
     /// @brief ソート元のインデックスを取得
     [[nodiscard]] int sortget(int index, const std::source_location& location = std::source_location::current());
 
+    /// @brief 配列変数を数値でソートし、並び替え情報を perm に格納（int版）
+    void sortval(std::vector<int>& arr, SortPermutation& perm, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 配列変数を数値でソートし、並び替え情報を perm に格納（double版）
+    void sortval(std::vector<double>& arr, SortPermutation& perm, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 配列変数を文字列でソートし、並び替え情報を perm に格納
+    void sortstr(std::vector<std::string>& arr, SortPermutation& perm, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief メモリノート文字列をソートし、並び替え情報を perm に格納
+    void sortnote(std::string& note, SortPermutation& perm, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 並び替え情報を記録せずに配列変数を数値でソート（int版）
+    void sortval(std::vector<int>& arr, detail::SortUntrackedTag, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 並び替え情報を記録せずに配列変数を数値でソート（double版）
+    void sortval(std::vector<double>& arr, detail::SortUntrackedTag, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 並び替え情報を記録せずに配列変数を文字列でソート
+    void sortstr(std::vector<std::string>& arr, detail::SortUntrackedTag, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief 並び替え情報を記録せずにメモリノート文字列をソート
+    void sortnote(std::string& note, detail::SortUntrackedTag, OptInt order = {}, const std::source_location& location = std::source_location::current());
+
+    /// @brief keys をソートし、values の各配列も同じ順序に並べ替える
+    /// @param keys ソートキー（int / double / std::string の配列）
+    /// @param order sort_ascending または sort_descending
+    /// @return 並び替え情報
+    template<typename Key, typename... Values>
+    SortPermutation sort_by_key(std::vector<Key>& keys, int order, std::vector<Values>&... values) {
+        static_assert(std::is_same_v<Key, int> || std::is_same_v<Key, double> || std::is_same_v<Key, std::string>,
+            "sort_by_key: キーは int / double / std::string の配列である必要があります");
+
+        // キーを並べ替える前に要素数を検証する
+        (detail::check_sort_by_key_size(keys.size(), values.size()), ...);
+
+        SortPermutation perm;
+        if constexpr (std::is_same_v<Key, std::string>) {
+            sortstr(keys, perm, order);
+        } else {
+            sortval(keys, perm, order);
+        }
+        if constexpr (sizeof...(Values) > 0) {
+            perm.apply(values...);
+        }
+        return perm;
+    }
+
     // ============================================================
     // 数学定数（HSP hspmath.as互換）
     // ============================================================
@@ -157,6 +157,10 @@ export namespace hsppp {
     /// @brief 画像ファイルをロードしてCelオブジェクトを作成
     Cel loadCel(std::string_view filename, OptInt celId = {}, const std::source_location& location = std::source_location::current());
 
+    /// @brief 画像ファイルをロードし、当たり判定マスクも作成してCelオブジェクトを作成
+    /// @details マスクはデコードしたピクセルから画像全体について作り、cel_mask / cel_masks で分割後のセルごとに取り出す
+    Cel loadCel(std::string_view filename, OptInt celId, const MaskParams& mask, const std::source_location& location = std::source_location::current());
+
     // ============================================================
     // ウィンドウ設定
     // ============================================================
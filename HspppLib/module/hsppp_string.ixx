@@ -17,6 +17,10 @@ import <vector>;
 import <source_location>;
 import <format>;
 import <algorithm>;
+import <memory>;
+import <array>;
+import <span>;
+import <type_traits>;
 
 export namespace hsppp {
 
@@ -25,18 +29,27 @@ export namespace hsppp {
     // ============================================================
 
     /// @brief 整数値に変換
+    /// @details 文字列は先頭の空白と符号を許容し、数値として読める部分までを変換する（"123abc" → 123）。
+    ///          数値が無い場合や int の範囲外の場合は 0。
     [[nodiscard]] int toInt(double p1);
-    [[nodiscard]] int toInt(const std::string& p1);
+    [[nodiscard]] int toInt(std::string_view p1) noexcept;
 
     /// @brief 実数値に変換
+    /// @details 文字列は先頭の空白・符号・16進表記（0x）を許容し、数値として読める部分までを変換する。
+    ///          数値が無い場合や double の範囲外の場合は 0.0。
     [[nodiscard]] double toDouble(int p1);
-    [[nodiscard]] double toDouble(const std::string& p1);
+    [[nodiscard]] double toDouble(std::string_view p1) noexcept;
 
-    /// @brief 文字列に変換
+    /// @brief 文字列に変換（実数は小数点以下6桁）
     [[nodiscard]] std::string str(double value, const std::source_location& location = std::source_location::current());
     [[nodiscard]] std::string str(int value, const std::source_location& location = std::source_location::current());
     [[nodiscard]] std::string str(int64_t value, const std::source_location& location = std::source_location::current());
 
+    /// @brief 文字列に変換して dest に格納（dest の容量を再利用）
+    std::string& str_into(std::string& dest, double value, const std::source_location& location = std::source_location::current());
+    std::string& str_into(std::string& dest, int value, const std::source_location& location = std::source_location::current());
+    std::string& str_into(std::string& dest, int64_t value, const std::source_location& location = std::source_location::current());
+
     /// @brief 文字列の長さを調べる
     [[nodiscard]] int64_t strlen(const std::string& p1) noexcept;
 
@@ -61,21 +74,293 @@ export namespace hsppp {
     int64_t getstr(std::string& dest, const std::string& src, int64_t index, int delimiter = 0, int64_t maxLen = 1024, const std::source_location& location = std::source_location::current());
     int64_t getstr(std::string& dest, const std::vector<uint8_t>& src, int64_t index, int delimiter = 0, int64_t maxLen = 1024, const std::source_location& location = std::source_location::current());
 
+    // ============================================================
+    // StrReader - getstr互換のストリーミングトークナイザ
+    // ============================================================
+
+    /// @brief getstr互換のカーソル付きトークナイザ
+    /// @details バッファ上の読み出し位置を保持し、トークンを std::string_view で返す。
+    ///          トークンごとのメモリ確保は行わない。区切り判定は getstr と同一
+    ///          （CR / LF / CRLF、delimiter==0 のときは NUL、delimiter>0 のときはその文字）。
+    ///
+    ///          メモリ上のバッファを参照する場合、元のバッファは StrReader より長く
+    ///          生存している必要がある。open() でファイルを開いた場合は内部の
+    ///          チャンクバッファへ逐次補充しながら読み進める。
+    ///          next() が返すビューは、次に next()/read() を呼ぶまで有効。
+    class StrReader {
+    private:
+        std::string_view m_view;            // 走査対象（メモリ参照またはチャンクバッファ）
+        size_t m_pos = 0;                   // m_view 内の現在位置
+        int64_t m_base = 0;                 // m_view 先頭のストリーム上の絶対オフセット
+        int64_t m_lastSize = 0;             // 直前の読み出しで消費したバイト数（strsize相当）
+        std::string m_chunk;                // ファイル読み込み用チャンクバッファ
+        std::shared_ptr<void> m_file;       // ファイルハンドル、または pack:// の内容の所有者（open時のみ）
+        size_t m_chunkSize = 0;
+        bool m_fileEof = true;
+
+        bool refill();
+
+    public:
+        /// @brief デフォルトコンストラクタ（空のリーダー）
+        StrReader() = default;
+
+        /// @brief 文字列ビューを参照して構築
+        explicit StrReader(std::string_view src, int64_t index = 0) noexcept;
+
+        /// @brief std::string を参照して構築
+        explicit StrReader(const std::string& src, int64_t index = 0) noexcept
+            : StrReader(std::string_view(src), index) {}
+
+        /// @brief バイト配列を参照して構築
+        explicit StrReader(const std::vector<uint8_t>& src, int64_t index = 0) noexcept
+            : StrReader(std::string_view(reinterpret_cast<const char*>(src.data()), src.size()), index) {}
+
+        /// @brief 一時オブジェクトの参照は禁止（ダングリング防止）
+        explicit StrReader(std::string&&, int64_t = 0) = delete;
+        explicit StrReader(std::vector<uint8_t>&&, int64_t = 0) = delete;
+
+        // ファイルハンドルとチャンクを共有しないようコピーは禁止
+        StrReader(const StrReader&) = delete;
+        StrReader& operator=(const StrReader&) = delete;
+        StrReader(StrReader&& other) noexcept;
+        StrReader& operator=(StrReader&& other) noexcept;
+
+        /// @brief ファイルを開いてチャンク単位で読み進める
+        /// @param filename ファイル名
+        /// @param chunkSize 1回に読み込むバイト数（0で既定値 1MB）
+        StrReader& open(std::string_view filename, size_t chunkSize = 0, const std::source_location& location = std::source_location::current());
+
+        /// @brief 次のトークンを取得
+        /// @param token 取得したトークン（次の読み出しまで有効）
+        /// @param delimiter 区切り文字（getstr の p4 と同じ）
+        /// @param maxLen 最大読み出しバイト数（getstr の p5 と同じ。1 以上）
+        /// @return トークンを取得できた場合 true、終端に達していた場合 false
+        bool next(std::string_view& token, int delimiter = 0, int64_t maxLen = 1024,
+                  const std::source_location& location = std::source_location::current());
+
+        /// @brief 次のトークンを dest へ読み出し（getstr互換、dest の容量を再利用）
+        /// @return 消費したバイト数（終端なら 0）
+        int64_t read(std::string& dest, int delimiter = 0, int64_t maxLen = 1024,
+                     const std::source_location& location = std::source_location::current());
+
+        /// @brief 終端に達したか
+        [[nodiscard]] bool eof() const noexcept { return m_pos >= m_view.size() && m_fileEof; }
+
+        /// @brief 現在の読み出し位置（先頭からのバイトオフセット）
+        [[nodiscard]] int64_t index() const noexcept { return m_base + static_cast<int64_t>(m_pos); }
+
+        /// @brief 直前の読み出しで消費したバイト数（strsize相当）
+        [[nodiscard]] int64_t strsize() const noexcept { return m_lastSize; }
+
+        /// @brief 読み出し位置を移動（メモリ参照時のみ）
+        StrReader& seek(int64_t index, const std::source_location& location = std::source_location::current());
+    };
+
     /// @brief 文字列から分割された要素を取得
     std::vector<std::string> split(const std::string& src, const std::string& delimiter, const std::source_location& location = std::source_location::current());
 
-    /// @brief 書式付き文字列を変換
+    // ============================================================
+    // strf - 書式付き文字列
+    // ============================================================
+
+    namespace detail {
+        /// @brief 解析済みの strf 書式指定子（%[flags][width][.precision][length]conv）
+        struct StrfSpec {
+            uint32_t begin = 0;         // '%' の位置
+            uint32_t end = 0;           // 指定子の直後の位置
+            int32_t width = -1;         // 最小フィールド幅（-1で指定なし）
+            int32_t precision = -1;     // 精度（-1で指定なし）
+            uint8_t flags = 0;          // strf_flag_* の論理和
+            char conv = 0;              // 変換指定文字
+        };
+
+        inline constexpr uint8_t strf_flag_minus = 0x01;
+        inline constexpr uint8_t strf_flag_plus  = 0x02;
+        inline constexpr uint8_t strf_flag_space = 0x04;
+        inline constexpr uint8_t strf_flag_zero  = 0x08;
+        inline constexpr uint8_t strf_flag_hash  = 0x10;
+
+        /// @brief pos 以降の次の書式指定子を解析する（%% と不正な指定子はリテラル扱い）
+        /// @return 指定子が見つかった場合 true
+        constexpr bool strf_parse_next(std::string_view fmt, size_t& pos, StrfSpec& spec) noexcept {
+            while (pos < fmt.size()) {
+                const size_t pct = fmt.find('%', pos);
+                if (pct == std::string_view::npos) {
+                    pos = fmt.size();
+                    return false;
+                }
+                size_t i = pct + 1;
+                if (i < fmt.size() && fmt[i] == '%') {
+                    pos = i + 1;
+                    continue;
+                }
+
+                StrfSpec s{};
+                s.begin = static_cast<uint32_t>(pct);
+                for (; i < fmt.size(); ++i) {
+                    const char c = fmt[i];
+                    if (c == '-') s.flags |= strf_flag_minus;
+                    else if (c == '+') s.flags |= strf_flag_plus;
+                    else if (c == ' ') s.flags |= strf_flag_space;
+                    else if (c == '0') s.flags |= strf_flag_zero;
+                    else if (c == '#') s.flags |= strf_flag_hash;
+                    else break;
+                }
+                if (i < fmt.size() && fmt[i] >= '0' && fmt[i] <= '9') {
+                    s.width = 0;
+                    for (; i < fmt.size() && fmt[i] >= '0' && fmt[i] <= '9'; ++i) {
+                        s.width = s.width * 10 + (fmt[i] - '0');
+                    }
+                }
+                if (i < fmt.size() && fmt[i] == '.') {
+                    s.precision = 0;
+                    for (++i; i < fmt.size() && fmt[i] >= '0' && fmt[i] <= '9'; ++i) {
+                        s.precision = s.precision * 10 + (fmt[i] - '0');
+                    }
+                }
+                // 長さ修飾子は引数の型から決まるため読み飛ばす
+                while (i < fmt.size() && (fmt[i] == 'h' || fmt[i] == 'l' || fmt[i] == 'L' || fmt[i] == 'j'
+                                          || fmt[i] == 'z' || fmt[i] == 't' || fmt[i] == 'q')) {
+                    ++i;
+                }
+                if (i + 2 < fmt.size() && fmt[i] == 'I' && fmt[i + 1] == '6' && fmt[i + 2] == '4') {
+                    i += 3;
+                }
+                if (i >= fmt.size()) {
+                    pos = fmt.size();
+                    return false;
+                }
+                const char conv = fmt[i];
+                if (std::string_view("diouxXcsfFeEgGaAp").find(conv) == std::string_view::npos) {
+                    // 未対応の変換指定子はリテラルとして出力
+                    pos = i;
+                    continue;
+                }
+                s.conv = conv;
+                s.end = static_cast<uint32_t>(i + 1);
+                spec = s;
+                pos = i + 1;
+                return true;
+            }
+            return false;
+        }
+
+        /// @brief strf 引数の型消去表現
+        struct StrfArg {
+            enum class Type : uint8_t { Int, UInt, Double, String, Char, Pointer };
+
+            Type type;
+            uint8_t size = 0;           // 元の整数型のバイト数（%x 等の符号なし解釈に使用）
+            union {
+                int64_t i;
+                uint64_t u;
+                double d;
+                const char* s;
+                const void* p;
+            };
+            size_t len = 0;
+
+            template<typename T>
+            constexpr StrfArg(const T& value) noexcept : type(Type::Int), i(0) {
+                using U = std::remove_cv_t<T>;
+                if constexpr (std::is_same_v<U, bool>) {
+                    type = Type::Int; i = value ? 1 : 0; size = 4;
+                } else if constexpr (std::is_same_v<U, char>) {
+                    type = Type::Char; i = static_cast<unsigned char>(value); size = 1;
+                } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+                    type = Type::Int; i = value; size = sizeof(U);
+                } else if constexpr (std::is_integral_v<U>) {
+                    type = Type::UInt; u = value; size = sizeof(U);
+                } else if constexpr (std::is_enum_v<U>) {
+                    type = Type::Int; i = static_cast<int64_t>(value); size = sizeof(U);
+                } else if constexpr (std::is_floating_point_v<U>) {
+                    type = Type::Double; d = static_cast<double>(value);
+                } else if constexpr (std::is_pointer_v<U> && std::is_same_v<std::remove_cv_t<std::remove_pointer_t<U>>, char>) {
+                    type = Type::String;
+                    s = value ? value : "(null)";
+                    len = std::char_traits<char>::length(s);
+                } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                    const std::string_view sv(value);
+                    type = Type::String; s = sv.data(); len = sv.size();
+                } else if constexpr (std::is_pointer_v<U> || std::is_null_pointer_v<U>) {
+                    type = Type::Pointer; p = value;
+                } else {
+                    static_assert(sizeof(T) == 0, "strf: 未対応の引数型です");
+                }
+            }
+        };
+
+        // 定数式評価中に呼ばれるとコンパイルエラーになる（書式エラー通知用）
+        inline void strf_format_error(const char*) {}
+
+        /// @brief 引数型に対応する strf 書式文字列
+        /// @details 文字列リテラルはコンパイル時に解析・検証し、実行時の文字列は解析結果をキャッシュする
+        template<typename... Args>
+        class StrfFormatString {
+        private:
+            std::string_view m_str;
+            std::array<StrfSpec, sizeof...(Args)> m_specs{};
+            uint32_t m_count = 0;
+            bool m_parsed = false;
+
+        public:
+            /// @brief 文字列リテラル（コンパイル時解析）
+            template<size_t N>
+            consteval StrfFormatString(const char (&format)[N]) : m_str(format), m_parsed(true) {
+                size_t pos = 0;
+                StrfSpec spec{};
+                while (strf_parse_next(m_str, pos, spec)) {
+                    if (m_count >= sizeof...(Args)) {
+                        strf_format_error("strf: 書式指定子の数が引数より多い");
+                    }
+                    m_specs[m_count++] = spec;
+                }
+            }
+
+            /// @brief 実行時の書式文字列（解析結果はスレッドごとにキャッシュ）
+            StrfFormatString(const std::string& format) noexcept : m_str(format) {}
+            StrfFormatString(std::string_view format) noexcept : m_str(format) {}
+            template<typename T>
+                requires std::is_same_v<std::decay_t<T>, const char*> || std::is_same_v<std::decay_t<T>, char*>
+            StrfFormatString(const T& format) noexcept : m_str(format) {}
+
+            [[nodiscard]] constexpr std::string_view get() const noexcept { return m_str; }
+            [[nodiscard]] constexpr bool parsed() const noexcept { return m_parsed; }
+            [[nodiscard]] constexpr std::span<const StrfSpec> specs() const noexcept { return { m_specs.data(), m_count }; }
+        };
+
+        /// @brief 型消去した引数で書式化し out に追記する（hsppp_string.inl で実装）
+        void strf_vformat_to(std::string& out, std::string_view format, bool parsed,
+                             std::span<const StrfSpec> specs, std::span<const StrfArg> args);
+    }
+
+    /// @brief strf の書式文字列型（引数型から推論されない）
+    template<typename... Args>
+    using strf_format = detail::StrfFormatString<std::type_identity_t<Args>...>;
+
+    /// @brief 書式付き文字列を変換（引数なしは書式文字列をそのまま返す）
     [[nodiscard]] std::string strf(const std::string& format);
-    [[nodiscard]] std::string strf(const std::string& format, int arg1);
-    [[nodiscard]] std::string strf(const std::string& format, double arg1);
-    [[nodiscard]] std::string strf(const std::string& format, const std::string& arg1);
-    [[nodiscard]] std::string strf(const std::string& format, int arg1, int arg2);
-    [[nodiscard]] std::string strf(const std::string& format, int arg1, double arg2);
-    [[nodiscard]] std::string strf(const std::string& format, int arg1, const std::string& arg2);
-    [[nodiscard]] std::string strf(const std::string& format, double arg1, int arg2);
-    [[nodiscard]] std::string strf(const std::string& format, double arg1, double arg2);
-    [[nodiscard]] std::string strf(const std::string& format, int arg1, int arg2, int arg3);
-    [[nodiscard]] std::string strf(const std::string& format, int arg1, double arg2, const std::string& arg3);
+
+    /// @brief 書式付き文字列を変換
+    /// @details printf 形式の書式に任意個・任意型の引数を渡せる。
+    ///          書式が文字列リテラルの場合はコンパイル時に解析され、指定子が引数より多いとコンパイルエラーになる。
+    ///          %d に実数、%f に整数を渡した場合は HSP と同様に型変換して出力する。
+    template<typename Arg1, typename... Args>
+    [[nodiscard]] std::string strf(strf_format<Arg1, Args...> format, const Arg1& arg1, const Args&... args) {
+        const std::array<detail::StrfArg, 1 + sizeof...(Args)> erased{ detail::StrfArg(arg1), detail::StrfArg(args)... };
+        std::string out;
+        detail::strf_vformat_to(out, format.get(), format.parsed(), format.specs(), erased);
+        return out;
+    }
+
+    /// @brief 書式付き文字列を dest に出力（dest の容量を再利用）
+    template<typename Arg1, typename... Args>
+    std::string& strf_into(std::string& dest, strf_format<Arg1, Args...> format, const Arg1& arg1, const Args&... args) {
+        const std::array<detail::StrfArg, 1 + sizeof...(Args)> erased{ detail::StrfArg(arg1), detail::StrfArg(args)... };
+        dest.clear();
+        detail::strf_vformat_to(dest, format.get(), format.parsed(), format.specs(), erased);
+        return dest;
+    }
 
     /// @brief パスの一部を取得
     [[nodiscard]] std::string getpath(const std::string& p1, int p2);
@@ -90,21 +375,51 @@ export namespace hsppp {
     /// @brief unicode(UTF-16)を通常文字列(UTF-8)に変換
     [[nodiscard]] std::string cnvwtos(const std::u16string& wstr, const std::source_location& location = std::source_location::current());
 
-    /// @brief 通常文字列(UTF-8)をANSI(ShiftJIS)文字列に変換
+    /// @brief 通常文字列(UTF-8)をANSI(ShiftJIS / CP932)文字列に変換
     [[nodiscard]] std::string cnvstoa(const std::string& str, const std::source_location& location = std::source_location::current());
 
-    /// @brief ANSI(ShiftJIS)文字列を通常文字列(UTF-8)に変換
+    /// @brief ANSI(ShiftJIS / CP932)文字列を通常文字列(UTF-8)に変換
     [[nodiscard]] std::string cnvatos(const std::string& astr, const std::source_location& location = std::source_location::current());
 
+    /// @brief cnvstow の結果を dest に出力（dest の容量を再利用）
+    std::u16string& cnvstow_into(std::u16string& dest, std::string_view str, const std::source_location& location = std::source_location::current());
+
+    /// @brief cnvwtos の結果を dest に出力（dest の容量を再利用）
+    std::string& cnvwtos_into(std::string& dest, std::u16string_view wstr, const std::source_location& location = std::source_location::current());
+
+    /// @brief cnvstoa の結果を dest に出力（dest の容量を再利用）
+    std::string& cnvstoa_into(std::string& dest, std::string_view str, const std::source_location& location = std::source_location::current());
+
+    /// @brief cnvatos の結果を dest に出力（dest の容量を再利用）
+    std::string& cnvatos_into(std::string& dest, std::string_view astr, const std::source_location& location = std::source_location::current());
+
     // ============================================================
     // NotePad クラス - OOP版メモリノートパッド
     // ============================================================
 
     /// @brief OOP版メモリノートパッド
+    /// @details map() で開いた場合はファイルを読み取り専用でメモリマップし、
+    ///          行はマップ上のビューとして返す。add/del 等の変更操作を行った時点で
+    ///          内容を m_buffer へコピーし、通常のノートパッドに切り替わる。
+    ///          const のメンバ関数はオブジェクトを変更しないため、複数のスレッドから同時に呼べる。
     class NotePad {
     private:
         std::string m_buffer;
 
+        // メモリマップ（map() 時のみ有効）。マップ、行インデックス、const 版 toString() 用の
+        // 実体化した文字列を持ち、一度だけ構築する（hsppp_string.inl で定義）。コピーとは共有する
+        struct MapState;
+        std::shared_ptr<MapState> m_map;
+        std::string_view m_mapped;
+
+        static constexpr size_t kLineIndexStride = 64;
+
+        [[nodiscard]] bool isMapped() const noexcept { return m_map != nullptr; }
+        [[nodiscard]] bool lineStart(size_t index, size_t& outOffset) const;
+        [[nodiscard]] const std::string& mappedString() const;
+        void detach();
+        void resetMapping() noexcept;
+
     public:
         /// @brief デフォルトコンストラクタ（空のノートパッド）
         NotePad() = default;
@@ -115,24 +430,28 @@ export namespace hsppp {
         /// @brief std::stringからのムーブ構築
         explicit NotePad(std::string&& text) noexcept;
 
-        // コピー・ムーブはデフォルト
+        // コピーはマップを共有する（読み取り専用のため安全）
         NotePad(const NotePad&) = default;
         NotePad& operator=(const NotePad&) = default;
-        NotePad(NotePad&&) noexcept = default;
-        NotePad& operator=(NotePad&&) noexcept = default;
+        NotePad(NotePad&& other) noexcept;
+        NotePad& operator=(NotePad&& other) noexcept;
 
         /// @brief 行数を取得（notemax相当）
         [[nodiscard]] size_t count() const noexcept;
 
         /// @brief 空かどうか
-        [[nodiscard]] bool empty() const noexcept { return m_buffer.empty(); }
+        [[nodiscard]] bool empty() const noexcept { return view().empty(); }
 
         /// @brief 総バイト数を取得（notesize相当）
-        [[nodiscard]] size_t size() const noexcept { return m_buffer.size(); }
+        [[nodiscard]] size_t size() const noexcept { return view().size(); }
 
         /// @brief 指定行の内容を取得（noteget相当）
         [[nodiscard]] std::string get(size_t index) const;
 
+        /// @brief 指定行の内容をコピーせずに取得
+        /// @details 次に内容を変更するまで有効。範囲外は空
+        [[nodiscard]] std::string_view line(size_t index) const;
+
         /// @brief 行を追加（noteadd相当）
         NotePad& add(std::string_view text, int index = -1, int overwrite = 0, const std::source_location& location = std::source_location::current());
 
@@ -140,7 +459,7 @@ export namespace hsppp {
         NotePad& del(size_t index, const std::source_location& location = std::source_location::current());
 
         /// @brief 全行をクリア
-        NotePad& clear() noexcept { m_buffer.clear(); return *this; }
+        NotePad& clear() noexcept { resetMapping(); m_buffer.clear(); return *this; }
 
         /// @brief 文字列を検索（notefind相当）
         [[nodiscard]] int find(std::string_view search, int mode = 0, size_t startIndex = 0) const;
@@ -148,18 +467,32 @@ export namespace hsppp {
         /// @brief ファイルから読み込み（noteload相当）
         NotePad& load(std::string_view filename, size_t maxSize = 0, const std::source_location& location = std::source_location::current());
 
+        /// @brief ファイルを読み取り専用でメモリマップして開く
+        /// @details ファイル全体を読み込まないため巨大なファイルも即座に開ける。
+        ///          行インデックスは count()/get() の初回呼び出し時に並列に構築する
+        NotePad& map(std::string_view filename, size_t maxSize = 0, const std::source_location& location = std::source_location::current());
+
+        /// @brief メモリマップ中かどうか
+        [[nodiscard]] bool mapped() const noexcept { return isMapped(); }
+
         /// @brief ファイルへ保存（notesave相当）
         [[nodiscard]] bool save(std::string_view filename, const std::source_location& location = std::source_location::current()) const;
 
+        /// @brief 内容をコピーせずに参照（次に内容を変更するまで有効）
+        [[nodiscard]] std::string_view view() const noexcept { return isMapped() ? m_mapped : std::string_view(m_buffer); }
+
+        /// @brief 内部バッファへの参照を取得（マップ中の場合は内容をコピーして通常のノートパッドに切り替える）
+        [[nodiscard]] std::string& buffer() { detach(); return m_buffer; }
+
         /// @brief 内部バッファへの参照を取得
-        [[nodiscard]] std::string& buffer() noexcept { return m_buffer; }
-        [[nodiscard]] const std::string& buffer() const noexcept { return m_buffer; }
+        /// @details マップ中の場合はマップを保ったまま内容を一度だけコピーし、その文字列を返す
+        [[nodiscard]] const std::string& buffer() const { return isMapped() ? mappedString() : m_buffer; }
 
-        /// @brief 改行区切りの文字列として出力
-        [[nodiscard]] const std::string& toString() const noexcept { return m_buffer; }
+        /// @brief 改行区切りの文字列として出力（マップ中の場合は buffer() const と同様）
+        [[nodiscard]] const std::string& toString() const { return buffer(); }
 
         /// @brief 明示的な文字列変換
-        explicit operator const std::string&() const noexcept { return m_buffer; }
+        explicit operator const std::string&() const { return buffer(); }
     };
 
     // ============================================================
@@ -0,0 +1,141 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/module/hsppp_tween.ixx
+// トゥイーンモジュール: 多数のアニメーションを一括で進める Timeline
+//
+// 使用例:
+//   Timeline timeline;
+//   double x = 0.0;
+//   auto move = timeline.add(&x, 0.0, 400.0, 1.0, ease_quad_out);
+//   timeline.add(&x, 400.0, 0.0, 0.5, ease_bounce_out, { .after = move });
+//   while (true) { timeline.update(1.0 / 60.0); ... await(16); }
+
+export module hsppp:tween;
+
+import :types;
+import :math;
+
+import <cstdint>;
+import <functional>;
+import <source_location>;
+import <vector>;
+
+export namespace hsppp {
+
+    /// @brief Timeline に登録したトゥイーンのハンドル
+    /// @details スロットは再利用されるため、世代番号で古いハンドルを無効として扱う
+    struct TweenHandle {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+
+        [[nodiscard]] constexpr bool valid() const noexcept { return slot != UINT32_MAX; }
+        [[nodiscard]] friend constexpr bool operator==(const TweenHandle&, const TweenHandle&) noexcept = default;
+    };
+
+    /// @brief トゥイーンの追加オプション
+    struct TweenOptions {
+        double delay = 0.0;                 ///< 開始までの待ち時間（秒。after 指定時は前のトゥイーン完了から）
+        int repeat = 0;                     ///< 追加の繰り返し回数（-1 で無限）
+        TweenHandle after = {};             ///< このトゥイーンの完了後に開始（連続再生）
+        std::function<void()> on_complete;  ///< 完了時のコールバック（update の最後に呼ばれる）
+    };
+
+    /// @brief 多数のトゥイーンを毎フレームまとめて進めるタイムライン
+    /// @details トゥイーンはイージングタイプごとに構造体配列（SoA）で保持し、
+    ///          update() で Easing のバッチ評価を使って一括計算する。
+    ///          完了したスロットは再利用される。スレッドセーフではない
+    class Timeline {
+    public:
+        Timeline() = default;
+
+        /// @brief トゥイーンを追加
+        /// @param target 毎フレーム値を書き込む先（nullptr 可。value() で取得）
+        /// @param from 開始値
+        /// @param to 終了値
+        /// @param duration 所要時間（秒、0 以上）
+        /// @param type イージングタイプ（ease_* 定数。ease_loop 指定時は remove するまで往復し続ける）
+        /// @param options 遅延・繰り返し・連続再生・完了コールバック
+        /// @note target は remove() または完了までの間有効である必要がある
+        TweenHandle add(double* target, double from, double to, double duration,
+                        int type = ease_linear, TweenOptions options = {},
+                        const std::source_location& location = std::source_location::current());
+
+        /// @brief 全トゥイーンの経過時間を進め、値を target に書き込む
+        /// @param dt 経過時間（秒）
+        void update(double dt);
+
+        /// @brief トゥイーンを削除（完了コールバックは呼ばれない。after で待っている後続も削除）
+        /// @return 削除した場合 true（無効なハンドルは false）
+        bool remove(TweenHandle handle);
+
+        /// @brief 全トゥイーンを削除（完了コールバックは呼ばれない）
+        void clear();
+
+        /// @brief トゥイーンが有効か（実行中・遅延中・後続待ち）
+        [[nodiscard]] bool active(TweenHandle handle) const noexcept;
+
+        /// @brief トゥイーンの現在値（開始前は開始値）
+        [[nodiscard]] double value(TweenHandle handle,
+                                   const std::source_location& location = std::source_location::current()) const;
+
+        /// @brief 有効なトゥイーンの数
+        [[nodiscard]] size_t size() const noexcept;
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+    private:
+        // 同じイージングタイプのトゥイーンを詰めて保持する（要素の順序は不定）
+        struct Bucket {
+            std::vector<double> elapsed;       // 経過時間（遅延中は負）
+            std::vector<double> duration;
+            std::vector<double> invDuration;
+            std::vector<double> from;
+            std::vector<double> delta;         // to - from
+            std::vector<double> value;         // 現在値（評価時は進行値の作業領域を兼ねる）
+            std::vector<double*> target;
+            std::vector<uint32_t> slot;        // 対応するスロット番号
+        };
+
+        // ハンドルから引くトゥイーンごとの情報（更新ループでは参照しない）
+        struct Slot {
+            uint32_t generation = 0;
+            uint8_t state = 0;                 // 0=空き, 1=実行中, 2=後続待ち
+            uint8_t bucket = 0;
+            uint32_t position = 0;             // バケット内の位置（後続待ちは m_pending 内の位置）
+            double to = 0.0;
+            int repeat = 0;
+            uint32_t leader = UINT32_MAX;      // after で指定したトゥイーンのスロット
+            uint32_t firstFollower = UINT32_MAX;
+            uint32_t nextFollower = UINT32_MAX;
+            std::function<void()> onComplete;
+        };
+
+        // 後続待ちのトゥイーン（前のトゥイーンの完了時にバケットへ移す）
+        struct Pending {
+            uint32_t slot;
+            double* target;
+            double from;
+            double duration;
+            double delay;
+            int type;
+        };
+
+        void start(uint32_t slotIndex, double* target, double from, double duration, double elapsed, int type);
+        void finish(uint32_t slotIndex);
+        void startFollowers(uint32_t slotIndex, double overshoot);
+        void detach(uint32_t slotIndex);
+        void releaseSlot(uint32_t slotIndex);
+
+        std::vector<Bucket> m_buckets;
+        std::vector<Slot> m_slots;
+        std::vector<uint32_t> m_freeSlots;
+        std::vector<Pending> m_pending;
+        std::vector<uint32_t> m_finished;                  // update 中に完了したスロット（作業領域）
+        std::vector<std::function<void()>> m_callbacks;    // update の最後に呼ぶコールバック（作業領域）
+        size_t m_count = 0;
+    };
+
+}  // namespace hsppp
@@ -190,6 +190,65 @@ export namespace hsppp {
         std::string_view title = "HSPPP Window";
     };
 
+    /// @brief ピクセル単位の当たり判定マスクの作成パラメータ（loadCel / PixelMask）
+    /// @details alpha_threshold 以上の不透明度で、color_key と異なる色の画素を当たりとする。
+    ///          画像ファイルから作る場合、色は乗算済みアルファで比較する（不透明な画素は元の色と同じ）
+    struct MaskParams {
+        int alpha_threshold = 128;  ///< 当たりとする最小のアルファ値 (0～256)
+        int color_key = -1;         ///< 当たりから除く色 0xRRGGBB (-1=使わない, 0=HSP の gmode 2 と同じ黒)
+    };
+
+    /// @brief bsave の保存方法
+    /// @details atomic は一時ファイルに書き込んでから置き換えるため、書き込み中に異常終了しても元のファイルが残る。
+    ///          deferred は同じファイルへの保存を次の await / bflush までまとめ、1回の書き込みにする
+    struct SaveParams {
+        bool atomic = false;        ///< 一時ファイルに書き込んでから置き換える
+        bool flush = false;         ///< 閉じる前にディスクへの書き込みの完了を待つ
+        bool deferred = false;      ///< 次の await / vwait / stop / bflush まで書き込みを遅らせてまとめる
+    };
+
+    /// @brief bcopy / bcopy_async のコピー方法
+    /// @details 対応するファイルシステムではデータを複製せずに共有し（clone）、それ以外は OS のコピー機能を使う（native）
+    struct CopyParams {
+        int chunk_size = 8 * 1024 * 1024;   ///< 進捗を通知する間隔（バイト、65536〜1GB）
+        bool clone = true;                  ///< ReFS・Dev Drive のブロック複製を使う（同じボリューム上のみ）
+        bool native = true;                 ///< CopyFile2 でコピーする（false は作業スレッドでの読み書き）
+        bool flush = false;                 ///< 完了前にディスクへの書き込みの完了を待つ
+    };
+
+    /// @brief packbuild のパラメータ
+    struct PackParams {
+        bool compress = true;       ///< 小さくなるファイルを LZ4 で圧縮する
+        int alignment = 16;         ///< 各ファイルの先頭の境界（2 の累乗、1〜65536）
+        int level = 1;              ///< 圧縮の強さ（CompressParams::level と同じ。展開の速さは変わらない）
+    };
+
+    /// @brief dirwalk のパラメータ
+    struct DirWalkParams {
+        int mode = 0;               ///< dirlist と同じ絞り込み（0=すべて, 1=ファイルのみ, 5=ディレクトリのみ 等）
+        std::string pattern;        ///< 名前のワイルドカード（"*.png;*.jpg" のように ';' で複数指定。空はすべて）
+        bool recursive = true;      ///< サブディレクトリも走査する
+        int threads = 0;            ///< 作業スレッドの数（0=ハードウェアスレッド数、最大 8）
+        int queue_capacity = 4096;  ///< 受け取る前にためておけるエントリーの数（超えると走査を待たせる）
+    };
+
+    /// @brief filewatch のパラメータ
+    struct WatchParams {
+        bool recursive = true;      ///< サブディレクトリも監視する
+        std::string pattern;        ///< 名前のワイルドカード（dirwalk と同じ。空はすべて）
+        int debounce_ms = 50;       ///< 続けざまの変更をまとめる時間（最後の変更からこの時間だけ待つ）
+        bool reload = true;         ///< 変更されたファイルから読み込んだ cel・mmload の素材を読み直す
+        bool cache_stats = false;   ///< 下のパスの exist / exist_many の結果をキャッシュする（pattern が空の場合のみ。他のプロセスの変更は遅れて反映される）
+    };
+
+    /// @brief Compressor / compress / bsave_compressed のパラメータ
+    struct CompressParams {
+        int level = 1;                  ///< 圧縮の強さ（1 = 速度優先、2〜12 = 圧縮率優先。展開の速さは変わらない）
+        int block_size = 256 * 1024;    ///< 1ブロックの大きさ（65536 / 262144 / 1048576 / 4194304）
+        int threads = 1;                ///< ブロックを並列に圧縮するスレッドの数（0 = ハードウェアスレッド数、最大 8）
+        bool checksum = true;           ///< 内容のチェックサムを付ける（展開時に壊れたデータを検出する）
+    };
+
 
     // ============================================================
     // DialogResult - dialog命令の戻り値
@@ -441,6 +500,12 @@ export namespace hsppp {
 
         /// @brief 画像の高さを取得
         [[nodiscard]] int height(const std::source_location& location = std::source_location::current()) const;
+
+        /// @brief 分割後の1セルの幅を取得（put で描画される大きさ）
+        [[nodiscard]] int cell_width(const std::source_location& location = std::source_location::current()) const;
+
+        /// @brief 分割後の1セルの高さを取得（put で描画される大きさ）
+        [[nodiscard]] int cell_height(const std::source_location& location = std::source_location::current()) const;
     };
 
 
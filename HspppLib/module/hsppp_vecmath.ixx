@@ -0,0 +1,264 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/module/hsppp_vecmath.ixx
+// ベクトル演算モジュール: Vec2, Vec4, Mat3 と座標の一括変換
+//
+// 使用例:
+//   const Mat3 m = Mat3::translation(320, 240) * Mat3::rotation(angle) * Mat3::scaling(2, 2);
+//   gsquare(-1, rect_quad(m, 64, 64));        // 64x64 の矩形を変換して描画
+//   transform(m, localPoints, screenPoints);  // 多数の点をまとめて変換
+
+export module hsppp:vecmath;
+
+import :types;
+
+import <cmath>;
+import <source_location>;
+import <span>;
+
+export namespace hsppp {
+
+    // ============================================================
+    // Vec2 - 2次元ベクトル
+    // ============================================================
+
+    /// @brief 2次元ベクトル（float）
+    /// @details 画面座標は x が右、y が下向き
+    struct Vec2 {
+        float x = 0.0f;
+        float y = 0.0f;
+
+        constexpr Vec2() noexcept = default;
+        constexpr Vec2(float px, float py) noexcept : x(px), y(py) {}
+        constexpr explicit Vec2(Point2i p) noexcept : x(static_cast<float>(p.x)), y(static_cast<float>(p.y)) {}
+
+        [[nodiscard]] constexpr Vec2 operator+(Vec2 rhs) const noexcept { return { x + rhs.x, y + rhs.y }; }
+        [[nodiscard]] constexpr Vec2 operator-(Vec2 rhs) const noexcept { return { x - rhs.x, y - rhs.y }; }
+        [[nodiscard]] constexpr Vec2 operator-() const noexcept { return { -x, -y }; }
+        [[nodiscard]] constexpr Vec2 operator*(float s) const noexcept { return { x * s, y * s }; }
+        [[nodiscard]] constexpr Vec2 operator/(float s) const noexcept { return { x / s, y / s }; }
+        [[nodiscard]] friend constexpr Vec2 operator*(float s, Vec2 v) noexcept { return v * s; }
+
+        constexpr Vec2& operator+=(Vec2 rhs) noexcept { x += rhs.x; y += rhs.y; return *this; }
+        constexpr Vec2& operator-=(Vec2 rhs) noexcept { x -= rhs.x; y -= rhs.y; return *this; }
+        constexpr Vec2& operator*=(float s) noexcept { x *= s; y *= s; return *this; }
+        constexpr Vec2& operator/=(float s) noexcept { x /= s; y /= s; return *this; }
+
+        [[nodiscard]] friend constexpr bool operator==(Vec2, Vec2) noexcept = default;
+
+        /// @brief 内積
+        [[nodiscard]] constexpr float dot(Vec2 rhs) const noexcept { return x * rhs.x + y * rhs.y; }
+
+        /// @brief 外積（z成分）。正なら rhs は画面上で時計回り側
+        [[nodiscard]] constexpr float cross(Vec2 rhs) const noexcept { return x * rhs.y - y * rhs.x; }
+
+        /// @brief 長さの2乗
+        [[nodiscard]] constexpr float length_sq() const noexcept { return dot(*this); }
+
+        /// @brief 長さ
+        [[nodiscard]] float length() const noexcept { return std::sqrt(length_sq()); }
+
+        /// @brief 長さ1のベクトル（長さ0の場合はそのまま返す）
+        [[nodiscard]] Vec2 normalized() const noexcept {
+            const float len = length();
+            return len > 0.0f ? *this / len : *this;
+        }
+
+        /// @brief 90度回転したベクトル（画面上で時計回り）
+        [[nodiscard]] constexpr Vec2 perp() const noexcept { return { -y, x }; }
+
+        /// @brief 回転したベクトル（ラジアン。grect / grotate と同じく画面上で時計回りが正）
+        [[nodiscard]] Vec2 rotated(double angle) const noexcept {
+            const float c = static_cast<float>(std::cos(angle));
+            const float s = static_cast<float>(std::sin(angle));
+            return { x * c - y * s, x * s + y * c };
+        }
+
+        /// @brief 整数座標に変換（四捨五入。0.5 は 0 から遠い方へ丸める）
+        [[nodiscard]] constexpr Point2i to_point() const noexcept {
+            return { static_cast<int>(x < 0.0f ? x - 0.5f : x + 0.5f),
+                     static_cast<int>(y < 0.0f ? y - 0.5f : y + 0.5f) };
+        }
+
+        /// @brief 線形補間
+        [[nodiscard]] static constexpr Vec2 lerp(Vec2 a, Vec2 b, float t) noexcept { return a + (b - a) * t; }
+    };
+
+    // ============================================================
+    // Vec4 - 4次元ベクトル（色・矩形・同次座標など）
+    // ============================================================
+
+    /// @brief 4次元ベクトル（float）
+    /// @details SIMD レジスタ1本分（16バイト境界）に揃えてある
+    struct alignas(16) Vec4 {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 0.0f;
+
+        constexpr Vec4() noexcept = default;
+        constexpr Vec4(float px, float py, float pz, float pw) noexcept : x(px), y(py), z(pz), w(pw) {}
+        constexpr Vec4(Vec2 xy, Vec2 zw) noexcept : x(xy.x), y(xy.y), z(zw.x), w(zw.y) {}
+
+        [[nodiscard]] constexpr Vec4 operator+(const Vec4& rhs) const noexcept { return { x + rhs.x, y + rhs.y, z + rhs.z, w + rhs.w }; }
+        [[nodiscard]] constexpr Vec4 operator-(const Vec4& rhs) const noexcept { return { x - rhs.x, y - rhs.y, z - rhs.z, w - rhs.w }; }
+        [[nodiscard]] constexpr Vec4 operator-() const noexcept { return { -x, -y, -z, -w }; }
+        [[nodiscard]] constexpr Vec4 operator*(float s) const noexcept { return { x * s, y * s, z * s, w * s }; }
+        [[nodiscard]] constexpr Vec4 operator/(float s) const noexcept { return { x / s, y / s, z / s, w / s }; }
+        [[nodiscard]] friend constexpr Vec4 operator*(float s, const Vec4& v) noexcept { return v * s; }
+
+        constexpr Vec4& operator+=(const Vec4& rhs) noexcept { x += rhs.x; y += rhs.y; z += rhs.z; w += rhs.w; return *this; }
+        constexpr Vec4& operator-=(const Vec4& rhs) noexcept { x -= rhs.x; y -= rhs.y; z -= rhs.z; w -= rhs.w; return *this; }
+        constexpr Vec4& operator*=(float s) noexcept { x *= s; y *= s; z *= s; w *= s; return *this; }
+
+        [[nodiscard]] friend constexpr bool operator==(const Vec4&, const Vec4&) noexcept = default;
+
+        [[nodiscard]] constexpr float dot(const Vec4& rhs) const noexcept { return x * rhs.x + y * rhs.y + z * rhs.z + w * rhs.w; }
+        [[nodiscard]] constexpr Vec2 xy() const noexcept { return { x, y }; }
+        [[nodiscard]] constexpr Vec2 zw() const noexcept { return { z, w }; }
+
+        [[nodiscard]] static constexpr Vec4 lerp(const Vec4& a, const Vec4& b, float t) noexcept { return a + (b - a) * t; }
+    };
+
+    // ============================================================
+    // Mat3 - 2次元の同次座標変換行列
+    // ============================================================
+
+    /// @brief 3x3 行列（2次元の同次座標変換）
+    /// @details 列ベクトル (x, y, 1) に左から掛ける。A * B は「B を適用してから A を適用」。
+    ///          3行目が (0, 0, 1) のアフィン変換は一括変換で高速な経路を通る
+    struct Mat3 {
+        float m[3][3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+
+        /// @brief 単位行列
+        constexpr Mat3() noexcept = default;
+        constexpr Mat3(float m00, float m01, float m02,
+                       float m10, float m11, float m12,
+                       float m20, float m21, float m22) noexcept
+            : m{ { m00, m01, m02 }, { m10, m11, m12 }, { m20, m21, m22 } } {}
+
+        [[nodiscard]] static constexpr Mat3 identity() noexcept { return {}; }
+
+        /// @brief 平行移動
+        [[nodiscard]] static constexpr Mat3 translation(float tx, float ty) noexcept {
+            return { 1.0f, 0.0f, tx, 0.0f, 1.0f, ty, 0.0f, 0.0f, 1.0f };
+        }
+        [[nodiscard]] static constexpr Mat3 translation(Vec2 t) noexcept { return translation(t.x, t.y); }
+
+        /// @brief 拡大縮小
+        [[nodiscard]] static constexpr Mat3 scaling(float sx, float sy) noexcept {
+            return { sx, 0.0f, 0.0f, 0.0f, sy, 0.0f, 0.0f, 0.0f, 1.0f };
+        }
+
+        /// @brief 原点を中心とした回転（ラジアン。grect / grotate と同じく画面上で時計回りが正）
+        [[nodiscard]] static Mat3 rotation(double angle) noexcept {
+            const float c = static_cast<float>(std::cos(angle));
+            const float s = static_cast<float>(std::sin(angle));
+            return { c, -s, 0.0f, s, c, 0.0f, 0.0f, 0.0f, 1.0f };
+        }
+
+        [[nodiscard]] constexpr Mat3 operator*(const Mat3& rhs) const noexcept {
+            Mat3 r;
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) {
+                    r.m[i][j] = m[i][0] * rhs.m[0][j] + m[i][1] * rhs.m[1][j] + m[i][2] * rhs.m[2][j];
+                }
+            }
+            return r;
+        }
+        constexpr Mat3& operator*=(const Mat3& rhs) noexcept { return *this = *this * rhs; }
+
+        [[nodiscard]] friend constexpr bool operator==(const Mat3&, const Mat3&) noexcept = default;
+
+        /// @brief アフィン変換か（3行目が (0, 0, 1)）
+        [[nodiscard]] constexpr bool is_affine() const noexcept {
+            return m[2][0] == 0.0f && m[2][1] == 0.0f && m[2][2] == 1.0f;
+        }
+
+        /// @brief 点を変換（アフィンでない場合は w で割る）
+        [[nodiscard]] constexpr Vec2 transform_point(Vec2 p) const noexcept {
+            const float x = m[0][0] * p.x + m[0][1] * p.y + m[0][2];
+            const float y = m[1][0] * p.x + m[1][1] * p.y + m[1][2];
+            if (is_affine()) {
+                return { x, y };
+            }
+            const float w = m[2][0] * p.x + m[2][1] * p.y + m[2][2];
+            return { x / w, y / w };
+        }
+
+        /// @brief 方向ベクトルを変換（平行移動を含めない）
+        [[nodiscard]] constexpr Vec2 transform_vector(Vec2 v) const noexcept {
+            return { m[0][0] * v.x + m[0][1] * v.y, m[1][0] * v.x + m[1][1] * v.y };
+        }
+
+        /// @brief 行列式
+        [[nodiscard]] constexpr float determinant() const noexcept {
+            return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1])
+                 - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0])
+                 + m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+        }
+
+        /// @brief 逆行列（行列式が 0 の場合は単位行列を返す）
+        [[nodiscard]] constexpr Mat3 inverse() const noexcept {
+            const float det = determinant();
+            if (det == 0.0f) {
+                return {};
+            }
+            const float inv = 1.0f / det;
+            return {
+                (m[1][1] * m[2][2] - m[1][2] * m[2][1]) * inv,
+                (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inv,
+                (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inv,
+                (m[1][2] * m[2][0] - m[1][0] * m[2][2]) * inv,
+                (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inv,
+                (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inv,
+                (m[1][0] * m[2][1] - m[1][1] * m[2][0]) * inv,
+                (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inv,
+                (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inv,
+            };
+        }
+    };
+
+    // ============================================================
+    // 描画命令との連携
+    // ============================================================
+
+    /// @brief 原点を中心とする幅 w・高さ h の矩形を変換した4頂点（gsquare のコピー先）
+    /// @details 頂点順序は Quad と同じ（左上, 右上, 右下, 左下）。座標は四捨五入する
+    [[nodiscard]] constexpr Quad rect_quad(const Mat3& matrix, float w, float h) noexcept {
+        const float hw = w * 0.5f;
+        const float hh = h * 0.5f;
+        return { matrix.transform_point({ -hw, -hh }).to_point(),
+                 matrix.transform_point({ hw, -hh }).to_point(),
+                 matrix.transform_point({ hw, hh }).to_point(),
+                 matrix.transform_point({ -hw, hh }).to_point() };
+    }
+
+    /// @brief 変換行列で配置した矩形を塗りつぶす（grect の行列版）
+    /// @details 原点を中心とする幅 w・高さ h の矩形を matrix の平行移動・回転・拡大率で描画する。
+    ///          せん断・射影成分は無視されるため、その場合は gsquare(-1, rect_quad(...)) を使う。
+    ///          grect({}, 100, 50) のような省略引数の呼び出しと衝突しないよう、grect とは別名にしている
+    void grect_transform(const Mat3& matrix, int w, int h, const std::source_location& location = std::source_location::current());
+
+    // ============================================================
+    // 一括変換（SSE2 で複数の点をまとめて処理）
+    // ============================================================
+    // 出力配列は入力と同じ要素数であること。入力と同じ配列を出力に指定してもよい
+
+    /// @brief 点をまとめて変換
+    void transform(const Mat3& matrix, std::span<const Vec2> src, std::span<Vec2> dst,
+                   const std::source_location& location = std::source_location::current());
+
+    /// @brief 整数座標の点をまとめて変換（結果は Vec2::to_point と同じく四捨五入）
+    void transform(const Mat3& matrix, std::span<const Point2i> src, std::span<Point2i> dst,
+                   const std::source_location& location = std::source_location::current());
+
+    /// @brief Quad の4頂点をまとめて変換（gsquare 用の頂点を一度に作成）
+    void transform(const Mat3& matrix, std::span<const Quad> src, std::span<Quad> dst,
+                   const std::source_location& location = std::source_location::current());
+
+}  // namespace hsppp
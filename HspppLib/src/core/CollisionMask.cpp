@@ -0,0 +1,190 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/CollisionMask.cpp
+// ピクセル単位の当たり判定マスクの実装
+// Win32 API を使用しないプラットフォーム非依存の実装。作成と判定は SSE2 で処理する
+
+#include "CollisionMask.h"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HSPPP_HAS_SSE2 1
+#endif
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+// ============================================================
+// 補助
+// ============================================================
+
+inline bool isSolid(uint32_t pixel, uint32_t alphaThreshold, int colorKey) noexcept {
+    return (pixel >> 24) >= alphaThreshold &&
+           (colorKey < 0 || (pixel & 0xFFFFFFu) != static_cast<uint32_t>(colorKey));
+}
+
+// 行の offset ビット目から 64 ビットを取り出す（行の外は 0）
+inline uint64_t fetchBits(const uint64_t* row, size_t words, int64_t offset) noexcept {
+    const int64_t index = offset >> 6;      // 負の値も切り捨て
+    const int shift = static_cast<int>(offset & 63);
+    auto word = [&](int64_t i) -> uint64_t {
+        return (i >= 0 && i < static_cast<int64_t>(words)) ? row[i] : 0;
+    };
+    const uint64_t lo = word(index) >> shift;
+    const uint64_t hi = shift != 0 ? word(index + 1) << (64 - shift) : 0;
+    return lo | hi;
+}
+
+} // namespace
+
+// ============================================================
+// 作成
+// ============================================================
+
+void BuildMask(const uint32_t* pixels, size_t stride, int width, int height,
+               int alphaThreshold, int colorKey, uint64_t* bits) noexcept {
+    const size_t wordsPerRow = MaskWordsPerRow(width);
+    const uint32_t threshold = static_cast<uint32_t>(std::clamp(alphaThreshold, 0, 256));
+#ifdef HSPPP_HAS_SSE2
+    // alpha は 0～255 なので符号付き比較で alpha > threshold - 1 を判定できる
+    const __m128i thresholdMinusOne = _mm_set1_epi32(static_cast<int>(threshold) - 1);
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i key = _mm_set1_epi32(colorKey);
+    const bool useKey = colorKey >= 0;
+#endif
+    for (int y = 0; y < height; ++y) {
+        const uint32_t* src = pixels + static_cast<size_t>(y) * stride;
+        uint64_t* dst = bits + static_cast<size_t>(y) * wordsPerRow;
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            const int x0 = static_cast<int>(w * 64);
+            const int count = std::min(64, width - x0);
+            uint64_t word = 0;
+            int i = 0;
+#ifdef HSPPP_HAS_SSE2
+            for (; i + 4 <= count; i += 4) {
+                const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x0 + i));
+                __m128i solid = _mm_cmpgt_epi32(_mm_srli_epi32(p, 24), thresholdMinusOne);
+                if (useKey) {
+                    solid = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(p, rgbMask), key), solid);
+                }
+                word |= static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(solid))) << i;
+            }
+#endif
+            for (; i < count; ++i) {
+                if (isSolid(src[x0 + i], threshold, colorKey)) {
+                    word |= uint64_t{1} << i;
+                }
+            }
+            dst[w] = word;
+        }
+    }
+}
+
+void CopyMaskRect(const uint64_t* src, size_t srcWordsPerRow, int x, int y, int width, int height,
+                  uint64_t* dst) noexcept {
+    const size_t wordsPerRow = MaskWordsPerRow(width);
+    for (int row = 0; row < height; ++row) {
+        const uint64_t* s = src + static_cast<size_t>(y + row) * srcWordsPerRow;
+        uint64_t* d = dst + static_cast<size_t>(row) * wordsPerRow;
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            d[w] = fetchBits(s, srcWordsPerRow, static_cast<int64_t>(x) + static_cast<int64_t>(w) * 64);
+        }
+        // 幅を超える余りのビットを落とす
+        if (const int tail = width & 63; tail != 0 && wordsPerRow > 0) {
+            d[wordsPerRow - 1] &= (uint64_t{1} << tail) - 1;
+        }
+    }
+}
+
+void MaskBounds(const uint64_t* bits, size_t wordsPerRow, int height,
+                int& left, int& top, int& right, int& bottom) noexcept {
+    int minX = INT32_MAX, minY = INT32_MAX, maxX = -1, maxY = -1;
+    for (int y = 0; y < height; ++y) {
+        const uint64_t* row = bits + static_cast<size_t>(y) * wordsPerRow;
+        for (size_t w = 0; w < wordsPerRow; ++w) {
+            if (row[w] == 0) {
+                continue;
+            }
+            const int base = static_cast<int>(w * 64);
+            minX = std::min(minX, base + std::countr_zero(row[w]));
+            maxX = std::max(maxX, base + 63 - std::countl_zero(row[w]));
+            minY = std::min(minY, y);
+            maxY = y;
+        }
+    }
+    if (maxY < 0) {
+        left = top = right = bottom = 0;
+        return;
+    }
+    left = minX;
+    top = minY;
+    right = maxX + 1;
+    bottom = maxY + 1;
+}
+
+// ============================================================
+// 判定
+// ============================================================
+
+bool MasksOverlap(const MaskView& a, int ax, int ay, const MaskView& b, int bx, int by) noexcept {
+    // 外接矩形同士の重なり（a の座標系）
+    const int64_t dx = static_cast<int64_t>(bx) - ax;
+    const int64_t dy = static_cast<int64_t>(by) - ay;
+    const int64_t left = std::max<int64_t>(a.left, b.left + dx);
+    const int64_t right = std::min<int64_t>(a.right, b.right + dx);
+    const int64_t top = std::max<int64_t>(a.top, b.top + dy);
+    const int64_t bottom = std::min<int64_t>(a.bottom, b.bottom + dy);
+    if (left >= right || top >= bottom) {
+        return false;
+    }
+
+    // a の x 列目は b の (x - dx) 列目に当たる。外接矩形の外はどちらかのビットが必ず 0 なので、
+    // 重なる範囲を含むワードだけを端の処理なしで AND すればよい
+    const size_t firstWord = static_cast<size_t>(left >> 6);
+    const size_t lastWord = static_cast<size_t>((right - 1) >> 6);
+    for (int64_t y = top; y < bottom; ++y) {
+        const uint64_t* aRow = a.bits + static_cast<size_t>(y) * a.wordsPerRow;
+        const uint64_t* bRow = b.bits + static_cast<size_t>(y - dy) * b.wordsPerRow;
+        size_t w = firstWord;
+#ifdef HSPPP_HAS_SSE2
+        // b の行内に収まる区間は2ワードずつ: (b[q] >> s) | (b[q + 1] << (64 - s))
+        // （シフト量 64 の左シフトは SSE2 では 0 になるため s = 0 でも分岐不要）
+        const int64_t shift = -dx;
+        const int s = static_cast<int>(shift & 63);
+        const __m128i shiftRight = _mm_cvtsi32_si128(s);
+        const __m128i shiftLeft = _mm_cvtsi32_si128(64 - s);
+        __m128i hit = _mm_setzero_si128();
+        for (; w + 2 <= lastWord + 1; w += 2) {
+            const int64_t q = (static_cast<int64_t>(w) * 64 + shift) >> 6;
+            if (q < 0 || q + 3 > static_cast<int64_t>(b.wordsPerRow)) {
+                break;
+            }
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bRow + q));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bRow + q + 1));
+            const __m128i shifted = _mm_or_si128(_mm_srl_epi64(lo, shiftRight), _mm_sll_epi64(hi, shiftLeft));
+            hit = _mm_or_si128(hit, _mm_and_si128(shifted, _mm_loadu_si128(reinterpret_cast<const __m128i*>(aRow + w))));
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(hit, _mm_setzero_si128())) != 0xFFFF) {
+            return true;
+        }
+#endif
+        for (; w <= lastWord; ++w) {
+            if (aRow[w] & fetchBits(bRow, b.wordsPerRow, static_cast<int64_t>(w) * 64 - dx)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,68 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/CollisionMask.h
+// ピクセル単位の当たり判定マスク（1ピクセル1ビット）の内部API
+// BGRA ピクセルからのマスク生成、矩形の切り出し、不透明領域の外接矩形、2 マスクの重なり判定を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// マスクの表現
+// ============================================================
+// 各行を 64bit ワードの配列に詰める。x 列目は (x / 64) 番目のワードの (x % 64) ビット目。
+// 行の長さは MaskWordsPerRow(width) ワードで、幅を超える余りのビットは常に 0
+
+constexpr size_t MaskWordsPerRow(int width) noexcept {
+    return width > 0 ? (static_cast<size_t>(width) + 63) / 64 : 0;
+}
+
+// 判定に使うマスクの参照
+struct MaskView {
+    const uint64_t* bits = nullptr;
+    size_t wordsPerRow = 0;
+    int width = 0;
+    int height = 0;
+    // 立っているビットの外接矩形（right / bottom は含まない。空なら left >= right）
+    int left = 0;
+    int top = 0;
+    int right = 0;
+    int bottom = 0;
+};
+
+// ============================================================
+// 作成
+// ============================================================
+
+// BGRA の画素（stride は1行の画素数）から作成する。
+// alpha が alphaThreshold 以上で、colorKey（0xRRGGBB、負なら無効）と異なる画素を 1 にする（SSE2 で4画素ずつ処理）
+void BuildMask(const uint32_t* pixels, size_t stride, int width, int height,
+               int alphaThreshold, int colorKey, uint64_t* bits) noexcept;
+
+// src の (x, y) から width x height の範囲を切り出す（範囲はマスク内に収まっていること）
+void CopyMaskRect(const uint64_t* src, size_t srcWordsPerRow, int x, int y, int width, int height,
+                  uint64_t* dst) noexcept;
+
+// 立っているビットの外接矩形を求める（空なら 0, 0, 0, 0）
+void MaskBounds(const uint64_t* bits, size_t wordsPerRow, int height,
+                int& left, int& top, int& right, int& bottom) noexcept;
+
+// ============================================================
+// 判定
+// ============================================================
+
+// a を (ax, ay)、b を (bx, by) に置いたときに重なるビットがあるか。
+// 外接矩形が重ならなければ即座に false。重なる行だけ b の行をずらして AND を取る（SSE2 で2ワードずつ処理）
+bool MasksOverlap(const MaskView& a, int ax, int ay, const MaskView& b, int bx, int by) noexcept;
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,291 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/ColorConvert.cpp
+// 色空間変換（HSV / RGB / BGRA / 乗算済みアルファ）の実装
+// Win32 API を使用しないプラットフォーム非依存の実装。主要な変換は SSE2 で4画素ずつ処理する
+
+#include "ColorConvert.h"
+
+#include <algorithm>
+#include <array>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HSPPP_HAS_SSE2 1
+#endif
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+// ============================================================
+// 補助
+// ============================================================
+
+// 0～255 の 8bit 値同士の積を 255 で割って丸める（c * a / 255 の四捨五入と一致）
+constexpr uint32_t mulDiv255(uint32_t c, uint32_t a) noexcept {
+    const uint32_t x = c * a + 128;
+    return (x + (x >> 8)) >> 8;
+}
+
+// 逆乗算用の逆数表: kUnpremultiplyScale[a] = ceil(2^24 / a)
+// x < 2^24 / a（x ≦ 255 * 255 + 127）の範囲で (x * scale) >> 24 が x / a の切り捨てと一致する
+constexpr int kUnpremultiplyShift = 24;
+constexpr std::array<uint64_t, 256> kUnpremultiplyScale = [] {
+    std::array<uint64_t, 256> table{};
+    for (uint64_t a = 1; a < 256; ++a) {
+        table[a] = ((uint64_t{1} << kUnpremultiplyShift) + a - 1) / a;
+    }
+    return table;
+}();
+
+uint32_t unpremultiplyChannel(uint32_t c, uint32_t a) noexcept {
+    const uint64_t x = c * 255 + a / 2;
+    const uint32_t result = static_cast<uint32_t>((x * kUnpremultiplyScale[a]) >> kUnpremultiplyShift);
+    return result > 255 ? 255 : result;
+}
+
+#ifdef HSPPP_HAS_SSE2
+inline __m128i select(__m128i mask, __m128i a, __m128i b) noexcept {
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// SSE2 に 32bit 整数の min/max がないため、比較と選択で [0, hi] に丸め込む
+inline __m128i clampInt(__m128i x, __m128i hi) noexcept {
+    x = _mm_and_si128(x, _mm_cmpgt_epi32(x, _mm_set1_epi32(-1)));
+    return select(_mm_cmpgt_epi32(x, hi), hi, x);
+}
+#endif
+
+} // namespace
+
+// ============================================================
+// HSV ⇔ RGB
+// ============================================================
+
+int HsvToRgb(int h, int s, int v) noexcept {
+    h = std::clamp(h, 0, kHsvHueSteps - 1);
+    s = std::clamp(s, 0, 255);
+    v = std::clamp(v, 0, 255);
+
+    if (s == 0) {
+        // 彩度0の場合はグレースケール
+        return (v << 16) | (v << 8) | v;
+    }
+
+    // 一括版と結果を揃えるため、演算の順序と精度（float）を変えないこと
+    const float hue = h * 360.0f / 192.0f;
+    const float sat = s / 255.0f;
+    const float val = v / 255.0f;
+    const float h6 = hue / 60.0f;
+    const int hi = static_cast<int>(h6);
+    const float f = h6 - static_cast<float>(hi);
+    const int vi = static_cast<int>(val * 255.0f);
+    const int pi = static_cast<int>(val * (1.0f - sat) * 255.0f);
+    const int qi = static_cast<int>(val * (1.0f - sat * f) * 255.0f);
+    const int ti = static_cast<int>(val * (1.0f - sat * (1.0f - f)) * 255.0f);
+
+    int r, g, b;
+    switch (hi) {
+        case 0:  r = vi; g = ti; b = pi; break;
+        case 1:  r = qi; g = vi; b = pi; break;
+        case 2:  r = pi; g = vi; b = ti; break;
+        case 3:  r = pi; g = qi; b = vi; break;
+        case 4:  r = ti; g = pi; b = vi; break;
+        default: r = vi; g = pi; b = qi; break;
+    }
+    return (r << 16) | (g << 8) | b;
+}
+
+void ConvertHsvToRgb(const int* h, const int* s, const int* v, size_t count, int* rgb) noexcept {
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    const __m128i maxHue = _mm_set1_epi32(kHsvHueSteps - 1);
+    const __m128i max8 = _mm_set1_epi32(255);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(255.0f);
+    const __m128i sextant[6] = {
+        _mm_set1_epi32(0), _mm_set1_epi32(1), _mm_set1_epi32(2),
+        _mm_set1_epi32(3), _mm_set1_epi32(4), _mm_set1_epi32(5),
+    };
+    for (; i + 4 <= count; i += 4) {
+        const __m128i hv = clampInt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i)), maxHue);
+        const __m128i sv = clampInt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)), max8);
+        const __m128i vv = clampInt(_mm_loadu_si128(reinterpret_cast<const __m128i*>(v + i)), max8);
+
+        // HsvToRgb と同じ順序で float 演算する（結果はビット単位で一致する）
+        const __m128 hue = _mm_div_ps(_mm_mul_ps(_mm_cvtepi32_ps(hv), _mm_set1_ps(360.0f)), _mm_set1_ps(192.0f));
+        const __m128 sat = _mm_div_ps(_mm_cvtepi32_ps(sv), scale);
+        const __m128 val = _mm_div_ps(_mm_cvtepi32_ps(vv), scale);
+        const __m128 h6 = _mm_div_ps(hue, _mm_set1_ps(60.0f));
+        const __m128i hi = _mm_cvttps_epi32(h6);
+        const __m128 f = _mm_sub_ps(h6, _mm_cvtepi32_ps(hi));
+
+        const __m128i vi = _mm_cvttps_epi32(_mm_mul_ps(val, scale));
+        const __m128i pi = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(val, _mm_sub_ps(one, sat)), scale));
+        const __m128i qi = _mm_cvttps_epi32(_mm_mul_ps(_mm_mul_ps(val, _mm_sub_ps(one, _mm_mul_ps(sat, f))), scale));
+        const __m128i ti = _mm_cvttps_epi32(_mm_mul_ps(
+            _mm_mul_ps(val, _mm_sub_ps(one, _mm_mul_ps(sat, _mm_sub_ps(one, f)))), scale));
+
+        __m128i is[6];
+        for (int k = 0; k < 6; ++k) {
+            is[k] = _mm_cmpeq_epi32(hi, sextant[k]);
+        }
+        __m128i r = select(_mm_or_si128(is[0], is[5]), vi, select(is[1], qi, select(is[4], ti, pi)));
+        __m128i g = select(_mm_or_si128(is[1], is[2]), vi, select(is[0], ti, select(is[3], qi, pi)));
+        __m128i b = select(_mm_or_si128(is[3], is[4]), vi, select(is[2], ti, select(is[5], qi, pi)));
+
+        // 彩度0はグレースケール
+        const __m128i grey = _mm_cmpeq_epi32(sv, _mm_setzero_si128());
+        r = select(grey, vv, r);
+        g = select(grey, vv, g);
+        b = select(grey, vv, b);
+
+        const __m128i packed = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(g, 8)), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + i), packed);
+    }
+#endif
+    for (; i < count; ++i) {
+        rgb[i] = HsvToRgb(h[i], s[i], v[i]);
+    }
+}
+
+void ConvertRgbToHsv(const int* rgb, size_t count, int* h, int* s, int* v) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        const int r = (rgb[i] >> 16) & 0xFF;
+        const int g = (rgb[i] >> 8) & 0xFF;
+        const int b = rgb[i] & 0xFF;
+        const int maxC = std::max({ r, g, b });
+        const int minC = std::min({ r, g, b });
+        const int d = maxC - minC;
+
+        v[i] = maxC;
+        s[i] = maxC == 0 ? 0 : (d * 255 + maxC / 2) / maxC;
+        if (d == 0) {
+            h[i] = 0;
+            continue;
+        }
+
+        // 色相を 0～6d の範囲で求め、192 段階（1区間 = 32 段階）に丸める
+        int hue;
+        if (maxC == r) {
+            hue = g - b;
+            if (hue < 0) hue += 6 * d;
+        } else if (maxC == g) {
+            hue = 2 * d + (b - r);
+        } else {
+            hue = 4 * d + (r - g);
+        }
+        const int step = (hue * 64 + d) / (2 * d);
+        h[i] = step >= kHsvHueSteps ? step - kHsvHueSteps : step;
+    }
+}
+
+void FillHsvHueTable(int s, int v, int* dst) noexcept {
+    std::array<int, kHsvHueSteps> hue;
+    std::array<int, kHsvHueSteps> sat;
+    std::array<int, kHsvHueSteps> val;
+    for (int i = 0; i < kHsvHueSteps; ++i) {
+        hue[i] = i;
+    }
+    sat.fill(s);
+    val.fill(v);
+    ConvertHsvToRgb(hue.data(), sat.data(), val.data(), kHsvHueSteps, dst);
+}
+
+// ============================================================
+// RGB ⇔ BGRA
+// ============================================================
+
+void ConvertRgbToBgra(const int* rgb, size_t count, uint32_t* bgra, int alpha) noexcept {
+    const uint32_t alphaBits = static_cast<uint32_t>(std::clamp(alpha, 0, 255)) << 24;
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i alphaVec = _mm_set1_epi32(static_cast<int>(alphaBits));
+    for (; i + 4 <= count; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i), _mm_or_si128(_mm_and_si128(x, colorMask), alphaVec));
+    }
+#endif
+    for (; i < count; ++i) {
+        bgra[i] = (static_cast<uint32_t>(rgb[i]) & 0x00FFFFFFu) | alphaBits;
+    }
+}
+
+void ConvertBgraToRgb(const uint32_t* bgra, size_t count, int* rgb) noexcept {
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    const __m128i colorMask = _mm_set1_epi32(0x00FFFFFF);
+    for (; i + 4 <= count; i += 4) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bgra + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(rgb + i), _mm_and_si128(x, colorMask));
+    }
+#endif
+    for (; i < count; ++i) {
+        rgb[i] = static_cast<int>(bgra[i] & 0x00FFFFFFu);
+    }
+}
+
+// ============================================================
+// 乗算済みアルファ
+// ============================================================
+
+void PremultiplyBgra(uint32_t* pixels, size_t count) noexcept {
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    // 16bit に広げて 2画素ずつ B,G,R にアルファを掛ける（A 自身には 255 を掛けて値を保つ）
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i colorLanes = _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+    const __m128i alphaLanes = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    const __m128i bias = _mm_set1_epi16(128);
+    auto multiply = [&](__m128i px) {
+        __m128i a = _mm_shufflelo_epi16(px, _MM_SHUFFLE(3, 3, 3, 3));
+        a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+        a = _mm_or_si128(_mm_and_si128(a, colorLanes), alphaLanes);
+        const __m128i x = _mm_add_epi16(_mm_mullo_epi16(px, a), bias);
+        return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+    };
+    for (; i + 4 <= count; i += 4) {
+        const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+        const __m128i lo = multiply(_mm_unpacklo_epi8(px, zero));
+        const __m128i hi = multiply(_mm_unpackhi_epi8(px, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for (; i < count; ++i) {
+        const uint32_t p = pixels[i];
+        const uint32_t a = p >> 24;
+        const uint32_t b = mulDiv255(p & 0xFF, a);
+        const uint32_t g = mulDiv255((p >> 8) & 0xFF, a);
+        const uint32_t r = mulDiv255((p >> 16) & 0xFF, a);
+        pixels[i] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+void UnpremultiplyBgra(uint32_t* pixels, size_t count) noexcept {
+    // アルファごとの除算を逆数表の乗算に置き換える（不透明・透明の画素は表引きも省く）
+    for (size_t i = 0; i < count; ++i) {
+        const uint32_t p = pixels[i];
+        const uint32_t a = p >> 24;
+        if (a == 255) {
+            continue;
+        }
+        if (a == 0) {
+            pixels[i] = 0;
+            continue;
+        }
+        const uint32_t b = unpremultiplyChannel(p & 0xFF, a);
+        const uint32_t g = unpremultiplyChannel((p >> 8) & 0xFF, a);
+        const uint32_t r = unpremultiplyChannel((p >> 16) & 0xFF, a);
+        pixels[i] = (a << 24) | (r << 16) | (g << 8) | b;
+    }
+}
+
+} // namespace internal
+} // namespace hsppp
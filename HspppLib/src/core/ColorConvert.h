@@ -0,0 +1,58 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/ColorConvert.h
+// 色空間変換（HSV / RGB / BGRA / 乗算済みアルファ）の内部API
+// 単色・配列単位の HSV/RGB 変換、色相表の生成、BGRA との相互変換と乗算済みアルファの変換を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// 色の表現
+// ============================================================
+// RGB  : 0xRRGGBB の int（rgbcolor / ginfo と同じ並び）
+// BGRA : メモリ上 B,G,R,A の順に並ぶ 32bit（リトルエンディアンで 0xAARRGGBB）
+// HSV  : H 0～191、S 0～255、V 0～255（hsvcolor と同じ範囲）
+
+constexpr int kHsvHueSteps = 192;
+
+// hsvcolor と同じ計算で HSV を RGB に変換する（範囲外の値は丸め込む）
+int HsvToRgb(int h, int s, int v) noexcept;
+
+// ============================================================
+// 一括変換（count 要素ずつ。入出力の重なりは不可）
+// ============================================================
+
+// HSV → RGB。結果は HsvToRgb と完全に一致する（SSE2 で4要素ずつ処理）
+void ConvertHsvToRgb(const int* h, const int* s, const int* v, size_t count, int* rgb) noexcept;
+
+// RGB → HSV。H は最も近い段階に丸める（HsvToRgb の逆変換として往復で色がずれにくい）
+void ConvertRgbToHsv(const int* rgb, size_t count, int* h, int* s, int* v) noexcept;
+
+// 色相方向の 192 段階テーブル（dst[h] = HsvToRgb(h, s, v)）
+void FillHsvHueTable(int s, int v, int* dst) noexcept;
+
+// RGB → BGRA（alpha は 0～255 に丸め込む）/ BGRA → RGB（アルファは捨てる）
+void ConvertRgbToBgra(const int* rgb, size_t count, uint32_t* bgra, int alpha) noexcept;
+void ConvertBgraToRgb(const uint32_t* bgra, size_t count, int* rgb) noexcept;
+
+// ============================================================
+// 乗算済みアルファ（その場で変換）
+// ============================================================
+// 乗算: c' = round(c * a / 255)
+// 逆変換: c = min(255, round(c' * 255 / a))、a = 0 の画素は全成分 0
+
+void PremultiplyBgra(uint32_t* pixels, size_t count) noexcept;
+void UnpremultiplyBgra(uint32_t* pixels, size_t count) noexcept;
+
+} // namespace internal
+} // namespace hsppp
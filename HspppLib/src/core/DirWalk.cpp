@@ -0,0 +1,483 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/DirWalk.cpp
+// ディレクトリの並列再帰走査の実装
+// 作業スレッドは未走査のディレクトリのスタックから1つずつ取り出して列挙し、見つけたサブディレクトリをスタックに戻す。
+// 条件に合うエントリーはまとめて上限付きのキューに入れ、呼び出し元のスレッドが取り出して consume に渡す
+
+#include "DirWalk.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include "Transcode.h"
+#else
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hsppp {
+namespace internal {
+
+bool DirModeAccepts(int mode, uint32_t flags) noexcept {
+    const bool isDir = (flags & kDirEntryDirectory) != 0;
+    const bool isHiddenOrSystem = (flags & (kDirEntryHidden | kDirEntrySystem)) != 0;
+    switch (mode) {
+        case 1:  return !isDir;                         // ディレクトリを除く
+        case 2:  return !isHiddenOrSystem;              // 隠し・システム属性を除く
+        case 3:  return !isDir && !isHiddenOrSystem;    // ディレクトリ・隠し・システム属性を除く
+        case 5:  return isDir;                          // ディレクトリのみ
+        case 6:  return isHiddenOrSystem;               // 隠し・システム属性のみ
+        case 7:  return isDir || isHiddenOrSystem;      // ディレクトリと隠し・システム属性のみ
+        default: return true;                           // 0 とその他: すべて
+    }
+}
+
+namespace {
+
+#ifdef _WIN32
+using NativeString = std::u16string;
+constexpr char16_t kNativeSeparator = u'\\';
+#else
+using NativeString = std::string;
+constexpr char kNativeSeparator = '/';
+#endif
+
+constexpr size_t kMaxWalkThreads = 8;
+
+struct DirTask {
+    std::string path;       // 起点からの相対パス（起点は空）
+    NativeString native;    // 開くときのパス
+};
+
+NativeString joinNative(const NativeString& dir, std::basic_string_view<NativeString::value_type> name) {
+    NativeString result;
+    result.reserve(dir.size() + 1 + name.size());
+    result = dir;
+    if (!result.empty() && result.back() != kNativeSeparator && result.back() != '/') {
+        result += kNativeSeparator;
+    }
+    result += name;
+    return result;
+}
+
+class Walker {
+public:
+    Walker(const DirWalkOptions& options, NativeString pattern)
+        : options_(options), pattern_(std::move(pattern)),
+          capacity_(std::max<size_t>(options.queueCapacity, kDirWalkBatchSize)) {}
+
+    void pushRoot(NativeString native) {
+        dirs_.push_back({ std::string(), std::move(native) });
+    }
+
+    // 作業スレッドの本体。未走査のディレクトリがなくなり、走査中のスレッドもなくなったら終わる
+    void workerLoop() {
+        std::vector<DirTask> subdirs;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            work_.wait(lock, [this] { return stopped_ || !dirs_.empty() || busy_ == 0; });
+            if (stopped_ || dirs_.empty()) {
+                break;
+            }
+            DirTask task = std::move(dirs_.back());
+            dirs_.pop_back();
+            ++busy_;
+            lock.unlock();
+
+            subdirs.clear();
+            scan(task, subdirs);
+
+            lock.lock();
+            --busy_;
+            for (DirTask& dir : subdirs) {
+                dirs_.push_back(std::move(dir));
+            }
+            if (!subdirs.empty() || busy_ == 0) {
+                work_.notify_all();
+            }
+        }
+        if (--workersLeft_ == 0) {
+            output_.notify_all();
+        }
+    }
+
+    // 呼び出し元のスレッドでまとめたエントリーを取り出して consume に渡す
+    // consume が例外を送出した場合も走査を中止してから送出する（作業スレッドはすぐに終わり、join できる）
+    bool consumeLoop(const std::function<bool(std::span<DirWalkEntry>)>& consume) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            output_.wait(lock, [this] { return !batches_.empty() || workersLeft_ == 0; });
+            if (batches_.empty()) {
+                return true;
+            }
+            std::vector<DirWalkEntry> batch = std::move(batches_.front());
+            batches_.pop_front();
+            queued_ -= batch.size();
+            space_.notify_all();
+            lock.unlock();
+
+            bool proceed = false;
+            try {
+                proceed = consume(batch);
+            } catch (...) {
+                lock.lock();
+                stopLocked();
+                throw;
+            }
+
+            lock.lock();
+            if (!proceed) {
+                stopLocked();
+                return false;
+            }
+        }
+    }
+
+    void setWorkerCount(size_t count) { workersLeft_ = count; }
+
+    // 作成できなかった作業スレッドを終了したものとして数える
+    void abandonWorkers(size_t count) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        workersLeft_ -= count;
+        if (workersLeft_ == 0) {
+            output_.notify_all();
+        }
+    }
+
+    // スレッドを作れなかった場合、呼び出し元だけで走査する（キューは上限なし）
+    void runInline(const std::function<bool(std::span<DirWalkEntry>)>& consume, bool& completed) {
+        capacity_ = SIZE_MAX;
+        workersLeft_ = 1;
+        workerLoop();
+        completed = consumeLoop(consume);
+    }
+
+private:
+    // 走査を中止し、待っている作業スレッドを起こす（mutex_ を保持して呼ぶ）
+    void stopLocked() {
+        stopped_ = true;
+        batches_.clear();
+        work_.notify_all();
+        space_.notify_all();
+    }
+
+    // 1つのディレクトリを列挙する
+    void scan(const DirTask& task, std::vector<DirTask>& subdirs);
+
+    // 条件に合うエントリーを1つ追加する。キューが一杯なら空くまで待つ。走査をやめる場合は false
+    bool add(DirWalkEntry&& entry) {
+        batch_().push_back(std::move(entry));
+        if (batch_().size() < kDirWalkBatchSize) {
+            return true;
+        }
+        return flush();
+    }
+
+    bool flush() {
+        std::vector<DirWalkEntry>& batch = batch_();
+        if (batch.empty()) {
+            return true;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_.wait(lock, [this] { return stopped_ || queued_ < capacity_; });
+        if (stopped_) {
+            batch.clear();
+            return false;
+        }
+        queued_ += batch.size();
+        batches_.push_back(std::move(batch));
+        batch = {};
+        output_.notify_one();
+        return true;
+    }
+
+    // 作業スレッドごとのまとめ中のエントリー
+    static std::vector<DirWalkEntry>& batch_() {
+        thread_local std::vector<DirWalkEntry> s_batch;
+        return s_batch;
+    }
+
+    // name が条件に合う場合に、DirWalkEntry の path を作る
+    static std::string childPath(const std::string& parent, std::string_view utf8Name) {
+        std::string path;
+        path.reserve(parent.size() + 1 + utf8Name.size());
+        path = parent;
+        if (!path.empty()) {
+            path += '/';
+        }
+        path += utf8Name;
+        return path;
+    }
+
+    const DirWalkOptions& options_;
+    const NativeString pattern_;
+    size_t capacity_;
+
+    std::mutex mutex_;
+    std::condition_variable work_;      // 未走査のディレクトリが増えた・走査が終わった
+    std::condition_variable output_;    // まとめたエントリーが増えた・作業スレッドが終わった
+    std::condition_variable space_;     // キューに空きができた・中止された
+    std::vector<DirTask> dirs_;         // 未走査のディレクトリ（深さ優先で取り出す）
+    size_t busy_ = 0;                   // 走査中の作業スレッドの数
+    size_t workersLeft_ = 0;            // 終了していない作業スレッドの数
+    std::deque<std::vector<DirWalkEntry>> batches_;
+    size_t queued_ = 0;                 // batches_ のエントリーの合計
+    bool stopped_ = false;
+};
+
+#ifdef _WIN32
+
+// FILETIME（1601-01-01 からの 100ns 単位）を 1970-01-01 からのミリ秒に
+int64_t fileTimeToUnixMs(const FILETIME& time) noexcept {
+    const int64_t ticks = (static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    return (ticks - 116444736000000000LL) / 10000;
+}
+
+void Walker::scan(const DirTask& task, std::vector<DirTask>& subdirs) {
+    const NativeString query = joinNative(task.native, u"*");
+    WIN32_FIND_DATAW findData;
+    // 短い名前は取得せず、大きなバッファでまとめて取得する
+    HANDLE hFind = FindFirstFileExW(reinterpret_cast<const wchar_t*>(query.c_str()), FindExInfoBasic, &findData,
+                                    FindExSearchNameMatch, nullptr, FIND_FIRST_EX_LARGE_FETCH);
+    if (hFind == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    std::string utf8Name;
+    bool proceed = true;
+    do {
+        const std::u16string_view name(reinterpret_cast<const char16_t*>(findData.cFileName));
+        if (name == u"." || name == u"..") {
+            continue;
+        }
+
+        const DWORD attributes = findData.dwFileAttributes;
+        uint32_t flags = 0;
+        if (attributes & FILE_ATTRIBUTE_DIRECTORY) flags |= kDirEntryDirectory;
+        if (attributes & FILE_ATTRIBUTE_HIDDEN) flags |= kDirEntryHidden;
+        if (attributes & FILE_ATTRIBUTE_SYSTEM) flags |= kDirEntrySystem;
+
+        // シンボリックリンク・ジャンクションの先はたどらない（循環を避ける）
+        const bool descend = options_.recursive && (flags & kDirEntryDirectory) &&
+                             !(attributes & FILE_ATTRIBUTE_REPARSE_POINT);
+        const bool include = DirModeAccepts(options_.mode, flags) &&
+                             MatchGlob(std::u16string_view(pattern_), name);
+        if (!descend && !include) {
+            continue;   // 条件に合わない名前は UTF-8 に変換しない
+        }
+
+        Utf16ToUtf8Into(name, utf8Name);
+        std::string path = childPath(task.path, utf8Name);
+        if (descend) {
+            subdirs.push_back({ path, joinNative(task.native, name) });
+        }
+        if (include) {
+            DirWalkEntry entry;
+            entry.path = std::move(path);
+            entry.size = (flags & kDirEntryDirectory) ? 0 :
+                ((static_cast<uint64_t>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow);
+            entry.mtimeMs = fileTimeToUnixMs(findData.ftLastWriteTime);
+            entry.flags = flags;
+            proceed = add(std::move(entry));
+        }
+    } while (proceed && FindNextFileW(hFind, &findData));
+
+    FindClose(hFind);
+    if (proceed) {
+        flush();
+    }
+}
+
+#else
+
+void Walker::scan(const DirTask& task, std::vector<DirTask>& subdirs) {
+    const int fd = ::open(task.native.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    DIR* dir = ::fdopendir(fd);
+    if (!dir) {
+        ::close(fd);
+        return;
+    }
+
+    bool proceed = true;
+    while (proceed) {
+        const dirent* ent = ::readdir(dir);
+        if (!ent) {
+            break;
+        }
+        const std::string_view name(ent->d_name);
+        if (name == "." || name == "..") {
+            continue;
+        }
+
+        struct stat st;
+        bool statDone = false;
+        unsigned char type = ent->d_type;
+        if (type == DT_UNKNOWN) {
+            if (::fstatat(fd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            statDone = true;
+            type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISLNK(st.st_mode) ? DT_LNK : DT_REG;
+        }
+
+        uint32_t flags = 0;
+        if (type == DT_DIR) flags |= kDirEntryDirectory;
+        if (name[0] == '.') flags |= kDirEntryHidden;
+
+        // シンボリックリンクの先はたどらない（循環を避ける）
+        const bool descend = options_.recursive && type == DT_DIR;
+        const bool include = DirModeAccepts(options_.mode, flags) && MatchGlob(std::string_view(pattern_), name);
+        if (!descend && !include) {
+            continue;
+        }
+
+        std::string path = childPath(task.path, name);
+        if (descend) {
+            subdirs.push_back({ path, joinNative(task.native, name) });
+        }
+        if (include) {
+            // 大きさと時刻は条件に合うエントリーだけ取得する
+            if (!statDone && ::fstatat(fd, ent->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            DirWalkEntry entry;
+            entry.path = std::move(path);
+            entry.size = (flags & kDirEntryDirectory) ? 0 : static_cast<uint64_t>(st.st_size);
+            entry.mtimeMs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+            entry.flags = flags;
+            proceed = add(std::move(entry));
+        }
+    }
+
+    ::closedir(dir);
+    if (proceed) {
+        flush();
+    }
+}
+
+#endif
+
+// 起点を開くためのパス（末尾の区切りは除く。ルートディレクトリはそのまま）
+NativeString rootNative(std::string_view utf8Root) {
+    std::string_view trimmed = utf8Root;
+    while (trimmed.size() > 1 && (trimmed.back() == '/' || trimmed.back() == '\\')) {
+        trimmed.remove_suffix(1);
+    }
+    if (trimmed.empty()) {
+        trimmed = ".";
+    }
+#ifdef _WIN32
+    NativeString native;
+    Utf8ToUtf16Into(trimmed, native);
+    return native;
+#else
+    return NativeString(trimmed);
+#endif
+}
+
+bool isDirectory(const NativeString& native, uint32_t& systemError) {
+#ifdef _WIN32
+    const DWORD attributes = GetFileAttributesW(reinterpret_cast<const wchar_t*>(native.c_str()));
+    if (attributes == INVALID_FILE_ATTRIBUTES) {
+        systemError = GetLastError();
+        return false;
+    }
+    if (!(attributes & FILE_ATTRIBUTE_DIRECTORY)) {
+        systemError = ERROR_DIRECTORY;
+        return false;
+    }
+#else
+    struct stat st;
+    if (::stat(native.c_str(), &st) != 0) {
+        systemError = static_cast<uint32_t>(errno);
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        systemError = ENOTDIR;
+        return false;
+    }
+#endif
+    return true;
+}
+
+} // namespace
+
+DirWalkStatus WalkDirectory(std::string_view utf8Root, const DirWalkOptions& options,
+                            const std::function<bool(std::span<DirWalkEntry>)>& consume, uint32_t& systemError) {
+    systemError = 0;
+    NativeString native = rootNative(utf8Root);
+    if (!isDirectory(native, systemError)) {
+        return DirWalkStatus::OpenFailed;
+    }
+
+#ifdef _WIN32
+    NativeString pattern;
+    Utf8ToUtf16Into(options.pattern, pattern);
+#else
+    NativeString pattern = options.pattern;
+#endif
+    Walker walker(options, std::move(pattern));
+    walker.pushRoot(std::move(native));
+
+    // 再帰しない場合は1つのディレクトリだけのため1本で足りる
+    const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+    const size_t threadCount = !options.recursive ? 1 :
+        std::clamp<size_t>(options.threads > 0 ? options.threads : hardware, 1, kMaxWalkThreads);
+
+    std::vector<std::thread> workers;
+    walker.setWorkerCount(threadCount);
+    try {
+        workers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.emplace_back([&walker] { walker.workerLoop(); });
+        }
+    } catch (const std::system_error&) {
+    } catch (const std::bad_alloc&) {
+    }
+
+    bool completed = true;
+    if (workers.empty()) {
+        walker.runInline(consume, completed);
+    } else {
+        walker.abandonWorkers(threadCount - workers.size());
+        // consume の例外で抜ける場合も、joinable な std::thread を破棄しないよう必ず join する
+        struct JoinWorkers {
+            std::vector<std::thread>& threads;
+            ~JoinWorkers() {
+                for (std::thread& thread : threads) {
+                    thread.join();
+                }
+            }
+        } joinWorkers{ workers };
+        completed = walker.consumeLoop(consume);
+    }
+    return completed ? DirWalkStatus::Ok : DirWalkStatus::Stopped;
+}
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,117 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/DirWalk.h
+// ディレクトリの並列再帰走査（dirwalk）と dirlist のモード判定の内部API
+// dirlist のモード判定、グロブ照合、作業スレッドで枝ごとに並列走査する WalkDirectory を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// 絞り込み
+// ============================================================
+
+// DirWalkEntry::flags
+constexpr uint32_t kDirEntryDirectory = 1u << 0;
+constexpr uint32_t kDirEntryHidden = 1u << 1;       // 隠し属性（POSIX では '.' で始まる名前）
+constexpr uint32_t kDirEntrySystem = 1u << 2;
+
+// dirlist の mode（0〜3, 5〜7）で flags のエントリーを含めるか。その他の mode はすべて含める
+bool DirModeAccepts(int mode, uint32_t flags) noexcept;
+
+// ワイルドカード（'*' '?'）との一致。ASCII の英字の大文字・小文字は区別しない
+// pattern は ';' で区切って複数指定できる（いずれかに一致すればよい）。空の pattern はすべてに一致する
+template<typename CharT>
+bool MatchGlob(std::basic_string_view<CharT> pattern, std::basic_string_view<CharT> name) noexcept {
+    auto lower = [](CharT c) { return (c >= 'A' && c <= 'Z') ? static_cast<CharT>(c - 'A' + 'a') : c; };
+
+    // 1つのパターンとの一致（最後の '*' の位置から貪欲にやり直す）
+    auto matchOne = [&](std::basic_string_view<CharT> p) {
+        size_t pi = 0, ni = 0;
+        size_t starP = std::basic_string_view<CharT>::npos, starN = 0;
+        while (ni < name.size()) {
+            if (pi < p.size() && p[pi] == '*') {
+                starP = pi++;
+                starN = ni;
+            } else if (pi < p.size() && (p[pi] == '?' || lower(p[pi]) == lower(name[ni]))) {
+                ++pi;
+                ++ni;
+            } else if (starP != std::basic_string_view<CharT>::npos) {
+                pi = starP + 1;
+                ni = ++starN;
+            } else {
+                return false;
+            }
+        }
+        while (pi < p.size() && p[pi] == '*') {
+            ++pi;
+        }
+        return pi == p.size();
+    };
+
+    if (pattern.empty()) {
+        return true;
+    }
+    size_t begin = 0;
+    while (begin <= pattern.size()) {
+        size_t end = pattern.find(static_cast<CharT>(';'), begin);
+        if (end == std::basic_string_view<CharT>::npos) {
+            end = pattern.size();
+        }
+        if (end > begin && matchOne(pattern.substr(begin, end - begin))) {
+            return true;
+        }
+        begin = end + 1;
+    }
+    return false;
+}
+
+// ============================================================
+// 走査
+// ============================================================
+
+struct DirWalkEntry {
+    std::string path;           // 起点からの相対パス（UTF-8、区切りは '/'）
+    uint64_t size = 0;          // ファイルサイズ（ディレクトリは 0）
+    int64_t mtimeMs = 0;        // 最終更新時刻（1970-01-01 UTC からのミリ秒）
+    uint32_t flags = 0;         // kDirEntry*
+};
+
+struct DirWalkOptions {
+    int mode = 0;               // dirlist と同じ絞り込み
+    std::string pattern;        // 名前（パスの最後の要素）のワイルドカード。空はすべて
+    bool recursive = true;      // サブディレクトリも走査する
+    size_t threads = 0;         // 作業スレッドの数（0 はハードウェアスレッド数、最大 8）
+    size_t queueCapacity = 4096;    // 呼び出し元が受け取る前にためておけるエントリーの数
+};
+
+enum class DirWalkStatus {
+    Ok,
+    OpenFailed,     // 起点のディレクトリを開けない
+    Stopped,        // consume が false を返した
+};
+
+// 一度に consume に渡すエントリーの最大数
+constexpr size_t kDirWalkBatchSize = 256;
+
+// root 以下を作業スレッドで並列に走査し、条件に合うエントリーを consume に渡す
+// consume は呼び出し元のスレッドで呼ばれ、false を返すと走査をやめる。渡したエントリーは consume の中で変更・ムーブしてよい
+// エントリーの順序は不定。シンボリックリンク・ジャンクションの先はたどらない。開けないサブディレクトリは飛ばす
+DirWalkStatus WalkDirectory(std::string_view utf8Root, const DirWalkOptions& options,
+                            const std::function<bool(std::span<DirWalkEntry>)>& consume, uint32_t& systemError);
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,538 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/FileCopy.cpp
+// ファイルのコピーの実装
+// Windows: ReFS・Dev Drive では FSCTL_DUPLICATE_EXTENTS_TO_FILE でクラスタを共有し、それ以外は CopyFile2 に任せる。
+// Linux: FICLONE（Btrfs・XFS 等の reflink）、copy_file_range（カーネル内のコピー）の順に試す。
+// どちらも使えない場合と native = false の場合は、1MB のバッファで読み書きを繰り返す
+
+#include "FileCopy.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <winioctl.h>
+#include "Transcode.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/fs.h>
+#endif
+#endif
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+constexpr size_t kReadWriteBufferSize = 1024 * 1024;
+
+// 1回の複製・copy_file_range で扱う最大の大きさ（進捗の間隔が大きすぎても中止できるように）
+constexpr uint64_t kMaxCopyStep = uint64_t{ 1 } << 30;
+
+// 各方法の結果
+enum class Attempt {
+    Done,
+    Unavailable,    // この方法は使えない（コピー先には何も残していない）
+    Failed,         // result.status に失敗の理由
+};
+
+// chunkSize 進むごとと最後に1回だけ progress を呼ぶ
+class ProgressGate {
+public:
+    ProgressGate(const std::function<bool(uint64_t, uint64_t)>& progress, uint64_t chunkSize) noexcept
+        : progress_(progress), step_(std::max<uint64_t>(chunkSize, 1)), next_(step_) {}
+
+    // 中止する場合 false
+    bool report(uint64_t copied, uint64_t total) {
+        if (!progress_ || finished_ || (copied < next_ && copied < total)) {
+            return true;
+        }
+        finished_ = copied >= total;
+        next_ = copied + step_;
+        return progress_(copied, total);
+    }
+
+private:
+    const std::function<bool(uint64_t, uint64_t)>& progress_;
+    uint64_t step_;
+    uint64_t next_;
+    bool finished_ = false;
+};
+
+#ifdef _WIN32
+
+// 大きなファイルはキャッシュを経由せずにコピーする（キャッシュを追い出さない）
+constexpr uint64_t kUnbufferedCopySize = uint64_t{ 256 } * 1024 * 1024;
+
+// コピー先に引き継ぐ属性（CopyFileW と同じもの）
+constexpr DWORD kCopiedAttributes = FILE_ATTRIBUTE_READONLY | FILE_ATTRIBUTE_HIDDEN | FILE_ATTRIBUTE_SYSTEM |
+                                    FILE_ATTRIBUTE_ARCHIVE | FILE_ATTRIBUTE_NOT_CONTENT_INDEXED;
+
+class Handle {
+public:
+    explicit Handle(HANDLE handle) noexcept : handle_(handle) {}
+    ~Handle() { reset(); }
+
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    void reset() noexcept {
+        if (handle_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(handle_);
+            handle_ = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    [[nodiscard]] HANDLE get() const noexcept { return handle_; }
+    [[nodiscard]] bool valid() const noexcept { return handle_ != INVALID_HANDLE_VALUE; }
+
+private:
+    HANDLE handle_;
+};
+
+const wchar_t* wide(const std::u16string& path) noexcept {
+    return reinterpret_cast<const wchar_t*>(path.c_str());
+}
+
+struct SourceInfo {
+    uint64_t size = 0;
+    FILETIME lastWrite{};
+    DWORD attributes = 0;
+};
+
+// 途中まで書いたコピー先を削除して失敗を記録する
+Attempt discard(Handle& dest, const std::u16string& destPath, FileCopyResult& result,
+                FileCopyStatus status, DWORD error) {
+    dest.reset();
+    DeleteFileW(wide(destPath));
+    result.status = status;
+    result.systemError = error;
+    return Attempt::Failed;
+}
+
+// 必要ならディスクへの書き込みを待ち、属性と最終更新時刻をコピー元に合わせる
+bool finishDest(HANDLE dest, const SourceInfo& info, bool flush) {
+    if (flush && !FlushFileBuffers(dest)) {
+        return false;
+    }
+    FILE_BASIC_INFO basic{};    // 0 のメンバーは変更しない
+    basic.LastWriteTime.LowPart = info.lastWrite.dwLowDateTime;
+    basic.LastWriteTime.HighPart = static_cast<LONG>(info.lastWrite.dwHighDateTime);
+    basic.FileAttributes = info.attributes & kCopiedAttributes;
+    return SetFileInformationByHandle(dest, FileBasicInfo, &basic, sizeof(basic)) != FALSE;
+}
+
+// ブロック複製（ReFS・Dev Drive の同じボリューム上のみ）。データは書き込まず、クラスタの参照を増やす
+Attempt cloneBlocks(HANDLE src, const SourceInfo& info, const std::u16string& destPath,
+                    const FileCopyOptions& options, ProgressGate& gate, FileCopyResult& result) {
+    DWORD fileSystemFlags = 0;
+    if (info.size == 0 || (info.attributes & FILE_ATTRIBUTE_SPARSE_FILE) ||
+        !GetVolumeInformationByHandleW(src, nullptr, 0, nullptr, nullptr, &fileSystemFlags, nullptr, 0) ||
+        !(fileSystemFlags & FILE_SUPPORTS_BLOCK_REFCOUNTING)) {
+        return Attempt::Unavailable;
+    }
+    DWORD returned = 0;
+    FSCTL_GET_INTEGRITY_INFORMATION_BUFFER integrity{};
+    if (!DeviceIoControl(src, FSCTL_GET_INTEGRITY_INFORMATION, nullptr, 0, &integrity, sizeof(integrity), &returned, nullptr) ||
+        integrity.ClusterSizeInBytes == 0) {
+        return Attempt::Unavailable;
+    }
+
+    Handle dest(CreateFileW(wide(destPath), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr));
+    if (!dest.valid()) {
+        result.status = FileCopyStatus::OpenDestFailed;
+        result.systemError = GetLastError();
+        return Attempt::Failed;
+    }
+
+    // 複製先は整合性ストリームの設定と大きさをコピー元に合わせておく必要がある
+    FSCTL_SET_INTEGRITY_INFORMATION_BUFFER setIntegrity{ integrity.ChecksumAlgorithm, 0, integrity.Flags };
+    FILE_END_OF_FILE_INFO endOfFile{};
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(info.size);
+    if (!DeviceIoControl(dest.get(), FSCTL_SET_INTEGRITY_INFORMATION, &setIntegrity, sizeof(setIntegrity),
+                         nullptr, 0, &returned, nullptr) ||
+        !SetFileInformationByHandle(dest.get(), FileEndOfFileInfo, &endOfFile, sizeof(endOfFile))) {
+        discard(dest, destPath, result, FileCopyStatus::Ok, 0);
+        return Attempt::Unavailable;
+    }
+
+    // 範囲はクラスタの境界にそろえる（最後の範囲はファイルの末尾を超えてよい）
+    const uint64_t cluster = integrity.ClusterSizeInBytes;
+    const uint64_t step = std::max(cluster, std::min(options.chunkSize, kMaxCopyStep) / cluster * cluster);
+    DUPLICATE_EXTENTS_DATA extents{};
+    extents.FileHandle = src;
+    for (uint64_t offset = 0; offset < info.size; offset += step) {
+        const uint64_t length = std::min(step, info.size - offset);
+        extents.SourceFileOffset.QuadPart = static_cast<LONGLONG>(offset);
+        extents.TargetFileOffset.QuadPart = static_cast<LONGLONG>(offset);
+        extents.ByteCount.QuadPart = static_cast<LONGLONG>((length + cluster - 1) / cluster * cluster);
+        if (!DeviceIoControl(dest.get(), FSCTL_DUPLICATE_EXTENTS_TO_FILE, &extents, sizeof(extents),
+                             nullptr, 0, &returned, nullptr)) {
+            const DWORD error = GetLastError();
+            if (offset == 0) {
+                // 別のボリュームなど。CopyFile2 で置き換える
+                discard(dest, destPath, result, FileCopyStatus::Ok, 0);
+                return Attempt::Unavailable;
+            }
+            return discard(dest, destPath, result, FileCopyStatus::CopyFailed, error);
+        }
+        result.bytes = offset + length;
+        if (!gate.report(result.bytes, info.size)) {
+            return discard(dest, destPath, result, FileCopyStatus::Canceled, ERROR_REQUEST_ABORTED);
+        }
+    }
+
+    if (!finishDest(dest.get(), info, options.flush)) {
+        return discard(dest, destPath, result, FileCopyStatus::CopyFailed, GetLastError());
+    }
+    result.method = FileCopyMethod::Clone;
+    return Attempt::Done;
+}
+
+struct NativeContext {
+    ProgressGate* gate;
+    bool canceled = false;
+};
+
+COPYFILE2_MESSAGE_ACTION CALLBACK nativeProgress(const COPYFILE2_MESSAGE* message, PVOID context) {
+    if (message->Type == COPYFILE2_CALLBACK_CHUNK_FINISHED) {
+        NativeContext* native = static_cast<NativeContext*>(context);
+        const uint64_t copied = message->Info.ChunkFinished.uliTotalBytesTransferred.QuadPart;
+        const uint64_t total = message->Info.ChunkFinished.uliTotalFileSize.QuadPart;
+        if (!native->gate->report(copied, total)) {
+            native->canceled = true;
+            return COPYFILE2_PROGRESS_CANCEL;   // CopyFile2 がコピー先を削除する
+        }
+    }
+    return COPYFILE2_PROGRESS_CONTINUE;
+}
+
+// CopyFile2（Windows 11 以降は対応するボリュームで自動的にブロック複製も使う）
+Attempt copyNative(const std::u16string& srcPath, const std::u16string& destPath, const SourceInfo& info,
+                   const FileCopyOptions& options, ProgressGate& gate, FileCopyResult& result) {
+    NativeContext context{ &gate };
+    COPYFILE2_EXTENDED_PARAMETERS params{};
+    params.dwSize = sizeof(params);
+    params.dwCopyFlags = info.size >= kUnbufferedCopySize ? COPY_FILE_NO_BUFFERING : 0;
+    params.pProgressRoutine = nativeProgress;
+    params.pvCallbackContext = &context;
+    const HRESULT hr = CopyFile2(wide(srcPath), wide(destPath), &params);
+    if (FAILED(hr)) {
+        result.status = context.canceled ? FileCopyStatus::Canceled : FileCopyStatus::CopyFailed;
+        result.systemError = HRESULT_FACILITY(hr) == FACILITY_WIN32 ? HRESULT_CODE(hr) : static_cast<uint32_t>(hr);
+        return Attempt::Failed;
+    }
+    result.bytes = info.size;
+
+    if (options.flush) {
+        Handle dest(CreateFileW(wide(destPath), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+        if (!dest.valid() || !FlushFileBuffers(dest.get())) {
+            result.status = FileCopyStatus::CopyFailed;
+            result.systemError = GetLastError();
+            return Attempt::Failed;
+        }
+    }
+    result.method = FileCopyMethod::Native;
+    return Attempt::Done;
+}
+
+Attempt copyReadWrite(HANDLE src, const SourceInfo& info, const std::u16string& destPath,
+                      const FileCopyOptions& options, ProgressGate& gate, FileCopyResult& result) {
+    Handle dest(CreateFileW(wide(destPath), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+    if (!dest.valid()) {
+        result.status = FileCopyStatus::OpenDestFailed;
+        result.systemError = GetLastError();
+        return Attempt::Failed;
+    }
+    // 先に領域を確保して断片化を減らす（失敗しても続ける）
+    FILE_ALLOCATION_INFO allocation{};
+    allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(info.size);
+    SetFileInformationByHandle(dest.get(), FileAllocationInfo, &allocation, sizeof(allocation));
+
+    const auto buffer = std::make_unique_for_overwrite<uint8_t[]>(kReadWriteBufferSize);
+    for (;;) {
+        DWORD bytesRead = 0;
+        if (!ReadFile(src, buffer.get(), static_cast<DWORD>(kReadWriteBufferSize), &bytesRead, nullptr)) {
+            return discard(dest, destPath, result, FileCopyStatus::CopyFailed, GetLastError());
+        }
+        if (bytesRead == 0) {
+            break;
+        }
+        DWORD written = 0;
+        while (written < bytesRead) {
+            DWORD bytesWritten = 0;
+            if (!WriteFile(dest.get(), buffer.get() + written, bytesRead - written, &bytesWritten, nullptr) || bytesWritten == 0) {
+                return discard(dest, destPath, result, FileCopyStatus::CopyFailed, GetLastError());
+            }
+            written += bytesWritten;
+        }
+        result.bytes += bytesRead;
+        if (!gate.report(result.bytes, std::max(info.size, result.bytes))) {
+            return discard(dest, destPath, result, FileCopyStatus::Canceled, ERROR_REQUEST_ABORTED);
+        }
+    }
+
+    if (!finishDest(dest.get(), info, options.flush)) {
+        return discard(dest, destPath, result, FileCopyStatus::CopyFailed, GetLastError());
+    }
+    result.method = FileCopyMethod::ReadWrite;
+    return Attempt::Done;
+}
+
+void copyFile(std::string_view utf8Src, std::string_view utf8Dest, const FileCopyOptions& options,
+              ProgressGate& gate, FileCopyResult& result) {
+    std::u16string srcPath;
+    std::u16string destPath;
+    Utf8ToUtf16Into(utf8Src, srcPath);
+    Utf8ToUtf16Into(utf8Dest, destPath);
+
+    SourceInfo info;
+    Attempt attempt = Attempt::Unavailable;
+    {
+        Handle src(CreateFileW(wide(srcPath), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                               FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+        BY_HANDLE_FILE_INFORMATION fileInfo;
+        if (!src.valid() || !GetFileInformationByHandle(src.get(), &fileInfo)) {
+            result.status = FileCopyStatus::OpenSourceFailed;
+            result.systemError = GetLastError();
+            return;
+        }
+        info.size = (static_cast<uint64_t>(fileInfo.nFileSizeHigh) << 32) | fileInfo.nFileSizeLow;
+        info.lastWrite = fileInfo.ftLastWriteTime;
+        info.attributes = fileInfo.dwFileAttributes;
+
+        if (options.clone) {
+            attempt = cloneBlocks(src.get(), info, destPath, options, gate, result);
+        }
+        if (attempt == Attempt::Unavailable && !options.native) {
+            attempt = copyReadWrite(src.get(), info, destPath, options, gate, result);
+        }
+    }
+    // CopyFile2 は自分でコピー元を開くため、先に閉じておく
+    if (attempt == Attempt::Unavailable) {
+        attempt = copyNative(srcPath, destPath, info, options, gate, result);
+    }
+    if (attempt == Attempt::Done) {
+        gate.report(result.bytes, result.bytes);    // 空のファイルなど、途中の通知がなかった場合
+    }
+}
+
+#else
+
+class Descriptor {
+public:
+    explicit Descriptor(int fd) noexcept : fd_(fd) {}
+    ~Descriptor() {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    Descriptor(const Descriptor&) = delete;
+    Descriptor& operator=(const Descriptor&) = delete;
+
+    // 閉じた結果（ネットワーク上のファイルでは書き込みの失敗がここで分かる）
+    bool close() noexcept {
+        const int fd = fd_;
+        fd_ = -1;
+        return fd < 0 || ::close(fd) == 0;
+    }
+
+    [[nodiscard]] int get() const noexcept { return fd_; }
+    [[nodiscard]] bool valid() const noexcept { return fd_ >= 0; }
+
+private:
+    int fd_;
+};
+
+Attempt discard(Descriptor& dest, const std::string& destPath, FileCopyResult& result,
+                FileCopyStatus status, int error) {
+    dest.close();
+    ::unlink(destPath.c_str());
+    result.status = status;
+    result.systemError = static_cast<uint32_t>(error);
+    return Attempt::Failed;
+}
+
+#if defined(__linux__)
+// カーネル内でコピーする（ユーザー空間のバッファを経由しない。NFS 等ではサーバー側でコピーされる）
+Attempt copyRange(int src, int dest, uint64_t size, const FileCopyOptions& options,
+                  ProgressGate& gate, FileCopyResult& result) {
+    const size_t step = static_cast<size_t>(std::clamp<uint64_t>(options.chunkSize, 1, kMaxCopyStep));
+    for (;;) {
+        const ssize_t n = ::copy_file_range(src, nullptr, dest, nullptr, step, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // 未対応のファイルシステム・古いカーネルでの別のファイルシステム間は読み書きで行う
+            if (result.bytes == 0 && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                                      errno == EOPNOTSUPP || errno == EBADF || errno == EPERM)) {
+                return Attempt::Unavailable;
+            }
+            result.status = FileCopyStatus::CopyFailed;
+            result.systemError = static_cast<uint32_t>(errno);
+            return Attempt::Failed;
+        }
+        if (n == 0) {
+            // 大きさを報告しない特殊なファイルは読み書きで行う
+            if (result.bytes == 0 && size > 0) {
+                return Attempt::Unavailable;
+            }
+            break;
+        }
+        result.bytes += static_cast<uint64_t>(n);
+        if (!gate.report(result.bytes, std::max(size, result.bytes))) {
+            result.status = FileCopyStatus::Canceled;
+            result.systemError = ECANCELED;
+            return Attempt::Failed;
+        }
+    }
+    result.method = FileCopyMethod::Native;
+    return Attempt::Done;
+}
+#endif
+
+Attempt copyReadWrite(int src, int dest, uint64_t size, ProgressGate& gate, FileCopyResult& result) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(src, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    const auto buffer = std::make_unique_for_overwrite<uint8_t[]>(kReadWriteBufferSize);
+    for (;;) {
+        const ssize_t n = ::read(src, buffer.get(), kReadWriteBufferSize);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            result.status = FileCopyStatus::CopyFailed;
+            result.systemError = static_cast<uint32_t>(errno);
+            return Attempt::Failed;
+        }
+        if (n == 0) {
+            break;
+        }
+        size_t written = 0;
+        while (written < static_cast<size_t>(n)) {
+            const ssize_t w = ::write(dest, buffer.get() + written, static_cast<size_t>(n) - written);
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                result.status = FileCopyStatus::CopyFailed;
+                result.systemError = static_cast<uint32_t>(errno);
+                return Attempt::Failed;
+            }
+            written += static_cast<size_t>(w);
+        }
+        result.bytes += static_cast<uint64_t>(n);
+        if (!gate.report(result.bytes, std::max(size, result.bytes))) {
+            result.status = FileCopyStatus::Canceled;
+            result.systemError = ECANCELED;
+            return Attempt::Failed;
+        }
+    }
+    result.method = FileCopyMethod::ReadWrite;
+    return Attempt::Done;
+}
+
+void copyFile(std::string_view utf8Src, std::string_view utf8Dest, const FileCopyOptions& options,
+              ProgressGate& gate, FileCopyResult& result) {
+    const std::string srcPath(utf8Src);
+    const std::string destPath(utf8Dest);
+
+    Descriptor src(::open(srcPath.c_str(), O_RDONLY | O_CLOEXEC));
+    struct stat st;
+    if (!src.valid() || ::fstat(src.get(), &st) != 0) {
+        result.status = FileCopyStatus::OpenSourceFailed;
+        result.systemError = static_cast<uint32_t>(errno);
+        return;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        result.status = FileCopyStatus::OpenSourceFailed;
+        result.systemError = EISDIR;
+        return;
+    }
+    // 同じファイルへのコピーは O_TRUNC で内容を失うため拒否する
+    struct stat destSt;
+    if (::stat(destPath.c_str(), &destSt) == 0 && destSt.st_dev == st.st_dev && destSt.st_ino == st.st_ino) {
+        result.status = FileCopyStatus::OpenDestFailed;
+        result.systemError = EINVAL;
+        return;
+    }
+
+    Descriptor dest(::open(destPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777));
+    if (!dest.valid()) {
+        result.status = FileCopyStatus::OpenDestFailed;
+        result.systemError = static_cast<uint32_t>(errno);
+        return;
+    }
+    const uint64_t size = static_cast<uint64_t>(st.st_size);
+
+    Attempt attempt = Attempt::Unavailable;
+#ifdef FICLONE
+    if (options.clone && S_ISREG(st.st_mode) && ::ioctl(dest.get(), FICLONE, src.get()) == 0) {
+        result.bytes = size;
+        result.method = FileCopyMethod::Clone;
+        attempt = Attempt::Done;
+    }
+#endif
+#if defined(__linux__)
+    if (attempt == Attempt::Unavailable && options.native) {
+        attempt = copyRange(src.get(), dest.get(), size, options, gate, result);
+    }
+#endif
+    if (attempt == Attempt::Unavailable) {
+        attempt = copyReadWrite(src.get(), dest.get(), size, gate, result);
+    }
+    if (attempt == Attempt::Failed) {
+        discard(dest, destPath, result, result.status, static_cast<int>(result.systemError));
+        return;
+    }
+
+    if (options.flush && ::fsync(dest.get()) != 0) {
+        discard(dest, destPath, result, FileCopyStatus::CopyFailed, errno);
+        return;
+    }
+    // 最終更新時刻をコピー元に合わせる（失敗しても内容のコピーは成功している）
+    const struct timespec times[2] = { { 0, UTIME_OMIT }, st.st_mtim };
+    ::futimens(dest.get(), times);
+    if (!dest.close()) {
+        discard(dest, destPath, result, FileCopyStatus::CopyFailed, errno);
+        return;
+    }
+    gate.report(result.bytes, result.bytes);    // 空のファイル・複製など、途中の通知がなかった場合
+}
+
+#endif
+
+} // namespace
+
+FileCopyResult CopyFileFast(std::string_view utf8Src, std::string_view utf8Dest, const FileCopyOptions& options,
+                            const std::function<bool(uint64_t, uint64_t)>& progress) {
+    FileCopyResult result;
+    ProgressGate gate(progress, options.chunkSize);
+    copyFile(utf8Src, utf8Dest, options, gate, result);
+    return result;
+}
+
+} // namespace internal
+} // namespace hsppp
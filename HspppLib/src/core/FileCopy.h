@@ -0,0 +1,59 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/FileCopy.h
+// ファイルのコピー（bcopy / bcopy_async）の内部API
+// ブロック複製・OS のコピー機能・読み書きの順に試す CopyFileFast と、進捗の通知・中止・使った方法の報告を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+
+namespace hsppp {
+namespace internal {
+
+// 実際に使ったコピーの方法
+enum class FileCopyMethod : uint8_t {
+    None,
+    Clone,          // データを複製せずに共有する（ReFS のブロック複製・Linux の FICLONE）
+    Native,         // OS のコピー機能（CopyFile2・copy_file_range。ユーザー空間のバッファを経由しない）
+    ReadWrite,      // 読み込み・書き込みの繰り返し
+};
+
+enum class FileCopyStatus : uint8_t {
+    Ok,
+    OpenSourceFailed,   // コピー元を開けない
+    OpenDestFailed,     // コピー先を作れない
+    CopyFailed,         // 読み書きの途中で失敗した
+    Canceled,           // progress が false を返した
+};
+
+struct FileCopyOptions {
+    uint64_t chunkSize = 8 * 1024 * 1024;   // progress を呼ぶ間隔
+    bool clone = true;                      // Clone を試す
+    bool native = true;                     // Native を試す（false の場合、Clone の次は ReadWrite）
+    bool flush = false;                     // 完了前にディスクへの書き込みを待つ
+};
+
+struct FileCopyResult {
+    FileCopyStatus status = FileCopyStatus::Ok;
+    FileCopyMethod method = FileCopyMethod::None;
+    uint64_t bytes = 0;             // コピーしたバイト数
+    uint32_t systemError = 0;       // 失敗時の GetLastError() / errno
+};
+
+// utf8Src を utf8Dest にコピーする。コピー先が既にあれば置き換え、最終更新時刻はコピー元に合わせる
+// Clone → Native → ReadWrite の順に、使えない場合（別のボリューム・未対応のファイルシステム）は次の方法を試す
+// progress(copied, total) はコピーしているスレッドで chunkSize ごとと最後に呼ばれ、false を返すと中止する
+// 失敗・中止した場合、途中まで書いたコピー先は削除する
+FileCopyResult CopyFileFast(std::string_view utf8Src, std::string_view utf8Dest, const FileCopyOptions& options,
+                            const std::function<bool(uint64_t, uint64_t)>& progress);
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,294 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/FileStat.cpp
+// ファイル情報の一括取得とキャッシュの実装
+// 一括取得は作業スレッドが共有の位置から kStatBatch 個ずつ取り出して取得する（遅いパスがあっても偏らない）。
+// キャッシュはパスの順の map で、消すときはパスの下を範囲で、上を親をたどって消す
+
+#include "FileStat.h"
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include "Transcode.h"
+#else
+#include <sys/stat.h>
+#endif
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+// 作業スレッドが1回に取り出すパスの数
+constexpr size_t kStatBatch = 16;
+
+// キャッシュに保持する最大の数（超えた場合はすべて捨てる）
+constexpr size_t kMaxStatCacheEntries = 65536;
+
+#ifdef _WIN32
+constexpr char kSeparator = '\\';
+
+int64_t fileTimeToUnixMs(const FILETIME& time) noexcept {
+    const int64_t ticks = (static_cast<int64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    return (ticks - 116444736000000000LL) / 10000;
+}
+
+// wide は呼び出し元で使い回す（パスごとに確保しない）
+FileStatInfo statWide(std::string_view utf8Path, std::u16string& wide) {
+    FileStatInfo info;
+    Utf8ToUtf16Into(utf8Path, wide);
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExW(reinterpret_cast<const wchar_t*>(wide.c_str()), GetFileExInfoStandard, &data)) {
+        return info;
+    }
+    info.directory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+    info.size = info.directory ? 0 :
+        static_cast<int64_t>((static_cast<uint64_t>(data.nFileSizeHigh) << 32) | data.nFileSizeLow);
+    info.mtimeMs = fileTimeToUnixMs(data.ftLastWriteTime);
+    return info;
+}
+#else
+constexpr char kSeparator = '/';
+
+FileStatInfo statPosix(const std::string& path) {
+    FileStatInfo info;
+    struct stat st;
+    if (::stat(path.c_str(), &st) != 0) {
+        return info;
+    }
+    info.directory = S_ISDIR(st.st_mode);
+    info.size = info.directory ? 0 : static_cast<int64_t>(st.st_size);
+    info.mtimeMs = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000 + st.st_mtim.tv_nsec / 1000000;
+    return info;
+}
+#endif
+
+// paths[begin, end) を取得する
+void statRange(std::span<const std::string> paths, std::span<FileStatInfo> out, size_t begin, size_t end) {
+#ifdef _WIN32
+    std::u16string wide;
+    for (size_t i = begin; i < end; ++i) {
+        out[i] = statWide(paths[i], wide);
+    }
+#else
+    for (size_t i = begin; i < end; ++i) {
+        out[i] = statPosix(paths[i]);
+    }
+#endif
+}
+
+// ============================================================
+// キャッシュ
+// ============================================================
+
+struct StatCacheRoot {
+    uint64_t id = 0;
+    std::string path;
+    bool recursive = true;
+};
+
+struct StatCache {
+    std::mutex mutex;
+    std::vector<StatCacheRoot> roots;
+    std::map<std::string, FileStatInfo, std::less<>> entries;
+    uint64_t nextId = 1;
+    std::atomic<size_t> rootCount{ 0 };
+    std::atomic<uint64_t> generation{ 0 };
+
+    // path とその下（path + 区切り で始まる）を消す
+    void eraseTree(std::string_view path) {
+        entries.erase(std::string(path));
+        std::string prefix(path);
+        if (prefix.empty() || prefix.back() != kSeparator) {
+            prefix += kSeparator;
+        }
+        auto it = entries.lower_bound(std::string_view(prefix));
+        while (it != entries.end() && std::string_view(it->first).starts_with(prefix)) {
+            it = entries.erase(it);
+        }
+    }
+
+    bool covers(std::string_view path) const noexcept {
+        for (const StatCacheRoot& root : roots) {
+            if (path.size() <= root.path.size() || !path.starts_with(root.path)) {
+                continue;
+            }
+            // ルートディレクトリ（"c:\" や "/"）は末尾が区切り
+            const size_t rest = root.path.back() == kSeparator ? root.path.size() : root.path.size() + 1;
+            if (rest != root.path.size() && path[root.path.size()] != kSeparator) {
+                continue;
+            }
+            if (rest < path.size() && (root.recursive || path.find(kSeparator, rest) == std::string_view::npos)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+StatCache& cache() {
+    static StatCache instance;
+    return instance;
+}
+
+} // namespace
+
+FileStatInfo StatPath(std::string_view utf8Path) {
+#ifdef _WIN32
+    std::u16string wide;
+    return statWide(utf8Path, wide);
+#else
+    return statPosix(std::string(utf8Path));
+#endif
+}
+
+void StatPaths(std::span<const std::string> utf8Paths, std::span<FileStatInfo> out, size_t threads) {
+    const size_t count = std::min(utf8Paths.size(), out.size());
+    if (count < kStatParallelThreshold) {
+        statRange(utf8Paths, out, 0, count);
+        return;
+    }
+    if (threads == 0) {
+        threads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threads = std::min({ threads, size_t{ 8 }, count / (kStatParallelThreshold / 2) });
+
+    std::atomic<size_t> next{ 0 };
+    auto work = [&] {
+        for (;;) {
+            const size_t begin = next.fetch_add(kStatBatch, std::memory_order_relaxed);
+            if (begin >= count) {
+                return;
+            }
+            statRange(utf8Paths, out, begin, std::min(count, begin + kStatBatch));
+        }
+    };
+
+    // スレッドを作れない場合も呼び出し元のスレッドが残りをすべて取得する
+    std::vector<std::thread> workers;
+    try {
+        workers.reserve(threads - 1);
+        for (size_t i = 1; i < threads; ++i) {
+            workers.emplace_back(work);
+        }
+    } catch (const std::system_error&) {
+    } catch (const std::bad_alloc&) {
+    }
+    work();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+uint64_t AddStatCacheRoot(std::string normalizedRoot, bool recursive) {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    const uint64_t id = c.nextId++;
+    c.roots.push_back({ id, std::move(normalizedRoot), recursive });
+    c.rootCount.store(c.roots.size(), std::memory_order_release);
+    return id;
+}
+
+void RemoveStatCacheRoot(uint64_t id) {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    auto it = std::find_if(c.roots.begin(), c.roots.end(), [id](const StatCacheRoot& root) { return root.id == id; });
+    if (it == c.roots.end()) {
+        return;
+    }
+    const std::string path = std::move(it->path);
+    c.roots.erase(it);
+    c.rootCount.store(c.roots.size(), std::memory_order_release);
+    c.generation.fetch_add(1, std::memory_order_acq_rel);
+    // 同じディレクトリを別の監視が見ていても、消すだけなので次の取得で戻る
+    c.eraseTree(path);
+}
+
+bool StatCacheActive() noexcept {
+    return cache().rootCount.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t StatCacheGeneration() noexcept {
+    return cache().generation.load(std::memory_order_acquire);
+}
+
+bool LookupStatCache(std::string_view normalizedPath, FileStatInfo& info) {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    auto it = c.entries.find(normalizedPath);
+    if (it == c.entries.end()) {
+        return false;
+    }
+    info = it->second;
+    return true;
+}
+
+void StoreStatCache(std::string_view normalizedPath, const FileStatInfo& info, uint64_t generation) {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    if (c.generation.load(std::memory_order_relaxed) != generation || !c.covers(normalizedPath)) {
+        return;
+    }
+    if (c.entries.size() >= kMaxStatCacheEntries) {
+        c.entries.clear();
+    }
+    c.entries.insert_or_assign(std::string(normalizedPath), info);
+}
+
+void InvalidateStatCache(std::string_view normalizedPath) {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    c.generation.fetch_add(1, std::memory_order_acq_rel);
+    if (c.entries.empty()) {
+        return;
+    }
+    c.eraseTree(normalizedPath);
+    // 親ディレクトリの最終更新時刻も変わる
+    std::string_view parent = normalizedPath;
+    for (size_t pos = parent.rfind(kSeparator); pos != std::string_view::npos && pos > 0;
+         pos = parent.rfind(kSeparator)) {
+        parent = parent.substr(0, pos);
+        c.entries.erase(std::string(parent));
+    }
+}
+
+void InvalidateStatCacheUnder(std::string_view normalizedDirectory) {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    c.generation.fetch_add(1, std::memory_order_acq_rel);
+    c.eraseTree(normalizedDirectory);
+}
+
+void InvalidateStatCacheFor(std::string_view utf8Path) {
+    if (StatCacheActive()) {
+        InvalidateStatCache(NormalizeWatchPath(utf8Path));
+    }
+}
+
+size_t StatCacheSize() {
+    StatCache& c = cache();
+    std::lock_guard lock(c.mutex);
+    return c.entries.size();
+}
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,79 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/FileStat.h
+// ファイル情報の一括取得（exist / exist_many）と、監視下のパスの情報のキャッシュの内部API
+// 単一・複数パスの情報取得（複数は並列）と、監視ルート配下のパス情報のキャッシュ・無効化を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// 取得
+// ============================================================
+
+struct FileStatInfo {
+    int64_t size = -1;          // ファイルサイズ（ディレクトリは 0、存在しない場合は -1）
+    int64_t mtimeMs = 0;        // 最終更新時刻（1970-01-01 UTC からのミリ秒）
+    bool directory = false;
+};
+
+// 1つのパスの情報。存在しない・参照できない場合は size = -1
+FileStatInfo StatPath(std::string_view utf8Path);
+
+// この数より少ないパスは呼び出し元のスレッドだけで取得する
+constexpr size_t kStatParallelThreshold = 64;
+
+// paths[i] の情報を out[i] に設定する（out は paths と同じ数）
+// threads 個（0 はハードウェアスレッド数、最大 8）のスレッドで連続した範囲を分担する
+void StatPaths(std::span<const std::string> utf8Paths, std::span<FileStatInfo> out, size_t threads = 0);
+
+// ============================================================
+// キャッシュ
+// ============================================================
+// 監視しているディレクトリ（root）の下のパスの情報だけを保持する。
+// 監視スレッドが変更を受け取るたびに Invalidate* で消すため、外部での変更は通知が届くまで古い値が残る。
+// パスはすべて NormalizeWatchPath の形。どのスレッドからも呼べる
+
+// root を登録し、取り除くときの番号を返す。recursive = false の場合は root の直下だけを保持する
+uint64_t AddStatCacheRoot(std::string normalizedRoot, bool recursive);
+
+// root を取り除き、その下の情報を消す
+void RemoveStatCacheRoot(uint64_t id);
+
+// root が1つでも登録されているか（パスを正規化する前の判定用）
+[[nodiscard]] bool StatCacheActive() noexcept;
+
+// 現在の世代。LookupStatCache で見つからなかった場合は、取得する前の世代を StoreStatCache に渡す
+[[nodiscard]] uint64_t StatCacheGeneration() noexcept;
+
+bool LookupStatCache(std::string_view normalizedPath, FileStatInfo& info);
+
+// root の下のパスだけを保持する。generation より後に Invalidate* が呼ばれていれば保持しない（取得中の変更）
+void StoreStatCache(std::string_view normalizedPath, const FileStatInfo& info, uint64_t generation);
+
+// path とその下・その上（root まで）の情報を消す（作成・削除・名前の変更でディレクトリの情報も変わるため）
+void InvalidateStatCache(std::string_view normalizedPath);
+
+// directory の下の情報をすべて消す（通知の取りこぼし）
+void InvalidateStatCacheUnder(std::string_view normalizedDirectory);
+
+// このプロセスで書き込んだ・削除したパスの情報を、監視の通知を待たずに消す（root がなければ正規化もしない）
+void InvalidateStatCacheFor(std::string_view utf8Path);
+
+// 保持している数（テスト・計測用）
+[[nodiscard]] size_t StatCacheSize();
+
+} // namespace internal
+} // namespace hsppp
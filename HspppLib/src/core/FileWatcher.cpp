@@ -0,0 +1,611 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/FileWatcher.cpp
+// ディレクトリの変更監視の実装
+// 監視スレッドは OS の通知を待ち、FileChangeBatcher で集約して、集まった変更をまとめて sink に渡す。
+// 通知を待つ間は集約の期限までだけ眠るため、変更がなければ CPU を使わない
+
+#include "FileWatcher.h"
+#include "DirWalk.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include "Transcode.h"
+#else
+#include <cerrno>
+#include <climits>
+#include <filesystem>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+uint64_t nowMs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// 同じパスへの変更を続けて受けた場合の結果
+FileChangeKind mergeKind(FileChangeKind current, FileChangeKind next) noexcept {
+    switch (current) {
+        case FileChangeKind::Added:
+            // 作ってすぐ消したファイルは通知しない
+            return next == FileChangeKind::Removed ? FileChangeKind::None : FileChangeKind::Added;
+        case FileChangeKind::Modified:
+            return next == FileChangeKind::Removed ? FileChangeKind::Removed : FileChangeKind::Modified;
+        case FileChangeKind::Removed:
+            // 消してから作り直した（置き換え保存など）
+            return next == FileChangeKind::Removed ? FileChangeKind::Removed : FileChangeKind::Modified;
+        default:
+            return next;
+    }
+}
+
+} // namespace
+
+// ============================================================
+// FileChangeBatcher
+// ============================================================
+
+void FileChangeBatcher::touch(uint64_t nowMs) noexcept {
+    if (events_.empty()) {
+        firstMs_ = nowMs;
+    }
+    lastMs_ = nowMs;
+}
+
+void FileChangeBatcher::add(std::string_view path, FileChangeKind kind, uint64_t nowMs) {
+    if (overflowed_) {
+        // 取りこぼした後は個別の変更を集めない（受け取る側がすべてを調べ直す）
+        lastMs_ = nowMs;
+        return;
+    }
+    touch(nowMs);
+    std::string key(path);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        index_.emplace(key, events_.size());
+        events_.push_back({ std::move(key), kind });
+        return;
+    }
+    FileChangeKind& current = events_[it->second].kind;
+    current = mergeKind(current, kind);
+}
+
+void FileChangeBatcher::overflow(uint64_t nowMs) {
+    touch(nowMs);
+    events_.clear();
+    index_.clear();
+    events_.push_back({ std::string(), FileChangeKind::Overflow });
+    overflowed_ = true;
+}
+
+bool FileChangeBatcher::ready(uint64_t nowMs) const noexcept {
+    return waitMs(nowMs) == 0;
+}
+
+uint64_t FileChangeBatcher::waitMs(uint64_t nowMs) const noexcept {
+    if (events_.empty()) {
+        return UINT64_MAX;
+    }
+    // 書き込み続けるファイルでも、最初の変更から一定時間で通知する
+    const uint64_t deadline = std::min(lastMs_ + debounceMs_, firstMs_ + uint64_t(debounceMs_) * 10);
+    return deadline > nowMs ? deadline - nowMs : 0;
+}
+
+std::vector<FileChangeEvent> FileChangeBatcher::take() {
+    std::vector<FileChangeEvent> result;
+    result.reserve(events_.size());
+    for (FileChangeEvent& event : events_) {
+        if (event.kind != FileChangeKind::None) {
+            result.push_back(std::move(event));
+        }
+    }
+    events_.clear();
+    index_.clear();
+    overflowed_ = false;
+    return result;
+}
+
+// ============================================================
+// 監視スレッド（OS ごと）
+// ============================================================
+
+#if defined(_WIN32)
+
+struct FileWatcher::Backend {
+    FileWatcherOptions options;
+    Sink sink;
+    FileChangeBatcher batcher;
+    std::u16string root;
+    std::u16string pattern;
+
+    HANDLE directory = INVALID_HANDLE_VALUE;
+    HANDLE ioEvent = nullptr;
+    HANDLE stopEvent = nullptr;
+    OVERLAPPED overlapped = {};
+    bool pending = false;                   // ReadDirectoryChangesW の完了待ち
+    std::vector<DWORD> buffer;              // FILE_NOTIFY_INFORMATION は DWORD 境界に置く必要がある
+    std::string path;                       // parse の作業用
+    std::thread thread;
+    std::atomic<bool> failed = false;       // 監視を続けられなくなって監視スレッドが止まった
+
+    Backend(const FileWatcherOptions& opts, Sink&& s)
+        : options(opts), sink(std::move(s)), batcher(opts.debounceMs) {}
+
+    ~Backend() {
+        if (thread.joinable()) {
+            SetEvent(stopEvent);
+            thread.join();
+        }
+        if (directory != INVALID_HANDLE_VALUE) CloseHandle(directory);
+        if (ioEvent) CloseHandle(ioEvent);
+        if (stopEvent) CloseHandle(stopEvent);
+    }
+
+    bool open(std::string_view utf8Directory, uint32_t& systemError) {
+        Utf8ToUtf16Into(utf8Directory.empty() ? std::string_view(".") : utf8Directory, root);
+        Utf8ToUtf16Into(options.pattern, pattern);
+
+        directory = CreateFileW(reinterpret_cast<const wchar_t*>(root.c_str()), FILE_LIST_DIRECTORY,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+        ioEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+        if (directory == INVALID_HANDLE_VALUE || !ioEvent || !stopEvent) {
+            systemError = GetLastError();
+            return false;
+        }
+        // ネットワーク共有では 64KB を超えるバッファを使えない
+        buffer.resize(64 * 1024 / sizeof(DWORD));
+        if (!issue()) {
+            systemError = GetLastError();
+            return false;
+        }
+        return true;
+    }
+
+    bool issue() {
+        constexpr DWORD kFilter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME |
+                                  FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_CREATION;
+        ResetEvent(ioEvent);
+        overlapped = {};
+        overlapped.hEvent = ioEvent;
+        pending = ReadDirectoryChangesW(directory, buffer.data(), static_cast<DWORD>(buffer.size() * sizeof(DWORD)),
+                                        options.recursive ? TRUE : FALSE, kFilter, nullptr, &overlapped, nullptr) != 0;
+        return pending;
+    }
+
+    void parse(DWORD bytes, uint64_t now) {
+        const BYTE* base = reinterpret_cast<const BYTE*>(buffer.data());
+        size_t offset = 0;
+        while (offset + sizeof(FILE_NOTIFY_INFORMATION) <= bytes) {
+            const auto* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(base + offset);
+            std::u16string_view name(reinterpret_cast<const char16_t*>(info->FileName), info->FileNameLength / sizeof(WCHAR));
+
+            FileChangeKind kind = FileChangeKind::None;
+            switch (info->Action) {
+                case FILE_ACTION_ADDED:
+                case FILE_ACTION_RENAMED_NEW_NAME: kind = FileChangeKind::Added; break;
+                case FILE_ACTION_REMOVED:
+                case FILE_ACTION_RENAMED_OLD_NAME: kind = FileChangeKind::Removed; break;
+                case FILE_ACTION_MODIFIED: kind = FileChangeKind::Modified; break;
+                default: break;
+            }
+
+            const size_t slash = name.find_last_of(u'\\');
+            const std::u16string_view leaf = (slash == std::u16string_view::npos) ? name : name.substr(slash + 1);
+            if (kind != FileChangeKind::None && MatchGlob(std::u16string_view(pattern), leaf)) {
+                Utf16ToUtf8Into(name, path);
+                std::replace(path.begin(), path.end(), '\\', '/');
+                batcher.add(path, kind, now);
+            }
+
+            if (info->NextEntryOffset == 0) {
+                break;
+            }
+            offset += info->NextEntryOffset;
+        }
+    }
+
+    // 子の変更でディレクトリ自体の更新も通知されるため、ディレクトリの Modified は除く
+    bool isDirectory(const std::string& relative) const {
+        std::u16string native = root;
+        native += u'\\';
+        std::u16string name;
+        Utf8ToUtf16Into(relative, name);
+        native += name;
+        const DWORD attributes = GetFileAttributesW(reinterpret_cast<const wchar_t*>(native.c_str()));
+        return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+    }
+
+    void deliver() {
+        std::vector<FileChangeEvent> events = batcher.take();
+        std::erase_if(events, [this](const FileChangeEvent& e) {
+            return e.kind == FileChangeKind::Modified && isDirectory(e.path);
+        });
+        if (!events.empty()) {
+            try {
+                sink(std::move(events));
+            } catch (...) {
+                // 配送できなかった変更は捨てる（監視は続ける）
+            }
+        }
+    }
+
+    void run() {
+        while (true) {
+            const uint64_t wait = batcher.waitMs(nowMs());
+            const DWORD timeout = (wait == UINT64_MAX) ? INFINITE : static_cast<DWORD>(std::min<uint64_t>(wait, INFINITE - 1));
+            HANDLE handles[2] = { stopEvent, ioEvent };
+            const DWORD signaled = WaitForMultipleObjects(2, handles, FALSE, timeout);
+            if (signaled == WAIT_OBJECT_0) {
+                break;
+            }
+            if (signaled == WAIT_FAILED) {
+                failed.store(true, std::memory_order_release);
+                break;
+            }
+            if (signaled == WAIT_OBJECT_0 + 1) {
+                DWORD bytes = 0;
+                pending = false;
+                if (!GetOverlappedResult(directory, &overlapped, &bytes, FALSE)) {
+                    if (GetLastError() != ERROR_NOTIFY_ENUM_DIR) {
+                        failed.store(true, std::memory_order_release);
+                        break;      // 監視中のディレクトリが削除された等
+                    }
+                    batcher.overflow(nowMs());
+                } else if (bytes == 0) {
+                    batcher.overflow(nowMs());      // バッファに収まらなかった
+                } else {
+                    parse(bytes, nowMs());
+                }
+                if (!issue()) {
+                    failed.store(true, std::memory_order_release);
+                    break;
+                }
+            }
+            if (batcher.ready(nowMs())) {
+                deliver();
+            }
+        }
+
+        if (pending) {
+            DWORD bytes = 0;
+            CancelIoEx(directory, &overlapped);
+            GetOverlappedResult(directory, &overlapped, &bytes, TRUE);
+            pending = false;
+        }
+        if (!batcher.empty()) {
+            deliver();
+        }
+    }
+};
+
+#elif defined(__linux__)
+
+struct FileWatcher::Backend {
+    FileWatcherOptions options;
+    Sink sink;
+    FileChangeBatcher batcher;
+    std::string root;
+
+    int inotifyFd = -1;
+    int stopPipe[2] = { -1, -1 };
+    std::unordered_map<int, std::string> dirs;      // 監視記述子 -> 相対パス（起点は空、それ以外は末尾に '/'）
+    std::thread thread;
+    std::atomic<bool> failed = false;               // 監視を続けられなくなって監視スレッドが止まった
+
+    static constexpr uint32_t kMask = IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE |
+                                      IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+    Backend(const FileWatcherOptions& opts, Sink&& s)
+        : options(opts), sink(std::move(s)), batcher(opts.debounceMs) {}
+
+    ~Backend() {
+        if (thread.joinable()) {
+            const char stop = 0;
+            [[maybe_unused]] ssize_t written = ::write(stopPipe[1], &stop, 1);
+            thread.join();
+        }
+        if (inotifyFd >= 0) ::close(inotifyFd);
+        if (stopPipe[0] >= 0) ::close(stopPipe[0]);
+        if (stopPipe[1] >= 0) ::close(stopPipe[1]);
+    }
+
+    bool open(std::string_view utf8Directory, uint32_t& systemError) {
+        root = utf8Directory.empty() ? std::string(".") : std::string(utf8Directory);
+        while (root.size() > 1 && root.back() == '/') {
+            root.pop_back();
+        }
+        inotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0 || ::pipe2(stopPipe, O_CLOEXEC) != 0) {
+            systemError = static_cast<uint32_t>(errno);
+            return false;
+        }
+        if (!addWatch(std::string())) {
+            systemError = static_cast<uint32_t>(errno);
+            return false;
+        }
+        if (options.recursive) {
+            addSubdirectories(std::string(), false, 0);
+        }
+        return true;
+    }
+
+    bool addWatch(const std::string& relative) {
+        const std::string native = relative.empty() ? root : root + "/" + relative;
+        const int wd = ::inotify_add_watch(inotifyFd, native.c_str(), kMask);
+        if (wd < 0) {
+            return false;
+        }
+        dirs[wd] = relative.empty() ? std::string() : relative + "/";
+        return true;
+    }
+
+    // relative 以下のサブディレクトリをすべて監視に加える
+    // report の場合は、監視を始める前に作られていたファイルを追加として通知する
+    void addSubdirectories(const std::string& relative, bool report, uint64_t now) {
+        DirWalkOptions walk;
+        walk.mode = report ? 0 : 5;
+        walk.threads = 1;
+        const std::string native = relative.empty() ? root : root + "/" + relative;
+        const std::string prefix = relative.empty() ? std::string() : relative + "/";
+        uint32_t ignored = 0;
+        WalkDirectory(native, walk, [&](std::span<DirWalkEntry> batch) {
+            for (const DirWalkEntry& entry : batch) {
+                const std::string path = prefix + entry.path;
+                if (entry.flags & kDirEntryDirectory) {
+                    addWatch(path);
+                } else if (report && matches(path)) {
+                    batcher.add(path, FileChangeKind::Added, now);
+                }
+            }
+            return true;
+        }, ignored);
+    }
+
+    // relative 以下の監視をやめる（ディレクトリが監視の外へ移動した）
+    void removeSubdirectories(const std::string& relative) {
+        const std::string prefix = relative + "/";
+        for (auto it = dirs.begin(); it != dirs.end();) {
+            if (it->second.starts_with(prefix)) {
+                ::inotify_rm_watch(inotifyFd, it->first);
+                it = dirs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    bool matches(std::string_view path) const {
+        const size_t slash = path.find_last_of('/');
+        const std::string_view leaf = (slash == std::string_view::npos) ? path : path.substr(slash + 1);
+        return MatchGlob(std::string_view(options.pattern), leaf);
+    }
+
+    void parse(const char* data, size_t bytes, uint64_t now) {
+        size_t offset = 0;
+        while (offset + sizeof(inotify_event) <= bytes) {
+            const auto* event = reinterpret_cast<const inotify_event*>(data + offset);
+            offset += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                batcher.overflow(now);
+                continue;
+            }
+            if (event->mask & IN_IGNORED) {
+                auto ignored = dirs.find(event->wd);
+                if (ignored != dirs.end() && ignored->second.empty()) {
+                    failed.store(true, std::memory_order_release);     // 監視するディレクトリ自体が削除・移動された
+                }
+                if (ignored != dirs.end()) {
+                    dirs.erase(ignored);
+                }
+                continue;
+            }
+            auto it = dirs.find(event->wd);
+            if (it == dirs.end() || event->len == 0) {
+                continue;
+            }
+            const std::string path = it->second + event->name;
+            const bool isDir = (event->mask & IN_ISDIR) != 0;
+
+            FileChangeKind kind = FileChangeKind::None;
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                kind = FileChangeKind::Added;
+            } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                kind = FileChangeKind::Removed;
+            } else if ((event->mask & (IN_MODIFY | IN_CLOSE_WRITE)) && !isDir) {
+                kind = FileChangeKind::Modified;
+            }
+
+            if (isDir && options.recursive) {
+                if (kind == FileChangeKind::Added && addWatch(path)) {
+                    addSubdirectories(path, true, now);
+                } else if (event->mask & IN_MOVED_FROM) {
+                    removeSubdirectories(path);
+                }
+            }
+            if (kind != FileChangeKind::None && matches(path)) {
+                batcher.add(path, kind, now);
+            }
+        }
+    }
+
+    void deliver() {
+        std::vector<FileChangeEvent> events = batcher.take();
+        if (!events.empty()) {
+            try {
+                sink(std::move(events));
+            } catch (...) {
+                // 配送できなかった変更は捨てる（監視は続ける）
+            }
+        }
+    }
+
+    void run() {
+        alignas(inotify_event) char data[64 * 1024];
+        while (true) {
+            const uint64_t wait = batcher.waitMs(nowMs());
+            const int timeout = (wait == UINT64_MAX) ? -1 : static_cast<int>(std::min<uint64_t>(wait, INT_MAX));
+            pollfd fds[2] = { { inotifyFd, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+            if (::poll(fds, 2, timeout) < 0) {
+                if (errno == EINTR) continue;
+                failed.store(true, std::memory_order_release);
+                break;
+            }
+            if (fds[1].revents) {
+                break;
+            }
+            if (fds[0].revents & POLLIN) {
+                ssize_t bytes;
+                while ((bytes = ::read(inotifyFd, data, sizeof(data))) > 0) {
+                    parse(data, static_cast<size_t>(bytes), nowMs());
+                }
+                if (failed.load(std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            if (batcher.ready(nowMs())) {
+                deliver();
+            }
+        }
+        if (!batcher.empty()) {
+            deliver();
+        }
+    }
+};
+
+#else
+
+struct FileWatcher::Backend {
+};
+
+#endif
+
+// ============================================================
+// FileWatcher
+// ============================================================
+
+FileWatcher::FileWatcher(std::unique_ptr<Backend> backend) : backend_(std::move(backend)) {}
+
+FileWatcher::~FileWatcher() = default;
+
+std::unique_ptr<FileWatcher> FileWatcher::Open(std::string_view utf8Directory, const FileWatcherOptions& options,
+                                               Sink sink, FileWatcherStatus& status, uint32_t& systemError) {
+    status = FileWatcherStatus::Ok;
+    systemError = 0;
+#if defined(_WIN32) || defined(__linux__)
+    auto backend = std::make_unique<Backend>(options, std::move(sink));
+    if (!backend->open(utf8Directory, systemError)) {
+        status = FileWatcherStatus::OpenFailed;
+        return nullptr;
+    }
+    try {
+        backend->thread = std::thread([raw = backend.get()] { raw->run(); });
+    } catch (const std::system_error& e) {
+        status = FileWatcherStatus::OpenFailed;
+        systemError = static_cast<uint32_t>(e.code().value());
+        return nullptr;
+    }
+    return std::unique_ptr<FileWatcher>(new FileWatcher(std::move(backend)));
+#else
+    (void)utf8Directory;
+    (void)options;
+    (void)sink;
+    status = FileWatcherStatus::Unsupported;
+    return nullptr;
+#endif
+}
+
+bool FileWatcher::running() const noexcept {
+#if defined(_WIN32) || defined(__linux__)
+    return !backend_->failed.load(std::memory_order_acquire);
+#else
+    return false;
+#endif
+}
+
+// ============================================================
+// パスの照合
+// ============================================================
+
+std::string NormalizeWatchPath(std::string_view utf8Path) {
+#ifdef _WIN32
+    std::u16string wide;
+    Utf8ToUtf16Into(utf8Path, wide);
+    std::replace(wide.begin(), wide.end(), u'/', u'\\');
+    const wchar_t* source = reinterpret_cast<const wchar_t*>(wide.c_str());
+    std::u16string full(GetFullPathNameW(source, 0, nullptr, nullptr), u'\0');
+    const DWORD length = full.empty() ? 0 :
+        GetFullPathNameW(source, static_cast<DWORD>(full.size()), reinterpret_cast<wchar_t*>(full.data()), nullptr);
+    if (length == 0 || length >= full.size()) {
+        full = wide;
+    } else {
+        full.resize(length);
+    }
+    // ドライブ直下（"c:\"）以外は末尾の区切りを除く
+    while (full.size() > 3 && full.back() == u'\\') {
+        full.pop_back();
+    }
+    if (!full.empty()) {
+        CharLowerBuffW(reinterpret_cast<wchar_t*>(full.data()), static_cast<DWORD>(full.size()));
+    }
+    std::string result;
+    Utf16ToUtf8Into(full, result);
+    return result;
+#else
+    std::error_code ec;
+    std::filesystem::path path = std::filesystem::absolute(std::filesystem::path(utf8Path), ec);
+    if (ec) {
+        path = std::filesystem::path(utf8Path);
+    }
+    std::string result = path.lexically_normal().string();
+    while (result.size() > 1 && result.back() == '/') {
+        result.pop_back();
+    }
+    return result;
+#endif
+}
+
+bool IsWatchPathUnder(std::string_view normalizedPath, std::string_view normalizedDirectory) noexcept {
+    if (normalizedDirectory.empty() || !normalizedPath.starts_with(normalizedDirectory)) {
+        return false;
+    }
+    // ルートディレクトリ（"c:\" や "/"）は末尾が区切り
+    const char last = normalizedDirectory.back();
+    if (last == '/' || last == '\\') {
+        return normalizedPath.size() > normalizedDirectory.size();
+    }
+    return normalizedPath.size() > normalizedDirectory.size() + 1 &&
+           (normalizedPath[normalizedDirectory.size()] == '/' || normalizedPath[normalizedDirectory.size()] == '\\');
+}
+
+} // namespace internal
+} // namespace hsppp
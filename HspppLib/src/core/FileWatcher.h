@@ -0,0 +1,123 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/FileWatcher.h
+// ディレクトリの変更監視（filewatch）の内部API
+// OS ごとの監視バックエンド、変更イベントを間引く FileChangeBatcher、監視パスの正規化と包含判定を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace hsppp {
+namespace internal {
+
+enum class FileChangeKind : uint8_t {
+    None = 0,       // 追加してから削除した（通知しない）
+    Added = 1,
+    Modified = 2,
+    Removed = 3,
+    Overflow = 4,   // 変更が多すぎて取りこぼした（path は空。監視下のすべてが変わった可能性がある）
+};
+
+struct FileChangeEvent {
+    std::string path;           // 監視するディレクトリからの相対パス（UTF-8、区切りは '/'）
+    FileChangeKind kind = FileChangeKind::None;
+};
+
+// ============================================================
+// 変更の集約
+// ============================================================
+// 同じパスへの続けざまの変更を1つにまとめる（保存1回で複数の通知が来るため）
+// 最後の変更から debounceMs 経過するか、最初の変更から debounceMs の 10 倍経過すると取り出せる
+// スレッドを持たないため、時刻を渡して単体でテストできる
+class FileChangeBatcher {
+public:
+    explicit FileChangeBatcher(uint32_t debounceMs) noexcept : debounceMs_(debounceMs) {}
+
+    void add(std::string_view path, FileChangeKind kind, uint64_t nowMs);
+
+    // 取りこぼしを記録する。集めた変更は捨て、次に取り出すまで Overflow だけを返す
+    void overflow(uint64_t nowMs);
+
+    [[nodiscard]] bool empty() const noexcept { return events_.empty(); }
+    [[nodiscard]] bool ready(uint64_t nowMs) const noexcept;
+
+    // ready になるまでの時間（空の場合は UINT64_MAX）
+    [[nodiscard]] uint64_t waitMs(uint64_t nowMs) const noexcept;
+
+    // 集めた変更を最初に変更された順に取り出す
+    std::vector<FileChangeEvent> take();
+
+private:
+    void touch(uint64_t nowMs) noexcept;
+
+    uint32_t debounceMs_;
+    std::vector<FileChangeEvent> events_;
+    std::unordered_map<std::string, size_t> index_;     // path -> events_ の位置
+    uint64_t firstMs_ = 0;
+    uint64_t lastMs_ = 0;
+    bool overflowed_ = false;
+};
+
+// ============================================================
+// 監視
+// ============================================================
+
+struct FileWatcherOptions {
+    bool recursive = true;      // サブディレクトリも監視する
+    std::string pattern;        // 名前（パスの最後の要素）のワイルドカード。空はすべて
+    uint32_t debounceMs = 50;   // FileChangeBatcher を参照
+};
+
+enum class FileWatcherStatus {
+    Ok,
+    OpenFailed,     // ディレクトリを開けない・監視を開始できない
+    Unsupported,    // この OS では使えない
+};
+
+// ディレクトリを専用のスレッドで監視し、まとめた変更を sink に渡す
+// sink は監視スレッドで呼ばれる。破棄すると監視を止め、スレッドの終了を待つ（sink の中から破棄しないこと）
+class FileWatcher {
+public:
+    using Sink = std::function<void(std::vector<FileChangeEvent>&&)>;
+
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // 失敗した場合は nullptr を返し、status と systemError（GetLastError / errno）を設定する
+    static std::unique_ptr<FileWatcher> Open(std::string_view utf8Directory, const FileWatcherOptions& options,
+                                             Sink sink, FileWatcherStatus& status, uint32_t& systemError);
+
+    // 監視を続けているか。監視するディレクトリが削除された等で監視スレッドが止まると false
+    [[nodiscard]] bool running() const noexcept;
+
+private:
+    struct Backend;
+
+    explicit FileWatcher(std::unique_ptr<Backend> backend);
+
+    std::unique_ptr<Backend> backend_;
+};
+
+// パスを比較用の形にする（絶対パス・区切りの統一。Windows では小文字にそろえる）
+// 読み込み済みの素材のファイル名と、変更されたファイルのパスの照合に使う
+std::string NormalizeWatchPath(std::string_view utf8Path);
+
+// NormalizeWatchPath の形のパスが directory の下にあるか（directory 自体は含まない）
+bool IsWatchPathUnder(std::string_view normalizedPath, std::string_view normalizedDirectory) noexcept;
+
+} // namespace internal
+} // namespace hsppp
@@ -14,8 +14,10 @@ module;
 #include <d2d1_1.h>
 #include <wincodec.h>
 #include <wrl/client.h>
+#include <climits>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #include "Internal.h"
 
@@ -30,23 +32,56 @@ namespace internal {
 std::map<int, CelData> g_celDataMap;
 int g_nextCelId = 1;
 
-// WICで画像ファイルをロードしてD2Dビットマップを作成
-ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& height) {
-    auto& deviceMgr = D2DDeviceManager::getInstance();
-    if (!deviceMgr.getWICFactory()) return nullptr;
+namespace {
 
-    std::wstring wideFilename = Utf8ToWide(filename);
+// pack:// の画像をメモリ上のストリームとしてデコーダーを作成
+// ストリームは packData の内容を直接参照するため、変換器を使い終わるまで packData を保持すること
+ComPtr<IWICBitmapDecoder> openPackDecoder(IWICImagingFactory* pFactory, std::string_view filename, PackData& packData) {
+    if (OpenPackData(filename, packData) != PackStatus::Ok || packData.bytes.empty() ||
+        packData.bytes.size() > UINT_MAX) {
+        return nullptr;
+    }
+
+    ComPtr<IWICStream> pStream;
+    HRESULT hr = pFactory->CreateStream(pStream.GetAddressOf());
+    if (FAILED(hr)) return nullptr;
+
+    hr = pStream->InitializeFromMemory(const_cast<BYTE*>(packData.bytes.data()),
+                                       static_cast<DWORD>(packData.bytes.size()));
+    if (FAILED(hr)) return nullptr;
 
-    // WICデコーダーを作成
     ComPtr<IWICBitmapDecoder> pDecoder;
-    HRESULT hr = deviceMgr.getWICFactory()->CreateDecoderFromFilename(
-        wideFilename.c_str(),
+    hr = pFactory->CreateDecoderFromStream(
+        pStream.Get(),
         nullptr,
-        GENERIC_READ,
         WICDecodeMetadataCacheOnDemand,
         pDecoder.GetAddressOf()
     );
     if (FAILED(hr)) return nullptr;
+    return pDecoder;
+}
+
+// WICで画像ファイルを開き、32bppPBGRAへのフォーマット変換器を作成
+// pack:// の場合、変換器は packData の内容を参照する
+ComPtr<IWICFormatConverter> openImageConverter(IWICImagingFactory* pFactory, std::string_view filename,
+                                               PackData& packData, int& width, int& height) {
+    // WICデコーダーを作成
+    ComPtr<IWICBitmapDecoder> pDecoder;
+    HRESULT hr;
+    if (IsPackPath(filename)) {
+        pDecoder = openPackDecoder(pFactory, filename, packData);
+        if (!pDecoder) return nullptr;
+    } else {
+        std::wstring wideFilename = Utf8ToWide(filename);
+        hr = pFactory->CreateDecoderFromFilename(
+            wideFilename.c_str(),
+            nullptr,
+            GENERIC_READ,
+            WICDecodeMetadataCacheOnDemand,
+            pDecoder.GetAddressOf()
+        );
+        if (FAILED(hr)) return nullptr;
+    }
 
     // フレームを取得
     ComPtr<IWICBitmapFrameDecode> pFrame;
@@ -55,7 +90,7 @@ ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& h
 
     // フォーマット変換器を作成（32bppPBGRAに統一）
     ComPtr<IWICFormatConverter> pConverter;
-    hr = deviceMgr.getWICFactory()->CreateFormatConverter(pConverter.GetAddressOf());
+    hr = pFactory->CreateFormatConverter(pConverter.GetAddressOf());
     if (FAILED(hr)) return nullptr;
 
     hr = pConverter->Initialize(
@@ -75,13 +110,64 @@ ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& h
 
     width = static_cast<int>(w);
     height = static_cast<int>(h);
+    return pConverter;
+}
+
+// 変換器から画素を読み出す（CopyPixels のバッファサイズは UINT に収まる必要がある）
+bool copyConverterPixels(IWICFormatConverter* pConverter, int width, int height, std::vector<uint32_t>& pixels) {
+    const uint64_t bytes = static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * 4;
+    if (bytes > UINT_MAX) return false;
+
+    pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+    HRESULT hr = pConverter->CopyPixels(
+        nullptr,
+        static_cast<UINT>(width) * 4,
+        static_cast<UINT>(bytes),
+        reinterpret_cast<BYTE*>(pixels.data())
+    );
+    return SUCCEEDED(hr);
+}
+
+// 呼び出したスレッドで COM を初期化し、スコープを抜けるときに対応する CoUninitialize を呼ぶ
+// メインスレッドのように既に別の方式で初期化済みの場合（RPC_E_CHANGED_MODE）はそのまま使う
+class ComThreadScope {
+public:
+    ComThreadScope() noexcept : m_hr(CoInitializeEx(nullptr, COINIT_MULTITHREADED)) {}
+    ~ComThreadScope() {
+        if (SUCCEEDED(m_hr)) {
+            CoUninitialize();
+        }
+    }
+    ComThreadScope(const ComThreadScope&) = delete;
+    ComThreadScope& operator=(const ComThreadScope&) = delete;
+
+private:
+    HRESULT m_hr;
+};
+
+} // namespace
+
+// WICで画像ファイルをロードしてD2Dビットマップを作成
+ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& height, std::vector<uint32_t>* pixels) {
+    auto& deviceMgr = D2DDeviceManager::getInstance();
+    if (!deviceMgr.getWICFactory()) return nullptr;
+
+    PackData packData;
+    ComPtr<IWICFormatConverter> pConverter = openImageConverter(deviceMgr.getWICFactory(), filename, packData, width, height);
+    if (!pConverter) return nullptr;
+
+    if (pixels) {
+        // 画素を取り出した場合は、同じ画素からビットマップを作る（デコードは1回だけ）
+        if (!copyConverterPixels(pConverter.Get(), width, height, *pixels)) return nullptr;
+        return createBitmapFromPixels(*pixels, width, height);
+    }
 
     // Direct2D ビットマップを作成
     ComPtr<ID2D1Bitmap1> pBitmap;
     auto pDeviceContext = deviceMgr.createDeviceContext();
     if (!pDeviceContext) return nullptr;
 
-    hr = pDeviceContext->CreateBitmapFromWicBitmap(
+    HRESULT hr = pDeviceContext->CreateBitmapFromWicBitmap(
         pConverter.Get(),
         nullptr,
         pBitmap.GetAddressOf()
@@ -91,6 +177,55 @@ ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& h
     return pBitmap;
 }
 
+// 32bppPBGRA の画素から D2D ビットマップを作成
+ComPtr<ID2D1Bitmap1> createBitmapFromPixels(const std::vector<uint32_t>& pixels, int width, int height) {
+    if (width <= 0 || height <= 0 || pixels.size() < static_cast<size_t>(width) * static_cast<size_t>(height)) {
+        return nullptr;
+    }
+    auto pDeviceContext = D2DDeviceManager::getInstance().createDeviceContext();
+    if (!pDeviceContext) return nullptr;
+
+    ComPtr<ID2D1Bitmap1> pBitmap;
+    HRESULT hr = pDeviceContext->CreateBitmap(
+        D2D1::SizeU(static_cast<UINT32>(width), static_cast<UINT32>(height)),
+        pixels.data(),
+        static_cast<UINT32>(width) * 4,
+        D2D1::BitmapProperties1(
+            D2D1_BITMAP_OPTIONS_NONE,
+            D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)
+        ),
+        pBitmap.GetAddressOf()
+    );
+    if (FAILED(hr)) return nullptr;
+
+    return pBitmap;
+}
+
+// WICだけで画像ファイルを画素にデコード（ウィンドウ・描画デバイスなしでも動作）
+bool decodeImageFile(std::string_view filename, std::vector<uint32_t>& pixels, int& width, int& height) {
+    // 作業スレッドからも呼ばれるため、このスレッドで COM を使えるようにする
+    // （COM オブジェクトより先に構築し、それらを解放した後で CoUninitialize する）
+    const ComThreadScope com;
+
+    // 描画デバイスの初期化前・初期化失敗時は単独で WIC ファクトリーを作る
+    ComPtr<IWICImagingFactory> pFactory = D2DDeviceManager::getInstance().getWICFactory();
+    if (!pFactory) {
+        HRESULT hr = CoCreateInstance(
+            CLSID_WICImagingFactory,
+            nullptr,
+            CLSCTX_INPROC_SERVER,
+            IID_PPV_ARGS(pFactory.GetAddressOf())
+        );
+        if (FAILED(hr)) return false;
+    }
+
+    PackData packData;
+    ComPtr<IWICFormatConverter> pConverter = openImageConverter(pFactory.Get(), filename, packData, width, height);
+    if (!pConverter) return false;
+
+    return copyConverterPixels(pConverter.Get(), width, height, pixels);
+}
+
 // D2DビットマップをBMPファイルに保存
 bool saveBitmapToFile(ID2D1Bitmap1* pBitmap, std::string_view filename) {
     if (!pBitmap) return false;
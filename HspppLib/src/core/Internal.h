@@ -22,6 +22,19 @@
 #include <memory>
 #include <map>
 #include <functional>
+#include <vector>
+
+#include "CollisionMask.h"
+#include "ColorConvert.h"
+#include "DirWalk.h"
+#include "FileCopy.h"
+#include "FileStat.h"
+#include "FileWatcher.h"
+#include "IoQueue.h"
+#include "Lz4Frame.h"
+#include "MemoryMap.h"
+#include "PackArchive.h"
+#include "Transcode.h"
 
 // COMスマートポインタのエイリアス
 template<typename T>
@@ -33,8 +46,11 @@ namespace internal {
 // UTF-8文字列をUTF-16(wchar_t)に変換（安全な string_view を使用）
 std::wstring Utf8ToWide(std::string_view utf8str);
 
+// UTF-8文字列をUTF-16(wchar_t)に変換して dest に格納（dest の容量を再利用）
+void Utf8ToWideInto(std::string_view utf8str, std::wstring& dest);
+
 // UTF-16文字列をUTF-8に変換
-std::string WideToUtf8(const std::wstring& wideStr);
+std::string WideToUtf8(std::wstring_view wideStr);
 
 // 前方宣言
 class HspSurface;
@@ -53,8 +69,13 @@ struct CelData {
     int centerX;                       // 中心X座標
     int centerY;                       // 中心Y座標
     std::string filename;              // ファイル名（再利用チェック用）
+    std::vector<uint64_t> maskBits;    // 画像全体の当たり判定マスク（マスク指定の loadCel のみ）
+    size_t maskWordsPerRow;            // マスク1行のワード数（マスクなしは 0）
+    int maskAlphaThreshold;            // マスクを作った条件（filewatch で読み直すときに使う）
+    int maskColorKey;
     
-    CelData() : width(0), height(0), divX(0), divY(0), centerX(0), centerY(0) {}
+    CelData() : width(0), height(0), divX(0), divY(0), centerX(0), centerY(0), maskWordsPerRow(0),
+                maskAlphaThreshold(128), maskColorKey(-1) {}
 };
 
 // ============================================================
@@ -638,6 +659,10 @@ namespace hsppp::internal {
     // 戻り値: true=終了をブロック, false=終了を許可
     bool triggerOnExit(int windowId, int reason);
 
+    // メインスレッドの割り込み処理で呼ぶ関数を投入（任意のスレッドから呼び出し可）
+    // await / stop / FileRequest::wait 等の待機中に投入順に呼ばれる
+    void postInterruptCallback(std::function<void()> callback);
+
     // HWNDからウィンドウIDを逆引き（見つからなければ0を返す）
     int getWindowIdFromHwnd(HWND hwnd);
 
@@ -645,7 +670,14 @@ namespace hsppp::internal {
     void setMouseWheelDelta(int delta);
 
     // 画像読み込み・保存（ImageLoader.cpp）
-    ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& height);
+    // pixels を指定すると、デコードした 32bppPBGRA の画素も返す
+    ComPtr<ID2D1Bitmap1> loadImageFile(std::string_view filename, int& width, int& height,
+                                       std::vector<uint32_t>* pixels = nullptr);
+    // 画像を 32bppPBGRA の画素にデコードする（WIC のみ使用。描画デバイスがなくても動作する）
+    // COM は呼び出したスレッドで必要に応じて初期化するため、作業スレッドから呼んでもよい
+    bool decodeImageFile(std::string_view filename, std::vector<uint32_t>& pixels, int& width, int& height);
+    // decodeImageFile の画素から D2D ビットマップを作る（メインスレッドで呼ぶ）
+    ComPtr<ID2D1Bitmap1> createBitmapFromPixels(const std::vector<uint32_t>& pixels, int width, int height);
     bool saveBitmapToFile(ID2D1Bitmap1* pBitmap, std::string_view filename);
 
     // cel素材管理（ImageLoader.cpp）
@@ -0,0 +1,133 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/IoQueue.cpp
+// ファイル入出力用の作業スレッドとキューの実装
+
+#include "IoQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <system_error>
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+std::atomic<IoWorkQueue*> g_sharedQueue = nullptr;
+
+uint64_t nowNs() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+IoWorkQueue::IoWorkQueue(size_t threadCount) {
+    threadCount = std::max<size_t>(1, threadCount);
+    threads_.reserve(threadCount);
+    try {
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads_.emplace_back([this] { workerLoop(); });
+        }
+    } catch (const std::system_error&) {
+        // 1つも作れない場合だけ失敗とする
+        if (threads_.empty()) {
+            throw;
+        }
+    }
+}
+
+IoWorkQueue::~IoWorkQueue() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void IoWorkQueue::submit(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back({ std::move(job), nowNs() });
+        ++stats_.submitted;
+        ++stats_.pending;
+        stats_.peakPending = std::max(stats_.peakPending, stats_.pending);
+    }
+    wake_.notify_one();
+}
+
+IoQueueStats IoWorkQueue::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void IoWorkQueue::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return stats_.pending == 0; });
+}
+
+// 未完了の数は実行中の仕事の完了時に減らすため残す
+void IoWorkQueue::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t pending = stats_.pending;
+    stats_ = {};
+    stats_.pending = pending;
+    stats_.peakPending = pending;
+}
+
+void IoWorkQueue::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return stopping_ || !jobs_.empty(); });
+        if (jobs_.empty()) {
+            return;     // 停止要求があり、残りの仕事もない
+        }
+
+        Job job = std::move(jobs_.front());
+        jobs_.pop_front();
+        const uint64_t startedAt = nowNs();
+        const uint64_t waitNs = startedAt - job.submittedAt;
+        ++stats_.started;
+        stats_.totalWaitNs += waitNs;
+        stats_.maxWaitNs = std::max(stats_.maxWaitNs, waitNs);
+
+        lock.unlock();
+        job.run();
+        job.run = nullptr;      // キャプチャした資源をロックの外で解放する
+        const uint64_t latencyNs = nowNs() - job.submittedAt;
+        lock.lock();
+
+        ++stats_.completed;
+        --stats_.pending;
+        stats_.totalLatencyNs += latencyNs;
+        stats_.maxLatencyNs = std::max(stats_.maxLatencyNs, latencyNs);
+        if (stats_.pending == 0) {
+            idle_.notify_all();
+        }
+    }
+}
+
+// 読み込みと書き込みが同時に進むように最低2本、ディスクを奪い合わないように最大4本
+IoWorkQueue& SharedIoQueue() {
+    static IoWorkQueue s_queue(std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2, 4));
+    g_sharedQueue.store(&s_queue, std::memory_order_release);
+    return s_queue;
+}
+
+void WaitSharedIoQueueIdle() {
+    if (IoWorkQueue* queue = g_sharedQueue.load(std::memory_order_acquire)) {
+        queue->waitIdle();
+    }
+}
+
+} // namespace internal
+} // namespace hsppp
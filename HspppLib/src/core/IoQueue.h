@@ -0,0 +1,86 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/IoQueue.h
+// ファイル入出力用の作業スレッドとキュー（bload_async / bsave_async）
+// 固定数の作業スレッドで投入順にジョブを処理する IoWorkQueue と、プロセス共有のキューおよびその待機を提供する
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hsppp {
+namespace internal {
+
+// キューの統計（時間はナノ秒）
+struct IoQueueStats {
+    uint64_t submitted = 0;         // 投入した仕事の数
+    uint64_t started = 0;           // 実行を開始した仕事の数
+    uint64_t completed = 0;         // 終了した仕事の数
+    size_t pending = 0;             // 未完了の仕事の数（待機中 + 実行中）
+    size_t peakPending = 0;         // pending の最大値
+    uint64_t totalWaitNs = 0;       // 投入から実行開始までの時間の合計
+    uint64_t maxWaitNs = 0;
+    uint64_t totalLatencyNs = 0;    // 投入から終了までの時間の合計
+    uint64_t maxLatencyNs = 0;
+};
+
+// ============================================================
+// 作業スレッドのプール
+// ============================================================
+// 仕事は投入順に取り出す。破棄時は残りの仕事をすべて実行してから終了する
+// （保存途中のファイルを残さないため）
+class IoWorkQueue {
+public:
+    explicit IoWorkQueue(size_t threadCount);
+    ~IoWorkQueue();
+
+    IoWorkQueue(const IoWorkQueue&) = delete;
+    IoWorkQueue& operator=(const IoWorkQueue&) = delete;
+
+    // job は作業スレッドで呼ばれる。例外は job の中で処理すること
+    void submit(std::function<void()> job);
+
+    IoQueueStats stats() const;
+    void resetStats();
+
+    // 投入済みの仕事がすべて終わるまで待つ
+    void waitIdle();
+
+    size_t threadCount() const noexcept { return threads_.size(); }
+
+private:
+    struct Job {
+        std::function<void()> run;
+        uint64_t submittedAt;       // steady_clock のナノ秒
+    };
+
+    void workerLoop();
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::deque<Job> jobs_;
+    std::vector<std::thread> threads_;
+    bool stopping_ = false;
+    IoQueueStats stats_;
+};
+
+// ファイル入出力で共有するキュー（初回呼び出し時に作成）
+IoWorkQueue& SharedIoQueue();
+
+// 共有キューが作成済みなら、投入済みの仕事がすべて終わるまで待つ（終了処理用）
+void WaitSharedIoQueueIdle();
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,413 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/Lz4.cpp
+// LZ4 ブロック形式の圧縮・展開
+//
+// シーケンス = トークン(上位4bit: リテラル長, 下位4bit: 一致長 - 4)
+//            + [リテラル長の追加バイト] + リテラル + オフセット(2バイト LE) + [一致長の追加バイト]
+// 長さが 15 以上の場合は 255 の追加バイトを続け、255 未満のバイトで終える。
+// 最後のシーケンスはリテラルのみで、末尾 5 バイトは必ずリテラル、最後の一致は末尾 12 バイトより前で始まる
+//
+// level 2 以上はハッシュ表から同じハッシュの位置を連結リスト（チェーン）でたどり、最も長い一致を選ぶ。
+// 直前の一致と同じオフセットを最初に試す（同じ値の連続を含む周期的なデータでは、近くの候補だけでチェーンが尽きるため）。
+// 次の位置の方が長く一致する場合は1バイトをリテラルにして次の位置の一致を使う（遅延評価）
+
+#include "Lz4.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+constexpr size_t kMinMatch = 4;
+constexpr size_t kLastLiterals = 5;         // 末尾の必ずリテラルにするバイト数
+constexpr size_t kMatchSearchLimit = 12;    // これより末尾に近い位置からは一致を探さない
+constexpr size_t kMaxOffset = 65535;
+constexpr int kHashBits = 12;
+constexpr unsigned kSkipTrigger = 6;        // 一致しない位置が続くと探索の間隔を広げる
+constexpr int kChainHashBits = 15;          // level 2 以上のハッシュ表
+constexpr size_t kChainWindow = 65536;      // チェーンに保持する位置の数（kMaxOffset を覆う）
+
+uint32_t read32(const uint8_t* p) noexcept {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t read64(const uint8_t* p) noexcept {
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+// p と ref から何バイト一致するか（p は limit まで）
+const uint8_t* extendMatch(const uint8_t* p, const uint8_t* ref, const uint8_t* limit) noexcept {
+    while (p + 8 <= limit) {
+        const uint64_t diff = read64(p) ^ read64(ref);
+        if (diff != 0) {
+            return p + (std::countr_zero(diff) >> 3);
+        }
+        p += 8;
+        ref += 8;
+    }
+    while (p < limit && *p == *ref) {
+        ++p;
+        ++ref;
+    }
+    return p;
+}
+
+uint32_t hashPosition(uint32_t sequence) noexcept {
+    return (sequence * 2654435761u) >> (32 - kHashBits);
+}
+
+// 長さの追加バイト（15 を超えた分）を書き込む
+uint8_t* writeLength(uint8_t* op, size_t length) noexcept {
+    while (length >= 255) {
+        *op++ = 255;
+        length -= 255;
+    }
+    *op++ = static_cast<uint8_t>(length);
+    return op;
+}
+
+// anchor から literalLength バイトのリテラルと、offset・matchLength（kMinMatch 以上）の一致を書き出す
+uint8_t* writeSequence(uint8_t* op, const uint8_t* anchor, size_t literalLength, size_t offset, size_t matchLength) noexcept {
+    matchLength -= kMinMatch;
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>(((literalLength < 15 ? literalLength : 15) << 4) |
+                                  (matchLength < 15 ? matchLength : 15));
+    if (literalLength >= 15) {
+        op = writeLength(op, literalLength - 15);
+    }
+    std::memcpy(op, anchor, literalLength);
+    op += literalLength;
+
+    *op++ = static_cast<uint8_t>(offset & 0xFF);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    if (matchLength >= 15) {
+        op = writeLength(op, matchLength - 15);
+    }
+    return op;
+}
+
+// 残りをリテラルだけの最後のシーケンスとして書き出す
+uint8_t* writeLastLiterals(uint8_t* op, const uint8_t* anchor, size_t literalLength) noexcept {
+    *op++ = static_cast<uint8_t>((literalLength < 15 ? literalLength : 15) << 4);
+    if (literalLength >= 15) {
+        op = writeLength(op, literalLength - 15);
+    }
+    if (literalLength > 0) {
+        std::memcpy(op, anchor, literalLength);
+        op += literalLength;
+    }
+    return op;
+}
+
+uint32_t hashChainPosition(uint32_t sequence) noexcept {
+    return (sequence * 2654435761u) >> (32 - kChainHashBits);
+}
+
+// level 2 以上の一致の探索
+// head はハッシュごとの最後の位置 + 1（0 は未登録）、chain は各位置から同じハッシュの1つ前の位置までの距離（0 は終端）
+class ChainMatchFinder {
+public:
+    // maxAttempts: たどる候補の最大数、niceLength: これ以上の長さの一致が見つかれば探索をやめる
+    ChainMatchFinder(const uint8_t* src, uint32_t* head, uint16_t* chain, unsigned maxAttempts, size_t niceLength) noexcept
+        : src_(src), head_(head), chain_(chain), maxAttempts_(maxAttempts), niceLength_(niceLength) {}
+
+    // ip より前の位置をすべて登録し、ip から始まる最も長い一致を探す（見つからない場合は 0）
+    // repeatOffset: 最初に試すオフセット（0 は試さない）
+    size_t find(const uint8_t* ip, const uint8_t* matchLimit, size_t repeatOffset, const uint8_t*& match) noexcept {
+        const uint32_t target = static_cast<uint32_t>(ip - src_);
+        while (next_ < target) {
+            insert(next_++);
+        }
+
+        const uint32_t sequence = read32(ip);
+        size_t bestLength = 0;
+        if (repeatOffset != 0 && repeatOffset <= target && read32(ip - repeatOffset) == sequence) {
+            match = ip - repeatOffset;
+            bestLength = static_cast<size_t>(extendMatch(ip + kMinMatch, match + kMinMatch, matchLimit) - ip);
+            if (bestLength >= niceLength_ || ip + bestLength >= matchLimit) {
+                return bestLength;
+            }
+        }
+        uint32_t entry = head_[hashChainPosition(sequence)];
+        for (unsigned attempts = maxAttempts_; entry != 0 && attempts > 0; --attempts) {
+            const uint32_t candidate = entry - 1;
+            if (target - candidate > kMaxOffset) {
+                break;
+            }
+            const uint8_t* ref = src_ + candidate;
+            // 最長より長くなりうる候補だけを調べる（最長の末尾のバイトが違えば伸びない）
+            if (ref[bestLength] == ip[bestLength] && read32(ref) == sequence) {
+                const size_t length = static_cast<size_t>(extendMatch(ip + kMinMatch, ref + kMinMatch, matchLimit) - ip);
+                if (length > bestLength) {
+                    bestLength = length;
+                    match = ref;
+                    if (length >= niceLength_ || ip + length >= matchLimit) {
+                        break;
+                    }
+                }
+            }
+            const uint16_t delta = chain_[candidate & (kChainWindow - 1)];
+            if (delta == 0 || delta > candidate) {
+                break;
+            }
+            entry = candidate - delta + 1;
+        }
+        return bestLength >= kMinMatch ? bestLength : 0;
+    }
+
+private:
+    void insert(uint32_t position) noexcept {
+        uint32_t& slot = head_[hashChainPosition(read32(src_ + position))];
+        const uint32_t distance = (slot == 0) ? 0 : position - (slot - 1);
+        chain_[position & (kChainWindow - 1)] = static_cast<uint16_t>(distance <= kMaxOffset ? distance : 0);
+        slot = position + 1;
+    }
+
+    const uint8_t* src_;
+    uint32_t* head_;
+    uint16_t* chain_;
+    unsigned maxAttempts_;
+    size_t niceLength_;
+    uint32_t next_ = 0;     // 次に登録する位置
+};
+
+} // namespace
+
+size_t Lz4Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity) noexcept {
+    // 途中の確認を省くため、最悪の場合でも収まる出力先だけを受け付ける
+    if (dstCapacity < Lz4CompressBound(srcSize)) {
+        return 0;
+    }
+
+    const uint8_t* const end = src + srcSize;
+    const uint8_t* anchor = src;    // まだ書き出していないリテラルの先頭
+    uint8_t* op = dst;
+
+    if (srcSize > kMatchSearchLimit) {
+        uint32_t table[1u << kHashBits] = {};   // 位置は src からの距離（0 は未登録と区別しない）
+        const uint8_t* const matchLimit = end - kLastLiterals;
+        const uint8_t* const searchLimit = end - kMatchSearchLimit;
+        const uint8_t* ip = src + 1;
+        table[hashPosition(read32(src))] = 0;
+
+        while (ip < searchLimit) {
+            // 一致する位置を探す
+            const uint8_t* match = nullptr;
+            unsigned attempts = 1u << kSkipTrigger;
+            while (ip < searchLimit) {
+                const uint32_t sequence = read32(ip);
+                const uint32_t h = hashPosition(sequence);
+                const uint8_t* candidate = src + table[h];
+                table[h] = static_cast<uint32_t>(ip - src);
+                if (static_cast<size_t>(ip - candidate) <= kMaxOffset && candidate < ip && read32(candidate) == sequence) {
+                    match = candidate;
+                    break;
+                }
+                ip += attempts++ >> kSkipTrigger;
+            }
+            if (!match) {
+                break;
+            }
+
+            // 一致を後ろへ伸ばす前に、前へ伸ばせる分を含める
+            while (ip > anchor && match > src && ip[-1] == match[-1]) {
+                --ip;
+                --match;
+            }
+
+            const uint8_t* matchEnd = extendMatch(ip + kMinMatch, match + kMinMatch, matchLimit);
+
+            // シーケンスを書き出す
+            op = writeSequence(op, anchor, static_cast<size_t>(ip - anchor), static_cast<size_t>(ip - match),
+                               static_cast<size_t>(matchEnd - ip));
+
+            // 一致の途中の位置も登録しておく（次の一致が見つかりやすくなる）
+            if (matchEnd - 2 > ip && matchEnd - 2 < searchLimit) {
+                table[hashPosition(read32(matchEnd - 2))] = static_cast<uint32_t>(matchEnd - 2 - src);
+            }
+            ip = matchEnd;
+            anchor = ip;
+        }
+    }
+
+    // 残りをリテラルとして書き出す
+    op = writeLastLiterals(op, anchor, static_cast<size_t>(end - anchor));
+    return static_cast<size_t>(op - dst);
+}
+
+size_t Lz4CompressLevel(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity, int level) noexcept {
+    level = std::clamp(level, kLz4MinLevel, kLz4MaxLevel);
+    if (level == kLz4MinLevel || srcSize <= kMatchSearchLimit) {
+        return Lz4Compress(src, srcSize, dst, dstCapacity);
+    }
+    if (dstCapacity < Lz4CompressBound(srcSize) || srcSize > UINT32_MAX - 1) {
+        return 0;
+    }
+
+    // 表は合わせて 256KB になるため、スタックではなくヒープに置く（確保できない場合は level 1 で圧縮する）
+    std::unique_ptr<uint32_t[]> head(new (std::nothrow) uint32_t[size_t{ 1 } << kChainHashBits]());
+    std::unique_ptr<uint16_t[]> chain(new (std::nothrow) uint16_t[kChainWindow]);
+    if (!head || !chain) {
+        return Lz4Compress(src, srcSize, dst, dstCapacity);
+    }
+    ChainMatchFinder finder(src, head.get(), chain.get(), 4u << (level - 2), size_t{ 8 } << (level / 2));
+
+    const uint8_t* const end = src + srcSize;
+    const uint8_t* const matchLimit = end - kLastLiterals;
+    const uint8_t* const searchLimit = end - kMatchSearchLimit;
+    const uint8_t* anchor = src;
+    const uint8_t* ip = src;
+    uint8_t* op = dst;
+    size_t lastOffset = 0;
+
+    while (ip < searchLimit) {
+        const uint8_t* match = nullptr;
+        size_t length = finder.find(ip, matchLimit, lastOffset, match);
+        if (length == 0) {
+            ++ip;
+            continue;
+        }
+
+        // 次の位置からの方が長く一致する間は、1バイトずつリテラルに回す
+        while (ip + 1 < searchLimit) {
+            const uint8_t* nextMatch = nullptr;
+            const size_t nextLength = finder.find(ip + 1, matchLimit, lastOffset, nextMatch);
+            if (nextLength <= length) {
+                break;
+            }
+            ++ip;
+            match = nextMatch;
+            length = nextLength;
+        }
+
+        lastOffset = static_cast<size_t>(ip - match);
+        op = writeSequence(op, anchor, static_cast<size_t>(ip - anchor), lastOffset, length);
+        ip += length;
+        anchor = ip;
+    }
+
+    op = writeLastLiterals(op, anchor, static_cast<size_t>(end - anchor));
+    return static_cast<size_t>(op - dst);
+}
+
+namespace {
+
+// 展開の本体。dst の直前の prefixSize バイトも一致の参照先にする
+// 戻り値: 書き込み終えた位置。壊れたデータ・出力先に収まらない場合は nullptr
+uint8_t* decompressSequences(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity,
+                             size_t prefixSize) noexcept {
+    const uint8_t* ip = src;
+    const uint8_t* const srcEnd = src + srcSize;
+    uint8_t* op = dst;
+    uint8_t* const dstEnd = dst + dstCapacity;
+    const uint8_t* const window = dst - prefixSize;
+
+    // 長さの追加バイトを読む。src の末尾を超える場合は false
+    auto readLength = [&](size_t& length) noexcept {
+        uint8_t b;
+        do {
+            if (ip >= srcEnd) {
+                return false;
+            }
+            b = *ip++;
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (ip < srcEnd) {
+        const uint8_t token = *ip++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength < 15 && srcEnd - ip >= 16 && dstEnd - op >= 16) {
+            // 短いリテラルは長さによらず 16 バイトをまとめてコピーする（余分に書いた分は後で上書きされる）
+            std::memcpy(op, ip, 16);
+        }
+        else {
+            if (literalLength == 15 && !readLength(literalLength)) {
+                return nullptr;
+            }
+            if (literalLength > static_cast<size_t>(srcEnd - ip) || literalLength > static_cast<size_t>(dstEnd - op)) {
+                return nullptr;
+            }
+            if (literalLength > 0) {
+                std::memcpy(op, ip, literalLength);
+            }
+        }
+        ip += literalLength;
+        op += literalLength;
+
+        if (ip == srcEnd) {
+            // 最後のシーケンスはリテラルのみ
+            break;
+        }
+
+        if (srcEnd - ip < 2) {
+            return nullptr;
+        }
+        const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - window)) {
+            return nullptr;
+        }
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !readLength(matchLength)) {
+            return nullptr;
+        }
+        matchLength += kMinMatch;
+        if (matchLength > static_cast<size_t>(dstEnd - op)) {
+            return nullptr;
+        }
+
+        // 一致は自分自身と重なりうる（offset < 長さ）。offset が 8 以上なら 8 バイトずつのコピーで
+        // 常に書き込み済みの範囲を読むため、出力先に余裕があればまとめてコピーする
+        const uint8_t* ref = op - offset;
+        uint8_t* const matchEnd = op + matchLength;
+        if (offset >= 8 && dstEnd - matchEnd >= 8) {
+            do {
+                std::memcpy(op, ref, 8);
+                op += 8;
+                ref += 8;
+            } while (op < matchEnd);
+            op = matchEnd;
+        }
+        else {
+            while (op < matchEnd) {
+                *op++ = *ref++;
+            }
+        }
+    }
+
+    return op;
+}
+
+} // namespace
+
+bool Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) noexcept {
+    return decompressSequences(src, srcSize, dst, dstSize, 0) == dst + dstSize;
+}
+
+size_t Lz4DecompressPartial(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity,
+                            size_t prefixSize) noexcept {
+    const uint8_t* const end = decompressSequences(src, srcSize, dst, dstCapacity, prefixSize);
+    return end ? static_cast<size_t>(end - dst) : kLz4Error;
+}
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,48 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/Lz4.h
+// LZ4 ブロック形式の圧縮・展開の内部API
+// 高速圧縮・レベル付き圧縮と、展開後の大きさが既知のデータ・未知のデータ（前のブロックを参照するもの）の展開を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace hsppp {
+namespace internal {
+
+// srcSize バイトを圧縮したときの最大の大きさ（圧縮できないデータでもこれを超えない）
+constexpr size_t Lz4CompressBound(size_t srcSize) noexcept { return srcSize + srcSize / 255 + 16; }
+
+// src を圧縮して dst に書き込む
+// 戻り値: 書き込んだバイト数。dstCapacity に収まらない場合は 0
+size_t Lz4Compress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity) noexcept;
+
+// 圧縮の強さ。1 は Lz4Compress と同じ。2 以上はハッシュチェーンで長い一致を探す（大きいほど遅く小さい）
+// 出力の形式は同じで、展開の速さは変わらない
+constexpr int kLz4MinLevel = 1;
+constexpr int kLz4MaxLevel = 12;
+
+// level を指定して src を圧縮する（level は kLz4MinLevel〜kLz4MaxLevel に丸める）
+// 戻り値: 書き込んだバイト数。dstCapacity に収まらない場合は 0
+size_t Lz4CompressLevel(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity, int level) noexcept;
+
+// 圧縮データ src を dst に展開する
+// 壊れたデータで dst の外や src の外を読み書きすることはない
+// 戻り値: ちょうど dstSize バイトに展開できた場合のみ true
+bool Lz4Decompress(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) noexcept;
+
+// 展開後の大きさが分からない圧縮データを dst に展開する
+// dst の直前の prefixSize バイト（展開済みのデータ）を一致の参照先に含める（前のブロックに依存するブロック用）
+// 戻り値: 書き込んだバイト数。壊れたデータ・dstCapacity に収まらない場合は kLz4Error
+constexpr size_t kLz4Error = static_cast<size_t>(-1);
+size_t Lz4DecompressPartial(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstCapacity,
+                            size_t prefixSize = 0) noexcept;
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,450 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/Lz4Frame.cpp
+// LZ4 フレーム形式の読み書きと xxHash32
+//
+// フレーム = マジック(4) + FLG(1) + BD(1) + [内容の大きさ(8)] + [辞書ID(4)] + HC(1)
+//          + ブロック* + 終端(4 バイトの 0) + [内容のチェックサム(4)]
+// ブロック = 大きさ(4、最上位 bit が立っていれば圧縮なし) + データ + [ブロックのチェックサム(4)]
+// HC はヘッダー（FLG から辞書IDまで）の xxHash32 の 8〜15 bit。数値はすべてリトルエンディアン
+
+#include "Lz4Frame.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+constexpr uint32_t kPrime1 = 2654435761u;
+constexpr uint32_t kPrime2 = 2246822519u;
+constexpr uint32_t kPrime3 = 3266489917u;
+constexpr uint32_t kPrime4 = 668265263u;
+constexpr uint32_t kPrime5 = 374761393u;
+
+constexpr uint32_t kSkippableMagic = 0x184D2A50;    // 下位 4 bit は任意
+constexpr uint32_t kSkippableMask = 0xFFFFFFF0;
+constexpr uint32_t kLegacyMagic = 0x184C2102;
+constexpr uint32_t kUncompressedBit = 0x80000000u;
+constexpr size_t kLinkedWindow = 64 * 1024;         // 依存するブロックが参照できる範囲
+
+// FLG
+constexpr uint8_t kFlagVersion = 0x40;
+constexpr uint8_t kFlagVersionMask = 0xC0;
+constexpr uint8_t kFlagIndependent = 0x20;
+constexpr uint8_t kFlagBlockChecksum = 0x10;
+constexpr uint8_t kFlagContentSize = 0x08;
+constexpr uint8_t kFlagContentChecksum = 0x04;
+constexpr uint8_t kFlagReserved = 0x02;
+constexpr uint8_t kFlagDictionary = 0x01;
+
+uint32_t readLe32(const uint8_t* p) noexcept {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint64_t readLe64(const uint8_t* p) noexcept {
+    return static_cast<uint64_t>(readLe32(p)) | (static_cast<uint64_t>(readLe32(p + 4)) << 32);
+}
+
+uint8_t* writeLe32(uint8_t* p, uint32_t value) noexcept {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+    return p + 4;
+}
+
+uint32_t xxhRound(uint32_t lane, uint32_t input) noexcept {
+    return std::rotl(lane + input * kPrime2, 13) * kPrime1;
+}
+
+// BD の上位 3 bit（4〜7）と 1ブロックの最大の大きさの対応
+size_t blockSizeFromId(unsigned id) noexcept {
+    return size_t{ 1 } << (2 * id + 8);
+}
+
+} // namespace
+
+// ============================================================
+// xxHash32
+// ============================================================
+
+Xxh32::Xxh32(uint32_t seed) noexcept
+    : seed_(seed), lanes_{ seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1 } {}
+
+void Xxh32::update(const uint8_t* data, size_t size) noexcept {
+    total_ += size;
+    if (buffered_ + size < 16) {
+        if (size > 0) {
+            std::memcpy(buffer_ + buffered_, data, size);
+        }
+        buffered_ += size;
+        return;
+    }
+
+    if (buffered_ > 0) {
+        const size_t take = 16 - buffered_;
+        std::memcpy(buffer_ + buffered_, data, take);
+        for (int i = 0; i < 4; ++i) {
+            lanes_[i] = xxhRound(lanes_[i], readLe32(buffer_ + i * 4));
+        }
+        data += take;
+        size -= take;
+        buffered_ = 0;
+    }
+
+    const uint8_t* const end = data + (size & ~size_t{ 15 });
+    uint32_t v1 = lanes_[0], v2 = lanes_[1], v3 = lanes_[2], v4 = lanes_[3];
+    for (; data < end; data += 16) {
+        v1 = xxhRound(v1, readLe32(data));
+        v2 = xxhRound(v2, readLe32(data + 4));
+        v3 = xxhRound(v3, readLe32(data + 8));
+        v4 = xxhRound(v4, readLe32(data + 12));
+    }
+    lanes_[0] = v1;
+    lanes_[1] = v2;
+    lanes_[2] = v3;
+    lanes_[3] = v4;
+
+    buffered_ = size & 15;
+    if (buffered_ > 0) {
+        std::memcpy(buffer_, end, buffered_);
+    }
+}
+
+uint32_t Xxh32::digest() const noexcept {
+    uint32_t h = (total_ >= 16)
+        ? std::rotl(lanes_[0], 1) + std::rotl(lanes_[1], 7) + std::rotl(lanes_[2], 12) + std::rotl(lanes_[3], 18)
+        : seed_ + kPrime5;
+    h += static_cast<uint32_t>(total_);
+
+    const uint8_t* p = buffer_;
+    const uint8_t* const end = buffer_ + buffered_;
+    for (; p + 4 <= end; p += 4) {
+        h = std::rotl(h + readLe32(p) * kPrime3, 17) * kPrime4;
+    }
+    for (; p < end; ++p) {
+        h = std::rotl(h + *p * kPrime5, 11) * kPrime1;
+    }
+
+    h ^= h >> 15;
+    h *= kPrime2;
+    h ^= h >> 13;
+    h *= kPrime3;
+    h ^= h >> 16;
+    return h;
+}
+
+uint32_t Xxh32::Hash(const uint8_t* data, size_t size, uint32_t seed) noexcept {
+    Xxh32 state(seed);
+    state.update(data, size);
+    return state.digest();
+}
+
+// ============================================================
+// 書き込み
+// ============================================================
+
+bool Lz4FrameBlockSizeValid(size_t blockSize) noexcept {
+    for (unsigned id = 4; id <= 7; ++id) {
+        if (blockSize == blockSizeFromId(id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t Lz4FrameWriteHeader(const Lz4FrameHeader& header, uint8_t* out) noexcept {
+    uint8_t* p = writeLe32(out, kLz4FrameMagic);
+    uint8_t* const descriptor = p;
+
+    uint8_t flags = kFlagVersion | kFlagIndependent;
+    if (header.contentChecksum) {
+        flags |= kFlagContentChecksum;
+    }
+    if (header.contentSize >= 0) {
+        flags |= kFlagContentSize;
+    }
+    *p++ = flags;
+    *p++ = static_cast<uint8_t>(((std::bit_width(header.blockSize) - 9) / 2) << 4);
+    if (header.contentSize >= 0) {
+        const uint64_t size = static_cast<uint64_t>(header.contentSize);
+        p = writeLe32(p, static_cast<uint32_t>(size));
+        p = writeLe32(p, static_cast<uint32_t>(size >> 32));
+    }
+    *p = static_cast<uint8_t>(Xxh32::Hash(descriptor, static_cast<size_t>(p - descriptor)) >> 8);
+    ++p;
+    return static_cast<size_t>(p - out);
+}
+
+size_t Lz4FrameWriteBlock(const uint8_t* src, size_t size, int level, uint8_t* out) noexcept {
+    const size_t packed = Lz4CompressLevel(src, size, out + 4, Lz4CompressBound(size), level);
+    if (packed > 0 && packed < size) {
+        writeLe32(out, static_cast<uint32_t>(packed));
+        return 4 + packed;
+    }
+    writeLe32(out, static_cast<uint32_t>(size) | kUncompressedBit);
+    std::memcpy(out + 4, src, size);
+    return 4 + size;
+}
+
+size_t Lz4FrameWriteEnd(bool contentChecksum, uint32_t checksum, uint8_t* out) noexcept {
+    uint8_t* p = writeLe32(out, 0);
+    if (contentChecksum) {
+        p = writeLe32(p, checksum);
+    }
+    return static_cast<size_t>(p - out);
+}
+
+// ============================================================
+// 読み込み
+// ============================================================
+
+// staging_ が need バイトになるまで input から写す（ヘッダーなどの小さな部分）
+bool Lz4FrameDecoder::fill(std::span<const uint8_t>& input, size_t need) {
+    if (staging_.size() >= need) {
+        return true;
+    }
+    const size_t take = std::min(need - staging_.size(), input.size());
+    staging_.insert(staging_.end(), input.begin(), input.begin() + take);
+    input = input.subspan(take);
+    return staging_.size() == need;
+}
+
+// need バイトをそろえて data に先頭を返す。input にそろっていればコピーしない
+bool Lz4FrameDecoder::gather(std::span<const uint8_t>& input, size_t need, const uint8_t*& data) {
+    if (staging_.empty() && input.size() >= need) {
+        data = input.data();
+        input = input.subspan(need);
+        return true;
+    }
+    if (!fill(input, need)) {
+        return false;
+    }
+    data = staging_.data();
+    return true;
+}
+
+Lz4FrameStatus Lz4FrameDecoder::fail(Lz4FrameStatus status) noexcept {
+    state_ = State::Failed;
+    error_ = status;
+    return status;
+}
+
+Lz4FrameStatus Lz4FrameDecoder::parseHeader() {
+    const uint8_t* const descriptor = staging_.data() + 4;
+    const uint8_t flags = descriptor[0];
+    const uint8_t bd = descriptor[1];
+    if ((flags & kFlagVersionMask) != kFlagVersion || (flags & (kFlagReserved | kFlagDictionary)) != 0 ||
+        (bd & 0x8F) != 0 || ((bd >> 4) & 7) < 4) {
+        return fail(Lz4FrameStatus::Unsupported);
+    }
+    const size_t descriptorSize = staging_.size() - 5;
+    if (static_cast<uint8_t>(Xxh32::Hash(descriptor, descriptorSize) >> 8) != staging_.back()) {
+        return fail(Lz4FrameStatus::Corrupt);
+    }
+
+    blockSize_ = blockSizeFromId((bd >> 4) & 7);
+    independentBlocks_ = (flags & kFlagIndependent) != 0;
+    blockChecksum_ = (flags & kFlagBlockChecksum) != 0;
+    contentChecksum_ = (flags & kFlagContentChecksum) != 0;
+    contentSize_ = -1;
+    if (flags & kFlagContentSize) {
+        const uint64_t size = readLe64(descriptor + 2);
+        if (size > static_cast<uint64_t>(INT64_MAX)) {
+            return fail(Lz4FrameStatus::Corrupt);
+        }
+        contentSize_ = static_cast<int64_t>(size);
+    }
+    decodedSize_ = 0;
+    contentHash_ = Xxh32();
+
+    // 依存するブロックでは、直前の 64KB を残したまま次のブロックを展開できる大きさにする
+    const size_t windowSize = independentBlocks_ ? blockSize_ : kLinkedWindow + blockSize_;
+    if (window_.size() < windowSize) {
+        window_.resize(windowSize);
+    }
+    windowUsed_ = 0;
+    return Lz4FrameStatus::NeedInput;
+}
+
+// fromStaging: data が staging_ を指す（圧縮なしのブロックも window_ に写してから返す）
+Lz4FrameStatus Lz4FrameDecoder::decodeBlock(const uint8_t* data, bool fromStaging, std::span<const uint8_t>& block) {
+    const bool uncompressed = (blockSizeField_ & kUncompressedBit) != 0;
+    const size_t size = blockSizeField_ & ~kUncompressedBit;
+    if (blockChecksum_ && Xxh32::Hash(data, size) != readLe32(data + size)) {
+        return fail(Lz4FrameStatus::ChecksumMismatch);
+    }
+
+    if (independentBlocks_) {
+        if (uncompressed && !fromStaging) {
+            block = std::span<const uint8_t>(data, size);
+        }
+        else if (uncompressed) {
+            std::memcpy(window_.data(), data, size);
+            block = std::span<const uint8_t>(window_.data(), size);
+        }
+        else {
+            const size_t produced = Lz4DecompressPartial(data, size, window_.data(), blockSize_);
+            if (produced == kLz4Error) {
+                return fail(Lz4FrameStatus::Corrupt);
+            }
+            block = std::span<const uint8_t>(window_.data(), produced);
+        }
+    }
+    else {
+        // 直前の 64KB を先頭に詰めてから、その後ろに展開する
+        if (windowUsed_ + blockSize_ > window_.size()) {
+            std::memmove(window_.data(), window_.data() + windowUsed_ - kLinkedWindow, kLinkedWindow);
+            windowUsed_ = kLinkedWindow;
+        }
+        uint8_t* const dst = window_.data() + windowUsed_;
+        size_t produced = size;
+        if (uncompressed) {
+            std::memcpy(dst, data, size);
+        }
+        else {
+            produced = Lz4DecompressPartial(data, size, dst, blockSize_, std::min(windowUsed_, kLinkedWindow));
+            if (produced == kLz4Error) {
+                return fail(Lz4FrameStatus::Corrupt);
+            }
+        }
+        windowUsed_ += produced;
+        block = std::span<const uint8_t>(dst, produced);
+    }
+
+    decodedSize_ += block.size();
+    if (contentSize_ >= 0 && decodedSize_ > static_cast<uint64_t>(contentSize_)) {
+        return fail(Lz4FrameStatus::Corrupt);
+    }
+    if (contentChecksum_) {
+        contentHash_.update(block.data(), block.size());
+    }
+    return Lz4FrameStatus::Block;
+}
+
+Lz4FrameStatus Lz4FrameDecoder::decode(std::span<const uint8_t>& input, std::span<const uint8_t>& block) {
+    block = {};
+    while (true) {
+        switch (state_) {
+        case State::Failed:
+            return error_;
+
+        case State::Magic: {
+            if (!fill(input, 4)) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            const uint32_t magic = readLe32(staging_.data());
+            if (magic == kLz4FrameMagic) {
+                state_ = State::Header;
+                break;
+            }
+            staging_.clear();
+            if ((magic & kSkippableMask) == kSkippableMagic) {
+                state_ = State::SkipSize;
+                break;
+            }
+            return fail(magic == kLegacyMagic ? Lz4FrameStatus::Unsupported : Lz4FrameStatus::BadMagic);
+        }
+
+        case State::SkipSize:
+            if (!fill(input, 4)) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            skipRemaining_ = readLe32(staging_.data());
+            staging_.clear();
+            state_ = State::Skip;
+            break;
+
+        case State::Skip: {
+            const size_t take = static_cast<size_t>(std::min<uint64_t>(skipRemaining_, input.size()));
+            input = input.subspan(take);
+            skipRemaining_ -= take;
+            if (skipRemaining_ > 0) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            state_ = State::Magic;
+            break;
+        }
+
+        case State::Header: {
+            // マジックの後ろの FLG を見てから、ヘッダー全体の大きさを決める
+            if (!fill(input, 5)) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            const uint8_t flags = staging_[4];
+            const size_t headerSize = 4 + 2 + ((flags & kFlagContentSize) ? 8 : 0) +
+                                      ((flags & kFlagDictionary) ? 4 : 0) + 1;
+            if (!fill(input, headerSize)) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            if (const Lz4FrameStatus status = parseHeader(); status != Lz4FrameStatus::NeedInput) {
+                return status;
+            }
+            staging_.clear();
+            state_ = State::BlockSize;
+            break;
+        }
+
+        case State::BlockSize:
+            if (!fill(input, 4)) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            blockSizeField_ = readLe32(staging_.data());
+            staging_.clear();
+            if (blockSizeField_ == 0) {
+                if (contentSize_ >= 0 && decodedSize_ != static_cast<uint64_t>(contentSize_)) {
+                    return fail(Lz4FrameStatus::Corrupt);
+                }
+                state_ = State::ContentChecksum;
+                break;
+            }
+            if ((blockSizeField_ & ~kUncompressedBit) > blockSize_) {
+                return fail(Lz4FrameStatus::Corrupt);
+            }
+            state_ = State::BlockData;
+            break;
+
+        case State::BlockData: {
+            const uint8_t* data = nullptr;
+            const size_t need = (blockSizeField_ & ~kUncompressedBit) + (blockChecksum_ ? 4 : 0);
+            if (!gather(input, need, data)) {
+                return Lz4FrameStatus::NeedInput;
+            }
+            const Lz4FrameStatus status = decodeBlock(data, data == staging_.data(), block);
+            if (status != Lz4FrameStatus::Block) {
+                return status;
+            }
+            staging_.clear();
+            state_ = State::BlockSize;
+            return status;
+        }
+
+        case State::ContentChecksum:
+            if (contentChecksum_) {
+                if (!fill(input, 4)) {
+                    return Lz4FrameStatus::NeedInput;
+                }
+                const uint32_t expected = readLe32(staging_.data());
+                staging_.clear();
+                if (contentHash_.digest() != expected) {
+                    return fail(Lz4FrameStatus::ChecksumMismatch);
+                }
+            }
+            ++frameCount_;
+            state_ = State::Magic;
+            return Lz4FrameStatus::FrameEnd;
+        }
+    }
+}
+
+} // namespace internal
+} // namespace hsppp
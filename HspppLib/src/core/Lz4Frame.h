@@ -0,0 +1,138 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/Lz4Frame.h
+// LZ4 フレーム形式の読み書きと xxHash32 の内部API（Compressor / Decompressor）
+// xxHash32、フレームのヘッダー・ブロック・終端の書き出し、分割入力を受け付ける逐次デコーダーを提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Lz4.h"
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// xxHash32
+// ============================================================
+
+// ヘッダー・ブロック・内容のチェックサムに使う xxHash32。少しずつ渡して計算できる
+class Xxh32 {
+public:
+    explicit Xxh32(uint32_t seed = 0) noexcept;
+
+    void update(const uint8_t* data, size_t size) noexcept;
+    uint32_t digest() const noexcept;
+
+    static uint32_t Hash(const uint8_t* data, size_t size, uint32_t seed = 0) noexcept;
+
+private:
+    uint32_t seed_;
+    uint32_t lanes_[4];
+    uint64_t total_ = 0;
+    uint8_t buffer_[16];        // 16 バイトに満たない残り
+    size_t buffered_ = 0;
+};
+
+// ============================================================
+// 書き込み
+// ============================================================
+
+constexpr uint32_t kLz4FrameMagic = 0x184D2204;
+constexpr size_t kLz4FrameMaxHeaderSize = 19;       // マジック + FLG + BD + 内容の大きさ + 辞書ID + HC
+constexpr size_t kLz4FrameMaxEndSize = 8;           // 終端 + 内容のチェックサム
+constexpr size_t kLz4FrameMaxBlockSize = 4 * 1024 * 1024;
+
+// 1ブロックの最大の大きさとして指定できるか（64KB / 256KB / 1MB / 4MB）
+bool Lz4FrameBlockSizeValid(size_t blockSize) noexcept;
+
+struct Lz4FrameHeader {
+    size_t blockSize = 256 * 1024;  // 1ブロックの最大の大きさ（Lz4FrameBlockSizeValid）
+    bool contentChecksum = true;    // 末尾に内容の xxHash32 を付ける
+    int64_t contentSize = -1;       // 内容の大きさ（負の場合は書かない）
+};
+
+// ヘッダーを out（kLz4FrameMaxHeaderSize バイト以上）に書き込み、書き込んだバイト数を返す
+// 書き出すブロックは前のブロックに依存しない（並列に圧縮・展開できる）
+size_t Lz4FrameWriteHeader(const Lz4FrameHeader& header, uint8_t* out) noexcept;
+
+// size バイトを1ブロックとして書き出すときの最大の大きさ（先頭の4バイトの大きさを含む）
+constexpr size_t Lz4FrameBlockBound(size_t size) noexcept { return 4 + Lz4CompressBound(size); }
+
+// src（ヘッダーの blockSize 以下）を1ブロックとして out（Lz4FrameBlockBound(size) バイト以上）に書き込む
+// 圧縮しても小さくならない場合はそのまま格納する
+// 戻り値: 書き込んだバイト数
+size_t Lz4FrameWriteBlock(const uint8_t* src, size_t size, int level, uint8_t* out) noexcept;
+
+// 終端と内容のチェックサムを out（kLz4FrameMaxEndSize バイト以上）に書き込み、書き込んだバイト数を返す
+size_t Lz4FrameWriteEnd(bool contentChecksum, uint32_t checksum, uint8_t* out) noexcept;
+
+// ============================================================
+// 読み込み
+// ============================================================
+
+enum class Lz4FrameStatus {
+    NeedInput,          // 渡した入力をすべて読んだ（続きを渡す）
+    Block,              // ブロックを1つ展開した
+    FrameEnd,           // フレームの終わりに達した（続きがあれば次のフレームとして読む）
+    BadMagic,           // LZ4 フレーム形式ではない
+    Unsupported,        // 辞書・旧形式など対応していない形式
+    Corrupt,            // 壊れている
+    ChecksumMismatch,   // チェックサムが一致しない
+};
+
+// 入力を少しずつ渡してフレームを展開する
+// 前のブロックに依存するブロック・ブロックのチェックサム・スキップ可能なフレーム・連結したフレームにも対応する
+class Lz4FrameDecoder {
+public:
+    // input の先頭から読み進め、読んだ分だけ input を縮める
+    // Block の場合は block に展開した内容を返す。次の呼び出しまで、かつ input の元のバッファを変更するまで有効
+    // エラーを返した後は同じエラーを返し続ける
+    Lz4FrameStatus decode(std::span<const uint8_t>& input, std::span<const uint8_t>& block);
+
+    // フレームの境目にいるか（入力の終わりで true なら、途中で切れていない）
+    bool atFrameBoundary() const noexcept { return state_ == State::Magic && staging_.empty(); }
+
+    // 読み終えた LZ4 フレームの数
+    int64_t frameCount() const noexcept { return frameCount_; }
+
+    // 読んでいるフレームのヘッダーにある内容の大きさ（ない場合は -1）
+    int64_t contentSize() const noexcept { return contentSize_; }
+
+private:
+    enum class State { Magic, SkipSize, Skip, Header, BlockSize, BlockData, ContentChecksum, Failed };
+
+    bool fill(std::span<const uint8_t>& input, size_t need);
+    bool gather(std::span<const uint8_t>& input, size_t need, const uint8_t*& data);
+    Lz4FrameStatus fail(Lz4FrameStatus status) noexcept;
+    Lz4FrameStatus parseHeader();
+    Lz4FrameStatus decodeBlock(const uint8_t* data, bool fromStaging, std::span<const uint8_t>& block);
+
+    State state_ = State::Magic;
+    Lz4FrameStatus error_ = Lz4FrameStatus::Corrupt;
+    std::vector<uint8_t> staging_;      // 入力の切れ目をまたぐヘッダー・ブロック
+    std::vector<uint8_t> window_;       // 展開先（依存するブロックでは直前の 64KB を残す）
+    size_t windowUsed_ = 0;
+    uint64_t skipRemaining_ = 0;
+    uint32_t blockSizeField_ = 0;
+
+    size_t blockSize_ = 0;
+    bool independentBlocks_ = true;
+    bool blockChecksum_ = false;
+    bool contentChecksum_ = false;
+    int64_t contentSize_ = -1;
+    uint64_t decodedSize_ = 0;
+    Xxh32 contentHash_;
+    int64_t frameCount_ = 0;
+};
+
+} // namespace internal
+} // namespace hsppp
@@ -20,9 +20,12 @@
 #include <evr.h>
 #include <wrl/client.h>
 
+#include <shlwapi.h>
 #include <fstream>
+#include <spanstream>
 #include <algorithm>
 #include <cmath>
+#include <climits>
 
 #include "MediaManager.h"
 #include "Internal.h"
@@ -34,6 +37,7 @@
 #pragma comment(lib, "mf.lib")
 #pragma comment(lib, "propsys.lib")
 #pragma comment(lib, "evr.lib")
+#pragma comment(lib, "shlwapi.lib")
 
 namespace hsppp {
 namespace internal {
@@ -163,6 +167,7 @@ MediaSlot::MediaSlot(MediaSlot&& other) noexcept
     , videoWindow(other.videoWindow)
     , videoX(other.videoX)
     , videoY(other.videoY)
+    , reloadPending(other.reloadPending)
     , audioBuffer(std::move(other.audioBuffer))
     , sourceVoice(std::move(other.sourceVoice))
     , voiceCallback(std::move(other.voiceCallback))
@@ -201,6 +206,7 @@ MediaSlot& MediaSlot::operator=(MediaSlot&& other) noexcept {
         videoWindow = other.videoWindow;
         videoX = other.videoX;
         videoY = other.videoY;
+        reloadPending = other.reloadPending;
         audioBuffer = std::move(other.audioBuffer);
         sourceVoice = std::move(other.sourceVoice);
         voiceCallback = std::move(other.voiceCallback);
@@ -376,7 +382,10 @@ bool MediaManager::mmload(std::string_view filename, int bufferId, int mode, HWN
 
     // ファイルサイズチェック（2MB以下のWAVはオンメモリ）
     bool loadToMemory = false;
-    if (slot->type == MediaType::WAV) {
+    if (slot->type == MediaType::WAV && IsPackPath(resolvedPath)) {
+        uint64_t size = 0;
+        loadToMemory = FindPackEntry(resolvedPath, size) == PackStatus::Ok && size <= 2 * 1024 * 1024;
+    } else if (slot->type == MediaType::WAV) {
         std::ifstream file(resolvedPath, std::ios::binary | std::ios::ate);
         if (file.is_open()) {
             auto size = file.tellg();
@@ -433,10 +442,7 @@ bool MediaManager::mmload(std::string_view filename, int bufferId, int mode, HWN
 // ============================================================
 // WAVファイル読み込み
 // ============================================================
-bool MediaManager::loadWavFile(std::string_view filename, AudioBuffer& buffer) {
-    std::ifstream file(std::string(filename), std::ios::binary);
-    if (!file.is_open()) return false;
-
+static bool parseWav(std::istream& file, AudioBuffer& buffer) {
     // RIFFヘッダ
     char riff[4];
     file.read(riff, 4);
@@ -489,29 +495,73 @@ bool MediaManager::loadWavFile(std::string_view filename, AudioBuffer& buffer) {
     return buffer.isValid;
 }
 
+bool MediaManager::loadWavFile(std::string_view filename, AudioBuffer& buffer) {
+    if (IsPackPath(filename)) {
+        // パック内の WAV はマップ上（圧縮している場合は展開したバッファ）から直接読む
+        PackData data;
+        if (OpenPackData(filename, data) != PackStatus::Ok) return false;
+        std::ispanstream stream(std::span<const char>(reinterpret_cast<const char*>(data.bytes.data()), data.bytes.size()));
+        return parseWav(stream, buffer);
+    }
+
+    std::ifstream file(std::string(filename), std::ios::binary);
+    if (!file.is_open()) return false;
+    return parseWav(file, buffer);
+}
+
+// Media Foundation のメディアソースを作成
+// pack:// の場合は内容をメモリストリームに複写して渡す（再生中もパックを閉じられるように）
+static HRESULT createMediaSource(IMFSourceResolver* resolver, std::string_view filename, ComPtr<IUnknown>& source) {
+    // ファイルパスをワイド文字に変換
+    std::wstring wpath = Utf8ToWide(filename);
+    MF_OBJECT_TYPE objectType;
+
+    if (!IsPackPath(filename)) {
+        return resolver->CreateObjectFromURL(
+            wpath.c_str(),
+            MF_RESOLUTION_MEDIASOURCE,
+            nullptr,
+            &objectType,
+            &source
+        );
+    }
+
+    PackData data;
+    if (OpenPackData(filename, data) != PackStatus::Ok || data.bytes.size() > UINT_MAX) {
+        return HRESULT_FROM_WIN32(ERROR_FILE_NOT_FOUND);
+    }
+    ComPtr<IStream> stream;
+    stream.Attach(SHCreateMemStream(data.bytes.data(), static_cast<UINT>(data.bytes.size())));
+    if (!stream) return E_OUTOFMEMORY;
+
+    ComPtr<IMFByteStream> byteStream;
+    HRESULT hr = MFCreateMFByteStreamOnStream(stream.Get(), &byteStream);
+    if (FAILED(hr)) return hr;
+
+    // 形式の判定に拡張子を使うため、名前も渡す
+    return resolver->CreateObjectFromByteStream(
+        byteStream.Get(),
+        wpath.c_str(),
+        MF_RESOLUTION_MEDIASOURCE,
+        nullptr,
+        &objectType,
+        &source
+    );
+}
+
 // ============================================================
 // Media Foundation でメディア読み込み（セッション準備）
 // ============================================================
 bool MediaManager::loadMediaFoundation(std::string_view filename, MediaSlot& slot) {
     HRESULT hr;
 
-    // ファイルパスをワイド文字に変換
-    std::wstring wpath = Utf8ToWide(filename);
-
     // メディアソース作成
     ComPtr<IMFSourceResolver> resolver;
     hr = MFCreateSourceResolver(&resolver);
     if (FAILED(hr)) return false;
 
-    MF_OBJECT_TYPE objectType;
     ComPtr<IUnknown> source;
-    hr = resolver->CreateObjectFromURL(
-        wpath.c_str(),
-        MF_RESOLUTION_MEDIASOURCE,
-        nullptr,
-        &objectType,
-        &source
-    );
+    hr = createMediaSource(resolver.Get(), filename, source);
     if (FAILED(hr)) return false;
 
     hr = source.As(&slot.mediaSource);
@@ -604,9 +654,11 @@ bool MediaManager::mmplay(int bufferId) {
         const bool needsRecreate =
             !slot.mediaSession ||
             !slot.mediaSource ||
+            slot.reloadPending ||
             (slot.mfCallback && slot.mfCallback->hasEnded.load());
 
         if (needsRecreate) {
+            slot.reloadPending = false;
             releaseMediaFoundation(slot);
             if (!loadMediaFoundation(slot.filename, slot)) {
                 return false;
@@ -1121,7 +1173,67 @@ float MediaManager::hspPanToFloat(int hspPan) {
     return hspPan / 1000.0f;
 }
 
+// ============================================================
+// ファイルの変更による読み直し（filewatch）
+// ============================================================
+// 入出力用の作業スレッドから呼ばれる。WAV の読み込みはロックの外で行い、差し替えだけをロックして行う
+int MediaManager::reloadFiles(std::span<const std::string> normalizedPaths, std::string_view underDirectory) {
+    auto matches = [&](const std::string& filename) {
+        if (filename.empty() || IsPackPath(filename)) return false;
+        const std::string normalized = NormalizeWatchPath(filename);
+        if (!underDirectory.empty()) {
+            return IsWatchPathUnder(normalized, underDirectory);
+        }
+        return std::find(normalizedPaths.begin(), normalizedPaths.end(), normalized) != normalizedPaths.end();
+    };
+
+    int reloaded = 0;
+    std::vector<std::string> wavFiles;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, slot] : slots_) {
+            if (!matches(slot->filename)) continue;
+            if (slot->audioBuffer) {
+                if (std::find(wavFiles.begin(), wavFiles.end(), slot->filename) == wavFiles.end()) {
+                    wavFiles.push_back(slot->filename);
+                }
+            } else {
+                // ストリーミング再生のため、開き直すまでは古い内容のまま再生する
+                // まだ読み直していないため reloaded には数えない
+                slot->reloadPending = true;
+            }
+        }
+    }
+
+    for (const std::string& file : wavFiles) {
+        AudioBuffer buffer;
+        if (!loadWavFile(file, buffer)) continue;   // 書き込み途中などで読めない場合は次の変更を待つ
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [id, slot] : slots_) {
+            if (slot->filename != file || !slot->audioBuffer) continue;
+            // 再生中のボイスは古いバッファを参照しているため、差し替える前に破棄する
+            // ループ再生中のものは新しい内容で再生し直す
+            const bool restart = slot->state == MediaState::Playing && slot->playMode == PlayMode::Loop;
+            if (slot->sourceVoice) {
+                stopXAudio2(*slot);
+                slot->sourceVoice.reset();
+            }
+            slot->audioBuffer = std::make_unique<AudioBuffer>(buffer);
+            if (restart && playXAudio2(*slot)) {
+                slot->state = MediaState::Playing;
+            }
+            ++reloaded;
+        }
+    }
+    return reloaded;
+}
+
 std::string MediaManager::resolveFilePath(std::string_view filename) {
+    // パック内のファイルはそのまま
+    if (IsPackPath(filename)) {
+        return std::string(filename);
+    }
     // 絶対パスならそのまま
     if (filename.length() >= 2 && filename[1] == ':') {
         return std::string(filename);
@@ -1173,6 +1285,10 @@ int MediaManager_mmstat(int bufferId, int mode) {
     return MediaManager::getInstance().mmstat(bufferId, mode);
 }
 
+int MediaManager_reloadFiles(std::span<const std::string> normalizedPaths, std::string_view underDirectory) {
+    return MediaManager::getInstance().reloadFiles(normalizedPaths, underDirectory);
+}
+
 void MediaManager_initialize() {
     MediaManager::getInstance().initialize();
 }
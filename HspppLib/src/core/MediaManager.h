@@ -29,6 +29,7 @@
 #include <string_view>
 #include <memory>
 #include <map>
+#include <span>
 #include <vector>
 #include <mutex>
 #include <atomic>
@@ -288,6 +289,7 @@ struct MediaSlot {
     HWND targetWindow = nullptr;     // 動画レンダラーの描画先ウィンドウ（内部で使用）
     HWND videoWindow = nullptr;      // 動画表示用の子ウィンドウ（EVRはここに描画）
     int videoX = 0, videoY = 0;      // 動画再生位置
+    bool reloadPending = false;      // ファイルが変更された（Media Foundation のスロットは次の mmplay で開き直す）
 
     // XAudio2用（SE/WAV）
     std::unique_ptr<AudioBuffer> audioBuffer;
@@ -334,6 +336,11 @@ public:
     bool isPlaying(int bufferId);
     MediaType detectMediaType(std::string_view filename);
 
+    // 変更されたファイルから読み込んだスロットを読み直す（filewatch。任意のスレッドから呼び出し可）
+    // normalizedPaths と underDirectory は NormalizeWatchPath の形。underDirectory が空でなければ、その下のすべてが対象
+    // 戻り値は読み直したスロットの数（次の mmplay で開き直す Media Foundation のスロットは含まない）
+    int reloadFiles(std::span<const std::string> normalizedPaths, std::string_view underDirectory);
+
 private:
     MediaManager() = default;
     ~MediaManager() = default;
@@ -0,0 +1,201 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/MemoryMap.cpp
+// ファイルの読み取り専用メモリマップの実装
+// ファイルハンドルとマッピングオブジェクトはビューが参照を保持するため、マップ直後に閉じる
+
+#include "MemoryMap.h"
+
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include "Transcode.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+// マップするバイト数を確定する。ビューが不要（空の範囲）なら 0
+// 32ビット環境では size_t に収まらないことがあるため、64ビットのまま返し、呼び出し側で確かめてから region.size に入れる
+uint64_t resolveRange(uint64_t fileSize, uint64_t offset, int64_t size) noexcept {
+    if (offset >= fileSize || size == 0) {
+        return 0;
+    }
+    const uint64_t remaining = fileSize - offset;
+    return (size < 0 || static_cast<uint64_t>(size) > remaining) ? remaining : static_cast<uint64_t>(size);
+}
+
+} // namespace
+
+#ifdef _WIN32
+
+size_t MapGranularity() noexcept {
+    static const size_t s_granularity = [] {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwAllocationGranularity);
+    }();
+    return s_granularity;
+}
+
+MapStatus MapFileRegion(std::string_view utf8Path, uint64_t offset, int64_t size,
+                        FileRegion& region, uint32_t& systemError) {
+    region = {};
+    systemError = 0;
+
+    std::u16string path;
+    Utf8ToUtf16Into(utf8Path, path);
+    HANDLE hFile = CreateFileW(reinterpret_cast<const wchar_t*>(path.c_str()), GENERIC_READ, FILE_SHARE_READ,
+                               nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (hFile == INVALID_HANDLE_VALUE) {
+        systemError = GetLastError();
+        return MapStatus::OpenFailed;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(hFile, &fileSize)) {
+        systemError = GetLastError();
+        CloseHandle(hFile);
+        return MapStatus::SizeFailed;
+    }
+
+    // 長さ 0 のファイルはマッピングオブジェクトを作れないため、ここで空の範囲として返す
+    region.fileSize = static_cast<uint64_t>(fileSize.QuadPart);
+    const uint64_t length = resolveRange(region.fileSize, offset, size);
+    if (length == 0) {
+        CloseHandle(hFile);
+        return MapStatus::Ok;
+    }
+
+    // viewLength >= length のため、これで length も size_t に収まる
+    const uint64_t viewOffset = offset - offset % MapGranularity();
+    const uint64_t viewLength = offset - viewOffset + length;
+    if (viewLength > static_cast<uint64_t>(SIZE_MAX)) {
+        CloseHandle(hFile);
+        region = {};
+        return MapStatus::TooLarge;
+    }
+    region.size = static_cast<size_t>(length);
+
+    HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!hMapping) {
+        systemError = GetLastError();
+        CloseHandle(hFile);
+        region = {};
+        return MapStatus::MapFailed;
+    }
+    CloseHandle(hFile);
+
+    void* base = MapViewOfFile(hMapping, FILE_MAP_READ,
+                               static_cast<DWORD>(viewOffset >> 32), static_cast<DWORD>(viewOffset),
+                               static_cast<SIZE_T>(viewLength));
+    if (!base) {
+        systemError = GetLastError();
+    }
+    CloseHandle(hMapping);
+    if (!base) {
+        region = {};
+        return MapStatus::MapFailed;
+    }
+
+    region.base = base;
+    region.mappedLength = static_cast<size_t>(viewLength);
+    region.data = static_cast<const uint8_t*>(base) + (offset - viewOffset);
+    return MapStatus::Ok;
+}
+
+void UnmapFileRegion(void* base, size_t) noexcept {
+    if (base) {
+        UnmapViewOfFile(base);
+    }
+}
+
+#else
+
+size_t MapGranularity() noexcept {
+    static const size_t s_granularity = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return s_granularity;
+}
+
+MapStatus MapFileRegion(std::string_view utf8Path, uint64_t offset, int64_t size,
+                        FileRegion& region, uint32_t& systemError) {
+    region = {};
+    systemError = 0;
+
+    const std::string path(utf8Path);
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        systemError = static_cast<uint32_t>(errno);
+        return MapStatus::OpenFailed;
+    }
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        systemError = static_cast<uint32_t>(errno);
+        ::close(fd);
+        return MapStatus::SizeFailed;
+    }
+
+    region.fileSize = static_cast<uint64_t>(st.st_size);
+    const uint64_t length = resolveRange(region.fileSize, offset, size);
+    if (length == 0) {
+        ::close(fd);
+        return MapStatus::Ok;
+    }
+
+    // viewLength >= length のため、これで length も size_t に収まる
+    const uint64_t viewOffset = offset - offset % MapGranularity();
+    const uint64_t viewLength = offset - viewOffset + length;
+    if (viewLength > static_cast<uint64_t>(SIZE_MAX)) {
+        ::close(fd);
+        region = {};
+        return MapStatus::TooLarge;
+    }
+    region.size = static_cast<size_t>(length);
+
+    void* base = ::mmap(nullptr, static_cast<size_t>(viewLength), PROT_READ, MAP_PRIVATE, fd,
+                        static_cast<off_t>(viewOffset));
+    if (base == MAP_FAILED) {
+        systemError = static_cast<uint32_t>(errno);
+    }
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        region = {};
+        return MapStatus::MapFailed;
+    }
+
+    region.base = base;
+    region.mappedLength = static_cast<size_t>(viewLength);
+    region.data = static_cast<const uint8_t*>(base) + (offset - viewOffset);
+    return MapStatus::Ok;
+}
+
+void UnmapFileRegion(void* base, size_t mappedLength) noexcept {
+    if (base) {
+        ::munmap(base, mappedLength);
+    }
+}
+
+#endif
+
+} // namespace internal
+} // namespace hsppp
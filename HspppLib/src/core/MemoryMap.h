@@ -0,0 +1,51 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/MemoryMap.h
+// ファイルの読み取り専用メモリマップの内部API
+// 任意オフセットからの領域マップ（割り当て粒度への切り下げを含む）と解放、失敗理由の MapStatus を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace hsppp {
+namespace internal {
+
+// マップしたファイルの範囲
+// ビューの先頭は割り当て粒度に揃えるため、data は base から (offset % 粒度) バイト進んだ位置になる
+struct FileRegion {
+    void* base = nullptr;           // ビューの先頭（空の範囲では nullptr）
+    size_t mappedLength = 0;        // ビュー全体の長さ
+    const uint8_t* data = nullptr;  // 要求した範囲の先頭
+    size_t size = 0;                // 要求した範囲の長さ
+    uint64_t fileSize = 0;          // ファイル全体の長さ
+};
+
+enum class MapStatus {
+    Ok,
+    OpenFailed,     // ファイルを開けない
+    SizeFailed,     // ファイルサイズを取得できない
+    TooLarge,       // アドレス空間に収まらない（32bit ビルド）
+    MapFailed,      // マップに失敗
+};
+
+// ビューの先頭位置の粒度（Windows: 割り当て粒度 64KB、POSIX: ページサイズ）
+size_t MapGranularity() noexcept;
+
+// utf8Path の offset バイト目から size バイトを読み取り専用でマップする
+// size < 0 はファイル末尾まで。末尾を超える分は切り詰め、offset が末尾以降なら空の範囲を返す
+// 失敗時の OS のエラーコードは systemError に格納する
+MapStatus MapFileRegion(std::string_view utf8Path, uint64_t offset, int64_t size,
+                        FileRegion& region, uint32_t& systemError);
+
+// MapFileRegion でマップした範囲を解除する（空の範囲は何もしない）
+void UnmapFileRegion(void* base, size_t mappedLength) noexcept;
+
+} // namespace internal
+} // namespace hsppp
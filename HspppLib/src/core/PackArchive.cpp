@@ -0,0 +1,421 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/PackArchive.cpp
+// パックファイルの読み込み・作成と pack:// の解決
+// 索引は開くときに1回だけ検証してハッシュの上位ビットでバケットに分け、以降の検索は1つのバケットだけを走査する
+
+#include "PackArchive.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+
+#include "Lz4.h"
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+constexpr uint64_t kFnvOffset = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+// 先頭の "./" と "/"（"\\"）を除く
+std::string_view trimPackName(std::string_view name) noexcept {
+    while (!name.empty()) {
+        if (name[0] == '/' || name[0] == '\\') {
+            name.remove_prefix(1);
+        }
+        else if (name.size() >= 2 && name[0] == '.' && (name[1] == '/' || name[1] == '\\')) {
+            name.remove_prefix(2);
+        }
+        else {
+            break;
+        }
+    }
+    return name;
+}
+
+char normalizeChar(char c) noexcept {
+    if (c == '\\') {
+        return '/';
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return static_cast<char>(c - 'A' + 'a');
+    }
+    return c;
+}
+
+// 正規化した名前と、正規化前の名前を比べる
+int compareName(std::string_view normalized, std::string_view raw) noexcept {
+    const size_t length = (std::min)(normalized.size(), raw.size());
+    for (size_t i = 0; i < length; ++i) {
+        const unsigned char a = static_cast<unsigned char>(normalized[i]);
+        const unsigned char b = static_cast<unsigned char>(normalizeChar(raw[i]));
+        if (a != b) {
+            return a < b ? -1 : 1;
+        }
+    }
+    return normalized.size() == raw.size() ? 0 : (normalized.size() < raw.size() ? -1 : 1);
+}
+
+// NormalizePackName の結果と同じ形か
+bool isNormalizedName(std::string_view name) noexcept {
+    if (trimPackName(name).size() != name.size()) {
+        return false;
+    }
+    return std::none_of(name.begin(), name.end(), [](char c) { return normalizeChar(c) != c; });
+}
+
+size_t bucketOf(uint64_t hash, int bits) noexcept {
+    return bits == 0 ? 0 : static_cast<size_t>(hash >> (64 - bits));
+}
+
+uint64_t alignUp(uint64_t value, uint64_t alignment) noexcept {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// ============================================================
+// 登録したパック
+// ============================================================
+
+std::shared_mutex g_mountMutex;
+std::vector<std::shared_ptr<PackArchive>> g_mounted;    // 後ろほど優先
+
+// 名前を持つパックとエントリーを探す（g_mountMutex を保持して呼ぶ）
+const std::shared_ptr<PackArchive>* findMountedLocked(std::string_view path, const PackEntry*& entry) {
+    entry = nullptr;
+    if (!IsPackPath(path)) {
+        return nullptr;
+    }
+    const std::string_view name = path.substr(kPackScheme.size());
+    for (auto it = g_mounted.rbegin(); it != g_mounted.rend(); ++it) {
+        if (const PackEntry* found = (*it)->find(name)) {
+            entry = found;
+            return &*it;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace
+
+// ============================================================
+// 名前
+// ============================================================
+
+bool IsPackPath(std::string_view path) noexcept {
+    return path.starts_with(kPackScheme);
+}
+
+std::string NormalizePackName(std::string_view name) {
+    name = trimPackName(name);
+    std::string result(name.size(), '\0');
+    std::transform(name.begin(), name.end(), result.begin(), normalizeChar);
+    return result;
+}
+
+uint64_t PackNameHash(std::string_view name) noexcept {
+    uint64_t hash = kFnvOffset;
+    for (char c : trimPackName(name)) {
+        hash ^= static_cast<unsigned char>(normalizeChar(c));
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+// ============================================================
+// 読み込み
+// ============================================================
+
+PackArchive::~PackArchive() {
+    UnmapFileRegion(region_.base, region_.mappedLength);
+}
+
+std::shared_ptr<PackArchive> PackArchive::open(std::string_view utf8Path, PackStatus& status, uint32_t& systemError) {
+    std::shared_ptr<PackArchive> archive(new PackArchive());
+    archive->path_ = std::string(utf8Path);
+
+    switch (MapFileRegion(utf8Path, 0, -1, archive->region_, systemError)) {
+        case MapStatus::Ok:
+            break;
+        case MapStatus::OpenFailed:
+        case MapStatus::SizeFailed:
+            status = PackStatus::OpenFailed;
+            return nullptr;
+        case MapStatus::TooLarge:
+        case MapStatus::MapFailed:
+            status = PackStatus::MapFailed;
+            return nullptr;
+    }
+
+    status = PackStatus::InvalidFormat;
+    const uint8_t* const data = archive->region_.data;
+    const uint64_t fileSize = archive->region_.size;
+    if (fileSize < sizeof(PackHeader)) {
+        return nullptr;
+    }
+
+    PackHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const uint64_t indexEnd = sizeof(PackHeader) + static_cast<uint64_t>(header.entryCount) * sizeof(PackEntry);
+    if (header.magic != kPackMagic || header.version != kPackVersion ||
+        header.alignment == 0 || header.alignment > kPackMaxAlignment || (header.alignment & (header.alignment - 1)) != 0 ||
+        header.fileSize != fileSize || header.namesOffset != indexEnd ||
+        header.namesSize > fileSize - (std::min)(indexEnd, fileSize) ||
+        header.dataOffset < header.namesOffset + header.namesSize || header.dataOffset > fileSize) {
+        return nullptr;
+    }
+
+    // 索引はマップの先頭から 64 バイト目にあるため、PackEntry の境界に揃っている
+    archive->entries_ = std::span<const PackEntry>(reinterpret_cast<const PackEntry*>(data + sizeof(PackHeader)),
+                                                   header.entryCount);
+    archive->names_ = reinterpret_cast<const char*>(data + header.namesOffset);
+
+    // 範囲と整列順を検証しておき、検索と読み込みでは確認しない
+    const PackEntry* previous = nullptr;
+    for (const PackEntry& entry : archive->entries_) {
+        if (static_cast<uint64_t>(entry.nameOffset) + entry.nameLength > header.namesSize ||
+            entry.offset < header.dataOffset || entry.offset > fileSize || entry.storedSize > fileSize - entry.offset) {
+            return nullptr;
+        }
+        if (entry.compression == PackCompression::None) {
+            if (entry.storedSize != entry.size) {
+                return nullptr;
+            }
+        }
+        else if (entry.compression != PackCompression::Lz4 ||
+                 entry.size / 255 > entry.storedSize) {
+            // LZ4 は圧縮データ1バイトあたり最大 255 バイトにしか展開されない
+            return nullptr;
+        }
+
+        const std::string_view name = archive->name(entry);
+        if (entry.hash != PackNameHash(name) || !isNormalizedName(name)) {
+            return nullptr;
+        }
+        if (previous && (previous->hash > entry.hash ||
+                         (previous->hash == entry.hash && archive->name(*previous) >= name))) {
+            return nullptr;
+        }
+        previous = &entry;
+    }
+
+    // エントリー数と同程度のバケットに分け、検索では二分探索の代わりにバケット内の数個だけを調べる
+    const int bits = (std::min)(static_cast<int>(std::bit_width(header.entryCount)), 24);
+    archive->bucketBits_ = bits;
+    archive->buckets_.resize((size_t{ 1 } << bits) + 1);
+    uint32_t index = 0;
+    for (size_t bucket = 0; bucket < archive->buckets_.size(); ++bucket) {
+        archive->buckets_[bucket] = index;
+        while (index < header.entryCount && bucketOf(archive->entries_[index].hash, bits) == bucket) {
+            ++index;
+        }
+    }
+
+    status = PackStatus::Ok;
+    return archive;
+}
+
+const PackEntry* PackArchive::find(std::string_view name) const noexcept {
+    const std::string_view trimmed = trimPackName(name);
+    const uint64_t hash = PackNameHash(trimmed);
+    const size_t bucket = bucketOf(hash, bucketBits_);
+    const PackEntry* it = entries_.data() + buckets_[bucket];
+    const PackEntry* const end = entries_.data() + buckets_[bucket + 1];
+    for (; it != end && it->hash <= hash; ++it) {
+        if (it->hash == hash && compareName(this->name(*it), trimmed) == 0) {
+            return it;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view PackArchive::name(const PackEntry& entry) const noexcept {
+    return std::string_view(names_ + entry.nameOffset, entry.nameLength);
+}
+
+std::span<const uint8_t> PackArchive::stored(const PackEntry& entry) const noexcept {
+    return std::span<const uint8_t>(region_.data + entry.offset, static_cast<size_t>(entry.storedSize));
+}
+
+// ============================================================
+// 登録と pack:// の解決
+// ============================================================
+
+PackStatus MountPack(std::string_view utf8Path, uint32_t& systemError) {
+    PackStatus status;
+    std::shared_ptr<PackArchive> archive = PackArchive::open(utf8Path, status, systemError);
+    if (!archive) {
+        return status;
+    }
+
+    // 同じパスを登録し直した場合は、最新の内容を最も優先する
+    std::unique_lock<std::shared_mutex> lock(g_mountMutex);
+    std::erase_if(g_mounted, [&](const auto& mounted) { return mounted->path() == utf8Path; });
+    g_mounted.push_back(std::move(archive));
+    return PackStatus::Ok;
+}
+
+bool UnmountPack(std::string_view utf8Path) {
+    std::unique_lock<std::shared_mutex> lock(g_mountMutex);
+    return std::erase_if(g_mounted, [&](const auto& mounted) { return mounted->path() == utf8Path; }) > 0;
+}
+
+void UnmountAllPacks() {
+    std::unique_lock<std::shared_mutex> lock(g_mountMutex);
+    g_mounted.clear();
+}
+
+size_t MountedPackCount() {
+    std::shared_lock<std::shared_mutex> lock(g_mountMutex);
+    return g_mounted.size();
+}
+
+PackStatus OpenPackData(std::string_view path, PackData& data) {
+    data = {};
+    const PackEntry* entry = nullptr;
+    std::shared_ptr<PackArchive> archive;
+    {
+        std::shared_lock<std::shared_mutex> lock(g_mountMutex);
+        if (const std::shared_ptr<PackArchive>* found = findMountedLocked(path, entry)) {
+            archive = *found;
+        }
+    }
+    if (!archive) {
+        return PackStatus::NotFound;
+    }
+
+    const std::span<const uint8_t> stored = archive->stored(*entry);
+    if (entry->compression == PackCompression::None) {
+        data.bytes = stored;
+        data.owner = std::move(archive);
+        return PackStatus::Ok;
+    }
+
+    if (entry->size > static_cast<uint64_t>(SIZE_MAX)) {
+        return PackStatus::Corrupt;
+    }
+    const size_t size = static_cast<size_t>(entry->size);
+    std::shared_ptr<uint8_t[]> buffer(new uint8_t[size > 0 ? size : 1]);
+    if (!Lz4Decompress(stored.data(), stored.size(), buffer.get(), size)) {
+        return PackStatus::Corrupt;
+    }
+    data.bytes = std::span<const uint8_t>(buffer.get(), size);
+    data.owner = std::move(buffer);
+    return PackStatus::Ok;
+}
+
+PackStatus FindPackEntry(std::string_view path, uint64_t& size) {
+    const PackEntry* entry = nullptr;
+    std::shared_lock<std::shared_mutex> lock(g_mountMutex);
+    if (!findMountedLocked(path, entry)) {
+        return PackStatus::NotFound;
+    }
+    size = entry->size;
+    return PackStatus::Ok;
+}
+
+// ============================================================
+// 作成
+// ============================================================
+
+bool BuildPack(std::span<const PackInput> inputs, uint32_t alignment, PackImage& image, std::string& duplicate) {
+    image = {};
+    struct Item {
+        std::string name;
+        uint64_t hash;
+        size_t input;
+    };
+    std::vector<Item> items;
+    items.reserve(inputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        std::string name = NormalizePackName(inputs[i].name);
+        const uint64_t hash = PackNameHash(name);
+        items.push_back({ std::move(name), hash, i });
+    }
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+    });
+    for (size_t i = 1; i < items.size(); ++i) {
+        if (items[i].hash == items[i - 1].hash && items[i].name == items[i - 1].name) {
+            duplicate = items[i].name;
+            return false;
+        }
+    }
+
+    PackHeader header{};
+    header.magic = kPackMagic;
+    header.version = kPackVersion;
+    header.entryCount = static_cast<uint32_t>(items.size());
+    header.alignment = alignment;
+    header.namesOffset = sizeof(PackHeader) + items.size() * sizeof(PackEntry);
+
+    std::vector<PackEntry> entries(items.size());
+    std::string names;
+    for (size_t i = 0; i < items.size(); ++i) {
+        entries[i].hash = items[i].hash;
+        entries[i].nameOffset = static_cast<uint32_t>(names.size());
+        entries[i].nameLength = static_cast<uint32_t>(items[i].name.size());
+        names += items[i].name;
+    }
+    header.namesSize = names.size();
+    header.dataOffset = alignUp(header.namesOffset + header.namesSize, alignment);
+
+    // 小さくなる場合だけ圧縮したものを格納する（展開の手間に見合わない 1/8 未満の縮小は無視する）
+    image.compressed.reserve(items.size());
+    uint64_t offset = header.dataOffset;
+    for (size_t i = 0; i < items.size(); ++i) {
+        const PackInput& input = inputs[items[i].input];
+        PackEntry& entry = entries[i];
+        entry.size = input.data.size();
+        entry.compression = PackCompression::None;
+        std::span<const uint8_t> stored = input.data;
+
+        if (input.level > 0 && !input.data.empty()) {
+            std::vector<uint8_t> packed(Lz4CompressBound(input.data.size()));
+            const size_t packedSize = Lz4CompressLevel(input.data.data(), input.data.size(), packed.data(), packed.size(),
+                                                       input.level);
+            if (packedSize > 0 && packedSize < input.data.size() - input.data.size() / 8) {
+                packed.resize(packedSize);
+                packed.shrink_to_fit();
+                image.compressed.push_back(std::move(packed));
+                stored = image.compressed.back();
+                entry.compression = PackCompression::Lz4;
+            }
+        }
+
+        // 空のデータは位置を進めない（末尾の余白は書かないため、ファイルの外を指さないようにする）
+        entry.storedSize = stored.size();
+        if (stored.empty()) {
+            entry.offset = header.dataOffset;
+            continue;
+        }
+        entry.offset = offset;
+        image.chunks.push_back({ offset, stored });
+        image.fileSize = offset + stored.size();
+        offset = alignUp(image.fileSize, alignment);
+    }
+    image.fileSize = (std::max)(image.fileSize, header.dataOffset);
+    header.fileSize = image.fileSize;
+
+    // head はデータの先頭までの余白を含む
+    image.head.resize(static_cast<size_t>(header.dataOffset));
+    std::memcpy(image.head.data(), &header, sizeof(header));
+    if (!entries.empty()) {
+        std::memcpy(image.head.data() + sizeof(header), entries.data(), entries.size() * sizeof(PackEntry));
+    }
+    if (!names.empty()) {
+        std::memcpy(image.head.data() + header.namesOffset, names.data(), names.size());
+    }
+    return true;
+}
+
+} // namespace internal
+} // namespace hsppp
@@ -0,0 +1,175 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/PackArchive.h
+// パックファイル（.hpk）の読み込み・作成と pack:// の解決の内部API
+// パックの形式定義、マウント表、pack:// パスのエントリ解決、パックイメージの構築（BuildPack）を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MemoryMap.h"
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// ファイル形式（すべてリトルエンディアン）
+// ============================================================
+//   PackHeader                  64 バイト
+//   PackEntry[entryCount]       48 バイトずつ。(hash, 名前) の順に整列
+//   名前                        正規化した UTF-8 を終端なしで続けて格納
+//   データ                      各エントリーの先頭は alignment バイト境界
+
+constexpr uint32_t kPackMagic = 0x314B5048;     // "HPK1"
+constexpr uint32_t kPackVersion = 1;
+constexpr uint32_t kPackDefaultAlignment = 16;
+constexpr uint32_t kPackMaxAlignment = 65536;
+
+struct PackHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint64_t dataOffset;
+    uint64_t fileSize;
+    uint8_t reserved[16];
+};
+static_assert(sizeof(PackHeader) == 64);
+
+enum class PackCompression : uint32_t {
+    None = 0,
+    Lz4 = 1,        // LZ4 ブロック形式（Lz4.h）
+};
+
+struct PackEntry {
+    uint64_t hash;              // PackNameHash(名前)
+    uint64_t offset;            // ファイル先頭からのデータの位置
+    uint64_t storedSize;        // 格納しているバイト数
+    uint64_t size;              // 展開後のバイト数
+    uint32_t nameOffset;        // 名前領域の中の位置
+    uint32_t nameLength;
+    PackCompression compression;
+    uint32_t reserved;
+};
+static_assert(sizeof(PackEntry) == 48);
+
+enum class PackStatus {
+    Ok,
+    OpenFailed,     // パックファイルを開けない
+    MapFailed,      // パックファイルをマップできない
+    InvalidFormat,  // パックファイルではない・壊れている
+    NotFound,       // 名前が見つからない
+    Corrupt,        // 圧縮データを展開できない
+};
+
+// ============================================================
+// 名前
+// ============================================================
+// パック内の名前は、先頭の "./" と "/" を除き、'\\' を '/' に、ASCII の英字を小文字にしたもの
+// （Windows のファイル名と同じく大文字・小文字を区別しない）
+
+constexpr std::string_view kPackScheme = "pack://";
+
+bool IsPackPath(std::string_view path) noexcept;
+std::string NormalizePackName(std::string_view name);
+
+// 正規化前の名前をそのまま渡してよい（正規化しながらハッシュを計算する）
+uint64_t PackNameHash(std::string_view name) noexcept;
+
+// ============================================================
+// 読み込み
+// ============================================================
+
+class PackArchive {
+public:
+    ~PackArchive();
+    PackArchive(const PackArchive&) = delete;
+    PackArchive& operator=(const PackArchive&) = delete;
+
+    // パックファイルを丸ごとマップし、ヘッダーと索引を検証する
+    static std::shared_ptr<PackArchive> open(std::string_view utf8Path, PackStatus& status, uint32_t& systemError);
+
+    // 名前を探す（正規化前の名前でよい。メモリ確保なし）。見つからなければ nullptr
+    const PackEntry* find(std::string_view name) const noexcept;
+
+    std::span<const PackEntry> entries() const noexcept { return entries_; }
+    std::string_view name(const PackEntry& entry) const noexcept;
+    // 格納しているデータ（圧縮している場合は圧縮後）
+    std::span<const uint8_t> stored(const PackEntry& entry) const noexcept;
+    const std::string& path() const noexcept { return path_; }
+
+private:
+    PackArchive() = default;
+
+    FileRegion region_;
+    std::span<const PackEntry> entries_;
+    // ハッシュの上位 bucketBits_ ビットごとのエントリーの開始位置（索引はハッシュの順に並んでいるため連続する）
+    std::vector<uint32_t> buckets_;
+    int bucketBits_ = 0;
+    const char* names_ = nullptr;
+    std::string path_;
+};
+
+// pack:// のファイルの内容。owner を保持している間 bytes は有効
+struct PackData {
+    std::shared_ptr<const void> owner;
+    std::span<const uint8_t> bytes;
+};
+
+// ============================================================
+// 登録と pack:// の解決（スレッドセーフ）
+// ============================================================
+// 同じ名前が複数のパックにある場合は、後から登録したパックを優先する
+
+PackStatus MountPack(std::string_view utf8Path, uint32_t& systemError);
+// 登録していなければ false
+bool UnmountPack(std::string_view utf8Path);
+void UnmountAllPacks();
+size_t MountedPackCount();
+
+// path は "pack://名前"。圧縮していない内容はマップ上を直接参照し、圧縮している内容は展開する
+PackStatus OpenPackData(std::string_view path, PackData& data);
+// 展開せずに大きさだけを調べる
+PackStatus FindPackEntry(std::string_view path, uint64_t& size);
+
+// ============================================================
+// 作成
+// ============================================================
+
+struct PackInput {
+    std::string name;
+    std::span<const uint8_t> data;
+    int level = 1;                  // 小さくなる場合だけ LZ4 で圧縮する強さ（Lz4CompressLevel。0 は圧縮しない）
+};
+
+// 書き出す内容。head（ヘッダー・索引・名前）をファイル先頭に、各 chunks を offset の位置に書く
+struct PackImage {
+    struct Chunk {
+        uint64_t offset;
+        std::span<const uint8_t> data;
+    };
+    std::vector<uint8_t> head;
+    std::vector<Chunk> chunks;
+    std::vector<std::vector<uint8_t>> compressed;   // chunks から参照する圧縮後のデータ
+    uint64_t fileSize = 0;
+};
+
+// inputs からパックの内容を作る（chunks は inputs のデータを参照する）
+// 正規化後の名前が重なる場合は false を返し、その名前を duplicate に格納する
+bool BuildPack(std::span<const PackInput> inputs, uint32_t alignment, PackImage& image, std::string& duplicate);
+
+} // namespace internal
+} // namespace hsppp
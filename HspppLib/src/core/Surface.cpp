@@ -40,52 +40,25 @@ namespace internal {
 constexpr double kRadToDeg = 180.0 / 3.14159265358979323846;
 
 // UTF-8文字列をUTF-16(wchar_t)に変換
-std::wstring Utf8ToWide(std::string_view utf8str) {
-    if (utf8str.empty()) {
-        return L"";
-    }
-
-    int wideSize = MultiByteToWideChar(
-        CP_UTF8, 0,
-        utf8str.data(), static_cast<int>(utf8str.size()),
-        nullptr, 0
-    );
-    if (wideSize == 0) {
-        return L"";
-    }
-
-    std::wstring wideStr(wideSize, 0);
-    MultiByteToWideChar(
-        CP_UTF8, 0,
-        utf8str.data(), static_cast<int>(utf8str.size()),
-        &wideStr[0], wideSize
-    );
+// Windows の wchar_t は UTF-16 なので char16_t 版の変換をそのまま使う
+static_assert(sizeof(wchar_t) == sizeof(char16_t), "wchar_t must be UTF-16");
 
+std::wstring Utf8ToWide(std::string_view utf8str) {
+    std::wstring wideStr;
+    Utf8ToWideInto(utf8str, wideStr);
     return wideStr;
 }
 
-// UTF-16文字列をUTF-8に変換
-std::string WideToUtf8(const std::wstring& wideStr) {
-    if (wideStr.empty()) {
-        return "";
-    }
-
-    int utf8Size = WideCharToMultiByte(
-        CP_UTF8, 0,
-        wideStr.c_str(), static_cast<int>(wideStr.size()),
-        nullptr, 0, nullptr, nullptr
-    );
-    if (utf8Size == 0) {
-        return "";
-    }
-
-    std::string utf8Str(utf8Size, 0);
-    WideCharToMultiByte(
-        CP_UTF8, 0,
-        wideStr.c_str(), static_cast<int>(wideStr.size()),
-        &utf8Str[0], utf8Size, nullptr, nullptr
-    );
+void Utf8ToWideInto(std::string_view utf8str, std::wstring& dest) {
+    dest.resize_and_overwrite(Utf8ToUtf16MaxLength(utf8str.size()), [&](wchar_t* buf, size_t) {
+        return ConvertUtf8ToUtf16(utf8str.data(), utf8str.size(), reinterpret_cast<char16_t*>(buf));
+    });
+}
 
+// UTF-16文字列をUTF-8に変換
+std::string WideToUtf8(std::wstring_view wideStr) {
+    std::string utf8Str;
+    Utf16ToUtf8Into(std::u16string_view(reinterpret_cast<const char16_t*>(wideStr.data()), wideStr.size()), utf8Str);
     return utf8Str;
 }
 
@@ -453,7 +426,9 @@ void HspSurface::mes(std::string_view text, int options) {
     }
     if (!m_isDrawing) return;
 
-    std::wstring wideText = Utf8ToWide(text);
+    // 毎フレーム呼ばれるため変換バッファを再利用する
+    thread_local std::wstring wideText;
+    Utf8ToWideInto(text, wideText);
 
     // オプションの解析
     bool nocr = (options & 1) != 0;        // mesopt_nocr: 改行しない
@@ -610,7 +585,8 @@ bool HspSurface::measureText(std::string_view text, int& width, int& height) con
         return false;
     }
 
-    std::wstring wideText = Utf8ToWide(text);
+    thread_local std::wstring wideText;
+    Utf8ToWideInto(text, wideText);
 
     IDWriteFactory* pDWriteFactory = D2DDeviceManager::getInstance().getDWriteFactory();
     if (!pDWriteFactory) {
@@ -0,0 +1,355 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/Transcode.cpp
+// 文字コード変換（UTF-8 / UTF-16 / CP932）の実装
+// Win32 API を使用しないプラットフォーム非依存の実装。ASCII 部分は SSE2 で一括処理する
+
+#include "Transcode.h"
+
+#include <algorithm>
+#include <bit>
+#include <vector>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HSPPP_HAS_SSE2 1
+#endif
+
+#include "Cp932Table.inl"
+
+namespace hsppp {
+namespace internal {
+
+namespace {
+
+constexpr char16_t kReplacementChar = 0xFFFD;   // 不正な UTF-8 / UTF-16
+constexpr char16_t kCp932DefaultChar = 0x30FB;  // CP932 の未定義文字（MultiByteToWideChar と同じ）
+constexpr char kCp932UnmappableChar = '?';      // CP932 で表せない文字（WideCharToMultiByte と同じ）
+
+// ============================================================
+// ASCII 高速経路
+// ============================================================
+
+// src の先頭から ASCII が続く限り dst(char16_t) へ拡張コピーし、処理したバイト数を返す
+size_t widenAscii(const char* src, size_t length, char16_t* dst) noexcept {
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+        if (mask != 0) {
+            const size_t n = static_cast<size_t>(std::countr_zero(mask));
+            for (size_t k = 0; k < n; ++k) {
+                dst[i + k] = static_cast<char16_t>(src[i + k]);
+            }
+            return i + n;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(v, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+    }
+#endif
+    for (; i < length && static_cast<unsigned char>(src[i]) < 0x80; ++i) {
+        dst[i] = static_cast<char16_t>(src[i]);
+    }
+    return i;
+}
+
+// src(char16_t) の先頭から ASCII が続く限り dst へ縮小コピーし、処理した要素数を返す
+size_t narrowAscii(const char16_t* src, size_t length, char* dst) noexcept {
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    const __m128i nonAscii = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 8 <= length; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i isAscii = _mm_cmpeq_epi16(_mm_and_si128(v, nonAscii), zero);
+        if (_mm_movemask_epi8(isAscii) != 0xFFFF) {
+            break;
+        }
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(v, v));
+    }
+#endif
+    for (; i < length && src[i] < 0x80; ++i) {
+        dst[i] = static_cast<char>(src[i]);
+    }
+    return i;
+}
+
+// ============================================================
+// UTF-8 デコード
+// ============================================================
+
+// src[i] から1文字デコードする。不正なシーケンスは U+FFFD を返し、
+// 不正と判明するまでの最大部分（最低1バイト）を消費する（Unicode 推奨の置換方式）
+char32_t decodeUtf8(const unsigned char* src, size_t length, size_t& i) noexcept {
+    const unsigned char c = src[i];
+    size_t need = 0;
+    unsigned char lo = 0x80, hi = 0xBF;     // 2バイト目の許容範囲
+    char32_t cp = 0;
+
+    if (c < 0x80) {
+        ++i;
+        return c;
+    } else if (c >= 0xC2 && c <= 0xDF) {
+        need = 1; cp = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        need = 2; cp = c & 0x0F;
+        if (c == 0xE0) lo = 0xA0;           // 過長表現
+        if (c == 0xED) hi = 0x9F;           // サロゲート
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        need = 3; cp = c & 0x07;
+        if (c == 0xF0) lo = 0x90;           // 過長表現
+        if (c == 0xF4) hi = 0x8F;           // U+10FFFF 超
+    } else {
+        ++i;
+        return kReplacementChar;
+    }
+
+    size_t k = 1;
+    for (; k <= need; ++k) {
+        if (i + k >= length) break;
+        const unsigned char t = src[i + k];
+        const unsigned char tLo = (k == 1) ? lo : 0x80;
+        const unsigned char tHi = (k == 1) ? hi : 0xBF;
+        if (t < tLo || t > tHi) break;
+        cp = (cp << 6) | (t & 0x3F);
+    }
+    if (k <= need) {
+        i += k;
+        return kReplacementChar;
+    }
+    i += need + 1;
+    return cp;
+}
+
+char* appendUtf8(char* dst, char32_t cp) noexcept {
+    if (cp < 0x80) {
+        *dst++ = static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        *dst++ = static_cast<char>(0xC0 | (cp >> 6));
+        *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        *dst++ = static_cast<char>(0xE0 | (cp >> 12));
+        *dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        *dst++ = static_cast<char>(0xF0 | (cp >> 18));
+        *dst++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *dst++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return dst;
+}
+
+// ============================================================
+// CP932 逆変換表（Unicode BMP → CP932、初回使用時に構築）
+// ============================================================
+
+std::vector<uint16_t> buildCp932EncodeTable() {
+    std::vector<uint16_t> table(0x10000, 0);
+
+    auto assign = [&](char16_t unicode, uint16_t code) {
+        if (unicode != 0 && table[unicode] == 0) {
+            table[unicode] = code;
+        }
+    };
+
+    // 1バイト文字
+    for (unsigned b = 0x80; b < 0x100; ++b) {
+        assign(kCp932SingleByte[b - 0x80], static_cast<uint16_t>(b));
+    }
+
+    // 2バイト文字: 小さいコードを優先し、NEC選定IBM拡張（0xED/0xEE）は最後（WideCharToMultiByte と同じ）
+    for (int pass = 0; pass < 2; ++pass) {
+        for (unsigned lead = 0x81; lead <= 0xFC; ++lead) {
+            const uint8_t index = kCp932LeadIndex[lead];
+            if (index == 0xFF) continue;
+            const bool necSelected = (lead == 0xED || lead == 0xEE);
+            if (necSelected != (pass == 1)) continue;
+            for (size_t t = 0; t < kCp932TrailCount; ++t) {
+                assign(kCp932DoubleByte[index][t], static_cast<uint16_t>((lead << 8) | (t + 0x40)));
+            }
+        }
+    }
+
+    for (const auto& fit : kCp932BestFit) {
+        assign(fit.unicode, fit.code);
+    }
+    return table;
+}
+
+const uint16_t* cp932EncodeTable() {
+    static const std::vector<uint16_t> s_table = buildCp932EncodeTable();
+    return s_table.data();
+}
+
+} // namespace
+
+// ============================================================
+// 公開関数
+// ============================================================
+
+size_t CountAsciiPrefix(const char* src, size_t length) noexcept {
+    size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+    for (; i + 16 <= length; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+        if (mask != 0) {
+            return i + static_cast<size_t>(std::countr_zero(mask));
+        }
+    }
+#endif
+    while (i < length && static_cast<unsigned char>(src[i]) < 0x80) {
+        ++i;
+    }
+    return i;
+}
+
+bool IsValidUtf8(std::string_view src) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(src.data());
+    size_t i = 0;
+    while (i < src.size()) {
+        i += CountAsciiPrefix(src.data() + i, src.size() - i);
+        if (i >= src.size()) break;
+        const size_t start = i;
+        const char32_t cp = decodeUtf8(p, src.size(), i);
+        // U+FFFD が返った場合、正しく符号化された U+FFFD（EF BF BD）以外は不正
+        if (cp == kReplacementChar
+            && !(i - start == 3 && p[start] == 0xEF && p[start + 1] == 0xBF && p[start + 2] == 0xBD)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t ConvertUtf8ToUtf16(const char* src, size_t length, char16_t* dst) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(src);
+    size_t i = 0;
+    char16_t* out = dst;
+    while (i < length) {
+        const size_t ascii = widenAscii(src + i, length - i, out);
+        i += ascii;
+        out += ascii;
+        while (i < length && p[i] >= 0x80) {
+            const char32_t cp = decodeUtf8(p, length, i);
+            if (cp < 0x10000) {
+                *out++ = static_cast<char16_t>(cp);
+            } else {
+                const char32_t v = cp - 0x10000;
+                *out++ = static_cast<char16_t>(0xD800 | (v >> 10));
+                *out++ = static_cast<char16_t>(0xDC00 | (v & 0x3FF));
+            }
+        }
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+size_t ConvertUtf16ToUtf8(const char16_t* src, size_t length, char* dst) noexcept {
+    size_t i = 0;
+    char* out = dst;
+    while (i < length) {
+        const size_t ascii = narrowAscii(src + i, length - i, out);
+        i += ascii;
+        out += ascii;
+        while (i < length && src[i] >= 0x80) {
+            const char16_t c = src[i++];
+            if (c >= 0xD800 && c <= 0xDBFF && i < length && src[i] >= 0xDC00 && src[i] <= 0xDFFF) {
+                const char32_t cp = 0x10000 + ((static_cast<char32_t>(c) - 0xD800) << 10) + (src[i++] - 0xDC00);
+                out = appendUtf8(out, cp);
+            } else if (c >= 0xD800 && c <= 0xDFFF) {
+                out = appendUtf8(out, kReplacementChar);     // 単独サロゲート
+            } else {
+                out = appendUtf8(out, c);
+            }
+        }
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+size_t ConvertUtf8ToCp932(const char* src, size_t length, char* dst) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(src);
+    const uint16_t* table = nullptr;
+    size_t i = 0;
+    char* out = dst;
+    while (i < length) {
+        const size_t ascii = CountAsciiPrefix(src + i, length - i);
+        std::copy(src + i, src + i + ascii, out);
+        i += ascii;
+        out += ascii;
+        while (i < length && p[i] >= 0x80) {
+            const char32_t cp = decodeUtf8(p, length, i);
+            if (!table) table = cp932EncodeTable();
+            const uint16_t code = (cp < 0x10000) ? table[cp] : 0;
+            if (code == 0) {
+                *out++ = kCp932UnmappableChar;
+            } else if (code < 0x100) {
+                *out++ = static_cast<char>(code);
+            } else {
+                *out++ = static_cast<char>(code >> 8);
+                *out++ = static_cast<char>(code & 0xFF);
+            }
+        }
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+size_t ConvertCp932ToUtf8(const char* src, size_t length, char* dst) noexcept {
+    const auto* p = reinterpret_cast<const unsigned char*>(src);
+    size_t i = 0;
+    char* out = dst;
+    while (i < length) {
+        const size_t ascii = CountAsciiPrefix(src + i, length - i);
+        std::copy(src + i, src + i + ascii, out);
+        i += ascii;
+        out += ascii;
+        while (i < length && p[i] >= 0x80) {
+            const unsigned char c = p[i];
+            const uint8_t lead = kCp932LeadIndex[c];
+            char16_t u = 0;
+            if (lead == 0xFF) {
+                u = kCp932SingleByte[c - 0x80];
+                ++i;
+            } else if (i + 1 < length && p[i + 1] >= 0x40 && p[i + 1] <= 0xFC) {
+                u = kCp932DoubleByte[lead][p[i + 1] - 0x40];
+                i += 2;
+            } else {
+                ++i;    // 後続バイトが無い・不正
+            }
+            out = appendUtf8(out, u != 0 ? u : kCp932DefaultChar);
+        }
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+void Utf8ToUtf16Into(std::string_view src, std::u16string& dest) {
+    dest.resize_and_overwrite(Utf8ToUtf16MaxLength(src.size()), [&](char16_t* buf, size_t) {
+        return ConvertUtf8ToUtf16(src.data(), src.size(), buf);
+    });
+}
+
+void Utf16ToUtf8Into(std::u16string_view src, std::string& dest) {
+    dest.resize_and_overwrite(Utf16ToUtf8MaxLength(src.size()), [&](char* buf, size_t) {
+        return ConvertUtf16ToUtf8(src.data(), src.size(), buf);
+    });
+}
+
+void Utf8ToCp932Into(std::string_view src, std::string& dest) {
+    dest.resize_and_overwrite(Utf8ToCp932MaxLength(src.size()), [&](char* buf, size_t) {
+        return ConvertUtf8ToCp932(src.data(), src.size(), buf);
+    });
+}
+
+void Cp932ToUtf8Into(std::string_view src, std::string& dest) {
+    dest.resize_and_overwrite(Cp932ToUtf8MaxLength(src.size()), [&](char* buf, size_t) {
+        return ConvertCp932ToUtf8(src.data(), src.size(), buf);
+    });
+}
+
+} // namespace internal
+} // namespace hsppp
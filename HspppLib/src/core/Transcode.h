@@ -0,0 +1,61 @@
+﻿// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/Transcode.h
+// 文字コード変換（UTF-8 / UTF-16 / CP932）の内部API
+// 長さ指定の一括変換（Convert*）、ASCII 先頭区間の計測、検証、std::string への追記変換（*Into）を提供する
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace hsppp {
+namespace internal {
+
+// ============================================================
+// 出力バッファに必要な最大要素数
+// ============================================================
+// UTF-8 1バイト → UTF-16 最大1単位、UTF-16 1単位 → UTF-8 最大3バイト
+// UTF-8 → CP932 は元のバイト数以下、CP932 1バイト → UTF-8 最大3バイト（半角カナ）
+constexpr size_t Utf8ToUtf16MaxLength(size_t utf8Length) noexcept { return utf8Length; }
+constexpr size_t Utf16ToUtf8MaxLength(size_t utf16Length) noexcept { return utf16Length * 3; }
+constexpr size_t Utf8ToCp932MaxLength(size_t utf8Length) noexcept { return utf8Length; }
+constexpr size_t Cp932ToUtf8MaxLength(size_t cp932Length) noexcept { return cp932Length * 3; }
+
+// ============================================================
+// 低レベル変換（dst は上記の最大長以上を確保しておくこと）
+// ============================================================
+// 不正なシーケンスは MultiByteToWideChar / WideCharToMultiByte と同様に置換する
+//   - 不正な UTF-8 / 単独サロゲート → U+FFFD
+//   - CP932 の未定義文字 → U+30FB（・）
+//   - CP932 で表せない文字 → '?'
+// 戻り値: 書き込んだ要素数
+
+size_t ConvertUtf8ToUtf16(const char* src, size_t length, char16_t* dst) noexcept;
+size_t ConvertUtf16ToUtf8(const char16_t* src, size_t length, char* dst) noexcept;
+size_t ConvertUtf8ToCp932(const char* src, size_t length, char* dst) noexcept;
+size_t ConvertCp932ToUtf8(const char* src, size_t length, char* dst) noexcept;
+
+// 先頭から連続する ASCII 文字のバイト数
+size_t CountAsciiPrefix(const char* src, size_t length) noexcept;
+
+// 正しい UTF-8 か（過長表現・サロゲート・範囲外を不正とする）
+bool IsValidUtf8(std::string_view src) noexcept;
+
+// ============================================================
+// バッファ再利用版（dest を上書きし、既存の容量を再利用する）
+// ============================================================
+
+void Utf8ToUtf16Into(std::string_view src, std::u16string& dest);
+void Utf16ToUtf8Into(std::u16string_view src, std::string& dest);
+void Utf8ToCp932Into(std::string_view src, std::string& dest);
+void Cp932ToUtf8Into(std::string_view src, std::string& dest);
+
+} // namespace internal
+} // namespace hsppp
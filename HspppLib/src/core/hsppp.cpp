@@ -14,8 +14,9 @@
 //   - hsppp_drawing.inl : 描画系関数（color, pos, mes, boxf, line, circle, pset, pget, redraw, await, end）
 //   - hsppp_ginfo.inl   : ginfo, font, sysfont, title, width
 //   - hsppp_copy.inl    : gsel, gmode, gcopy, gzoom
-//   - hsppp_interrupt.inl : 割り込みハンドラ（onclick, oncmd, onerror, onexit, onkey）
+//   - hsppp_interrupt.inl : 割り込みハンドラ（onclick, oncmd, onerror, onexit, onkey）、完了通知の配送
 //   - hsppp_string.inl  : 文字列操作関数（instr, strmid, strtrim, strf, getpath）
+//   - hsppp_sort.inl    : ソート関数（sortval, sortstr, sortnote, sortget）
 
 // グローバルモジュールフラグメント
 module;
@@ -32,6 +33,7 @@ module;
 #include <source_location>
 #include <format>
 #include <stdexcept>
+#include <exception>
 #include <filesystem>
 #include <system_error>
 #include <map>
@@ -39,7 +41,27 @@ module;
 #include <fstream>
 #include <cstdio>
 #include <cctype>
-#include <random>
+#include <bit>
+#include <charconv>
+#include <unordered_map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <climits>
+#include <cmath>
+#include <array>
+#include <span>
+#include <utility>
+#include <type_traits>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#include <emmintrin.h>
+#define HSPPP_HAS_SSE2 1
+#endif
 #include <shlobj.h>
 #include <lmcons.h>
 #include <shellapi.h>
@@ -208,6 +230,59 @@ namespace {
             throw hsppp::HspError(hsppp::ERR_INTERNAL, "Unknown exception caught", loc);
         }
     }
+
+    // ============================================================
+    // 並列実行ヘルパー
+    // ============================================================
+
+    // count 個の要素を minChunk 個以上ずつに分けたときのチャンク数（ハードウェアスレッド数が上限）
+    size_t parallelChunkCount(size_t count, size_t minChunk) {
+        const size_t byThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+        const size_t bySize = std::max<size_t>(1, count / minChunk);
+        return std::min(byThreads, bySize);
+    }
+
+    // func(chunk) を chunk = 0 .. chunkCount-1 について並列に実行する
+    // スレッドを作成できない場合は残りを呼び出し元スレッドで処理する
+    template<typename Func>
+    void runParallelChunks(size_t chunkCount, Func&& func) {
+        std::vector<std::thread> workers;
+        size_t next = 1;
+        try {
+            workers.reserve(chunkCount - 1);
+            for (; next < chunkCount; ++next) {
+                workers.emplace_back(func, next);
+            }
+        } catch (const std::system_error&) {
+        } catch (const std::bad_alloc&) {
+        }
+        if (chunkCount > 0) {
+            func(size_t{ 0 });
+        }
+        for (size_t c = next; c < chunkCount; ++c) {
+            func(c);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+// ============================================================
+// 分割ファイル間で使用する関数の前方宣言
+// ============================================================
+namespace hsppp {
+    namespace {
+        // SaveParams::deferred で遅らせた bsave をすべて書き出す（hsppp_file.inl）
+        void flushDeferredSaves(const std::source_location& location);
+
+        // filename への遅らせた bsave だけを書き出し、投入済みの非同期の書き込みも終わるまで待つ
+        // ファイルを同期で読み書きする命令の前に呼ぶ（hsppp_file.inl）
+        void flushDeferredSave(const std::string& filename, const std::source_location& location);
+
+        // pack:// のファイルを開く。見つからない・展開できない場合は HspError（hsppp_file.inl）
+        internal::PackData openPackFile(std::string_view filename, const std::source_location& location);
+    }
 }
 
 // ============================================================
@@ -230,6 +305,10 @@ namespace {
 #include "hsppp_system.inl"
 #include "hsppp_file.inl"
 #include "hsppp_easing.inl"
+#include "hsppp_tween.inl"
+#include "hsppp_vecmath.inl"
+#include "hsppp_collision.inl"
+#include "hsppp_sort.inl"
 #include "hsppp_gui.inl"
 #include "hsppp_media.inl"
 
@@ -265,6 +344,16 @@ namespace hsppp::internal {
     }
 
     void close_system([[maybe_unused]] const std::source_location& location) {
+        // 遅らせた bsave と実行中の bsave_async を書き終える
+        // （end() は ExitProcess するため静的オブジェクトのデストラクタに任せられない）
+        // 終了処理中はエラーを表示できないため、書き出しの失敗は無視する
+        try {
+            flushDeferredSaves(location);
+        }
+        catch (...) {
+        }
+        WaitSharedIoQueueIdle();
+
         // マルチメディアマネージャーの終了
         MediaManager_shutdown();
 
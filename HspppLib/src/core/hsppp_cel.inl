@@ -120,38 +120,58 @@ int Cel::height(const std::source_location& location) const {
     });
 }
 
+int Cel::cell_width(const std::source_location& location) const {
+    return safe_call(location, [&]() -> int {
+        if (!m_valid) return 0;
+
+        auto it = internal::g_celDataMap.find(m_id);
+        if (it == internal::g_celDataMap.end()) {
+            return 0;
+        }
+
+        const internal::CelData& cel = it->second;
+        return cel.divX > 0 ? cel.width / cel.divX : cel.width;
+    });
+}
+
+int Cel::cell_height(const std::source_location& location) const {
+    return safe_call(location, [&]() -> int {
+        if (!m_valid) return 0;
+
+        auto it = internal::g_celDataMap.find(m_id);
+        if (it == internal::g_celDataMap.end()) {
+            return 0;
+        }
+
+        const internal::CelData& cel = it->second;
+        return cel.divY > 0 ? cel.height / cel.divY : cel.height;
+    });
+}
+
 // ============================================================
 // loadCel - Celファクトリー関数
 // ============================================================
 Cel loadCel(std::string_view filename, OptInt celId, const std::source_location& location) {
     return safe_call(location, [&]() -> Cel {
-        int id = celId.value_or(-1);
-        
-        // 自動割り当てモード
-        if (id < 0) {
-            id = internal::g_nextCelId++;
-        }
-        
-        // 画像読み込み
-        int width = 0, height = 0;
-        auto bitmap = internal::loadImageFile(filename, width, height);
-        if (!bitmap) {
-            throw HspError(ERR_FILE_IO, "loadCel: failed to load image", location);
-        }
-        
-        // CelDataを作成
-        internal::CelData celData;
-        celData.pBitmap = bitmap;
-        celData.width = width;
-        celData.height = height;
-        celData.divX = 1;
-        celData.divY = 1;
-        celData.centerX = 0;
-        celData.centerY = 0;
-        celData.filename = std::string(filename);
-        
-        // マップに登録
-        internal::g_celDataMap[id] = std::move(celData);
+        return Cel(loadCelDataInternal(filename, celId, location, "loadCel"), true);
+    });
+}
+
+Cel loadCel(std::string_view filename, OptInt celId, const MaskParams& mask, const std::source_location& location) {
+    return safe_call(location, [&]() -> Cel {
+        // 読み込みは loadCel と同じで、デコードした画素からマスクも作る
+        std::vector<uint32_t> pixels;
+        const int id = loadCelDataInternal(filename, celId, location, "loadCel", &pixels);
+
+        internal::CelData& celData = internal::g_celDataMap[id];
+        const int width = celData.width;
+        const int height = celData.height;
+        celData.maskWordsPerRow = internal::MaskWordsPerRow(width);
+        celData.maskAlphaThreshold = mask.alpha_threshold;
+        celData.maskColorKey = mask.color_key;
+        celData.maskBits.resize(celData.maskWordsPerRow * static_cast<size_t>(height));
+        internal::BuildMask(pixels.data(), static_cast<size_t>(width), width, height,
+                            mask.alpha_threshold, mask.color_key, celData.maskBits.data());
         
         return Cel(id, true);
     });
@@ -0,0 +1,556 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/hsppp_collision.inl
+// 当たり判定の実装（AabbList / SpatialHash / SweepAndPrune / PixelMask）
+// このファイルは hsppp.cpp から #include される
+//
+// 索引（グリッドの登録・並び順）は作業用の配列を使い回して作り直すため、
+// ボディ数が増えない限り2回目以降の検索でメモリ確保は起きない
+
+namespace hsppp {
+
+    namespace {
+
+        // 極端な座標でセル番号があふれないように丸め込む
+        inline int32_t cellCoord(float v, float invCellSize) noexcept {
+            const float c = std::floor(v * invCellSize);
+            if (!(c > -1.0e9f)) return -1'000'000'000;  // NaN もここに含める
+            if (c > 1.0e9f) return 1'000'000'000;
+            return static_cast<int32_t>(c);
+        }
+
+        // SweepAndPrune の並べ替えのキー。NaN は順序を壊すため +∞ として末尾に置く（どの矩形とも重ならない）
+        inline float sweepKey(float v) noexcept {
+            return std::isnan(v) ? std::numeric_limits<float>::infinity() : v;
+        }
+
+    } // namespace
+
+    // ============================================================
+    // Aabb / Cel 連携
+    // ============================================================
+
+    Aabb cel_hitbox(const Cel& cel, float x, float y, float inset, const std::source_location& location) {
+        const float w = static_cast<float>(cel.cell_width(location));
+        const float h = static_cast<float>(cel.cell_height(location));
+        // 縮めすぎた場合は中央の大きさ0の矩形になる
+        const float insetX = std::min(inset, w * 0.5f);
+        const float insetY = std::min(inset, h * 0.5f);
+        return { x + insetX, y + insetY, x + w - insetX, y + h - insetY };
+    }
+
+    // ============================================================
+    // AabbList
+    // ============================================================
+
+    void AabbList::checkRange(const char* name, size_t first, size_t count, const std::source_location& location) const {
+        if (first > size() || count > size() - first) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("{}: ボディ番号が範囲外です（{} + {} / {}）", name, first, count, size()), location);
+        }
+    }
+
+    uint32_t AabbList::insert(const Aabb& box) {
+        const uint32_t body = static_cast<uint32_t>(m_left.size());
+        m_left.push_back(box.left);
+        m_top.push_back(box.top);
+        m_right.push_back(box.right);
+        m_bottom.push_back(box.bottom);
+        m_dirty = true;
+        return body;
+    }
+
+    void AabbList::insert(std::span<const Aabb> boxes) {
+        reserve(size() + boxes.size());
+        for (const Aabb& box : boxes) {
+            m_left.push_back(box.left);
+            m_top.push_back(box.top);
+            m_right.push_back(box.right);
+            m_bottom.push_back(box.bottom);
+        }
+        m_dirty = true;
+    }
+
+    void AabbList::update(uint32_t body, const Aabb& box, const std::source_location& location) {
+        checkRange("AabbList::update", body, 1, location);
+        m_left[body] = box.left;
+        m_top[body] = box.top;
+        m_right[body] = box.right;
+        m_bottom[body] = box.bottom;
+        m_dirty = true;
+    }
+
+    void AabbList::update(std::span<const Aabb> boxes, uint32_t first, const std::source_location& location) {
+        checkRange("AabbList::update", first, boxes.size(), location);
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            m_left[first + i] = boxes[i].left;
+            m_top[first + i] = boxes[i].top;
+            m_right[first + i] = boxes[i].right;
+            m_bottom[first + i] = boxes[i].bottom;
+        }
+        m_dirty = true;
+    }
+
+    void AabbList::move_to(std::span<const Vec2> positions, uint32_t first, const std::source_location& location) {
+        checkRange("AabbList::move_to", first, positions.size(), location);
+        float* left = m_left.data() + first;
+        float* top = m_top.data() + first;
+        float* right = m_right.data() + first;
+        float* bottom = m_bottom.data() + first;
+        for (size_t i = 0; i < positions.size(); ++i) {
+            right[i] = positions[i].x + (right[i] - left[i]);
+            bottom[i] = positions[i].y + (bottom[i] - top[i]);
+            left[i] = positions[i].x;
+            top[i] = positions[i].y;
+        }
+        m_dirty = true;
+    }
+
+    void AabbList::clear() noexcept {
+        m_left.clear();
+        m_top.clear();
+        m_right.clear();
+        m_bottom.clear();
+        m_dirty = true;
+    }
+
+    void AabbList::reserve(size_t count) {
+        m_left.reserve(count);
+        m_top.reserve(count);
+        m_right.reserve(count);
+        m_bottom.reserve(count);
+    }
+
+    // ============================================================
+    // SpatialHash
+    // ============================================================
+
+    SpatialHash::SpatialHash(float cellSize, const std::source_location& location)
+        : m_cellSize(cellSize)
+        , m_invCellSize(1.0f / cellSize) {
+        if (!(cellSize > 0.0f)) {
+            throw HspError(ERR_OUT_OF_RANGE, "SpatialHashのセルの大きさは0より大きい値を指定してください", location);
+        }
+    }
+
+    // 登録するボディは縦横とも2セル以内に収まるため、重なる2つのボディの登録セルは
+    // 縦横とも1つ以内の差になる。隣り合うセルだけを調べれば取りこぼしはない
+
+    void SpatialHash::rebuild() {
+        const uint32_t count = static_cast<uint32_t>(size());
+
+        m_entries.clear();
+        m_large.clear();
+        int32_t minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+        for (uint32_t body = 0; body < count; ++body) {
+            const float left = m_left[body];
+            const float top = m_top[body];
+            const float right = m_right[body];
+            const float bottom = m_bottom[body];
+            const int32_t x0 = cellCoord(left, m_invCellSize);
+            const int32_t y0 = cellCoord(top, m_invCellSize);
+            if (static_cast<int64_t>(cellCoord(right, m_invCellSize)) - x0 > 1 ||
+                static_cast<int64_t>(cellCoord(bottom, m_invCellSize)) - y0 > 1) {
+                m_large.push_back(body);
+                continue;
+            }
+            m_entries.push_back({ x0, y0, body, left, top, right, bottom });
+            minX = std::min(minX, x0);
+            maxX = std::max(maxX, x0);
+            minY = std::min(minY, y0);
+            maxY = std::max(maxY, y0);
+        }
+
+        // セルの (行, 列) で基数ソート（11ビットずつ。使われている範囲の分だけ桁を処理する）
+        if (m_entries.size() > 1) {
+            const uint64_t spanX = static_cast<uint64_t>(static_cast<int64_t>(maxX) - minX) + 1;
+            auto key = [&](const Entry& e) {
+                return static_cast<uint64_t>(static_cast<int64_t>(e.cellY) - minY) * spanX +
+                       static_cast<uint64_t>(static_cast<int64_t>(e.cellX) - minX);
+            };
+            const uint64_t maxKey = static_cast<uint64_t>(static_cast<int64_t>(maxY) - minY) * spanX + (spanX - 1);
+            const int keyBits = std::bit_width(maxKey);
+
+            constexpr int kRadixBits = 11;
+            constexpr uint32_t kRadixSize = 1u << kRadixBits;
+            m_scratch.resize(m_entries.size());
+            for (int shift = 0; shift < keyBits; shift += kRadixBits) {
+                uint32_t offset[kRadixSize] = {};
+                for (const Entry& e : m_entries) {
+                    ++offset[(key(e) >> shift) & (kRadixSize - 1)];
+                }
+                uint32_t sum = 0;
+                for (uint32_t& o : offset) {
+                    const uint32_t n = o;
+                    o = sum;
+                    sum += n;
+                }
+                for (const Entry& e : m_entries) {
+                    m_scratch[offset[(key(e) >> shift) & (kRadixSize - 1)]++] = e;
+                }
+                m_entries.swap(m_scratch);
+            }
+        }
+        m_dirty = false;
+    }
+
+    void SpatialHash::queryInto(const Aabb& area, uint32_t areaIndex,
+                                std::vector<uint32_t>* bodies, std::vector<CollisionPair>* pairs) {
+        auto visit = [&](uint32_t body, float left, float top, float right, float bottom) {
+            if (area.left < right && left < area.right && area.top < bottom && top < area.bottom) {
+                if (bodies) {
+                    bodies->push_back(body);
+                } else {
+                    pairs->push_back({ areaIndex, body });
+                }
+            }
+        };
+
+        // 重なるボディの登録セルは、範囲の左上の1つ手前から右下までのセル
+        const int64_t x0 = static_cast<int64_t>(cellCoord(area.left, m_invCellSize)) - 1;
+        const int64_t x1 = cellCoord(area.right, m_invCellSize);
+        const int64_t y0 = static_cast<int64_t>(cellCoord(area.top, m_invCellSize)) - 1;
+        const int64_t y1 = cellCoord(area.bottom, m_invCellSize);
+        if (y1 - y0 + 1 > static_cast<int64_t>(m_entries.size())) {
+            // 行数が多い場合は行ごとに探すより全登録を調べた方が速い
+            for (const Entry& e : m_entries) {
+                visit(e.body, e.left, e.top, e.right, e.bottom);
+            }
+        } else {
+            for (int64_t y = y0; y <= y1; ++y) {
+                auto it = std::lower_bound(m_entries.begin(), m_entries.end(), std::pair(y, x0),
+                    [](const Entry& e, const std::pair<int64_t, int64_t>& cell) {
+                        return e.cellY < cell.first || (e.cellY == cell.first && e.cellX < cell.second);
+                    });
+                for (; it != m_entries.end() && it->cellY == y && it->cellX <= x1; ++it) {
+                    visit(it->body, it->left, it->top, it->right, it->bottom);
+                }
+            }
+        }
+        for (uint32_t body : m_large) {
+            visit(body, m_left[body], m_top[body], m_right[body], m_bottom[body]);
+        }
+    }
+
+    void SpatialHash::query(const Aabb& area, std::vector<uint32_t>& out) {
+        out.clear();
+        if (m_dirty) {
+            rebuild();
+        }
+        queryInto(area, 0, &out, nullptr);
+    }
+
+    void SpatialHash::query(std::span<const Aabb> areas, std::vector<CollisionPair>& out) {
+        out.clear();
+        if (m_dirty) {
+            rebuild();
+        }
+        for (size_t i = 0; i < areas.size(); ++i) {
+            queryInto(areas[i], static_cast<uint32_t>(i), nullptr, &out);
+        }
+    }
+
+    void SpatialHash::find_pairs(std::vector<CollisionPair>& out) {
+        out.clear();
+        if (m_dirty) {
+            rebuild();
+        }
+
+        auto test = [&out](const Entry& a, const Entry& b) {
+            if (a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom) {
+                out.push_back({ std::min(a.body, b.body), std::max(a.body, b.body) });
+            }
+        };
+
+        // セルごとに、同じセル・右隣のセル・下の行の3セルと組み合わせる（各組は1回だけ調べる）。
+        // 下の行の位置は単調に進むため、全体を1回なめるだけで済む
+        const Entry* entries = m_entries.data();
+        const size_t count = m_entries.size();
+        size_t below = 0;
+        size_t begin = 0;
+        while (begin < count) {
+            const int32_t x = entries[begin].cellX;
+            const int32_t y = entries[begin].cellY;
+            size_t end = begin + 1;
+            while (end < count && entries[end].cellX == x && entries[end].cellY == y) {
+                ++end;
+            }
+
+            for (size_t i = begin; i < end; ++i) {
+                for (size_t j = i + 1; j < end; ++j) {
+                    test(entries[i], entries[j]);
+                }
+            }
+            for (size_t j = end; j < count && entries[j].cellY == y && entries[j].cellX == x + 1; ++j) {
+                for (size_t i = begin; i < end; ++i) {
+                    test(entries[i], entries[j]);
+                }
+            }
+            while (below < count && (entries[below].cellY < y + 1 ||
+                                     (entries[below].cellY == y + 1 && entries[below].cellX < x - 1))) {
+                ++below;
+            }
+            for (size_t j = below; j < count && entries[j].cellY == y + 1 && entries[j].cellX <= x + 1; ++j) {
+                for (size_t i = begin; i < end; ++i) {
+                    test(entries[i], entries[j]);
+                }
+            }
+            begin = end;
+        }
+
+        // 大きなボディは全ボディと総当たり（大きなボディ同士は番号の小さい側で1回だけ）
+        for (uint32_t large : m_large) {
+            for (uint32_t body = 0; body < size(); ++body) {
+                if (body == large) {
+                    continue;
+                }
+                if (!(m_left[large] < m_right[body] && m_left[body] < m_right[large] &&
+                      m_top[large] < m_bottom[body] && m_top[body] < m_bottom[large])) {
+                    continue;
+                }
+                if (body < large && std::binary_search(m_large.begin(), m_large.end(), body)) {
+                    continue;
+                }
+                out.push_back({ std::min(large, body), std::max(large, body) });
+            }
+        }
+    }
+
+    // ============================================================
+    // SweepAndPrune
+    // ============================================================
+
+    void SweepAndPrune::rebuild() {
+        const uint32_t count = static_cast<uint32_t>(size());
+
+        // 前回の並び順を引き継ぎ、増えたボディは末尾に追加、減ったボディは取り除く
+        if (m_order.size() > count) {
+            std::erase_if(m_order, [count](uint32_t body) { return body >= count; });
+        }
+        for (uint32_t body = static_cast<uint32_t>(m_order.size()); body < count; ++body) {
+            m_order.push_back(body);
+        }
+
+        // 少しずつ動く場合はほぼ整列済みなので挿入ソート。移動が多すぎる場合は打ち切って通常のソート
+        const float* left = m_left.data();
+        size_t budget = static_cast<size_t>(count) * 8 + 64;
+        bool sorted = true;
+        for (size_t i = 1; i < count && sorted; ++i) {
+            const uint32_t body = m_order[i];
+            const float key = sweepKey(left[body]);
+            size_t j = i;
+            while (j > 0 && sweepKey(left[m_order[j - 1]]) > key) {
+                m_order[j] = m_order[j - 1];
+                --j;
+                if (--budget == 0) {
+                    sorted = false;
+                    break;
+                }
+            }
+            m_order[j] = body;
+        }
+        if (!sorted) {
+            std::sort(m_order.begin(), m_order.end(), [left](uint32_t a, uint32_t b) {
+                const float ka = sweepKey(left[a]);
+                const float kb = sweepKey(left[b]);
+                return ka < kb || (ka == kb && a < b);
+            });
+        }
+
+        // 走査が連続したメモリを読むように、並べた順の矩形を写しておく
+        m_sortedLeft.resize(count);
+        m_sortedTop.resize(count);
+        m_sortedRight.resize(count);
+        m_sortedBottom.resize(count);
+        m_maxWidth = 0.0f;
+        for (uint32_t i = 0; i < count; ++i) {
+            const uint32_t body = m_order[i];
+            m_sortedLeft[i] = sweepKey(left[body]);
+            m_sortedTop[i] = m_top[body];
+            m_sortedRight[i] = m_right[body];
+            m_sortedBottom[i] = m_bottom[body];
+            m_maxWidth = std::max(m_maxWidth, m_right[body] - m_sortedLeft[i]);
+        }
+        m_dirty = false;
+    }
+
+    void SweepAndPrune::queryInto(const Aabb& area, uint32_t areaIndex,
+                                  std::vector<uint32_t>* bodies, std::vector<CollisionPair>* pairs) {
+        // 重なるボディの left は (area.left - 最大幅, area.right) の範囲にある
+        const double lowest = static_cast<double>(area.left) - m_maxWidth;
+        auto it = std::lower_bound(m_sortedLeft.begin(), m_sortedLeft.end(), lowest,
+                                   [](float value, double bound) { return value < bound; });
+        for (size_t i = static_cast<size_t>(it - m_sortedLeft.begin()); i < m_sortedLeft.size(); ++i) {
+            if (!(m_sortedLeft[i] < area.right)) {
+                break;
+            }
+            if (area.left < m_sortedRight[i] && area.top < m_sortedBottom[i] && m_sortedTop[i] < area.bottom) {
+                if (bodies) {
+                    bodies->push_back(m_order[i]);
+                } else {
+                    pairs->push_back({ areaIndex, m_order[i] });
+                }
+            }
+        }
+    }
+
+    void SweepAndPrune::query(const Aabb& area, std::vector<uint32_t>& out) {
+        out.clear();
+        if (m_dirty) {
+            rebuild();
+        }
+        queryInto(area, 0, &out, nullptr);
+    }
+
+    void SweepAndPrune::query(std::span<const Aabb> areas, std::vector<CollisionPair>& out) {
+        out.clear();
+        if (m_dirty) {
+            rebuild();
+        }
+        for (size_t i = 0; i < areas.size(); ++i) {
+            queryInto(areas[i], static_cast<uint32_t>(i), nullptr, &out);
+        }
+    }
+
+    void SweepAndPrune::find_pairs(std::vector<CollisionPair>& out) {
+        out.clear();
+        if (m_dirty) {
+            rebuild();
+        }
+
+        // x 方向に並べた順に、右端より左から始まるボディだけを調べる
+        const size_t count = m_order.size();
+        const float* sortedLeft = m_sortedLeft.data();
+        const float* sortedTop = m_sortedTop.data();
+        const float* sortedRight = m_sortedRight.data();
+        const float* sortedBottom = m_sortedBottom.data();
+        for (size_t i = 0; i < count; ++i) {
+            const float left = sortedLeft[i];
+            const float top = sortedTop[i];
+            const float right = sortedRight[i];
+            const float bottom = sortedBottom[i];
+            for (size_t j = i + 1; j < count && sortedLeft[j] < right; ++j) {
+                if (left < sortedRight[j] && top < sortedBottom[j] && sortedTop[j] < bottom) {
+                    const uint32_t a = m_order[i];
+                    const uint32_t b = m_order[j];
+                    out.push_back({ std::min(a, b), std::max(a, b) });
+                }
+            }
+        }
+    }
+
+    // ============================================================
+    // PixelMask
+    // ============================================================
+    // マスクの作成・判定は CollisionMask.cpp（Win32 非依存）のカーネルを使う
+
+    PixelMask PixelMask::from_bgra(std::span<const uint32_t> pixels, int width, int height,
+                                   const MaskParams& params, const std::source_location& location) {
+        if (width < 0 || height < 0 ||
+            pixels.size() != static_cast<size_t>(width) * static_cast<size_t>(height)) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("PixelMask::from_bgra: 画素数が大きさと一致しません（{} / {}x{}）", pixels.size(), width, height), location);
+        }
+        PixelMask mask;
+        mask.m_width = width;
+        mask.m_height = height;
+        mask.m_wordsPerRow = internal::MaskWordsPerRow(width);
+        mask.m_bits.resize(mask.m_wordsPerRow * static_cast<size_t>(height));
+        internal::BuildMask(pixels.data(), static_cast<size_t>(width), width, height,
+                            params.alpha_threshold, params.color_key, mask.m_bits.data());
+        mask.updateBounds();
+        return mask;
+    }
+
+    PixelMask PixelMask::from_bits(int width, int height, std::vector<uint64_t> bits, const std::source_location& location) {
+        const size_t wordsPerRow = internal::MaskWordsPerRow(width);
+        if (width < 0 || height < 0 || bits.size() != wordsPerRow * static_cast<size_t>(height)) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("PixelMask::from_bits: ワード数が大きさと一致しません（{} / {}x{}）", bits.size(), width, height), location);
+        }
+        // 幅を超える余りのビットは常に 0 にしておく（判定はこれを前提にする）
+        if (const int tail = width & 63; tail != 0) {
+            for (int y = 0; y < height; ++y) {
+                bits[static_cast<size_t>(y) * wordsPerRow + wordsPerRow - 1] &= (uint64_t{1} << tail) - 1;
+            }
+        }
+        PixelMask mask;
+        mask.m_width = width;
+        mask.m_height = height;
+        mask.m_wordsPerRow = wordsPerRow;
+        mask.m_bits = std::move(bits);
+        mask.updateBounds();
+        return mask;
+    }
+
+    void PixelMask::updateBounds() noexcept {
+        internal::MaskBounds(m_bits.data(), m_wordsPerRow, m_height, m_left, m_top, m_right, m_bottom);
+    }
+
+    bool PixelMask::overlaps(int x, int y, const PixelMask& other, int otherX, int otherY) const noexcept {
+        const internal::MaskView a{ m_bits.data(), m_wordsPerRow, m_width, m_height, m_left, m_top, m_right, m_bottom };
+        const internal::MaskView b{ other.m_bits.data(), other.m_wordsPerRow, other.m_width, other.m_height,
+                                    other.m_left, other.m_top, other.m_right, other.m_bottom };
+        return internal::MasksOverlap(a, x, y, b, otherX, otherY);
+    }
+
+    PixelMask load_mask(std::string_view filename, const MaskParams& params, const std::source_location& location) {
+        flushDeferredSave(std::string(filename), location);
+        int width = 0, height = 0;
+        std::vector<uint32_t> pixels;
+        if (!internal::decodeImageFile(filename, pixels, width, height)) {
+            throw HspError(ERR_FILE_IO, std::format("load_mask: 画像を読み込めません（{}）", filename), location);
+        }
+        return PixelMask::from_bgra(pixels, width, height, params, location);
+    }
+
+    namespace {
+
+        const internal::CelData& celDataWithMask(const Cel& cel, const char* name, const std::source_location& location) {
+            auto it = internal::g_celDataMap.find(cel.id());
+            if (!cel.valid() || it == internal::g_celDataMap.end()) {
+                throw HspError(ERR_INVALID_HANDLE, std::format("{}: Cel が無効です", name), location);
+            }
+            if (it->second.maskWordsPerRow == 0) {
+                throw HspError(ERR_UNSUPPORTED,
+                    std::format("{}: マスクを作成していない Cel です（MaskParams を指定して loadCel してください）", name), location);
+            }
+            return it->second;
+        }
+
+        PixelMask cutCelMask(const internal::CelData& cel, int cellIndex, const std::source_location& location) {
+            const int cellWidth = cel.width / cel.divX;
+            const int cellHeight = cel.height / cel.divY;
+            std::vector<uint64_t> bits(internal::MaskWordsPerRow(cellWidth) * static_cast<size_t>(cellHeight));
+            internal::CopyMaskRect(cel.maskBits.data(), cel.maskWordsPerRow,
+                                   (cellIndex % cel.divX) * cellWidth, (cellIndex / cel.divX) * cellHeight,
+                                   cellWidth, cellHeight, bits.data());
+            return PixelMask::from_bits(cellWidth, cellHeight, std::move(bits), location);
+        }
+
+    } // namespace
+
+    PixelMask cel_mask(const Cel& cel, int cellIndex, const std::source_location& location) {
+        const internal::CelData& data = celDataWithMask(cel, "cel_mask", location);
+        if (cellIndex < 0 || cellIndex >= data.divX * data.divY) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("cel_mask: セル番号が範囲外です（{} / {}）", cellIndex, data.divX * data.divY), location);
+        }
+        return cutCelMask(data, cellIndex, location);
+    }
+
+    std::vector<PixelMask> cel_masks(const Cel& cel, const std::source_location& location) {
+        const internal::CelData& data = celDataWithMask(cel, "cel_masks", location);
+        std::vector<PixelMask> masks;
+        masks.reserve(static_cast<size_t>(data.divX) * static_cast<size_t>(data.divY));
+        for (int i = 0; i < data.divX * data.divY; ++i) {
+            masks.push_back(cutCelMask(data, i, location));
+        }
+        return masks;
+    }
+
+} // namespace hsppp
@@ -80,6 +80,9 @@ namespace hsppp {
             if (time_ms < 0) {
                 throw HspError(ERR_OUT_OF_RANGE, "awaitの待ち時間は0以上の値を指定してください", location);
             }
+
+            // このフレームで遅らせた bsave を書き出す
+            flushDeferredSaves(location);
             
             // StateMachine コンテキストを取得（遷移チェック用）
             auto* sm_context = detail::get_current_statemachine();
@@ -140,6 +143,8 @@ namespace hsppp {
             }
             else {
                 // すでに指定時間を超過している場合もメッセージ処理だけ行う
+                // 完了通知はメッセージがなくても配送する
+                processPostedCallbacks();
                 while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
                     // StateMachine コンテキストがある場合、遷移予約をチェック
                     if (sm_context && sm_context->should_transition()) {
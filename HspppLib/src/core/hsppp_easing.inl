@@ -5,18 +5,12 @@
 // SPDX-License-Identifier: BSL-1.0
 
 // HspppLib/src/core/hsppp_easing.inl
-// イージング関数、ソート関数、デバッグ出力の実装
+// イージング関数、デバッグ出力の実装
+// ソート関数は hsppp_sort.inl
 
 namespace {
-    // イージング関数の状態
-    double g_easeMin = 0.0;
-    double g_easeMax = 1.0;
-    int g_easeType = 0;  // ease_linear
-
-    // ソート関数のインデックス履歴
-    // NOTE: HSP互換性のため、最後にソートされた配列のインデックスをグローバルに保持
-    // sortget()は「最後に実行されたソート」の結果を返すHSPの仕様を再現している
-    std::vector<int> g_sortIndices;
+    // setease で設定されたイージング曲線（getease/geteasef 用）
+    hsppp::Easing g_ease;
 }
 
 namespace hsppp {
@@ -24,6 +18,10 @@ namespace hsppp {
     // ============================================================
     // イージング計算ヘルパー
     // ============================================================
+    //
+    // 曲線の式はレーン型（スカラー / SSE2）に対するテンプレートで1回だけ記述し、
+    // タイプごとにコンパイル時に特殊化したバッチカーネルを関数テーブルから選ぶ。
+    // 分岐のある曲線は両側を計算してマスクで選択するため、SIMD版もスカラー版と同じ値になる
 
     namespace {
         // バウンスイージング用定数
@@ -32,249 +30,270 @@ namespace hsppp {
             constexpr double D1 = 2.75;
         }
 
-        // バウンスアウトの共通実装
-        double bounceOutImpl(double t) {
-            if (t < 1.0 / bounce::D1) {
-                return bounce::N1 * t * t;
-            } else if (t < 2.0 / bounce::D1) {
-                t -= 1.5 / bounce::D1;
-                return bounce::N1 * t * t + 0.75;
-            } else if (t < 2.5 / bounce::D1) {
-                t -= 2.25 / bounce::D1;
-                return bounce::N1 * t * t + 0.9375;
-            } else {
-                t -= 2.625 / bounce::D1;
-                return bounce::N1 * t * t + 0.984375;
+        constexpr int kEaseTypeCount = ease_shake_inout + 1;
+
+        // スカラー演算（1要素）
+        struct ScalarLane {
+            using Value = double;
+            using Mask = bool;
+            static double set1(double v) noexcept { return v; }
+            static double add(double a, double b) noexcept { return a + b; }
+            static double sub(double a, double b) noexcept { return a - b; }
+            static double mul(double a, double b) noexcept { return a * b; }
+            static bool less(double a, double b) noexcept { return a < b; }
+            static double select(bool mask, double a, double b) noexcept { return mask ? a : b; }
+            static double clamp01(double t) noexcept { return std::clamp(t, 0.0, 1.0); }
+        };
+
+#ifdef HSPPP_HAS_SSE2
+        // SSE2 演算（2要素）
+        struct Sse2Lane {
+            using Value = __m128d;
+            using Mask = __m128d;
+            static __m128d set1(double v) noexcept { return _mm_set1_pd(v); }
+            static __m128d add(__m128d a, __m128d b) noexcept { return _mm_add_pd(a, b); }
+            static __m128d sub(__m128d a, __m128d b) noexcept { return _mm_sub_pd(a, b); }
+            static __m128d mul(__m128d a, __m128d b) noexcept { return _mm_mul_pd(a, b); }
+            static __m128d less(__m128d a, __m128d b) noexcept { return _mm_cmplt_pd(a, b); }
+            static __m128d select(__m128d mask, __m128d a, __m128d b) noexcept {
+                return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+            }
+            // 引数順は std::clamp と同じく NaN をそのまま通すため
+            static __m128d clamp01(__m128d t) noexcept {
+                return _mm_min_pd(_mm_set1_pd(1.0), _mm_max_pd(_mm_set1_pd(0.0), t));
             }
+        };
+#endif
+
+        // バウンスアウトの共通実装（4区間を計算して選択）
+        template<typename L>
+        typename L::Value bounceOut(typename L::Value t) noexcept {
+            const auto n1 = L::set1(bounce::N1);
+            const auto t1 = L::sub(t, L::set1(1.5 / bounce::D1));
+            const auto t2 = L::sub(t, L::set1(2.25 / bounce::D1));
+            const auto t3 = L::sub(t, L::set1(2.625 / bounce::D1));
+            const auto r0 = L::mul(L::mul(n1, t), t);
+            const auto r1 = L::add(L::mul(L::mul(n1, t1), t1), L::set1(0.75));
+            const auto r2 = L::add(L::mul(L::mul(n1, t2), t2), L::set1(0.9375));
+            const auto r3 = L::add(L::mul(L::mul(n1, t3), t3), L::set1(0.984375));
+            return L::select(L::less(t, L::set1(1.0 / bounce::D1)), r0,
+                   L::select(L::less(t, L::set1(2.0 / bounce::D1)), r1,
+                   L::select(L::less(t, L::set1(2.5 / bounce::D1)), r2, r3)));
         }
 
-        // 正規化された時間 t (0.0〜1.0) から補間値を計算
-        double calculateEase(double t, int type) {
-            // ループフラグの処理
-            bool isLoop = (type & ease_loop) != 0;
-            int baseType = type & ~ease_loop;
-            
-            if (isLoop) {
-                // ループ処理: 0→1→0→1...を繰り返す
-                t = std::fmod(t, 2.0);
-                if (t > 1.0) {
-                    t = 2.0 - t;  // 折り返し
-                }
+        // シェイク系は sin を使うためスカラーのみ
+        template<int Type>
+        constexpr bool kEaseVectorizable = Type < ease_shake_in;
+
+        // 正規化・クランプ済みの t から補間値（0.0〜1.0）を計算
+        template<int Type, typename L>
+        typename L::Value easeCurve(typename L::Value t) noexcept {
+            const auto one = L::set1(1.0);
+            const auto half = L::set1(0.5);
+            if constexpr (Type == ease_quad_in) {
+                return L::mul(t, t);
+            } else if constexpr (Type == ease_quad_out) {
+                return L::mul(t, L::sub(L::set1(2.0), t));
+            } else if constexpr (Type == ease_quad_inout) {
+                const auto lo = L::mul(L::mul(L::set1(2.0), t), t);
+                const auto hi = L::add(L::set1(-1.0), L::mul(L::sub(L::set1(4.0), L::mul(L::set1(2.0), t)), t));
+                return L::select(L::less(t, half), lo, hi);
+            } else if constexpr (Type == ease_cubic_in) {
+                return L::mul(L::mul(t, t), t);
+            } else if constexpr (Type == ease_cubic_out) {
+                const auto t1 = L::sub(t, one);
+                return L::add(L::mul(L::mul(t1, t1), t1), one);
+            } else if constexpr (Type == ease_cubic_inout) {
+                const auto lo = L::mul(L::mul(L::mul(L::set1(4.0), t), t), t);
+                const auto t1 = L::sub(L::mul(L::set1(2.0), t), L::set1(2.0));
+                const auto hi = L::add(L::mul(L::mul(L::mul(half, t1), t1), t1), one);
+                return L::select(L::less(t, half), lo, hi);
+            } else if constexpr (Type == ease_quartic_in) {
+                return L::mul(L::mul(L::mul(t, t), t), t);
+            } else if constexpr (Type == ease_quartic_out) {
+                const auto t1 = L::sub(t, one);
+                return L::sub(one, L::mul(L::mul(L::mul(t1, t1), t1), t1));
+            } else if constexpr (Type == ease_quartic_inout) {
+                const auto lo = L::mul(L::mul(L::mul(L::mul(L::set1(8.0), t), t), t), t);
+                const auto t1 = L::sub(t, one);
+                const auto hi = L::sub(one, L::mul(L::mul(L::mul(L::mul(L::set1(8.0), t1), t1), t1), t1));
+                return L::select(L::less(t, half), lo, hi);
+            } else if constexpr (Type == ease_bounce_in) {
+                return L::sub(one, bounceOut<L>(L::sub(one, t)));
+            } else if constexpr (Type == ease_bounce_out) {
+                return bounceOut<L>(t);
+            } else if constexpr (Type == ease_bounce_inout) {
+                const auto two = L::set1(2.0);
+                const auto lo = L::mul(L::sub(one, bounceOut<L>(L::sub(one, L::mul(two, t)))), half);
+                const auto hi = L::add(L::mul(bounceOut<L>(L::sub(L::mul(two, t), one)), half), half);
+                return L::select(L::less(t, half), lo, hi);
+            } else if constexpr (Type == ease_shake_in || Type == ease_shake_out || Type == ease_shake_inout) {
+                static_assert(std::is_same_v<L, ScalarLane>, "シェイク系はスカラーのみ");
+                // シェイク効果（in: 振動しながら収束 / out: 振動しながら減衰 / inout: 中央でピーク）
+                // NOTE: out の (1 - 振幅) は in の振幅と同じ式になる
+                constexpr double frequency = 10.0;
+                const double amplitude = (Type == ease_shake_inout) ? (t < 0.5 ? t : (1.0 - t)) : (1.0 - t);
+                return t + amplitude * std::sin(t * frequency * M_PI) * 0.1;
             } else {
-                // 範囲外はクランプ
-                t = std::clamp(t, 0.0, 1.0);
+                return t;  // ease_linear / 不明なタイプ
             }
+        }
 
-            switch (baseType) {
-                case ease_linear:
-                    return t;
-
-                case ease_quad_in:
-                    return t * t;
-
-                case ease_quad_out:
-                    return t * (2.0 - t);
-
-                case ease_quad_inout:
-                    if (t < 0.5) {
-                        return 2.0 * t * t;
-                    } else {
-                        return -1.0 + (4.0 - 2.0 * t) * t;
-                    }
-
-                case ease_cubic_in:
-                    return t * t * t;
-
-                case ease_cubic_out: {
-                    double t1 = t - 1.0;
-                    return t1 * t1 * t1 + 1.0;
-                }
-
-                case ease_cubic_inout:
-                    if (t < 0.5) {
-                        return 4.0 * t * t * t;
-                    } else {
-                        double t1 = 2.0 * t - 2.0;
-                        return 0.5 * t1 * t1 * t1 + 1.0;
-                    }
-
-                case ease_quartic_in:
-                    return t * t * t * t;
-
-                case ease_quartic_out: {
-                    double t1 = t - 1.0;
-                    return 1.0 - t1 * t1 * t1 * t1;
-                }
-
-                case ease_quartic_inout:
-                    if (t < 0.5) {
-                        return 8.0 * t * t * t * t;
-                    } else {
-                        double t1 = t - 1.0;
-                        return 1.0 - 8.0 * t1 * t1 * t1 * t1;
-                    }
+        // ease_loop 時の折り返し（0→1→0→1...）
+        double foldEaseLoop(double t) noexcept {
+            t = std::fmod(t, 2.0);
+            if (t > 1.0) {
+                t = 2.0 - t;
+            }
+            return t;
+        }
 
-                case ease_bounce_in:
-                    return 1.0 - bounceOutImpl(1.0 - t);
+        template<int Type>
+        double easeScalar(double t) noexcept {
+            return easeCurve<Type, ScalarLane>(t);
+        }
 
-                case ease_bounce_out:
-                    return bounceOutImpl(t);
+        // 正規化された時間 t (0.0〜1.0) から補間値を計算
+        double calculateEase(double t, int type) {
+            using ScalarFn = double (*)(double) noexcept;
+            static constexpr auto table = []<int... I>(std::integer_sequence<int, I...>) {
+                return std::array<ScalarFn, kEaseTypeCount>{ &easeScalar<I>... };
+            }(std::make_integer_sequence<int, kEaseTypeCount>{});
+
+            const bool isLoop = (type & ease_loop) != 0;
+            const int baseType = type & ~ease_loop;
+            // 範囲外はループ時は折り返し、それ以外はクランプ
+            t = isLoop ? foldEaseLoop(t) : std::clamp(t, 0.0, 1.0);
+            if (baseType < 0 || baseType >= kEaseTypeCount) {
+                return t;  // 不明なタイプはリニア
+            }
+            return table[static_cast<size_t>(baseType)](t);
+        }
 
-                case ease_bounce_inout:
-                    if (t < 0.5) {
-                        return (1.0 - bounceOutImpl(1.0 - 2.0 * t)) * 0.5;
-                    } else {
-                        return bounceOutImpl(2.0 * t - 1.0) * 0.5 + 0.5;
+        // バッチ評価カーネル: out[i] = base + scale * ease(t[i])
+        // Clamp が false のとき t は折り返し済み（ease_loop）
+        template<int Type, bool Clamp>
+        void easeBatch(const double* t, double* out, size_t count, double base, double scale) noexcept {
+            size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+            if constexpr (kEaseVectorizable<Type>) {
+                const __m128d vBase = _mm_set1_pd(base);
+                const __m128d vScale = _mm_set1_pd(scale);
+                for (; i + 4 <= count; i += 4) {
+                    __m128d a = _mm_loadu_pd(t + i);
+                    __m128d b = _mm_loadu_pd(t + i + 2);
+                    if constexpr (Clamp) {
+                        a = Sse2Lane::clamp01(a);
+                        b = Sse2Lane::clamp01(b);
                     }
-
-                case ease_shake_in: {
-                    // シェイク効果（振動しながら収束）
-                    double amplitude = 1.0 - t;
-                    constexpr double frequency = 10.0;
-                    return t + amplitude * std::sin(t * frequency * M_PI) * 0.1;
-                }
-
-                case ease_shake_out: {
-                    // シェイク効果（振動しながら減衰）
-                    double amplitude = t;
-                    constexpr double frequency = 10.0;
-                    return t + (1.0 - amplitude) * std::sin(t * frequency * M_PI) * 0.1;
+                    a = easeCurve<Type, Sse2Lane>(a);
+                    b = easeCurve<Type, Sse2Lane>(b);
+                    _mm_storeu_pd(out + i, _mm_add_pd(vBase, _mm_mul_pd(vScale, a)));
+                    _mm_storeu_pd(out + i + 2, _mm_add_pd(vBase, _mm_mul_pd(vScale, b)));
                 }
-
-                case ease_shake_inout: {
-                    // シェイク効果（中央でピーク）
-                    double amplitude = t < 0.5 ? t : (1.0 - t);
-                    constexpr double frequency = 10.0;
-                    return t + amplitude * std::sin(t * frequency * M_PI) * 0.1;
+            }
+#endif
+            for (; i < count; ++i) {
+                double v = t[i];
+                if constexpr (Clamp) {
+                    v = std::clamp(v, 0.0, 1.0);
                 }
-
-                default:
-                    return t;  // 不明なタイプはリニア
+                out[i] = base + scale * easeCurve<Type, ScalarLane>(v);
             }
         }
+
+        using EaseBatchFn = void (*)(const double*, double*, size_t, double, double) noexcept;
+
+        template<bool Clamp>
+        constexpr auto kEaseBatchTable = []<int... I>(std::integer_sequence<int, I...>) {
+            return std::array<EaseBatchFn, kEaseTypeCount>{ &easeBatch<I, Clamp>... };
+        }(std::make_integer_sequence<int, kEaseTypeCount>{});
     }
 
     // ============================================================
-    // イージング関数の実装
+    // Easing / EasingTable
     // ============================================================
 
-    void setease(double p1, double p2, OptInt p3, [[maybe_unused]] const std::source_location& location) {
-        g_easeMin = p1;
-        g_easeMax = p2;
-        if (!p3.is_default()) {
-            g_easeType = p3.value();
-        }
+    double Easing::evaluate(double t) const noexcept {
+        return m_min + (m_max - m_min) * calculateEase(t, m_type);
     }
 
-    int getease(int p1, OptInt p2, [[maybe_unused]] const std::source_location& location) {
-        int maxVal = p2.value_or(4096);
-        if (maxVal <= 0) {
-            return static_cast<int>(g_easeMin);
+    void Easing::evaluate(std::span<const double> t, std::span<double> out, const std::source_location& location) const {
+        if (t.size() != out.size()) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("Easing::evaluate: 出力配列の要素数が入力と一致しません（{} / {}）", out.size(), t.size()), location);
         }
-
-        double t = static_cast<double>(p1) / static_cast<double>(maxVal);
-        double eased = calculateEase(t, g_easeType);
-        double result = g_easeMin + (g_easeMax - g_easeMin) * eased;
-        return static_cast<int>(result);
-    }
-
-    double geteasef(double p1, OptDouble p2, [[maybe_unused]] const std::source_location& location) {
-        double maxVal = p2.value_or(1.0);
-        if (maxVal <= 0.0) {
-            return g_easeMin;
+        const bool isLoop = (m_type & ease_loop) != 0;
+        int baseType = m_type & ~ease_loop;
+        if (baseType < 0 || baseType >= kEaseTypeCount) {
+            baseType = ease_linear;  // 不明なタイプはリニア
         }
 
-        double t = p1 / maxVal;
-        double eased = calculateEase(t, g_easeType);
-        return g_easeMin + (g_easeMax - g_easeMin) * eased;
+        const double* src = t.data();
+        if (isLoop) {
+            // 折り返しは fmod を使うため先にスカラーで out に書き出し、その場で評価
+            for (size_t i = 0; i < t.size(); ++i) {
+                out[i] = foldEaseLoop(src[i]);
+            }
+            src = out.data();
+            kEaseBatchTable<false>[static_cast<size_t>(baseType)](src, out.data(), out.size(), m_min, m_max - m_min);
+        } else {
+            kEaseBatchTable<true>[static_cast<size_t>(baseType)](src, out.data(), out.size(), m_min, m_max - m_min);
+        }
     }
 
-    // ============================================================
-    // ソート関数の実装
-    // ============================================================
-
-    namespace {
-        // ソート共通実装（インデックスソート方式で効率化）
-        template<typename T>
-        void sortImpl(std::vector<T>& arr, bool descending) {
-            size_t n = arr.size();
-            
-            // インデックス配列を作成
-            std::vector<int> indices(n);
-            for (size_t i = 0; i < n; ++i) {
-                indices[i] = static_cast<int>(i);
-            }
-            
-            // インデックスをソート
-            if (descending) {
-                std::sort(indices.begin(), indices.end(),
-                    [&arr](int a, int b) { return arr[a] > arr[b]; });
-            } else {
-                std::sort(indices.begin(), indices.end(),
-                    [&arr](int a, int b) { return arr[a] < arr[b]; });
+    EasingTable::EasingTable(const Easing& easing, int maxValue, const std::source_location& location)
+        : m_easing(easing)
+        , m_maxValue(maxValue)
+        , m_loop((easing.type() & ease_loop) != 0)
+    {
+        constexpr int kMaxTableValue = 1 << 24;
+        if (maxValue <= 0 || maxValue > kMaxTableValue) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("EasingTable: 最大値は1〜{}の範囲で指定してください（{}）", kMaxTableValue, maxValue), location);
+        }
+        safe_call(location, [&] {
+            // ループ時は 0〜2*maxValue-1 で1周期
+            const size_t size = m_loop ? static_cast<size_t>(maxValue) * 2 : static_cast<size_t>(maxValue) + 1;
+            std::vector<double> t(size);
+            const double denom = static_cast<double>(maxValue);
+            for (size_t i = 0; i < size; ++i) {
+                t[i] = static_cast<double>(i) / denom;
             }
-            
-            // ソート結果の配列を作成（moveで効率化）
-            std::vector<T> sorted;
-            sorted.reserve(n);
-            g_sortIndices.resize(n);
-            
-            for (size_t i = 0; i < n; ++i) {
-                sorted.push_back(std::move(arr[indices[i]]));
-                g_sortIndices[i] = indices[i];
+            easing.evaluate(t, t, location);
+            m_values.resize(size);
+            for (size_t i = 0; i < size; ++i) {
+                m_values[i] = static_cast<int>(t[i]);
             }
-            
-            arr = std::move(sorted);
-        }
+        });
     }
 
-    void sortval(std::vector<int>& arr, OptInt order, [[maybe_unused]] const std::source_location& location) {
-        sortImpl(arr, order.value_or(0) == 1);
+    int EasingTable::evaluate_direct(int p1) const noexcept {
+        return static_cast<int>(m_easing.evaluate(static_cast<double>(p1) / static_cast<double>(m_maxValue)));
     }
 
-    void sortval(std::vector<double>& arr, OptInt order, [[maybe_unused]] const std::source_location& location) {
-        sortImpl(arr, order.value_or(0) == 1);
-    }
+    // ============================================================
+    // イージング関数の実装（HSP互換: g_ease を使う薄いラッパー）
+    // ============================================================
 
-    void sortstr(std::vector<std::string>& arr, OptInt order, [[maybe_unused]] const std::source_location& location) {
-        sortImpl(arr, order.value_or(0) == 1);
+    void setease(double p1, double p2, OptInt p3, [[maybe_unused]] const std::source_location& location) {
+        g_ease = Easing(p1, p2, p3.value_or(g_ease.type()));
     }
 
-    void sortnote(std::string& note, OptInt order, const std::source_location& location) {
-        // メモリノート形式を行に分解
-        std::vector<std::string> lines = split(note, "\n", location);
-
-        // sortstrを使ってソート
-        sortstr(lines, order, location);
-
-        // 再度メモリノート形式に結合（reserveで効率化）
-        if (lines.empty()) {
-            note.clear();
-            return;
-        }
-        
-        size_t totalSize = 0;
-        for (const auto& line : lines) {
-            totalSize += line.size();
-        }
-        totalSize += lines.size() - 1;  // 改行文字分
-        
-        note.clear();
-        note.reserve(totalSize);
-        note += lines[0];
-        for (size_t i = 1; i < lines.size(); ++i) {
-            note += '\n';
-            note += lines[i];
+    int getease(int p1, OptInt p2, [[maybe_unused]] const std::source_location& location) {
+        int maxVal = p2.value_or(4096);
+        if (maxVal <= 0) {
+            return static_cast<int>(g_ease.min_value());
         }
+        return static_cast<int>(g_ease.evaluate(static_cast<double>(p1) / static_cast<double>(maxVal)));
     }
 
-    int sortget(int index, const std::source_location& location) {
-        return safe_call(location, [&]() -> int {
-            if (index < 0 || static_cast<size_t>(index) >= g_sortIndices.size()) {
-                throw HspError(ERR_OUT_OF_ARRAY, "sortgetのインデックスが範囲外です", location);
-            }
-            return g_sortIndices[index];
-        });
+    double geteasef(double p1, OptDouble p2, [[maybe_unused]] const std::source_location& location) {
+        double maxVal = p2.value_or(1.0);
+        if (maxVal <= 0.0) {
+            return g_ease.min_value();
+        }
+        return g_ease.evaluate(p1 / maxVal);
     }
 
     // ============================================================
@@ -282,19 +301,11 @@ namespace hsppp {
     // ============================================================
 
     void logmes(std::string_view message, [[maybe_unused]] const std::source_location& location) {
-        // UTF-8からワイド文字列への変換
-        int wlen = MultiByteToWideChar(CP_UTF8, 0, message.data(), 
-            static_cast<int>(message.size()), nullptr, 0);
-        if (wlen > 0) {
-            std::wstring wmsg(wlen, L'\0');
-            MultiByteToWideChar(CP_UTF8, 0, message.data(), 
-                static_cast<int>(message.size()), wmsg.data(), wlen);
-            wmsg += L"\n";
-            OutputDebugStringW(wmsg.c_str());
-        } else {
-            // 変換に失敗した場合もW系を使用（空文字列として出力）
-            OutputDebugStringW(L"[logmes: encoding error]\n");
-        }
+        // UTF-8からワイド文字列への変換（ループ内で多用されるためバッファを再利用）
+        thread_local std::wstring wmsg;
+        internal::Utf8ToWideInto(message, wmsg);
+        wmsg += L"\n";
+        OutputDebugStringW(wmsg.c_str());
     }
 
     void logmes(int value, const std::source_location& location) {
@@ -16,22 +16,320 @@ namespace hsppp {
     // ============================================================
     // ヘルパー関数
     // ============================================================
-    namespace internal {
-        // UTF-8からUTF-16への変換
-        inline std::wstring Utf8ToWide(const std::string& utf8String) {
-            if (utf8String.empty()) {
-                return L"";
-            }
-            int len = MultiByteToWideChar(CP_UTF8, 0, utf8String.c_str(), -1, nullptr, 0);
-            if (len > 0) {
-                std::wstring result(len - 1, L'\0');
-                MultiByteToWideChar(CP_UTF8, 0, utf8String.c_str(), -1, result.data(), len);
-                return result;
+    // UTF-8 ⇔ UTF-16 変換は internal::Utf8ToWide / internal::WideToUtf8（Transcode.cpp）を使用
+
+    namespace {
+        // 1回の読み込み/書き込み上限 (DWORD最大値)
+        // Windows max マクロとの衝突を避けるため括弧で囲む
+        constexpr int64_t kMaxChunkSize = static_cast<int64_t>((std::numeric_limits<DWORD>::max)());
+
+        [[noreturn]] void throwLastError(std::string_view what, const std::source_location& location) {
+            DWORD err = GetLastError();
+            std::string msg = std::string(what) + " (Windows error: " + std::to_string(err) + ")";
+            throw HspError(ERR_FILE_IO, msg, location);
+        }
+
+        // パック内のファイルは読み込み専用
+        void rejectPackWrite(std::string_view filename, const std::source_location& location) {
+            if (internal::IsPackPath(filename)) {
+                throw HspError(ERR_UNSUPPORTED,
+                    std::format("パック内のファイルには書き込めません: {}", filename), location);
+            }
+        }
+
+        // ファイルの offset バイト目から書き込む範囲
+        struct WriteChunk {
+            int64_t offset;
+            const uint8_t* data;
+            int64_t size;
+        };
+
+        // 開いたファイルの現在位置に書き込む (4GBを超える場合は分割書き込み)
+        int64_t writeAll(HANDLE hFile, const uint8_t* src, int64_t size, const std::source_location& location) {
+            int64_t totalWritten = 0;
+            int64_t remaining = size;
+
+            while (remaining > 0) {
+                DWORD chunkSize = (remaining > kMaxChunkSize)
+                    ? static_cast<DWORD>(kMaxChunkSize)
+                    : static_cast<DWORD>(remaining);
+
+                DWORD bytesWritten = 0;
+                if (!WriteFile(hFile, src, chunkSize, &bytesWritten, nullptr)) {
+                    throwLastError("ファイルの書き込みに失敗しました", location);
+                }
+
+                totalWritten += static_cast<int64_t>(bytesWritten);
+                remaining -= static_cast<int64_t>(bytesWritten);
+                src += bytesWritten;
+
+                if (bytesWritten == 0) {
+                    // 書き込みが進まない場合は中断
+                    break;
+                }
+            }
+
+            return totalWritten;
+        }
+
+        // chunks を1回のオープンで書き込む
+        // replace: ファイルを作り直す (CREATE_ALWAYS)。false の場合は既存のファイルを書き換える (OPEN_EXISTING)
+        // atomic:  同じディレクトリの一時ファイルに書き込み、MoveFileExW で置き換える。
+        //          書き込み途中で異常終了しても元のファイルは壊れない。
+        //          一時ファイル名は書き込みごとに変える（別のスレッド・プロセスの保存と衝突しないように）
+        int64_t writeChunks(const std::string& filename, bool replace, std::span<const WriteChunk> chunks,
+                            const SaveParams& params, const std::source_location& location) {
+            rejectPackWrite(filename, location);
+            static std::atomic<uint64_t> s_tempSerial = 0;
+            const std::wstring targetW = internal::Utf8ToWide(filename);
+            const std::wstring pathW = params.atomic
+                ? std::format(L"{}.{}-{}.hsppp_tmp", targetW, GetCurrentProcessId(), ++s_tempSerial)
+                : targetW;
+
+            // 部分書き換えは元の内容を写した一時ファイルに対して行う
+            if (params.atomic && !replace && !CopyFileW(targetW.c_str(), pathW.c_str(), FALSE)) {
+                throwLastError("ファイルを開けません", location);
+            }
+
+            int64_t totalWritten = 0;
+            try {
+                {
+                    internal::UniqueHandle hFile(CreateFileW(pathW.c_str(), GENERIC_WRITE, 0,
+                                               nullptr, replace ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+                    if (!hFile.is_valid()) {
+                        throwLastError("ファイルを開けません", location);
+                    }
+
+                    for (const WriteChunk& chunk : chunks) {
+                        if (!replace || chunk.offset > 0) {
+                            LARGE_INTEGER li;
+                            li.QuadPart = chunk.offset;
+                            if (!SetFilePointerEx(hFile.get(), li, nullptr, FILE_BEGIN)) {
+                                throwLastError("ファイルオフセットの設定に失敗しました", location);
+                            }
+                        }
+                        totalWritten += writeAll(hFile.get(), chunk.data, chunk.size, location);
+                    }
+
+                    if (params.flush && !FlushFileBuffers(hFile.get())) {
+                        throwLastError("ファイルのフラッシュに失敗しました", location);
+                    }
+                }
+
+                if (params.atomic) {
+                    const DWORD flags = MOVEFILE_REPLACE_EXISTING | (params.flush ? MOVEFILE_WRITE_THROUGH : 0);
+                    if (!MoveFileExW(pathW.c_str(), targetW.c_str(), flags)) {
+                        throwLastError("ファイルの置き換えに失敗しました", location);
+                    }
+                }
+            }
+            catch (...) {
+                if (params.atomic) {
+                    DeleteFileW(pathW.c_str());
+                }
+                internal::InvalidateStatCacheFor(filename);
+                throw;
+            }
+
+            internal::InvalidateStatCacheFor(filename);
+            return totalWritten;
+        }
+
+        // ============================================================
+        // pack:// の解決
+        // ============================================================
+
+        internal::PackData openPackFile(std::string_view filename, const std::source_location& location) {
+            internal::PackData data;
+            switch (internal::OpenPackData(filename, data)) {
+                case internal::PackStatus::Ok:
+                    return data;
+                case internal::PackStatus::Corrupt:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("パック内のファイルを展開できません: {}", filename), location);
+                default:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("パック内にファイルが見つかりません: {}", filename), location);
+            }
+        }
+
+        // ============================================================
+        // 非同期の書き込みの順序
+        // ============================================================
+        // 同じファイルへの非同期の書き込み（bsave_async / bcopy_async のコピー先）を投入順に1つずつ実行する
+        // 投入時に番号を受け取り、作業スレッドは自分の番になるまで待つ。作業スレッドは投入順に要求を
+        // 取り出すため、先の番号の要求は必ず実行が始まっており、待ち続けることはない
+
+        class AsyncWriteOrder {
+        public:
+            uint64_t enter(const std::string& key) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_paths[key].issued++;
+            }
+
+            void wait(const std::string& key, uint64_t ticket) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_turn.wait(lock, [&] { return m_paths[key].serving == ticket; });
+            }
+
+            void leave(const std::string& key) {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    auto it = m_paths.find(key);
+                    if (++it->second.serving == it->second.issued) {
+                        m_paths.erase(it);      // 待っている要求がなければ消す
+                    }
+                }
+                m_turn.notify_all();
+            }
+
+            // 投入済みの書き込みがすべて終わるまで待つ
+            // 投入はメインスレッドだけが行うため、待っている間に番号が増えることはない
+            void drain(const std::string& key) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_turn.wait(lock, [&] { return !m_paths.contains(key); });
+            }
+
+            bool idle() {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_paths.empty();
+            }
+
+        private:
+            struct Path {
+                uint64_t issued = 0;
+                uint64_t serving = 0;
+            };
+            std::mutex m_mutex;
+            std::condition_variable m_turn;
+            std::unordered_map<std::string, Path> m_paths;
+        };
+
+        AsyncWriteOrder& asyncWriteOrder() {
+            static AsyncWriteOrder s_order;
+            return s_order;
+        }
+
+        // filename への投入済みの非同期の書き込みが終わるまで待つ。同期の読み書きの前に呼ぶ
+        void waitAsyncWrites(const std::string& filename) {
+            if (!asyncWriteOrder().idle()) {
+                asyncWriteOrder().drain(internal::NormalizeWatchPath(filename));
+            }
+        }
+
+        // ============================================================
+        // SaveParams::deferred による書き込みのまとめ
+        // ============================================================
+        // 同じファイルへの保存を記録し、await / vwait / stop / bflush で1回のオープンにまとめて書き出す。
+        // 同じファイルを読み込む・削除する命令の前にはそのファイルの分だけ先に書き出す。
+        // メインスレッドからのみ使用する（作業スレッドの bsave_impl は使わない）
+
+        struct DeferredSave {
+            std::string filename;                   // 書き込みに使う名前（最初に保存したときの表記）
+            std::string key;                        // 照合に使う正規化したパス（NormalizeWatchPath）
+            bool replace = false;                   // image でファイルを作り直す
+            std::vector<uint8_t> image;             // replace の場合の内容
+            std::vector<std::pair<int64_t, std::vector<uint8_t>>> patches;  // 既存のファイルへの部分書き換え
+            SaveParams params;                      // atomic / flush はいずれかの保存で指定されていれば有効
+        };
+
+        std::vector<DeferredSave> g_deferredSaves;
+
+        void deferSave(const std::string& filename, const uint8_t* data, int64_t size, int64_t fileOffset,
+                       const SaveParams& params) {
+            // "a.dat" と "./a.dat" のように表記の違う同じファイルは1つにまとめる
+            std::string key = internal::NormalizeWatchPath(filename);
+            auto it = std::find_if(g_deferredSaves.begin(), g_deferredSaves.end(),
+                                   [&](const DeferredSave& save) { return save.key == key; });
+            if (it == g_deferredSaves.end()) {
+                DeferredSave& added = g_deferredSaves.emplace_back();
+                added.filename = filename;
+                added.key = std::move(key);
+                it = std::prev(g_deferredSaves.end());
+            }
+            DeferredSave& save = *it;
+            save.params.atomic |= params.atomic;
+            save.params.flush |= params.flush;
+
+            if (fileOffset < 0) {
+                // 作り直す場合はそれまでの保存をすべて置き換える
+                save.replace = true;
+                save.image.assign(data, data + size);
+                save.patches.clear();
+            }
+            else if (save.replace) {
+                // 作り直す内容に重ねる（末尾より先は 0 で埋める）
+                const size_t end = static_cast<size_t>(fileOffset + size);
+                if (save.image.size() < end) {
+                    save.image.resize(end);
+                }
+                std::copy(data, data + size, save.image.begin() + static_cast<std::ptrdiff_t>(fileOffset));
+            }
+            else {
+                save.patches.emplace_back(fileOffset, std::vector<uint8_t>(data, data + size));
+            }
+        }
+
+        void writeDeferred(const DeferredSave& save, const std::source_location& location) {
+            std::vector<WriteChunk> chunks;
+            if (save.replace) {
+                chunks.push_back({ 0, save.image.data(), static_cast<int64_t>(save.image.size()) });
+            }
+            else {
+                for (const auto& [offset, bytes] : save.patches) {
+                    chunks.push_back({ offset, bytes.data(), static_cast<int64_t>(bytes.size()) });
+                }
+            }
+            // 先に投入した非同期の書き込みを追い越さない
+            waitAsyncWrites(save.filename);
+            writeChunks(save.filename, save.replace, chunks, save.params, location);
+        }
+
+        // filename への遅延中の書き込みだけを書き出す（非同期の要求の投入時。先の非同期の書き込みは待たない）
+        void writeDeferredSave(const std::string& filename, const std::source_location& location) {
+            if (g_deferredSaves.empty()) {
+                return;
             }
-            return L"";
+            const std::string key = internal::NormalizeWatchPath(filename);
+            auto it = std::find_if(g_deferredSaves.begin(), g_deferredSaves.end(),
+                                   [&](const DeferredSave& save) { return save.key == key; });
+            if (it != g_deferredSaves.end()) {
+                DeferredSave save = std::move(*it);
+                g_deferredSaves.erase(it);
+                writeDeferred(save, location);
+            }
+        }
+
+        // filename への遅延中の書き込みを書き出し、投入済みの非同期の書き込みも終わるまで待つ
+        // 同期の読み書きの前に呼ぶ
+        void flushDeferredSave(const std::string& filename, const std::source_location& location) {
+            writeDeferredSave(filename, location);
+            waitAsyncWrites(filename);
         }
 
-        // UTF-16からUTF-8への変換（WideToUtf8は hsppp_system.inl で定義済み）
+        // すべて書き出す。失敗したファイルがあっても残りは書き出し、最初のエラーを送出する
+        void flushDeferredSaves(const std::source_location& location) {
+            if (g_deferredSaves.empty()) {
+                return;
+            }
+            std::vector<DeferredSave> saves;
+            saves.swap(g_deferredSaves);
+
+            std::exception_ptr firstError;
+            for (const DeferredSave& save : saves) {
+                try {
+                    writeDeferred(save, location);
+                }
+                catch (...) {
+                    if (!firstError) {
+                        firstError = std::current_exception();
+                    }
+                }
+            }
+            if (firstError) {
+                std::rethrow_exception(firstError);
+            }
+        }
     }
 
     // ============================================================
@@ -123,6 +421,7 @@ namespace hsppp {
                     throw HspError(ERR_FILE_IO, "ファイルが見つからないか無効な名前です", location);
                 }
             }
+            internal::InvalidateStatCacheFor(dirname);
         });
     }
 
@@ -133,8 +432,12 @@ namespace hsppp {
 
     void deletefile(const std::string& filename, const std::source_location& location) {
         safe_call(location, [&] {
+            flushDeferredSave(filename, location);
+            rejectPackWrite(filename, location);
             std::wstring filenameW = internal::Utf8ToWide(filename);
-            if (!DeleteFileW(filenameW.c_str())) {
+            const BOOL deleted = DeleteFileW(filenameW.c_str());
+            internal::InvalidateStatCacheFor(filename);
+            if (!deleted) {
                 DWORD err = GetLastError();
                 std::string msg = "ファイルの削除に失敗しました (Windows error: " + std::to_string(err) + ")";
                 throw HspError(ERR_FILE_IO, msg, location);
@@ -145,17 +448,73 @@ namespace hsppp {
     // ============================================================
     // bcopy - ファイルのコピー（HSP互換）
     // ============================================================
+    // コピーは internal::CopyFileFast（FileCopy.cpp）で行う。bcopy_async は作業スレッドから bcopy_impl を呼ぶ
+
+    namespace {
+        // コピーの進捗（コピー済み・全体のバイト数）を受け取り、false を返すと中止する
+        using CopyProgressFunc = std::function<bool(uint64_t, uint64_t)>;
+
+        void checkCopyParams(const CopyParams& params, const std::source_location& location) {
+            if (params.chunk_size < 65536 || params.chunk_size > (1 << 30)) {
+                throw HspError(ERR_OUT_OF_RANGE,
+                    std::format("chunk_size は 65536〜1073741824 を指定してください: {}", params.chunk_size), location);
+            }
+        }
+
+        // 作業スレッド（bcopy_async）からも呼ばれるため、遅延書き込みの状態には触れない
+        int64_t bcopy_impl(const std::string& src, const std::string& dest, const CopyParams& params,
+                           const CopyProgressFunc& progress, const std::source_location& location) {
+            rejectPackWrite(dest, location);
+            if (internal::IsPackPath(src)) {
+                // パックから取り出す（メモリ上にあるため1回で書き込む）
+                const internal::PackData data = openPackFile(src, location);
+                const WriteChunk chunk{ 0, data.bytes.data(), static_cast<int64_t>(data.bytes.size()) };
+                writeChunks(dest, true, std::span<const WriteChunk>(&chunk, 1), SaveParams{ .flush = params.flush }, location);
+                if (progress) {
+                    progress(data.bytes.size(), data.bytes.size());
+                }
+                return static_cast<int64_t>(data.bytes.size());
+            }
+
+            internal::FileCopyOptions options;
+            options.chunkSize = static_cast<uint64_t>(params.chunk_size);
+            options.clone = params.clone;
+            options.native = params.native;
+            options.flush = params.flush;
+            const internal::FileCopyResult result = internal::CopyFileFast(src, dest, options, progress);
+            internal::InvalidateStatCacheFor(dest);
+
+            const char* what = "ファイルのコピーに失敗しました";
+            switch (result.status) {
+                case internal::FileCopyStatus::Ok:
+                    return static_cast<int64_t>(result.bytes);
+                case internal::FileCopyStatus::Canceled:
+                    throw HspError(ERR_FILE_IO, std::format("コピーを中止しました: {}", dest), location);
+                case internal::FileCopyStatus::OpenSourceFailed:
+                    what = "コピー元のファイルを開けません";
+                    break;
+                case internal::FileCopyStatus::OpenDestFailed:
+                    what = "コピー先のファイルを作成できません";
+                    break;
+                default:
+                    break;
+            }
+            throw HspError(ERR_FILE_IO, std::format("{} (Windows error: {})", what, result.systemError), location);
+        }
+    }
 
     // 注意: bcopy() は既存ファイルを警告なしに上書きします（HSP互換動作）。
     void bcopy(const std::string& src, const std::string& dest, const std::source_location& location) {
+        bcopy(src, dest, CopyParams{}, location);
+    }
+
+    void bcopy(const std::string& src, const std::string& dest, const CopyParams& params,
+               const std::source_location& location) {
         safe_call(location, [&] {
-            std::wstring srcW = internal::Utf8ToWide(src);
-            std::wstring destW = internal::Utf8ToWide(dest);
-            if (!CopyFileW(srcW.c_str(), destW.c_str(), FALSE)) {
-                DWORD err = GetLastError();
-                std::string msg = "ファイルのコピーに失敗しました (Windows error: " + std::to_string(err) + ")";
-                throw HspError(ERR_FILE_IO, msg, location);
-            }
+            checkCopyParams(params, location);
+            flushDeferredSave(src, location);
+            flushDeferredSave(dest, location);
+            bcopy_impl(src, dest, params, nullptr, location);
         });
     }
 
@@ -163,21 +522,102 @@ namespace hsppp {
     // exist - ファイルのサイズ取得（HSP互換）
     // ============================================================
 
+    // 取得は internal::StatPath / StatPaths（FileStat.cpp）で行う。
+    // pattern を指定しない filewatch の下のパスは、監視の通知で消すキャッシュから返す
+
+    namespace {
+        FileStat toFileStat(const internal::FileStatInfo& info) noexcept {
+            return FileStat{ info.size, info.mtimeMs, info.directory };
+        }
+
+        // pack:// の情報（時刻は持たない）。見つからない場合は size = -1
+        internal::FileStatInfo statPackEntry(const std::string& filename) {
+            internal::FileStatInfo info;
+            uint64_t size = 0;
+            if (internal::FindPackEntry(filename, size) == internal::PackStatus::Ok) {
+                info.size = static_cast<int64_t>(size);
+            }
+            return info;
+        }
+    }
+
     int64_t exist(const std::string& filename, const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
-            std::wstring filenameW = internal::Utf8ToWide(filename);
-            WIN32_FILE_ATTRIBUTE_DATA fileInfo;
-            
-            if (GetFileAttributesExW(filenameW.c_str(), GetFileExInfoStandard, &fileInfo)) {
-                // ファイルサイズを取得
-                LARGE_INTEGER fileSize;
-                fileSize.LowPart = fileInfo.nFileSizeLow;
-                fileSize.HighPart = fileInfo.nFileSizeHigh;
-                return static_cast<int64_t>(fileSize.QuadPart);
+            flushDeferredSave(filename, location);
+            if (internal::IsPackPath(filename)) {
+                return statPackEntry(filename).size;
             }
-            else {
-                // ファイルが存在しない
-                return -1;
+            if (!internal::StatCacheActive()) {
+                return internal::StatPath(filename).size;
+            }
+            const std::string key = internal::NormalizeWatchPath(filename);
+            internal::FileStatInfo info;
+            if (!internal::LookupStatCache(key, info)) {
+                const uint64_t generation = internal::StatCacheGeneration();
+                info = internal::StatPath(filename);
+                internal::StoreStatCache(key, info, generation);
+            }
+            return info.size;
+        });
+    }
+
+    std::vector<FileStat> exist_many(std::span<const std::string> filenames, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::vector<FileStat> {
+            std::vector<FileStat> result;
+            exist_many(filenames, result, location);
+            return result;
+        });
+    }
+
+    void exist_many(std::span<const std::string> filenames, std::vector<FileStat>& result,
+                    const std::source_location& location) {
+        safe_call(location, [&] {
+            result.assign(filenames.size(), FileStat{});
+            const bool cached = internal::StatCacheActive();
+            const uint64_t generation = internal::StatCacheGeneration();
+
+            // パック・キャッシュで決まらないものだけをまとめて取得する
+            std::vector<size_t> pending;
+            std::vector<std::string> keys;      // cached の場合の pending ごとの正規化したパス
+            pending.reserve(filenames.size());
+            for (size_t i = 0; i < filenames.size(); ++i) {
+                const std::string& filename = filenames[i];
+                flushDeferredSave(filename, location);
+                if (internal::IsPackPath(filename)) {
+                    result[i] = toFileStat(statPackEntry(filename));
+                    continue;
+                }
+                if (cached) {
+                    std::string key = internal::NormalizeWatchPath(filename);
+                    internal::FileStatInfo info;
+                    if (internal::LookupStatCache(key, info)) {
+                        result[i] = toFileStat(info);
+                        continue;
+                    }
+                    keys.push_back(std::move(key));
+                }
+                pending.push_back(i);
+            }
+            if (pending.empty()) {
+                return;
+            }
+
+            std::vector<internal::FileStatInfo> infos(pending.size());
+            if (pending.size() == filenames.size()) {
+                internal::StatPaths(filenames, infos);
+            } else {
+                std::vector<std::string> paths;
+                paths.reserve(pending.size());
+                for (size_t index : pending) {
+                    paths.push_back(filenames[index]);
+                }
+                internal::StatPaths(paths, infos);
+            }
+            for (size_t p = 0; p < pending.size(); ++p) {
+                result[pending[p]] = toFileStat(infos[p]);
+                if (cached) {
+                    internal::StoreStatCache(keys[p], infos[p], generation);
+                }
             }
         });
     }
@@ -213,41 +653,13 @@ namespace hsppp {
                     continue;
                 }
 
-                bool isDir = (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
-                bool isHidden = (findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) != 0;
-                bool isSystem = (findData.dwFileAttributes & FILE_ATTRIBUTE_SYSTEM) != 0;
-                bool isHiddenOrSystem = isHidden || isSystem;
-
-            // モードに応じてフィルタリング
-            bool include = false;
-            switch (dirMode) {
-                case 0:  // すべてのファイル
-                    include = true;
-                    break;
-                case 1:  // ディレクトリを除く
-                    include = !isDir;
-                    break;
-                case 2:  // 隠し・システム属性を除く
-                    include = !isHiddenOrSystem;
-                    break;
-                case 3:  // ディレクトリ・隠し・システム属性を除く
-                    include = !isDir && !isHiddenOrSystem;
-                    break;
-                case 5:  // ディレクトリのみ
-                    include = isDir;
-                    break;
-                case 6:  // 隠し・システム属性のみ
-                    include = isHiddenOrSystem;
-                    break;
-                case 7:  // ディレクトリと隠し・システム属性のみ
-                    include = isDir || isHiddenOrSystem;
-                    break;
-                default:
-                    include = true;
-                    break;
-            }
+                uint32_t flags = 0;
+                if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) flags |= internal::kDirEntryDirectory;
+                if (findData.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN) flags |= internal::kDirEntryHidden;
+                if (findData.dwFileAttributes & FILE_ATTRIBUTE_SYSTEM) flags |= internal::kDirEntrySystem;
 
-            if (include) {
+            // モードに応じてフィルタリング（dirwalk と共通）
+            if (internal::DirModeAccepts(dirMode, flags)) {
                 result.push_back(internal::WideToUtf8(findData.cFileName));
             }
         } while (FindNextFileW(hFind, &findData));
@@ -257,20 +669,142 @@ namespace hsppp {
         });
     }
 
+    // ============================================================
+    // dirwalk - ディレクトリ以下の並列走査
+    // ============================================================
+    // 走査は internal::WalkDirectory の作業スレッドで行い、callback は呼び出し元のスレッドで呼ぶ
+
+    namespace {
+        internal::DirWalkOptions toWalkOptions(const DirWalkParams& params, const std::source_location& location) {
+            if (params.threads < 0 || params.queue_capacity < 0) {
+                throw HspError(ERR_OUT_OF_RANGE, "threads と queue_capacity は 0 以上を指定してください", location);
+            }
+            internal::DirWalkOptions options;
+            options.mode = params.mode;
+            options.pattern = params.pattern;
+            options.recursive = params.recursive;
+            options.threads = static_cast<size_t>(params.threads);
+            options.queueCapacity = static_cast<size_t>(params.queue_capacity);
+            return options;
+        }
+
+        void walkOrThrow(const std::string& root, const DirWalkParams& params,
+                         const std::function<bool(std::span<internal::DirWalkEntry>)>& consume,
+                         const std::source_location& location) {
+            uint32_t systemError = 0;
+            if (internal::WalkDirectory(root, toWalkOptions(params, location), consume, systemError) ==
+                internal::DirWalkStatus::OpenFailed) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("ディレクトリを開けません: {} (Windows error: {})", root, systemError), location);
+            }
+        }
+
+        DirEntry toDirEntry(internal::DirWalkEntry&& entry) {
+            DirEntry result;
+            result.path = std::move(entry.path);
+            result.size = static_cast<int64_t>(entry.size);
+            result.mtime = entry.mtimeMs;
+            result.directory = (entry.flags & internal::kDirEntryDirectory) != 0;
+            result.hidden = (entry.flags & (internal::kDirEntryHidden | internal::kDirEntrySystem)) != 0;
+            return result;
+        }
+    }
+
+    int64_t dirwalk(const std::string& root, const DirWalkCallback& callback, const DirWalkParams& params,
+                    const std::source_location& location) {
+        return safe_call(location, [&]() -> int64_t {
+            int64_t delivered = 0;
+            walkOrThrow(root, params, [&](std::span<internal::DirWalkEntry> batch) {
+                for (internal::DirWalkEntry& entry : batch) {
+                    ++delivered;
+                    if (!callback(toDirEntry(std::move(entry)))) {
+                        return false;
+                    }
+                }
+                return true;
+            }, location);
+            return delivered;
+        });
+    }
+
+    std::vector<DirEntry> dirwalk(const std::string& root, const DirWalkParams& params,
+                                  const std::source_location& location) {
+        return safe_call(location, [&]() -> std::vector<DirEntry> {
+            std::vector<DirEntry> result;
+            // 結果はすべて保持するため、作業スレッドを待たせない
+            DirWalkParams unbounded = params;
+            unbounded.queue_capacity = INT_MAX;
+            walkOrThrow(root, unbounded, [&](std::span<internal::DirWalkEntry> batch) {
+                for (internal::DirWalkEntry& entry : batch) {
+                    result.push_back(toDirEntry(std::move(entry)));
+                }
+                return true;
+            }, location);
+            std::sort(result.begin(), result.end(), [](const DirEntry& a, const DirEntry& b) { return a.path < b.path; });
+            return result;
+        });
+    }
+
     // ============================================================
     // bload - バッファにファイルをロード（HSP互換）
     // ============================================================
 
     namespace {
-        // 1回の読み込み/書き込み上限 (DWORD最大値)
-        // Windows max マクロとの衝突を避けるため括弧で囲む
-        constexpr int64_t kMaxChunkSize = static_cast<int64_t>((std::numeric_limits<DWORD>::max)());
         // 自動バッファ確保の上限 (2GB) - メモリ不足を防止
         constexpr int64_t kMaxAutoAllocSize = 2LL * 1024 * 1024 * 1024;
 
+        // 読み込むバイト数を決め、必要ならバッファを広げる
+        // size 省略時はバッファの大きさ（空の場合はファイルの残り全体を確保）
+        template<typename BufferType>
+        int64_t prepareLoad(BufferType& buffer, OptInt64 size, int64_t fileRemaining, const std::source_location& location) {
+            int64_t readSize = size.value_or(-1);
+            if (readSize < 0) {
+                // 自動サイズ（バッファサイズまたはファイル残りサイズ）
+                readSize = static_cast<int64_t>(buffer.size());
+                if (readSize == 0) {
+                    readSize = fileRemaining;
+                    // 自動確保の上限チェック
+                    if (readSize > kMaxAutoAllocSize) {
+                        throw HspError(ERR_FILE_IO, "ファイルが大きすぎます (自動確保上限: 2GB)", location);
+                    }
+                    buffer.resize(static_cast<size_t>(readSize));
+                } else {
+                    // バッファサイズがファイル残りを超える場合は残りサイズに制限
+                    if (readSize > fileRemaining) {
+                        readSize = fileRemaining;
+                    }
+                }
+            }
+            else {
+                if (static_cast<size_t>(readSize) > buffer.size()) {
+                    buffer.resize(static_cast<size_t>(readSize));
+                }
+            }
+            return readSize;
+        }
+
+        template<typename BufferType>
+        int64_t bload_pack(const std::string& filename, BufferType& buffer, OptInt64 size, OptInt64 offset,
+                           const std::source_location& location) {
+            const internal::PackData data = openPackFile(filename, location);
+            const int64_t fileSize = static_cast<int64_t>(data.bytes.size());
+            const int64_t fileOffset = (std::min)((std::max)(offset.value_or(0), int64_t{ 0 }), fileSize);
+            const int64_t readSize = prepareLoad(buffer, size, fileSize - fileOffset, location);
+
+            // ファイルと同じく、残りより多く要求された場合は残りだけを読む
+            const int64_t copySize = (std::min)(readSize, fileSize - fileOffset);
+            if (copySize > 0) {
+                std::memcpy(buffer.data(), data.bytes.data() + fileOffset, static_cast<size_t>(copySize));
+            }
+            return copySize;
+        }
+
         template<typename BufferType>
         int64_t bload_impl(const std::string& filename, BufferType& buffer, OptInt64 size, OptInt64 offset,
                       const std::source_location& location) {
+            if (internal::IsPackPath(filename)) {
+                return bload_pack(filename, buffer, size, offset, location);
+            }
             std::wstring filenameW = internal::Utf8ToWide(filename);
             
             internal::UniqueHandle hFile(CreateFileW(filenameW.c_str(), GENERIC_READ, FILE_SHARE_READ,
@@ -309,29 +843,7 @@ namespace hsppp {
             if (fileRemaining < 0) fileRemaining = 0;
 
             // 読み込みサイズを決定
-            int64_t readSize = size.value_or(-1);
-            if (readSize < 0) {
-                // 自動サイズ（バッファサイズまたはファイル残りサイズ）
-                readSize = static_cast<int64_t>(buffer.size());
-                if (readSize == 0) {
-                    readSize = fileRemaining;
-                    // 自動確保の上限チェック
-                    if (readSize > kMaxAutoAllocSize) {
-                        throw HspError(ERR_FILE_IO, "ファイルが大きすぎます (自動確保上限: 2GB)", location);
-                    }
-                    buffer.resize(static_cast<size_t>(readSize));
-                } else {
-                    // バッファサイズがファイル残りを超える場合は残りサイズに制限
-                    if (readSize > fileRemaining) {
-                        readSize = fileRemaining;
-                    }
-                }
-            }
-            else {
-                if (static_cast<size_t>(readSize) > buffer.size()) {
-                    buffer.resize(static_cast<size_t>(readSize));
-                }
-            }
+            const int64_t readSize = prepareLoad(buffer, size, fileRemaining, location);
 
             // 読み込み (4GBを超える場合は分割読み込み)
             int64_t totalRead = 0;
@@ -367,6 +879,7 @@ namespace hsppp {
     int64_t bload(const std::string& filename, std::string& buffer, OptInt64 size, OptInt64 offset,
               const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
+            flushDeferredSave(filename, location);
             return bload_impl(filename, buffer, size, offset, location);
         });
     }
@@ -374,6 +887,7 @@ namespace hsppp {
     int64_t bload(const std::string& filename, std::vector<uint8_t>& buffer, OptInt64 size, OptInt64 offset,
               const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
+            flushDeferredSave(filename, location);
             return bload_impl(filename, buffer, size, offset, location);
         });
     }
@@ -383,93 +897,1456 @@ namespace hsppp {
     // ============================================================
 
     namespace {
+        template<typename BufferType>
+        int64_t saveSize(const BufferType& buffer, OptInt64 size) {
+            const int64_t writeSize = size.value_or(-1);
+            return writeSize < 0 ? static_cast<int64_t>(buffer.size())
+                                 : (std::min)(writeSize, static_cast<int64_t>(buffer.size()));
+        }
+
+        // offset 省略時はファイルを作り直し、指定時は既存のファイルの offset バイト目から書き換える
+        // 作業スレッド（bsave_async）からも呼ばれるため、遅延書き込みの状態には触れない
         template<typename BufferType>
         int64_t bsave_impl(const std::string& filename, const BufferType& buffer, OptInt64 size, OptInt64 offset,
-                       const std::source_location& location) {
-            std::wstring filenameW = internal::Utf8ToWide(filename);
-            
-            int64_t fileOffset = offset.value_or(-1);
-            
-            DWORD createMode = CREATE_ALWAYS;
-            if (fileOffset >= 0) {
-                // オフセット指定時はファイルが存在する必要がある
-                createMode = OPEN_EXISTING;
-            }
+                       const std::source_location& location, const SaveParams& params = {}) {
+            const int64_t fileOffset = offset.value_or(-1);
+            const WriteChunk chunk{ (std::max)(fileOffset, int64_t{ 0 }),
+                                    reinterpret_cast<const uint8_t*>(buffer.data()), saveSize(buffer, size) };
+            return writeChunks(filename, fileOffset < 0, std::span<const WriteChunk>(&chunk, 1), params, location);
+        }
 
-            internal::UniqueHandle hFile(CreateFileW(filenameW.c_str(), GENERIC_WRITE, 0,
-                                       nullptr, createMode, FILE_ATTRIBUTE_NORMAL, nullptr));
-            
-            if (!hFile.is_valid()) {
-                DWORD err = GetLastError();
-                std::string msg = "ファイルを開けません (Windows error: " + std::to_string(err) + ")";
-                throw HspError(ERR_FILE_IO, msg, location);
+        // メインスレッドからの bsave
+        template<typename BufferType>
+        int64_t bsave_main(const std::string& filename, const BufferType& buffer, OptInt64 size, OptInt64 offset,
+                           const SaveParams& params, const std::source_location& location) {
+            if (params.deferred) {
+                rejectPackWrite(filename, location);
+                const int64_t writeSize = saveSize(buffer, size);
+                deferSave(filename, reinterpret_cast<const uint8_t*>(buffer.data()), writeSize, offset.value_or(-1), params);
+                return writeSize;
             }
+            // 先に遅らせた保存があれば、順序を保つため先に書き出す
+            flushDeferredSave(filename, location);
+            return bsave_impl(filename, buffer, size, offset, location, params);
+        }
+    }
 
-            // オフセット位置に移動
-            if (fileOffset > 0) {
-                LARGE_INTEGER li;
-                li.QuadPart = fileOffset;
-                if (!SetFilePointerEx(hFile.get(), li, nullptr, FILE_BEGIN)) {
-                    DWORD err = GetLastError();
-                    std::string msg = "ファイルオフセットの設定に失敗しました (Windows error: " + std::to_string(err) + ")";
-                    throw HspError(ERR_FILE_IO, msg, location);
+    int64_t bsave(const std::string& filename, const std::string& buffer, OptInt64 size, OptInt64 offset,
+               const std::source_location& location) {
+        return safe_call(location, [&]() -> int64_t {
+            return bsave_main(filename, buffer, size, offset, SaveParams{}, location);
+        });
+    }
+
+    int64_t bsave(const std::string& filename, const std::vector<uint8_t>& buffer, OptInt64 size, OptInt64 offset,
+               const std::source_location& location) {
+        return safe_call(location, [&]() -> int64_t {
+            return bsave_main(filename, buffer, size, offset, SaveParams{}, location);
+        });
+    }
+
+    int64_t bsave(const std::string& filename, const std::string& buffer, OptInt64 size, OptInt64 offset,
+               const SaveParams& params, const std::source_location& location) {
+        return safe_call(location, [&]() -> int64_t {
+            return bsave_main(filename, buffer, size, offset, params, location);
+        });
+    }
+
+    int64_t bsave(const std::string& filename, const std::vector<uint8_t>& buffer, OptInt64 size, OptInt64 offset,
+               const SaveParams& params, const std::source_location& location) {
+        return safe_call(location, [&]() -> int64_t {
+            return bsave_main(filename, buffer, size, offset, params, location);
+        });
+    }
+
+    void bflush(const std::source_location& location) {
+        safe_call(location, [&] {
+            flushDeferredSaves(location);
+        });
+    }
+
+    // ============================================================
+    // peek / poke - バッファの読み書き（HSP互換）
+    // ============================================================
+    // 複数バイトの値は HSP と同じくリトルエンディアン。BufferReader / BufferWriter はモジュールのインライン関数
+
+    void detail::throw_buffer_range(size_t position, size_t count, size_t size, const std::source_location& location) {
+        throw HspError(ERR_BUFFER_OVERFLOW,
+            std::format("バッファの範囲外です（位置 {} から {} バイト、大きさ {} バイト）", position, count, size), location);
+    }
+
+    void detail::throw_varint_overflow(size_t position, const std::source_location& location) {
+        throw HspError(ERR_OUT_OF_RANGE,
+            std::format("可変長整数が 64 ビットに収まりません（位置 {}）", position), location);
+    }
+
+    namespace {
+        // buffer の index から count バイトの位置（範囲外は ERR_BUFFER_OVERFLOW）
+        template<typename Buffer>
+        auto* bytesAt(Buffer& buffer, int64_t index, size_t count, const std::source_location& location) {
+            if (index < 0 || static_cast<uint64_t>(index) > buffer.size() || count > buffer.size() - static_cast<size_t>(index)) {
+                throw HspError(ERR_BUFFER_OVERFLOW,
+                    std::format("バッファの範囲外です（位置 {} から {} バイト、大きさ {} バイト）", index, count, buffer.size()),
+                    location);
+            }
+            return reinterpret_cast<std::conditional_t<std::is_const_v<Buffer>, const uint8_t*, uint8_t*>>(buffer.data())
+                   + index;
+        }
+
+        template<typename Buffer>
+        uint32_t peekLittle(const Buffer& buffer, int64_t index, size_t count, const std::source_location& location) {
+            return safe_call(location, [&]() -> uint32_t {
+                const uint8_t* p = bytesAt(buffer, index, count, location);
+                uint32_t value = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    value |= static_cast<uint32_t>(p[i]) << (8 * i);
+                }
+                return value;
+            });
+        }
+
+        template<typename Buffer>
+        void pokeLittle(Buffer& buffer, int64_t index, size_t count, int value, const std::source_location& location) {
+            safe_call(location, [&] {
+                uint8_t* p = bytesAt(buffer, index, count, location);
+                for (size_t i = 0; i < count; ++i) {
+                    p[i] = static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * i));
                 }
+            });
+        }
+
+        template<typename Buffer>
+        void pokeText(Buffer& buffer, int64_t index, std::string_view text, const std::source_location& location) {
+            safe_call(location, [&] {
+                uint8_t* p = bytesAt(buffer, index, text.size(), location);
+                std::copy(text.begin(), text.end(), p);
+            });
+        }
+    }
+
+    int peek(const std::vector<uint8_t>& buffer, int64_t index, const std::source_location& location) {
+        return static_cast<int>(peekLittle(buffer, index, 1, location));
+    }
+
+    int peek(const std::string& buffer, int64_t index, const std::source_location& location) {
+        return static_cast<int>(peekLittle(buffer, index, 1, location));
+    }
+
+    int wpeek(const std::vector<uint8_t>& buffer, int64_t index, const std::source_location& location) {
+        return static_cast<int>(peekLittle(buffer, index, 2, location));
+    }
+
+    int wpeek(const std::string& buffer, int64_t index, const std::source_location& location) {
+        return static_cast<int>(peekLittle(buffer, index, 2, location));
+    }
+
+    int lpeek(const std::vector<uint8_t>& buffer, int64_t index, const std::source_location& location) {
+        return static_cast<int>(peekLittle(buffer, index, 4, location));
+    }
+
+    int lpeek(const std::string& buffer, int64_t index, const std::source_location& location) {
+        return static_cast<int>(peekLittle(buffer, index, 4, location));
+    }
+
+    void poke(std::vector<uint8_t>& buffer, int64_t index, int value, const std::source_location& location) {
+        pokeLittle(buffer, index, 1, value, location);
+    }
+
+    void poke(std::string& buffer, int64_t index, int value, const std::source_location& location) {
+        pokeLittle(buffer, index, 1, value, location);
+    }
+
+    void poke(std::vector<uint8_t>& buffer, int64_t index, std::string_view text, const std::source_location& location) {
+        pokeText(buffer, index, text, location);
+    }
+
+    void poke(std::string& buffer, int64_t index, std::string_view text, const std::source_location& location) {
+        pokeText(buffer, index, text, location);
+    }
+
+    void wpoke(std::vector<uint8_t>& buffer, int64_t index, int value, const std::source_location& location) {
+        pokeLittle(buffer, index, 2, value, location);
+    }
+
+    void wpoke(std::string& buffer, int64_t index, int value, const std::source_location& location) {
+        pokeLittle(buffer, index, 2, value, location);
+    }
+
+    void lpoke(std::vector<uint8_t>& buffer, int64_t index, int value, const std::source_location& location) {
+        pokeLittle(buffer, index, 4, value, location);
+    }
+
+    void lpoke(std::string& buffer, int64_t index, int value, const std::source_location& location) {
+        pokeLittle(buffer, index, 4, value, location);
+    }
+
+    // ============================================================
+    // bmap - ファイルを読み取り専用でメモリマップ
+    // ============================================================
+    // ビューの先頭は割り当て粒度に揃える必要があるため、offset を切り下げた位置からマップし、
+    // data() はその中の要求した位置を指す（internal::MapFileRegion）
+
+    MappedFile MappedFile::open(const std::string& filename, OptInt64 offset, OptInt64 size,
+                                const std::source_location& location) {
+        return safe_call(location, [&]() -> MappedFile {
+            flushDeferredSave(filename, location);
+            const int64_t fileOffset = (std::max)(offset.value_or(0), int64_t{ 0 });
+            const int64_t mapSize = size.value_or(-1);
+
+            if (internal::IsPackPath(filename)) {
+                // 圧縮していないファイルはパックのマップをそのまま参照する（圧縮している場合は展開したバッファ）
+                internal::PackData data = openPackFile(filename, location);
+                MappedFile result;
+                result.m_fileSize = static_cast<int64_t>(data.bytes.size());
+                result.m_offset = (std::min)(fileOffset, result.m_fileSize);
+                const int64_t remaining = result.m_fileSize - result.m_offset;
+                const int64_t length = (mapSize < 0) ? remaining : (std::min)(mapSize, remaining);
+                if (length > 0) {
+                    result.m_data = data.bytes.subspan(static_cast<size_t>(result.m_offset), static_cast<size_t>(length));
+                    result.m_mapping = std::const_pointer_cast<void>(std::move(data.owner));
+                }
+                return result;
             }
 
-            // 書き込みサイズを決定
-            int64_t writeSize = size.value_or(-1);
-            if (writeSize < 0) {
-                writeSize = static_cast<int64_t>(buffer.size());
+            internal::FileRegion region;
+            uint32_t systemError = 0;
+            switch (internal::MapFileRegion(filename, static_cast<uint64_t>(fileOffset), mapSize, region, systemError)) {
+                case internal::MapStatus::Ok:
+                    break;
+                case internal::MapStatus::OpenFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルを開けません: {} (Windows error: {})", filename, systemError), location);
+                case internal::MapStatus::SizeFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルサイズの取得に失敗しました: {} (Windows error: {})", filename, systemError), location);
+                case internal::MapStatus::TooLarge:
+                    throw HspError(ERR_OUT_OF_MEMORY,
+                        std::format("マップする範囲が大きすぎます: {}", filename), location);
+                case internal::MapStatus::MapFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルのマップに失敗しました: {} (Windows error: {})", filename, systemError), location);
             }
-            else {
-                writeSize = (std::min)(writeSize, static_cast<int64_t>(buffer.size()));
+
+            MappedFile result;
+            result.m_fileSize = static_cast<int64_t>(region.fileSize);
+            result.m_offset = (std::min)(fileOffset, result.m_fileSize);
+            if (region.base) {
+                result.m_mapping = std::shared_ptr<void>(region.base, [length = region.mappedLength](void* p) {
+                    internal::UnmapFileRegion(p, length);
+                });
+                result.m_data = std::span<const uint8_t>(region.data, region.size);
             }
+            return result;
+        });
+    }
 
-            // 書き込み (4GBを超える場合は分割書き込み)
-            int64_t totalWritten = 0;
-            const uint8_t* src = reinterpret_cast<const uint8_t*>(buffer.data());
-            int64_t remaining = writeSize;
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        *this = std::move(other);
+    }
 
-            while (remaining > 0) {
-                DWORD chunkSize = (remaining > kMaxChunkSize)
-                    ? static_cast<DWORD>(kMaxChunkSize)
-                    : static_cast<DWORD>(remaining);
+    // ムーブ元にビューへの参照が残らないようにする
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            m_mapping = std::move(other.m_mapping);
+            m_data = std::exchange(other.m_data, {});
+            m_offset = std::exchange(other.m_offset, 0);
+            m_fileSize = std::exchange(other.m_fileSize, 0);
+        }
+        return *this;
+    }
 
-                DWORD bytesWritten = 0;
-                if (!WriteFile(hFile.get(), src, chunkSize, &bytesWritten, nullptr)) {
-                    DWORD err = GetLastError();
-                    std::string msg = "ファイルの書き込みに失敗しました (Windows error: " + std::to_string(err) + ")";
-                    throw HspError(ERR_FILE_IO, msg, location);
+    void MappedFile::close() noexcept {
+        *this = MappedFile();
+    }
+
+    MappedFile bmap(const std::string& filename, OptInt64 offset, OptInt64 size,
+                    const std::source_location& location) {
+        return MappedFile::open(filename, offset, size, location);
+    }
+
+    // ============================================================
+    // bload_async / bsave_async / bcopy_async - 非同期ファイル操作
+    // ============================================================
+    // 読み書きは internal::SharedIoQueue() の作業スレッドで bload_impl / bsave_impl / bcopy_impl を実行する。
+    // 完了通知・進捗のコールバックは internal::postInterruptCallback でメインスレッドに配送する
+
+    class FileRequest::State {
+    public:
+        enum class Kind { Load, Save, Copy };
+
+        std::string filename;           // 対象のファイル（コピーはコピー先）
+        std::string source;             // コピー元
+        std::vector<uint8_t> buffer;    // 読み込み先 / 保存する内容
+        OptInt64 size;
+        OptInt64 offset;
+        CopyParams copyParams;
+        Kind kind = Kind::Load;
+        FileCallback callback;
+        FileCallback progressCallback;  // 作業スレッドが実行の開始時に取り出す
+        std::source_location location;
+        std::chrono::steady_clock::time_point submittedAt;
+
+        // 以下は status が fileio_pending でなくなった後にだけ読む
+        int64_t bytes = 0;
+        int errorCode = 0;
+        std::string errorMessage;
+        double latencyMs = 0.0;
+
+        std::atomic<int> status = fileio_pending;
+        std::atomic<int64_t> processed = 0;
+        std::atomic<int64_t> total = 0;
+        std::atomic<bool> canceled = false;
+        std::atomic<bool> progressPosted = false;   // 配送待ちの進捗通知がある
+        std::mutex mutex;
+        std::condition_variable finished;
+
+        // 書き込む要求の、同じファイルへの書き込みの中での順番（AsyncWriteOrder）
+        std::string writeKey;           // 正規化したパス（Load は空）
+        uint64_t writeTicket = 0;
+
+        // 作業スレッドのキューに投入する
+        static void submit(const std::shared_ptr<State>& state) {
+            state->submittedAt = std::chrono::steady_clock::now();
+            if (state->kind != Kind::Load) {
+                state->writeKey = internal::NormalizeWatchPath(state->filename);
+                state->writeTicket = asyncWriteOrder().enter(state->writeKey);
+            }
+            internal::SharedIoQueue().submit([state] { state->run(state); });
+        }
+
+        // 作業スレッドで実行する
+        void run(const std::shared_ptr<State>& self) {
+            int result = fileio_done;
+            if (!writeKey.empty()) {
+                asyncWriteOrder().wait(writeKey, writeTicket);
+            }
+            try {
+                if (canceled.load(std::memory_order_relaxed)) {
+                    throw HspError(ERR_FILE_IO, std::format("要求は中止されました: {}", filename), location);
+                }
+                switch (kind) {
+                    case Kind::Save:
+                        bytes = bsave_impl(filename, buffer, size, offset, location);
+                        std::vector<uint8_t>().swap(buffer);    // 保存した内容はすぐに解放する
+                        break;
+                    case Kind::Load:
+                        bytes = bload_impl(filename, buffer, size, offset, location);
+                        buffer.resize(static_cast<size_t>(bytes));
+                        break;
+                    case Kind::Copy:
+                        bytes = runCopy(self);
+                        break;
                 }
+                processed.store(bytes, std::memory_order_relaxed);
+                total.store(bytes, std::memory_order_relaxed);
+            }
+            catch (const HspErrorBase& e) {
+                errorCode = e.error_code();
+                errorMessage = e.message();
+                result = fileio_error;
+            }
+            catch (const std::exception& e) {
+                errorCode = ERR_FILE_IO;
+                errorMessage = e.what();
+                result = fileio_error;
+            }
+            if (result == fileio_error) {
+                bytes = 0;
+                std::vector<uint8_t>().swap(buffer);
+            }
+            if (!writeKey.empty()) {
+                asyncWriteOrder().leave(writeKey);
+            }
+            latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - submittedAt).count();
+
+            // コールバックは完了を公開する前に配送キューへ投入する
+            // （wait() から戻った後に await などで配送を処理すれば、必ずコールバックが呼ばれている）
+            // 取り出して投入するため、コールバックが要求を保持していても循環しない
+            FileCallback done = std::move(callback);
+            callback = nullptr;
+            if (done) {
+                FileRequest request;
+                request.m_state = self;
+                internal::postInterruptCallback([done = std::move(done), request]() mutable {
+                    done(request);
+                });
+            }
 
-                totalWritten += static_cast<int64_t>(bytesWritten);
-                remaining -= static_cast<int64_t>(bytesWritten);
-                src += bytesWritten;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                status.store(result, std::memory_order_release);
+            }
+            finished.notify_all();
+        }
 
-                if (bytesWritten == 0) {
-                    // 書き込みが進まない場合は中断
+        // 進捗はコピーしているスレッドで記録し、通知は配送待ちがない場合だけ投入する
+        // （メインスレッドが処理するまでの進捗は、処理時に最新の値を読むことでまとめる）
+        int64_t runCopy(const std::shared_ptr<State>& self) {
+            auto onProgress = std::make_shared<FileCallback>(std::move(progressCallback));
+            progressCallback = nullptr;
+            return bcopy_impl(source, filename, copyParams, [&](uint64_t copied, uint64_t all) {
+                processed.store(static_cast<int64_t>(copied), std::memory_order_relaxed);
+                total.store(static_cast<int64_t>(all), std::memory_order_relaxed);
+                if (*onProgress && !progressPosted.exchange(true)) {
+                    internal::postInterruptCallback([self, onProgress] {
+                        self->progressPosted.store(false);
+                        FileRequest request;
+                        request.m_state = self;
+                        (*onProgress)(request);
+                    });
+                }
+                return !canceled.load(std::memory_order_relaxed);
+            }, location);
+        }
+
+        // 完了するか timeout が経過するまで待つ
+        void waitFor(std::chrono::milliseconds timeout) {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait_for(lock, timeout, [this] { return status.load(std::memory_order_acquire) != fileio_pending; });
+        }
+    };
+
+    FileRequest FileRequest::load(const std::string& filename, OptInt64 size, OptInt64 offset,
+                                  FileCallback callback, const std::source_location& location) {
+        return safe_call(location, [&]() -> FileRequest {
+            writeDeferredSave(filename, location);
+            auto state = std::make_shared<State>();
+            state->filename = filename;
+            state->size = size;
+            state->offset = offset;
+            state->callback = std::move(callback);
+            state->location = location;
+
+            FileRequest request;
+            request.m_state = state;
+            State::submit(state);
+            return request;
+        });
+    }
+
+    FileRequest FileRequest::save(const std::string& filename, std::vector<uint8_t> buffer, OptInt64 size, OptInt64 offset,
+                                  FileCallback callback, const std::source_location& location) {
+        return safe_call(location, [&]() -> FileRequest {
+            writeDeferredSave(filename, location);
+            auto state = std::make_shared<State>();
+            state->filename = filename;
+            state->buffer = std::move(buffer);
+            state->size = size;
+            state->offset = offset;
+            state->kind = State::Kind::Save;
+            state->callback = std::move(callback);
+            state->location = location;
+
+            FileRequest request;
+            request.m_state = state;
+            State::submit(state);
+            return request;
+        });
+    }
+
+    FileRequest FileRequest::copy(const std::string& src, const std::string& dest, FileCallback callback,
+                                  FileCallback progress, const CopyParams& params, const std::source_location& location) {
+        return safe_call(location, [&]() -> FileRequest {
+            checkCopyParams(params, location);
+            writeDeferredSave(src, location);
+            writeDeferredSave(dest, location);
+            auto state = std::make_shared<State>();
+            state->filename = dest;
+            state->source = src;
+            state->copyParams = params;
+            state->kind = State::Kind::Copy;
+            state->callback = std::move(callback);
+            state->progressCallback = std::move(progress);
+            state->location = location;
+
+            FileRequest request;
+            request.m_state = state;
+            State::submit(state);
+            return request;
+        });
+    }
+
+    int FileRequest::stat() const noexcept {
+        return m_state ? m_state->status.load(std::memory_order_acquire) : fileio_none;
+    }
+
+    bool FileRequest::ready() const noexcept {
+        const int status = stat();
+        return status == fileio_done || status == fileio_error;
+    }
+
+    // stop と同様にメッセージを処理しながら待つ
+    // 終了要求（WM_QUIT）を受けた後も、保存を途中で終わらせないため完了までは待つ
+    int64_t FileRequest::wait(const std::source_location& location) {
+        return safe_call(location, [&]() -> int64_t {
+            if (!m_state) {
+                return 0;
+            }
+
+            MSG msg;
+            while (!ready()) {
+                processPendingInterrupt();
+
+                if (!g_shouldQuit && PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
+                    if (msg.message == WM_QUIT) {
+                        g_shouldQuit = true;
+                        continue;
+                    }
+                    TranslateMessage(&msg);
+                    DispatchMessage(&msg);
+                }
+                else {
+                    m_state->waitFor(std::chrono::milliseconds(1));
+                }
+            }
+
+            if (stat() == fileio_error) {
+                throw HspError(m_state->errorCode, m_state->errorMessage, location);
+            }
+            return m_state->bytes;
+        });
+    }
+
+    int64_t FileRequest::size() const noexcept {
+        return ready() ? m_state->bytes : 0;
+    }
+
+    std::span<const uint8_t> FileRequest::data() const noexcept {
+        return ready() ? std::span<const uint8_t>(m_state->buffer) : std::span<const uint8_t>();
+    }
+
+    std::string_view FileRequest::view() const noexcept {
+        const std::span<const uint8_t> bytes = data();
+        return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+    }
+
+    std::vector<uint8_t> FileRequest::take() noexcept {
+        return ready() ? std::move(m_state->buffer) : std::vector<uint8_t>();
+    }
+
+    int FileRequest::error_code() const noexcept {
+        return ready() ? m_state->errorCode : 0;
+    }
+
+    std::string FileRequest::error_message() const {
+        return ready() ? m_state->errorMessage : std::string();
+    }
+
+    std::string FileRequest::filename() const {
+        return m_state ? m_state->filename : std::string();
+    }
+
+    double FileRequest::latency_ms() const noexcept {
+        return ready() ? m_state->latencyMs : 0.0;
+    }
+
+    int64_t FileRequest::processed() const noexcept {
+        return m_state ? m_state->processed.load(std::memory_order_relaxed) : 0;
+    }
+
+    int64_t FileRequest::total() const noexcept {
+        return m_state ? m_state->total.load(std::memory_order_relaxed) : 0;
+    }
+
+    void FileRequest::cancel() noexcept {
+        if (m_state) {
+            m_state->canceled.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    FileRequest bload_async(const std::string& filename, OptInt64 size, OptInt64 offset,
+                            FileCallback callback, const std::source_location& location) {
+        return FileRequest::load(filename, size, offset, std::move(callback), location);
+    }
+
+    FileRequest bsave_async(const std::string& filename, std::vector<uint8_t> buffer, OptInt64 size, OptInt64 offset,
+                            FileCallback callback, const std::source_location& location) {
+        return FileRequest::save(filename, std::move(buffer), size, offset, std::move(callback), location);
+    }
+
+    FileRequest bsave_async(const std::string& filename, std::string_view buffer, OptInt64 size, OptInt64 offset,
+                            FileCallback callback, const std::source_location& location) {
+        return FileRequest::save(filename, std::vector<uint8_t>(buffer.begin(), buffer.end()), size, offset,
+                                 std::move(callback), location);
+    }
+
+    FileRequest bcopy_async(const std::string& src, const std::string& dest, FileCallback callback,
+                            FileCallback progress, const CopyParams& params, const std::source_location& location) {
+        return FileRequest::copy(src, dest, std::move(callback), std::move(progress), params, location);
+    }
+
+    FileIoStats fileio_stats() {
+        const internal::IoWorkQueue& queue = internal::SharedIoQueue();
+        const internal::IoQueueStats stats = queue.stats();
+        const double started = static_cast<double>((std::max)(stats.started, uint64_t{ 1 }));
+        const double completed = static_cast<double>((std::max)(stats.completed, uint64_t{ 1 }));
+
+        FileIoStats result;
+        result.submitted = static_cast<int64_t>(stats.submitted);
+        result.completed = static_cast<int64_t>(stats.completed);
+        result.pending = static_cast<int>(stats.pending);
+        result.peak_pending = static_cast<int>(stats.peakPending);
+        result.threads = static_cast<int>(queue.threadCount());
+        result.average_wait_ms = static_cast<double>(stats.totalWaitNs) / started / 1e6;
+        result.max_wait_ms = static_cast<double>(stats.maxWaitNs) / 1e6;
+        result.average_latency_ms = static_cast<double>(stats.totalLatencyNs) / completed / 1e6;
+        result.max_latency_ms = static_cast<double>(stats.maxLatencyNs) / 1e6;
+        return result;
+    }
+
+    void fileio_reset_stats() {
+        internal::SharedIoQueue().resetStats();
+    }
+
+    // ============================================================
+    // パックファイル
+    // ============================================================
+    // packopen で登録したパックの中のファイルは "pack://名前" で読み込める
+    // 圧縮していないファイルはパックのマップ上を直接参照する（internal::PackArchive）
+
+    namespace {
+        // 圧縮の強さ（PackParams::level / CompressParams::level）
+        void checkCompressLevel(int level, const std::source_location& location) {
+            if (level < internal::kLz4MinLevel || level > internal::kLz4MaxLevel) {
+                throw HspError(ERR_OUT_OF_RANGE,
+                    std::format("level は {}〜{} を指定してください: {}", internal::kLz4MinLevel, internal::kLz4MaxLevel, level),
+                    location);
+            }
+        }
+    }
+
+    int packbuild(const std::string& archive, const std::string& directory, const PackParams& params,
+                  const std::source_location& location) {
+        return safe_call(location, [&]() -> int {
+            if (params.alignment < 1 || params.alignment > static_cast<int>(internal::kPackMaxAlignment) ||
+                !std::has_single_bit(static_cast<uint32_t>(params.alignment))) {
+                throw HspError(ERR_OUT_OF_RANGE,
+                    std::format("alignment は 1〜{} の2の累乗を指定してください: {}", internal::kPackMaxAlignment, params.alignment),
+                    location);
+            }
+            checkCompressLevel(params.level, location);
+            rejectPackWrite(archive, location);
+            flushDeferredSaves(location);
+
+            namespace fs = std::filesystem;
+            const fs::path root(internal::Utf8ToWide(directory));
+            std::error_code ec;
+            if (!fs::is_directory(root, ec)) {
+                throw HspError(ERR_FILE_IO, std::format("ディレクトリが見つかりません: {}", directory), location);
+            }
+            // 出力先がディレクトリの中にある場合は、前回作ったパック自身を含めない
+            const fs::path archivePath(internal::Utf8ToWide(archive));
+
+            // 書き出し終わるまで各ファイルのマップを保持する
+            std::vector<std::shared_ptr<void>> mappings;
+            std::vector<internal::PackInput> inputs;
+            for (fs::recursive_directory_iterator it(root, ec), end; it != end; it.increment(ec)) {
+                if (ec) {
                     break;
                 }
+                std::error_code ignored;
+                if (!it->is_regular_file(ignored) || fs::equivalent(it->path(), archivePath, ignored)) {
+                    continue;
+                }
+                const std::u8string relative = it->path().lexically_relative(root).generic_u8string();
+                const std::string name(relative.begin(), relative.end());
+                const std::string path = internal::WideToUtf8(it->path().wstring());
+
+                internal::FileRegion region;
+                uint32_t systemError = 0;
+                if (internal::MapFileRegion(path, 0, -1, region, systemError) != internal::MapStatus::Ok) {
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルを開けません: {} (Windows error: {})", path, systemError), location);
+                }
+                if (region.base) {
+                    mappings.emplace_back(region.base, [length = region.mappedLength](void* p) {
+                        internal::UnmapFileRegion(p, length);
+                    });
+                }
+                inputs.push_back({ name, std::span<const uint8_t>(region.data, region.size), params.compress ? params.level : 0 });
+            }
+            if (ec) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("ディレクトリの列挙に失敗しました: {} ({})", directory, ec.message()), location);
             }
 
-            return totalWritten;
+            internal::PackImage image;
+            std::string duplicate;
+            if (!internal::BuildPack(inputs, static_cast<uint32_t>(params.alignment), image, duplicate)) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("パック内の名前が重複しています（大文字・小文字は区別しません）: {}", duplicate), location);
+            }
+
+            std::vector<WriteChunk> chunks;
+            chunks.reserve(image.chunks.size() + 1);
+            chunks.push_back({ 0, image.head.data(), static_cast<int64_t>(image.head.size()) });
+            for (const internal::PackImage::Chunk& chunk : image.chunks) {
+                if (!chunk.data.empty()) {
+                    chunks.push_back({ static_cast<int64_t>(chunk.offset), chunk.data.data(), static_cast<int64_t>(chunk.data.size()) });
+                }
+            }
+            flushDeferredSave(archive, location);
+            writeChunks(archive, true, chunks, SaveParams{ .atomic = true }, location);
+            return static_cast<int>(inputs.size());
+        });
+    }
+
+    void packopen(const std::string& archive, const std::source_location& location) {
+        safe_call(location, [&] {
+            flushDeferredSave(archive, location);
+            uint32_t systemError = 0;
+            switch (internal::MountPack(archive, systemError)) {
+                case internal::PackStatus::Ok:
+                    return;
+                case internal::PackStatus::OpenFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("パックファイルを開けません: {} (Windows error: {})", archive, systemError), location);
+                case internal::PackStatus::MapFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("パックファイルのマップに失敗しました: {} (Windows error: {})", archive, systemError), location);
+                default:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("パックファイルの形式が正しくありません: {}", archive), location);
+            }
+        });
+    }
+
+    void packclose(const std::string& archive, const std::source_location& location) {
+        safe_call(location, [&] {
+            if (archive.empty()) {
+                internal::UnmountAllPacks();
+                return;
+            }
+            if (!internal::UnmountPack(archive)) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("登録されていないパックファイルです: {}", archive), location);
+            }
+        });
+    }
+
+    // ============================================================
+    // filewatch - ディレクトリの変更監視
+    // ============================================================
+    // 監視は internal::FileWatcher のスレッドで行い、まとめた変更を internal::postInterruptCallback でメインスレッドに配送する。
+    // 素材の読み直しは、画像のデコードと WAV の読み込みを internal::SharedIoQueue() の作業スレッドで行い、
+    // cel の差し替えだけをメインスレッドで行う
+
+    static_assert(filechange_added == static_cast<int>(internal::FileChangeKind::Added));
+    static_assert(filechange_modified == static_cast<int>(internal::FileChangeKind::Modified));
+    static_assert(filechange_removed == static_cast<int>(internal::FileChangeKind::Removed));
+    static_assert(filechange_overflow == static_cast<int>(internal::FileChangeKind::Overflow));
+
+    namespace internal {
+        // MediaManager への外部関数宣言（MediaManager.cpp で定義）
+        // 戻り値: 読み直したスロットの数
+        int MediaManager_reloadFiles(std::span<const std::string> normalizedPaths, std::string_view underDirectory);
+    }
+
+    class FileWatch::State {
+    public:
+        std::string directory;
+        std::string normalizedDirectory;    // NormalizeWatchPath の形
+        FileWatchCallback callback;
+        bool reload = true;
+        std::unique_ptr<internal::FileWatcher> watcher;     // close で破棄する
+        uint64_t statCacheRoot = 0;     // exist のキャッシュに登録した番号（0 は登録していない）
+
+        ~State() {
+            stop();
         }
+
+        // 監視を止め、exist のキャッシュからこのディレクトリの情報を消す
+        void stop() noexcept {
+            watcher.reset();
+            if (statCacheRoot != 0) {
+                internal::RemoveStatCacheRoot(std::exchange(statCacheRoot, 0));
+            }
+        }
+
+        // 以下はメインスレッドでだけ使う
+        int64_t changeCount = 0;
+        int64_t reloadCount = 0;
+        // 同じファイルの読み直しが前後して終わった場合に古い内容で上書きしないよう、要求ごとに番号を振る
+        uint64_t reloadSerial = 0;
+        std::unordered_map<std::string, uint64_t> latestReload;     // cel のファイル名 -> 最後に要求した番号
+
+        // 監視スレッドから配送された変更を処理する
+        void deliver(const std::shared_ptr<State>& self, std::vector<internal::FileChangeEvent>&& events) {
+            if (!watcher) {
+                return;     // close の後に届いた変更は捨てる
+            }
+            std::vector<FileChange> changes;
+            changes.reserve(events.size());
+            for (internal::FileChangeEvent& event : events) {
+                changes.push_back({ std::move(event.path), static_cast<int>(event.kind) });
+            }
+            changeCount += static_cast<int64_t>(changes.size());
+
+            if (reload) {
+                reloadAssets(self, changes);
+            }
+            if (callback) {
+                callback(changes);
+            }
+        }
+
+    private:
+        void reloadAssets(const std::shared_ptr<State>& self, const std::vector<FileChange>& changes) {
+            // 変更されたファイル（取りこぼした場合は監視するディレクトリの下すべて）
+            std::vector<std::string> targets;
+            bool everything = false;
+            for (const FileChange& change : changes) {
+                if (change.action == filechange_overflow) {
+                    everything = true;
+                } else if (change.action != filechange_removed) {
+                    targets.push_back(internal::NormalizeWatchPath(directory + "/" + change.path));
+                }
+            }
+            if (!everything && targets.empty()) {
+                return;
+            }
+            std::sort(targets.begin(), targets.end());
+            const std::string underDirectory = everything ? normalizedDirectory : std::string();
+            auto isTarget = [&](const std::string& filename) {
+                const std::string normalized = internal::NormalizeWatchPath(filename);
+                return everything ? internal::IsWatchPathUnder(normalized, underDirectory)
+                                  : std::binary_search(targets.begin(), targets.end(), normalized);
+            };
+
+            // cel: 同じファイルから読み込んだものは1回だけデコードする
+            std::map<std::string, std::vector<int>> cels;   // 読み込んだときのファイル名 -> cel ID
+            for (const auto& [id, cel] : internal::g_celDataMap) {
+                if (!cel.filename.empty() && !internal::IsPackPath(cel.filename) && isTarget(cel.filename)) {
+                    cels[cel.filename].push_back(id);
+                }
+            }
+
+            std::weak_ptr<State> weak = self;
+            for (auto& [file, celIds] : cels) {
+                const uint64_t serial = ++reloadSerial;
+                latestReload[file] = serial;
+                internal::SharedIoQueue().submit([weak, filename = file, ids = std::move(celIds), serial] {
+                    try {
+                        std::vector<uint32_t> pixels;
+                        int width = 0, height = 0;
+                        if (!internal::decodeImageFile(filename, pixels, width, height)) {
+                            return;     // 書き込み途中などで読めない場合は次の変更を待つ
+                        }
+                        internal::postInterruptCallback(
+                            [weak, filename, ids, serial, pixels = std::move(pixels), width, height] {
+                                if (auto state = weak.lock()) {
+                                    state->applyCel(filename, ids, serial, pixels, width, height);
+                                }
+                            });
+                    } catch (...) {
+                    }
+                });
+            }
+
+            // mmload: 読み込みと差し替えは MediaManager がロックして行う
+            internal::SharedIoQueue().submit([weak, targets = std::move(targets), underDirectory] {
+                try {
+                    const int reloaded = internal::MediaManager_reloadFiles(targets, underDirectory);
+                    if (reloaded > 0) {
+                        internal::postInterruptCallback([weak, reloaded] {
+                            if (auto state = weak.lock()) {
+                                state->reloadCount += reloaded;
+                            }
+                        });
+                    }
+                } catch (...) {
+                }
+            });
+        }
+
+        // デコードした画素で cel を差し替える（メインスレッド）
+        void applyCel(const std::string& filename, const std::vector<int>& ids, uint64_t serial,
+                      const std::vector<uint32_t>& pixels, int width, int height) {
+            auto latest = latestReload.find(filename);
+            if (latest == latestReload.end() || latest->second != serial) {
+                return;     // 後から要求した読み直しを待つ
+            }
+            latestReload.erase(latest);
+
+            auto bitmap = internal::createBitmapFromPixels(pixels, width, height);
+            if (!bitmap) {
+                return;
+            }
+            for (int id : ids) {
+                auto it = internal::g_celDataMap.find(id);
+                // 読み直している間に別の画像を読み込んだ cel はそのままにする
+                if (it == internal::g_celDataMap.end() || it->second.filename != filename) {
+                    continue;
+                }
+                internal::CelData& cel = it->second;
+                cel.pBitmap = bitmap;
+                cel.width = width;
+                cel.height = height;
+                if (cel.maskWordsPerRow != 0) {
+                    cel.maskWordsPerRow = internal::MaskWordsPerRow(width);
+                    cel.maskBits.assign(cel.maskWordsPerRow * static_cast<size_t>(height), 0);
+                    internal::BuildMask(pixels.data(), static_cast<size_t>(width), width, height,
+                                        cel.maskAlphaThreshold, cel.maskColorKey, cel.maskBits.data());
+                }
+                ++reloadCount;
+            }
+        }
+    };
+
+    FileWatch FileWatch::open(const std::string& directory, FileWatchCallback callback, const WatchParams& params,
+                              const std::source_location& location) {
+        return safe_call(location, [&]() -> FileWatch {
+            if (params.debounce_ms < 0) {
+                throw HspError(ERR_OUT_OF_RANGE, "debounce_ms は 0 以上を指定してください", location);
+            }
+            if (internal::IsPackPath(directory)) {
+                throw HspError(ERR_UNSUPPORTED, "パックファイルの中は監視できません", location);
+            }
+
+            auto state = std::make_shared<State>();
+            state->directory = directory;
+            state->normalizedDirectory = internal::NormalizeWatchPath(directory);
+            state->callback = std::move(callback);
+            state->reload = params.reload;
+
+            internal::FileWatcherOptions options;
+            options.recursive = params.recursive;
+            options.pattern = params.pattern;
+            options.debounceMs = static_cast<uint32_t>(params.debounce_ms);
+
+            // 指定された場合で、すべての変更が通知される（pattern を指定しない）ときだけ、exist のキャッシュの対象にする
+            const bool cacheStats = params.cache_stats && params.pattern.empty();
+
+            // 監視スレッドでは exist のキャッシュを消し、メインスレッドへ配送する（ハンドルがすべて破棄された後の変更は捨てる）
+            std::weak_ptr<State> weak = state;
+            internal::FileWatcherStatus status = internal::FileWatcherStatus::Ok;
+            uint32_t systemError = 0;
+            state->watcher = internal::FileWatcher::Open(directory, options,
+                [weak, cacheStats, root = state->normalizedDirectory](std::vector<internal::FileChangeEvent>&& events) {
+                    if (cacheStats) {
+                        for (const internal::FileChangeEvent& event : events) {
+                            if (event.kind == internal::FileChangeKind::Overflow) {
+                                internal::InvalidateStatCacheUnder(root);
+                            } else {
+                                internal::InvalidateStatCache(internal::NormalizeWatchPath(root + "/" + event.path));
+                            }
+                        }
+                    }
+                    internal::postInterruptCallback([weak, events = std::move(events)]() mutable {
+                        if (auto state = weak.lock()) {
+                            state->deliver(state, std::move(events));
+                        }
+                    });
+                }, status, systemError);
+            if (status == internal::FileWatcherStatus::Unsupported) {
+                throw HspError(ERR_UNSUPPORTED, "この環境ではファイルの変更を監視できません", location);
+            }
+            if (!state->watcher) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("ディレクトリを監視できません: {} (Windows error: {})", directory, systemError), location);
+            }
+            if (cacheStats) {
+                state->statCacheRoot = internal::AddStatCacheRoot(state->normalizedDirectory, params.recursive);
+            }
+
+            FileWatch watch;
+            watch.m_state = std::move(state);
+            return watch;
+        });
     }
 
-    int64_t bsave(const std::string& filename, const std::string& buffer, OptInt64 size, OptInt64 offset,
-               const std::source_location& location) {
+    void FileWatch::close() noexcept {
+        if (m_state) {
+            m_state->stop();
+        }
+    }
+
+    bool FileWatch::active() const noexcept {
+        return m_state && m_state->watcher && m_state->watcher->running();
+    }
+
+    std::string FileWatch::directory() const {
+        return m_state ? m_state->directory : std::string();
+    }
+
+    int64_t FileWatch::change_count() const noexcept {
+        return m_state ? m_state->changeCount : 0;
+    }
+
+    int64_t FileWatch::reload_count() const noexcept {
+        return m_state ? m_state->reloadCount : 0;
+    }
+
+    FileWatch filewatch(const std::string& directory, FileWatchCallback callback, const WatchParams& params,
+                        const std::source_location& location) {
+        return FileWatch::open(directory, std::move(callback), params, location);
+    }
+
+    // ============================================================
+    // Compressor / Decompressor - LZ4 フレーム形式の圧縮・展開
+    // ============================================================
+    // 形式の読み書きは internal::Lz4FrameWriteHeader / Lz4FrameDecoder（Lz4Frame.cpp）。
+    // 書き出すブロックは前のブロックに依存しないため、threads 個のブロックをためてから並列に圧縮し、順に書き出す
+
+    namespace {
+        // Decompressor::open でファイルから1回に読み込むバイト数
+        constexpr size_t kDecompressReadChunk = 256 * 1024;
+
+        void checkCompressParams(const CompressParams& params, const std::source_location& location) {
+            checkCompressLevel(params.level, location);
+            if (params.block_size <= 0 || !internal::Lz4FrameBlockSizeValid(static_cast<size_t>(params.block_size))) {
+                throw HspError(ERR_OUT_OF_RANGE,
+                    std::format("block_size は 65536 / 262144 / 1048576 / 4194304 のいずれかを指定してください: {}",
+                                params.block_size), location);
+            }
+            if (params.threads < 0) {
+                throw HspError(ERR_OUT_OF_RANGE, std::format("threads は 0 以上を指定してください: {}", params.threads), location);
+            }
+        }
+
+        [[noreturn]] void throwFrameError(internal::Lz4FrameStatus status, std::string_view source,
+                                          const std::source_location& location) {
+            switch (status) {
+                case internal::Lz4FrameStatus::BadMagic:
+                    throw HspError(ERR_FILE_IO, std::format("LZ4 フレーム形式ではありません: {}", source), location);
+                case internal::Lz4FrameStatus::Unsupported:
+                    throw HspError(ERR_UNSUPPORTED,
+                        std::format("対応していない LZ4 フレームです（辞書・旧形式）: {}", source), location);
+                case internal::Lz4FrameStatus::ChecksumMismatch:
+                    throw HspError(ERR_FILE_IO, std::format("圧縮データのチェックサムが一致しません: {}", source), location);
+                default:
+                    throw HspError(ERR_FILE_IO, std::format("圧縮データが壊れています: {}", source), location);
+            }
+        }
+    }
+
+    class Compressor::State {
+    public:
+        // まとめて圧縮するブロックの数の上限（ブロック 4MB でも pending と packed で 64MB に収まる）
+        static constexpr size_t kMaxBatchBlocks = 8;
+
+        std::vector<uint8_t>* output = nullptr;     // メモリに追記する場合
+        internal::UniqueHandle file;                // ファイルに書き出す場合
+        std::string filename;                       // 閉じたときに exist のキャッシュを消すため
+        size_t blockSize = 0;
+        int level = 1;
+        size_t batchBlocks = 1;                     // まとめて圧縮するブロックの数（threads）
+        bool checksum = true;
+        internal::Xxh32 hash;
+        std::vector<uint8_t> pending;               // batchBlocks 個のブロックの大きさにたまるまでのデータ
+        std::vector<std::vector<uint8_t>> packed;   // 圧縮後のブロック（batchBlocks 個）
+        std::vector<size_t> packedSizes;
+        int64_t bytesIn = 0;
+        int64_t bytesOut = 0;
+        bool open = true;
+
+        explicit State(const CompressParams& params)
+            : blockSize(static_cast<size_t>(params.block_size)), level(params.level), checksum(params.checksum) {
+            const size_t requested = (params.threads == 0) ? std::thread::hardware_concurrency()
+                                                           : static_cast<size_t>(params.threads);
+            batchBlocks = std::clamp<size_t>(requested, 1, kMaxBatchBlocks);
+            packed.resize(batchBlocks);
+            packedSizes.resize(batchBlocks);
+        }
+
+        // finish していなければ閉じる（デストラクタでは失敗を無視する）
+        ~State() {
+            if (open) {
+                try {
+                    finish(std::source_location::current());
+                } catch (...) {
+                }
+            }
+        }
+
+        // ヘッダーを書き出す
+        void begin(const std::source_location& location) {
+            internal::Lz4FrameHeader header;
+            header.blockSize = blockSize;
+            header.contentChecksum = checksum;
+            uint8_t bytes[internal::kLz4FrameMaxHeaderSize];
+            emit(bytes, internal::Lz4FrameWriteHeader(header, bytes), location);
+        }
+
+        void write(std::span<const uint8_t> data, const std::source_location& location) {
+            if (checksum) {
+                hash.update(data.data(), data.size());
+            }
+            bytesIn += static_cast<int64_t>(data.size());
+
+            const size_t batchBytes = blockSize * batchBlocks;
+            if (!pending.empty()) {
+                const size_t take = std::min(batchBytes - pending.size(), data.size());
+                pending.insert(pending.end(), data.begin(), data.begin() + take);
+                data = data.subspan(take);
+                if (pending.size() < batchBytes) {
+                    return;
+                }
+                compressBlocks(pending, location);
+                pending.clear();
+            }
+            // まとまった分は pending に写さずに圧縮する
+            const size_t direct = data.size() - data.size() % batchBytes;
+            if (direct > 0) {
+                compressBlocks(data.first(direct), location);
+            }
+            pending.insert(pending.end(), data.begin() + direct, data.end());
+        }
+
+        void finish(const std::source_location& location) {
+            open = false;
+            if (!pending.empty()) {
+                compressBlocks(pending, location);
+                pending.clear();
+            }
+            uint8_t bytes[internal::kLz4FrameMaxEndSize];
+            emit(bytes, internal::Lz4FrameWriteEnd(checksum, hash.digest(), bytes), location);
+            file.reset();
+            if (!filename.empty()) {
+                internal::InvalidateStatCacheFor(filename);
+            }
+        }
+
+    private:
+        void emit(const uint8_t* data, size_t size, const std::source_location& location) {
+            if (output) {
+                output->insert(output->end(), data, data + size);
+            }
+            else if (writeAll(file.get(), data, static_cast<int64_t>(size), location) != static_cast<int64_t>(size)) {
+                throwLastError("ファイルの書き込みに失敗しました", location);
+            }
+            bytesOut += static_cast<int64_t>(size);
+        }
+
+        // data を blockSize ごとのブロックにして書き出す（最後のブロックだけは短くてよい）
+        void compressBlocks(std::span<const uint8_t> data, const std::source_location& location) {
+            while (!data.empty()) {
+                const size_t count = std::min(batchBlocks, (data.size() + blockSize - 1) / blockSize);
+                // 作業スレッドでは確保しない
+                for (size_t b = 0; b < count; ++b) {
+                    if (packed[b].empty()) {
+                        packed[b].resize(internal::Lz4FrameBlockBound(blockSize));
+                    }
+                }
+                auto compressBlock = [&](size_t b) {
+                    const size_t offset = b * blockSize;
+                    const size_t size = std::min(blockSize, data.size() - offset);
+                    packedSizes[b] = internal::Lz4FrameWriteBlock(data.data() + offset, size, level, packed[b].data());
+                };
+                if (count > 1) {
+                    runParallelChunks(count, compressBlock);
+                }
+                else {
+                    compressBlock(0);
+                }
+                for (size_t b = 0; b < count; ++b) {
+                    emit(packed[b].data(), packedSizes[b], location);
+                }
+                data = data.subspan(std::min(data.size(), count * blockSize));
+            }
+        }
+    };
+
+    Compressor::Compressor() noexcept = default;
+    Compressor::~Compressor() = default;
+    Compressor::Compressor(Compressor&& other) noexcept = default;
+    Compressor& Compressor::operator=(Compressor&& other) noexcept = default;
+
+    Compressor::Compressor(std::vector<uint8_t>& output, const CompressParams& params, const std::source_location& location) {
+        safe_call(location, [&] {
+            checkCompressParams(params, location);
+            auto state = std::make_unique<State>(params);
+            state->output = &output;
+            state->begin(location);
+            m_state = std::move(state);
+        });
+    }
+
+    Compressor& Compressor::open(const std::string& filename, const CompressParams& params, const std::source_location& location) {
+        safe_call(location, [&] {
+            checkCompressParams(params, location);
+            rejectPackWrite(filename, location);
+            flushDeferredSave(filename, location);
+            m_state.reset();    // 前に開いていた出力先を閉じる
+
+            const std::wstring filenameW = internal::Utf8ToWide(filename);
+            internal::UniqueHandle hFile(CreateFileW(filenameW.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                                     FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+            if (!hFile.is_valid()) {
+                throwLastError("ファイルを開けません", location);
+            }
+            internal::InvalidateStatCacheFor(filename);
+            auto state = std::make_unique<State>(params);
+            state->file = std::move(hFile);
+            state->filename = filename;
+            state->begin(location);
+            m_state = std::move(state);
+        });
+        return *this;
+    }
+
+    namespace {
+        template<typename StateType>
+        StateType& requireOpen(const std::unique_ptr<StateType>& state, const std::source_location& location) {
+            if (!state || !state->open) {
+                throw HspError(ERR_INVALID_HANDLE, "Compressor は開いていません（open の前、または finish の後）", location);
+            }
+            return *state;
+        }
+    }
+
+    void Compressor::write(std::span<const uint8_t> data, const std::source_location& location) {
+        safe_call(location, [&] {
+            State& state = requireOpen(m_state, location);
+            try {
+                state.write(data, location);
+            } catch (...) {
+                state.open = false;     // 途中まで書いたフレームには続けない
+                throw;
+            }
+        });
+    }
+
+    void Compressor::write(std::string_view data, const std::source_location& location) {
+        write(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(data.data()), data.size()), location);
+    }
+
+    void Compressor::finish(const std::source_location& location) {
+        safe_call(location, [&] {
+            requireOpen(m_state, location).finish(location);
+        });
+    }
+
+    bool Compressor::is_open() const noexcept { return m_state && m_state->open; }
+    int64_t Compressor::bytes_in() const noexcept { return m_state ? m_state->bytesIn : 0; }
+    int64_t Compressor::bytes_out() const noexcept { return m_state ? m_state->bytesOut : 0; }
+
+    class Decompressor::State {
+    public:
+        // ヘッダーの大きさを信じて先に確保する上限（壊れた・細工したヘッダーで巨大な確保をしない）
+        static constexpr int64_t kMaxHeaderReserve = 64LL * 1024 * 1024;
+
+        std::string source;                         // エラーメッセージ用
+        internal::Lz4FrameDecoder decoder;
+        std::span<const uint8_t> input;             // まだ渡していない圧縮データ
+        std::span<const uint8_t> current;           // 展開して読み出していない範囲
+        internal::UniqueHandle file;                // ファイルから読む場合（終端で閉じる）
+        std::vector<uint8_t> chunk;                 // ファイルから読み込んだ圧縮データ
+        std::shared_ptr<const void> owner;          // pack:// の内容の所有者
+        bool ended = false;
+        int64_t bytesIn = 0;
+        int64_t bytesOut = 0;
+
+        // current が空なら次のブロックを展開する。終端に達していれば false
+        bool fill(const std::source_location& location) {
+            while (current.empty()) {
+                if (ended) {
+                    return false;
+                }
+                const size_t before = input.size();
+                const internal::Lz4FrameStatus status = decoder.decode(input, current);
+                bytesIn += static_cast<int64_t>(before - input.size());
+                switch (status) {
+                    case internal::Lz4FrameStatus::Block:
+                    case internal::Lz4FrameStatus::FrameEnd:
+                        break;
+                    case internal::Lz4FrameStatus::NeedInput:
+                        if (refill(location)) {
+                            break;
+                        }
+                        if (decoder.frameCount() == 0 && decoder.atFrameBoundary()) {
+                            throwFrameError(internal::Lz4FrameStatus::BadMagic, source, location);
+                        }
+                        if (!decoder.atFrameBoundary()) {
+                            throw HspError(ERR_FILE_IO, std::format("圧縮データが途中で終わっています: {}", source), location);
+                        }
+                        ended = true;
+                        return false;
+                    default:
+                        throwFrameError(status, source, location);
+                }
+            }
+            return true;
+        }
+
+        // 残りをすべて output に追記する
+        template<typename BufferType>
+        int64_t appendAll(BufferType& output, const std::source_location& location) {
+            const size_t start = output.size();
+            bool reserved = false;
+            while (fill(location)) {
+                // ヘッダーに大きさがあれば（lz4 コマンドなどで作ったフレーム）、最初に1回だけ確保する
+                // ヘッダーは検証前の値のため kMaxHeaderReserve までにとどめ、それを超える分は追記に合わせて伸ばす
+                if (!reserved && decoder.contentSize() >= 0) {
+                    output.reserve(start + static_cast<size_t>(std::min(decoder.contentSize(), kMaxHeaderReserve)));
+                    reserved = true;
+                }
+                if (static_cast<int64_t>(output.size() - start + current.size()) > kMaxAutoAllocSize) {
+                    throw HspError(ERR_FILE_IO, "展開後のデータが大きすぎます (自動確保上限: 2GB)", location);
+                }
+                output.insert(output.end(), current.begin(), current.end());
+                bytesOut += static_cast<int64_t>(current.size());
+                current = {};
+            }
+            return static_cast<int64_t>(output.size() - start);
+        }
+
+    private:
+        // ファイルから次の圧縮データを読み込む。終端なら false
+        bool refill(const std::source_location& location) {
+            if (!file.is_valid()) {
+                return false;
+            }
+            DWORD bytesRead = 0;
+            if (!ReadFile(file.get(), chunk.data(), static_cast<DWORD>(chunk.size()), &bytesRead, nullptr)) {
+                throwLastError("ファイルの読み込みに失敗しました", location);
+            }
+            // 要求より少なければファイルの終端
+            if (bytesRead < chunk.size()) {
+                file.reset();
+            }
+            input = std::span<const uint8_t>(chunk.data(), bytesRead);
+            return bytesRead > 0;
+        }
+    };
+
+    Decompressor::Decompressor() noexcept = default;
+    Decompressor::~Decompressor() = default;
+    Decompressor::Decompressor(Decompressor&& other) noexcept = default;
+    Decompressor& Decompressor::operator=(Decompressor&& other) noexcept = default;
+
+    Decompressor::Decompressor(std::span<const uint8_t> input)
+        : m_state(std::make_unique<State>()) {
+        m_state->source = "メモリ上のデータ";
+        m_state->input = input;
+    }
+
+    Decompressor& Decompressor::open(const std::string& filename, const std::source_location& location) {
+        safe_call(location, [&] {
+            auto state = std::make_unique<State>();
+            state->source = filename;
+            if (internal::IsPackPath(filename)) {
+                // パック内のファイルは全体がメモリ上にあるため、そのまま参照する
+                internal::PackData data = openPackFile(filename, location);
+                state->input = data.bytes;
+                state->owner = std::move(data.owner);
+            }
+            else {
+                flushDeferredSave(filename, location);
+                const std::wstring filenameW = internal::Utf8ToWide(filename);
+                state->file.reset(CreateFileW(filenameW.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr));
+                if (!state->file.is_valid()) {
+                    throw HspError(ERR_FILE_IO, std::format("ファイルが見つかりません: {}", filename), location);
+                }
+                state->chunk.resize(kDecompressReadChunk);
+            }
+            m_state = std::move(state);
+        });
+        return *this;
+    }
+
+    size_t Decompressor::read(std::span<uint8_t> dest, const std::source_location& location) {
+        return safe_call(location, [&]() -> size_t {
+            if (!m_state) {
+                return 0;
+            }
+            State& state = *m_state;
+            size_t total = 0;
+            while (total < dest.size() && state.fill(location)) {
+                const size_t n = std::min(state.current.size(), dest.size() - total);
+                std::memcpy(dest.data() + total, state.current.data(), n);
+                state.current = state.current.subspan(n);
+                total += n;
+            }
+            state.bytesOut += static_cast<int64_t>(total);
+            return total;
+        });
+    }
+
+    bool Decompressor::next(std::span<const uint8_t>& data, const std::source_location& location) {
+        return safe_call(location, [&]() -> bool {
+            data = {};
+            if (!m_state || !m_state->fill(location)) {
+                return false;
+            }
+            data = m_state->current;
+            m_state->current = {};
+            m_state->bytesOut += static_cast<int64_t>(data.size());
+            return true;
+        });
+    }
+
+    int64_t Decompressor::read_all(std::vector<uint8_t>& output, const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
-            return bsave_impl(filename, buffer, size, offset, location);
+            return m_state ? m_state->appendAll(output, location) : 0;
         });
     }
 
-    int64_t bsave(const std::string& filename, const std::vector<uint8_t>& buffer, OptInt64 size, OptInt64 offset,
-               const std::source_location& location) {
+    int64_t Decompressor::read_all(std::string& output, const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
-            return bsave_impl(filename, buffer, size, offset, location);
+            return m_state ? m_state->appendAll(output, location) : 0;
         });
     }
 
+    bool Decompressor::eof() const noexcept {
+        if (!m_state) {
+            return true;
+        }
+        const State& state = *m_state;
+        return state.ended || (state.current.empty() && state.input.empty() && !state.file.is_valid() &&
+                               state.decoder.atFrameBoundary() && state.decoder.frameCount() > 0);
+    }
+
+    int64_t Decompressor::bytes_in() const noexcept { return m_state ? m_state->bytesIn : 0; }
+    int64_t Decompressor::bytes_out() const noexcept { return m_state ? m_state->bytesOut : 0; }
+
+    std::vector<uint8_t> compress(std::span<const uint8_t> data, const CompressParams& params,
+                                  const std::source_location& location) {
+        std::vector<uint8_t> output;
+        Compressor writer(output, params, location);
+        writer.write(data, location);
+        writer.finish(location);
+        return output;
+    }
+
+    std::vector<uint8_t> decompress(std::span<const uint8_t> data, const std::source_location& location) {
+        std::vector<uint8_t> output;
+        Decompressor(data).read_all(output, location);
+        return output;
+    }
+
+    int64_t bsave_compressed(const std::string& filename, const std::vector<uint8_t>& buffer, const CompressParams& params,
+                             const SaveParams& save, const std::source_location& location) {
+        const std::vector<uint8_t> packed = compress(buffer, params, location);
+        return safe_call(location, [&]() -> int64_t {
+            return bsave_main(filename, packed, {}, {}, save, location);
+        });
+    }
+
+    int64_t bsave_compressed(const std::string& filename, std::string_view buffer, const CompressParams& params,
+                             const SaveParams& save, const std::source_location& location) {
+        const std::vector<uint8_t> packed = compress(
+            std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size()), params, location);
+        return safe_call(location, [&]() -> int64_t {
+            return bsave_main(filename, packed, {}, {}, save, location);
+        });
+    }
+
+    int64_t bload_compressed(const std::string& filename, std::vector<uint8_t>& buffer, const std::source_location& location) {
+        Decompressor reader;
+        reader.open(filename, location);
+        buffer.clear();
+        return reader.read_all(buffer, location);
+    }
+
+    int64_t bload_compressed(const std::string& filename, std::string& buffer, const std::source_location& location) {
+        Decompressor reader;
+        reader.open(filename, location);
+        buffer.clear();
+        return reader.read_all(buffer, location);
+    }
+
     // ============================================================
     // dialog - ダイアログを開く（HSP互換）
     // ============================================================
@@ -31,6 +31,8 @@ void picload(std::string_view p1, OptInt p2, const std::source_location& locatio
             throw HspError(ERR_FILE_IO, "picload: no active surface", location);
         }
         
+        flushDeferredSave(std::string(p1), location);
+        
         if (!pSurface->picload(p1, mode)) {
             throw HspError(ERR_FILE_IO, "picload: failed to load image", location);
         }
@@ -55,9 +57,12 @@ void bmpsave(std::string_view p1, const std::source_location& location) {
 
 // ============================================================
 // celload読み込みヘルパー（celloadとloadCelで共有）
+// caller はエラーメッセージの先頭に付ける名前
+// pixels を指定すると、デコードした画素も返す（マスクを作る loadCel 用）
 // ============================================================
 namespace {
-    int loadCelDataInternal(std::string_view filename, hsppp::OptInt celId, const std::source_location& location) {
+    int loadCelDataInternal(std::string_view filename, hsppp::OptInt celId, const std::source_location& location,
+                            std::string_view caller = "cel loading", std::vector<uint32_t>* pixels = nullptr) {
         int id = celId.value_or(-1);
         
         // 自動割り当てモード
@@ -65,11 +70,12 @@ namespace {
             id = internal::g_nextCelId++;
         }
         
-        // 画像読み込み
+        // 画像読み込み（遅らせた bsave で書いている途中の画像なら先に書き出す）
+        flushDeferredSave(std::string(filename), location);
         int width = 0, height = 0;
-        auto bitmap = internal::loadImageFile(filename, width, height);
+        auto bitmap = internal::loadImageFile(filename, width, height, pixels);
         if (!bitmap) {
-            throw HspError(ERR_FILE_IO, "cel loading: failed to load image", location);
+            throw HspError(ERR_FILE_IO, std::format("{}: failed to load image", caller), location);
         }
         
         // CelDataを作成
@@ -56,9 +56,42 @@ namespace {
     PendingInterruptType g_pendingType = PendingInterruptType::None;
     int g_pendingMessageId = 0;  // oncmd用
 
+    // 他のスレッドから投入されたコールバック（bload_async 等の完了通知）
+    std::mutex g_postedMutex;
+    std::vector<std::function<void()>> g_postedCallbacks;
+    std::atomic<bool> g_hasPostedCallbacks = false;
+
+    // 投入されたコールバックを投入順に呼ぶ。1つ以上呼んだ場合は true
+    // コールバックが例外を送出した場合、残りは次回に回す
+    bool processPostedCallbacks() {
+        if (!g_hasPostedCallbacks.load(std::memory_order_acquire)) return false;
+
+        std::vector<std::function<void()>> callbacks;
+        {
+            std::lock_guard<std::mutex> lock(g_postedMutex);
+            callbacks.swap(g_postedCallbacks);
+            g_hasPostedCallbacks.store(false, std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < callbacks.size(); ++i) {
+            try {
+                callbacks[i]();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(g_postedMutex);
+                g_postedCallbacks.insert(g_postedCallbacks.begin(),
+                    std::make_move_iterator(callbacks.begin() + static_cast<std::ptrdiff_t>(i) + 1),
+                    std::make_move_iterator(callbacks.end()));
+                g_hasPostedCallbacks.store(!g_postedCallbacks.empty(), std::memory_order_release);
+                throw;
+            }
+        }
+        return !callbacks.empty();
+    }
+
     // 割り込みを処理する内部関数
     bool processPendingInterrupt() {
-        if (!g_interruptPending) return false;
+        const bool posted = processPostedCallbacks();
+        if (!g_interruptPending) return posted;
 
         g_interruptPending = false;
         InterruptHandlerInfo* handlerInfo = nullptr;
@@ -88,7 +121,7 @@ namespace {
         g_pendingType = PendingInterruptType::None;
 
         if (!handlerInfo || !handlerInfo->enabled || !handlerInfo->handler) {
-            return false;
+            return posted;
         }
 
         handlerInfo->handler();
@@ -136,6 +169,9 @@ namespace hsppp {
 
     void stop(const std::source_location& location) {
         safe_call(location, [&] {
+            // 待機に入る前に遅らせた bsave を書き出す
+            flushDeferredSaves(location);
+
             MSG msg;
             
             // StateMachine コンテキストを取得（遷移チェック用）
@@ -343,6 +379,13 @@ namespace hsppp::internal {
         return true;  // 終了をブロック
     }
 
+    // コールバックを投入（任意のスレッドから呼び出し可）
+    void postInterruptCallback(std::function<void()> callback) {
+        std::lock_guard<std::mutex> lock(g_postedMutex);
+        g_postedCallbacks.push_back(std::move(callback));
+        g_hasPostedCallbacks.store(true, std::memory_order_release);
+    }
+
     // エラー割り込みは例外処理で直接handleHspErrorによって処理されるため、
     // triggerOnError関数は使用されません（後方互換性のため残していますが、実際には呼び出されない）
 
@@ -10,9 +10,20 @@
 // 注: ヘッダーのインポートは hsppp.ixx モジュールで行われています
 
 namespace {
-    // 乱数生成器（スレッドローカル）
-    thread_local std::mt19937 g_randomEngine;
-    thread_local bool g_randomInitialized = false;
+    // 乱数の状態（スレッドローカル）
+    // 未初期化時は randomize(0) と同じ固定シード（HSP互換: 一定パターン）
+    struct RandomContext {
+        hsppp::Xoshiro256 engine{ 0 };
+        uint32_t hspState = 0;      // rndmode_hsp 用の線形合同法の状態
+        int mode = hsppp::rndmode_fast;
+    };
+    thread_local RandomContext g_random;
+
+    // C ランタイム rand() と同じ線形合同法（0〜32767）
+    int hspRand(uint32_t& state) noexcept {
+        state = state * 214013u + 2531011u;
+        return static_cast<int>((state >> 16) & 0x7FFF);
+    }
 }
 
 namespace hsppp {
@@ -34,14 +45,44 @@ namespace hsppp {
     //   - rad2deg(double) : ラジアン → 度 変換
 
     int rnd(int p1) {
-        if (!g_randomInitialized) {
-            // 初期化されていない場合は固定シードを使用（HSP互換: 一定パターン）
-            g_randomEngine.seed(0);
-            g_randomInitialized = true;
-        }
         if (p1 <= 0) return 0;
-        std::uniform_int_distribution<int> dist(0, p1 - 1);
-        return dist(g_randomEngine);
+        RandomContext& random = g_random;
+        if (random.mode == rndmode_hsp) {
+            return hspRand(random.hspState) % p1;
+        }
+        return static_cast<int>(random.engine.bounded(static_cast<uint32_t>(p1)));
+    }
+
+    void rnd_fill(std::span<int> dest, int range) {
+        if (range <= 0) {
+            std::fill(dest.begin(), dest.end(), 0);
+            return;
+        }
+        // 状態をローカルに写して回す（thread_local へのアクセスをループから外す）
+        RandomContext& random = g_random;
+        if (random.mode == rndmode_hsp) {
+            uint32_t state = random.hspState;
+            for (int& v : dest) {
+                v = hspRand(state) % range;
+            }
+            random.hspState = state;
+            return;
+        }
+        Xoshiro256 engine = random.engine;
+        const uint32_t bound = static_cast<uint32_t>(range);
+        for (int& v : dest) {
+            v = static_cast<int>(engine.bounded(bound));
+        }
+        random.engine = engine;
+    }
+
+    void rnd_fill(std::span<double> dest) {
+        RandomContext& random = g_random;
+        Xoshiro256 engine = random.engine;
+        for (double& v : dest) {
+            v = engine.uniform();
+        }
+        random.engine = engine;
     }
 
     void randomize(OptInt p1, const std::source_location& location) {
@@ -54,11 +95,18 @@ namespace hsppp {
             } else {
                 seed = static_cast<unsigned int>(p1.value());
             }
-            g_randomEngine.seed(seed);
-            g_randomInitialized = true;
+            g_random.engine.seed(seed);
+            g_random.hspState = seed;
         });
     }
 
+    void rndmode(int p1, const std::source_location& location) {
+        if (p1 != rndmode_fast && p1 != rndmode_hsp) {
+            throw HspError(ERR_OUT_OF_RANGE, "rndmodeの引数は rndmode_fast または rndmode_hsp を指定してください", location);
+        }
+        g_random.mode = p1;
+    }
+
     int limit(int p1, OptInt p2, OptInt p3) {
         int result = p1;
         if (!p2.is_default() && result < p2.value()) {
@@ -89,45 +137,119 @@ namespace hsppp {
         return static_cast<int>(p1);
     }
 
-    int toInt(const std::string& p1) {
-        try {
-            return std::stoi(p1);
-        } catch (const std::invalid_argument&) {
-            return 0;  // 変換失敗時は0を返す（HSP互換）
-        } catch (const std::out_of_range&) {
-            return 0;  // 変換失敗時は0を返す（HSP互換）
+    namespace {
+        // strtol / strtod と同じ先頭空白（スペース, \t, \n, \v, \f, \r）を読み飛ばす
+        const char* skipNumberSpace(const char* p, const char* last) noexcept {
+            while (p != last && (*p == ' ' || (*p >= '\t' && *p <= '\r'))) {
+                ++p;
+            }
+            return p;
         }
+
+        // std::to_string(double) と同じ "%f" 表記（最大でも約320文字）
+        constexpr size_t kDoubleFixedBufferSize = 400;
+    }
+
+    // stoi と同じく先頭空白・符号を許容し、数値として読める部分までを変換する。
+    // 数値が無い・int の範囲外の場合は 0（HSP互換）。例外は使用しない。
+    int toInt(std::string_view p1) noexcept {
+        const char* first = skipNumberSpace(p1.data(), p1.data() + p1.size());
+        const char* last = p1.data() + p1.size();
+        if (first != last && *first == '+') {
+            ++first;
+            if (first == last || *first < '0' || *first > '9') {
+                return 0;
+            }
+        }
+        int value = 0;
+        const auto [ptr, ec] = std::from_chars(first, last, value);
+        return (ec == std::errc{}) ? value : 0;
     }
 
     double toDouble(int p1) {
         return static_cast<double>(p1);
     }
 
-    double toDouble(const std::string& p1) {
-        try {
-            return std::stod(p1);
-        } catch (const std::invalid_argument&) {
-            return 0.0;  // 変換失敗時は0を返す（HSP互換）
-        } catch (const std::out_of_range&) {
-            return 0.0;  // 変換失敗時は0を返す（HSP互換）
+    // stod と同じく先頭空白・符号・16進表記（0x）・inf/nan を許容する。
+    // 数値が無い・double の範囲外の場合は 0.0（HSP互換）。例外は使用しない。
+    double toDouble(std::string_view p1) noexcept {
+        const char* first = skipNumberSpace(p1.data(), p1.data() + p1.size());
+        const char* last = p1.data() + p1.size();
+
+        bool negative = false;
+        if (first != last && (*first == '+' || *first == '-')) {
+            negative = (*first == '-');
+            ++first;
+        }
+
+        double value = 0.0;
+        std::from_chars_result result{};
+        if (last - first >= 2 && first[0] == '0' && (first[1] == 'x' || first[1] == 'X')) {
+            result = std::from_chars(first + 2, last, value, std::chars_format::hex);
+            if (result.ec == std::errc::invalid_argument) {
+                return 0.0;  // "0x" のみは 0
+            }
+        } else {
+            // from_chars は '-' のみ受け付けるため、符号は上で処理済み
+            if (first != last && (*first == '+' || *first == '-')) {
+                return 0.0;
+            }
+            result = std::from_chars(first, last, value, std::chars_format::general);
         }
+        if (result.ec != std::errc{}) {
+            return 0.0;
+        }
+        return negative ? -value : value;
     }
 
     std::string str(double value, const std::source_location& location) {
         return safe_call(location, [&]() -> std::string {
-            return std::to_string(value);
+            char buf[kDoubleFixedBufferSize];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 6);
+            return std::string(buf, result.ptr);
         });
     }
 
     std::string str(int value, const std::source_location& location) {
         return safe_call(location, [&]() -> std::string {
-            return std::to_string(value);
+            char buf[16];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            return std::string(buf, result.ptr);
         });
     }
 
     std::string str(int64_t value, const std::source_location& location) {
         return safe_call(location, [&]() -> std::string {
-            return std::to_string(value);
+            char buf[24];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            return std::string(buf, result.ptr);
+        });
+    }
+
+    std::string& str_into(std::string& dest, double value, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::string& {
+            char buf[kDoubleFixedBufferSize];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), value, std::chars_format::fixed, 6);
+            dest.assign(buf, result.ptr);
+            return dest;
+        });
+    }
+
+    std::string& str_into(std::string& dest, int value, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::string& {
+            char buf[16];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            dest.assign(buf, result.ptr);
+            return dest;
+        });
+    }
+
+    std::string& str_into(std::string& dest, int64_t value, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::string& {
+            char buf[24];
+            const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+            dest.assign(buf, result.ptr);
+            return dest;
         });
     }
 
@@ -152,41 +274,12 @@ namespace hsppp {
                 throw HspError(ERR_OUT_OF_RANGE, "hsvcolorのV値は0～255の範囲で指定してください", location);
             }
 
-            // HSVをRGBに変換
-            // H: 0-191 (色相), S: 0-255 (彩度), V: 0-255 (明度)
-            
-            int h = p1;
-            int s = p2;
-            int v = p3;
-            
-            // Hを0-191から0-360にマッピング
-            float hue = h * 360.0f / 192.0f;
-            float sat = s / 255.0f;
-            float val = v / 255.0f;
-            
-            int r, g, b;
-            
-            if (s == 0) {
-                // 彩度0の場合はグレースケール
-                r = g = b = v;
-            } else {
-                float h6 = hue / 60.0f;
-                int hi = static_cast<int>(h6) % 6;
-                float f = h6 - static_cast<int>(h6);
-                float p = val * (1.0f - sat);
-                float q = val * (1.0f - sat * f);
-                float t = val * (1.0f - sat * (1.0f - f));
-                
-                switch (hi) {
-                    case 0: r = static_cast<int>(val * 255); g = static_cast<int>(t * 255); b = static_cast<int>(p * 255); break;
-                    case 1: r = static_cast<int>(q * 255); g = static_cast<int>(val * 255); b = static_cast<int>(p * 255); break;
-                    case 2: r = static_cast<int>(p * 255); g = static_cast<int>(val * 255); b = static_cast<int>(t * 255); break;
-                    case 3: r = static_cast<int>(p * 255); g = static_cast<int>(q * 255); b = static_cast<int>(val * 255); break;
-                    case 4: r = static_cast<int>(t * 255); g = static_cast<int>(p * 255); b = static_cast<int>(val * 255); break;
-                    default: r = static_cast<int>(val * 255); g = static_cast<int>(p * 255); b = static_cast<int>(q * 255); break;
-                }
-            }
-            
+            // HSVをRGBに変換（一括版 hsv_to_rgb と共通の実装。ColorConvert.cpp）
+            const int rgb = internal::HsvToRgb(p1, p2, p3);
+            const int r = (rgb >> 16) & 0xFF;
+            const int g = (rgb >> 8) & 0xFF;
+            const int b = rgb & 0xFF;
+
             // color関数を呼び出してカレントカラーを設定
             color(r, g, b, location);
         });
@@ -223,4 +316,68 @@ namespace hsppp {
         });
     }
 
+    // ============================================================
+    // 色変換（配列の一括処理）
+    // ============================================================
+    // 変換本体は ColorConvert.cpp（Win32 非依存、SSE2 で4要素ずつ処理）
+
+    namespace {
+        void checkColorSpanSize(const char* name, size_t outputSize, size_t inputSize, const std::source_location& location) {
+            if (outputSize != inputSize) {
+                throw HspError(ERR_OUT_OF_RANGE,
+                    std::format("{}: 配列の要素数が一致しません（{} / {}）", name, outputSize, inputSize), location);
+            }
+        }
+    }
+
+    void hsv_to_rgb(std::span<const int> h, std::span<const int> s, std::span<const int> v, std::span<int> rgb,
+                    const std::source_location& location) {
+        checkColorSpanSize("hsv_to_rgb", s.size(), h.size(), location);
+        checkColorSpanSize("hsv_to_rgb", v.size(), h.size(), location);
+        checkColorSpanSize("hsv_to_rgb", rgb.size(), h.size(), location);
+        internal::ConvertHsvToRgb(h.data(), s.data(), v.data(), h.size(), rgb.data());
+    }
+
+    void rgb_to_hsv(std::span<const int> rgb, std::span<int> h, std::span<int> s, std::span<int> v,
+                    const std::source_location& location) {
+        checkColorSpanSize("rgb_to_hsv", h.size(), rgb.size(), location);
+        checkColorSpanSize("rgb_to_hsv", s.size(), rgb.size(), location);
+        checkColorSpanSize("rgb_to_hsv", v.size(), rgb.size(), location);
+        internal::ConvertRgbToHsv(rgb.data(), rgb.size(), h.data(), s.data(), v.data());
+    }
+
+    std::array<int, 192> hsv_palette(int s, int v, const std::source_location& location) {
+        if (s < 0 || s > 255) {
+            throw HspError(ERR_OUT_OF_RANGE, "hsv_paletteのS値は0～255の範囲で指定してください", location);
+        }
+        if (v < 0 || v > 255) {
+            throw HspError(ERR_OUT_OF_RANGE, "hsv_paletteのV値は0～255の範囲で指定してください", location);
+        }
+        std::array<int, 192> palette;
+        static_assert(palette.size() == internal::kHsvHueSteps);
+        internal::FillHsvHueTable(s, v, palette.data());
+        return palette;
+    }
+
+    void rgb_to_bgra(std::span<const int> rgb, std::span<uint32_t> bgra, int alpha, const std::source_location& location) {
+        checkColorSpanSize("rgb_to_bgra", bgra.size(), rgb.size(), location);
+        if (alpha < 0 || alpha > 255) {
+            throw HspError(ERR_OUT_OF_RANGE, "rgb_to_bgraのアルファ値は0～255の範囲で指定してください", location);
+        }
+        internal::ConvertRgbToBgra(rgb.data(), rgb.size(), bgra.data(), alpha);
+    }
+
+    void bgra_to_rgb(std::span<const uint32_t> bgra, std::span<int> rgb, const std::source_location& location) {
+        checkColorSpanSize("bgra_to_rgb", rgb.size(), bgra.size(), location);
+        internal::ConvertBgraToRgb(bgra.data(), bgra.size(), rgb.data());
+    }
+
+    void premultiply_bgra(std::span<uint32_t> pixels) noexcept {
+        internal::PremultiplyBgra(pixels.data(), pixels.size());
+    }
+
+    void unpremultiply_bgra(std::span<uint32_t> pixels) noexcept {
+        internal::UnpremultiplyBgra(pixels.data(), pixels.size());
+    }
+
 } // namespace hsppp
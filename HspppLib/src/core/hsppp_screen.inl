@@ -44,6 +44,9 @@ namespace hsppp {
 
     double Screen::vwait(const std::source_location& location) {
         return safe_call(location, [&]() -> double {
+            // このフレームで遅らせた bsave を書き出す
+            flushDeferredSaves(location);
+
             // 高精度タイマーの初期化
             initHighResolutionTimer();
             
@@ -58,6 +61,8 @@ namespace hsppp {
             }
             
             // メッセージ処理（ペンディング分を処理）
+            // 完了通知はメッセージがなくても配送する
+            processPostedCallbacks();
             MSG msg;
             while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
                 if (processPendingInterrupt()) {
@@ -0,0 +1,514 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/hsppp_sort.inl
+// ソート関数の実装（sortval, sortstr, sortnote, sortget）
+//
+// - 数値: キーを符号なし整数に変換して LSD 基数ソート（8ビット × キー幅）
+// - 文字列: マルチキークイックソート（文字単位の3分割）
+// - 大きな配列: チャンクごとに並列ソートしてから隣接チャンクを順にマージ
+// いずれも安定ソート（値が等しい要素は元の順序を保つ）
+//
+// 並び替え情報は呼び出し側の SortPermutation に格納する。
+// HSP互換の sortval(arr, order) 等は、グローバルな SortPermutation に格納する薄いラッパー
+
+namespace {
+    // ソート関数のインデックス履歴
+    // NOTE: HSP互換性のため、最後にソートされた配列のインデックスをグローバルに保持
+    // sortget()は「最後に実行されたソート」の結果を返すHSPの仕様を再現している
+    hsppp::SortPermutation g_sortPermutation;
+}
+
+namespace hsppp {
+
+    // SortPermutation の内部バッファへのアクセス（実装側のみ）
+    struct detail::SortAccess {
+        static std::vector<int>& indices(SortPermutation& perm) noexcept { return perm.m_indices; }
+    };
+
+    int SortPermutation::get(int index, const std::source_location& location) const {
+        if (index < 0 || static_cast<size_t>(index) >= m_indices.size()) {
+            throw HspError(ERR_OUT_OF_ARRAY, "sortgetのインデックスが範囲外です", location);
+        }
+        return m_indices[static_cast<size_t>(index)];
+    }
+
+    void SortPermutation::check_size(size_t size, const std::source_location& location) const {
+        if (size != m_indices.size()) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("並べ替える配列の要素数がソート結果と一致しません（{} / {}）", size, m_indices.size()), location);
+        }
+    }
+
+    void detail::check_sort_by_key_size(size_t keySize, size_t valueSize, const std::source_location& location) {
+        if (keySize != valueSize) {
+            throw HspError(ERR_OUT_OF_RANGE,
+                std::format("sort_by_key: 配列の要素数がキーと一致しません（{} / {}）", valueSize, keySize), location);
+        }
+    }
+
+    namespace {
+        // これ以下の要素数は挿入ソートで処理
+        constexpr size_t kSortSmallThreshold = 48;
+        // これ以上の要素数はチャンク並列ソート + マージ
+        constexpr size_t kSortParallelThreshold = size_t{ 1 } << 18;
+        // 並列ソート時の1チャンクあたりの最小要素数
+        constexpr size_t kSortParallelMinChunk = size_t{ 1 } << 16;
+
+        // ソートキーと元のインデックスの組
+        template<typename Key>
+        struct SortItem {
+            Key key;
+            uint32_t index;
+        };
+
+        // 並び替え情報が不要な場合はキーのみを並べ替える
+        inline uint32_t sortItemKey(uint32_t key) noexcept { return key; }
+        inline uint64_t sortItemKey(uint64_t key) noexcept { return key; }
+        template<typename Key>
+        inline Key sortItemKey(const SortItem<Key>& item) noexcept { return item.key; }
+
+        // ============================================================
+        // 数値キー変換
+        // ============================================================
+        // 符号なし整数として比較したときに元の値と同じ順序になるよう変換する
+        // 降順はキーを反転する（等しい値の順序は変わらないため安定性を保てる）
+
+        inline uint32_t sortKeyOf(int value, bool descending) noexcept {
+            const uint32_t key = static_cast<uint32_t>(value) ^ 0x80000000u;
+            return descending ? ~key : key;
+        }
+
+        inline int sortValueOf(uint32_t key, bool descending) noexcept {
+            if (descending) key = ~key;
+            return static_cast<int>(key ^ 0x80000000u);
+        }
+
+        // IEEE 754: 負数は全ビット反転、正数は符号ビットのみ反転すると整数の大小と一致する
+        // （-0.0 は +0.0 より前、NaN は符号に応じて両端に並ぶ）
+        inline uint64_t sortKeyOf(double value, bool descending) noexcept {
+            constexpr uint64_t kSignBit = 0x8000000000000000ull;
+            const uint64_t bits = std::bit_cast<uint64_t>(value);
+            const uint64_t key = (bits & kSignBit) ? ~bits : (bits | kSignBit);
+            return descending ? ~key : key;
+        }
+
+        inline double sortValueOf(uint64_t key, bool descending) noexcept {
+            constexpr uint64_t kSignBit = 0x8000000000000000ull;
+            if (descending) key = ~key;
+            const uint64_t bits = (key & kSignBit) ? (key & ~kSignBit) : ~key;
+            return std::bit_cast<double>(bits);
+        }
+
+        // ============================================================
+        // LSD 基数ソート
+        // ============================================================
+
+        template<typename Item>
+        void insertionSortItems(Item* items, size_t n) {
+            for (size_t i = 1; i < n; ++i) {
+                const Item item = items[i];
+                size_t j = i;
+                while (j > 0 && sortItemKey(item) < sortItemKey(items[j - 1])) {
+                    items[j] = items[j - 1];
+                    --j;
+                }
+                items[j] = item;
+            }
+        }
+
+        // buffer は n 要素以上の作業領域
+        template<typename Item>
+        void radixSortItems(Item* items, Item* buffer, size_t n) {
+            using Key = decltype(sortItemKey(std::declval<const Item&>()));
+
+            if (n <= kSortSmallThreshold) {
+                insertionSortItems(items, n);
+                return;
+            }
+
+            constexpr size_t kPasses = sizeof(Key);
+            std::array<std::array<size_t, 256>, kPasses> counts{};
+            for (size_t i = 0; i < n; ++i) {
+                const Key key = sortItemKey(items[i]);
+                for (size_t pass = 0; pass < kPasses; ++pass) {
+                    ++counts[pass][static_cast<size_t>(key >> (pass * 8)) & 0xFF];
+                }
+            }
+
+            Item* src = items;
+            Item* dst = buffer;
+            for (size_t pass = 0; pass < kPasses; ++pass) {
+                auto& count = counts[pass];
+                const size_t shift = pass * 8;
+
+                // 全要素がこの桁で同じ値なら並べ替え不要
+                if (count[static_cast<size_t>(sortItemKey(src[0]) >> shift) & 0xFF] == n) {
+                    continue;
+                }
+
+                size_t offset = 0;
+                for (size_t& c : count) {
+                    const size_t bucket = c;
+                    c = offset;
+                    offset += bucket;
+                }
+                for (size_t i = 0; i < n; ++i) {
+                    dst[count[static_cast<size_t>(sortItemKey(src[i]) >> shift) & 0xFF]++] = src[i];
+                }
+                std::swap(src, dst);
+            }
+
+            if (src != items) {
+                std::copy(src, src + n, items);
+            }
+        }
+
+        // ============================================================
+        // マルチキークイックソート（文字列）
+        // ============================================================
+
+        struct StrSortItem {
+            const char* data;
+            size_t size;
+            uint32_t index;
+        };
+
+        inline std::string_view sortSuffix(const StrSortItem& item, size_t depth) noexcept {
+            const size_t start = std::min(depth, item.size);
+            return std::string_view(item.data + start, item.size - start);
+        }
+
+        // depth 文字目を順序値に変換
+        // 昇順: 終端 0 < 文字 1..256、降順: 文字 1..256（逆順） < 終端 257
+        inline int sortCharAt(const StrSortItem& item, size_t depth, bool descending) noexcept {
+            if (depth >= item.size) return descending ? 257 : 0;
+            const int c = static_cast<unsigned char>(item.data[depth]);
+            return descending ? 256 - c : c + 1;
+        }
+
+        // depth 文字目以降を比較し、等しければ元のインデックス順
+        inline bool strSortLess(const StrSortItem& a, const StrSortItem& b, size_t depth, bool descending) noexcept {
+            const int cmp = sortSuffix(a, depth).compare(sortSuffix(b, depth));
+            if (cmp != 0) return descending ? (cmp > 0) : (cmp < 0);
+            return a.index < b.index;
+        }
+
+        void insertionSortStrings(StrSortItem* items, size_t n, size_t depth, bool descending) {
+            for (size_t i = 1; i < n; ++i) {
+                const StrSortItem item = items[i];
+                size_t j = i;
+                while (j > 0 && strSortLess(item, items[j - 1], depth, descending)) {
+                    items[j] = items[j - 1];
+                    --j;
+                }
+                items[j] = item;
+            }
+        }
+
+        // items[0..n) は先頭 depth 文字が共通
+        void multikeyQuicksort(StrSortItem* items, size_t n, size_t depth, bool descending) {
+            const int endMark = descending ? 257 : 0;
+
+            while (n > kSortSmallThreshold) {
+                const int a = sortCharAt(items[0], depth, descending);
+                const int b = sortCharAt(items[n / 2], depth, descending);
+                const int c = sortCharAt(items[n - 1], depth, descending);
+                const int pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+                // depth 文字目で3分割: [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+                size_t lt = 0;
+                size_t i = 0;
+                size_t gt = n;
+                while (i < gt) {
+                    const int ch = sortCharAt(items[i], depth, descending);
+                    if (ch < pivot) {
+                        std::swap(items[lt++], items[i++]);
+                    } else if (ch > pivot) {
+                        std::swap(items[i], items[--gt]);
+                    } else {
+                        ++i;
+                    }
+                }
+
+                multikeyQuicksort(items, lt, depth, descending);
+                multikeyQuicksort(items + gt, n - gt, depth, descending);
+
+                items += lt;
+                n = gt - lt;
+                if (pivot == endMark) {
+                    // すべて同じ文字列: 元のインデックス順に並べる
+                    std::sort(items, items + n,
+                        [](const StrSortItem& l, const StrSortItem& r) { return l.index < r.index; });
+                    return;
+                }
+                ++depth;
+            }
+
+            insertionSortStrings(items, n, depth, descending);
+        }
+
+        // ============================================================
+        // 並列ソート
+        // ============================================================
+        // チャンクごとに chunkSort(items, buffer, count) で並べ替え、隣接チャンクを2つずつマージする
+        // std::merge は等しい要素を前の範囲から取り出すため、チャンクの順序（=元の順序）が保たれる
+        // buffer は n 要素以上の作業領域（並列化しない場合は chunkSort にそのまま渡す）
+
+        template<typename Item, typename ChunkSort, typename Less>
+        void sortChunked(Item* items, Item* buffer, size_t n, ChunkSort&& chunkSort, Less&& less) {
+            const size_t chunkCount = (n >= kSortParallelThreshold) ? parallelChunkCount(n, kSortParallelMinChunk) : 1;
+            if (chunkCount <= 1) {
+                chunkSort(items, buffer, n);
+                return;
+            }
+
+            std::vector<size_t> bounds(chunkCount + 1);
+            for (size_t c = 0; c <= chunkCount; ++c) {
+                bounds[c] = n * c / chunkCount;
+            }
+
+            runParallelChunks(chunkCount, [&](size_t c) {
+                chunkSort(items + bounds[c], buffer + bounds[c], bounds[c + 1] - bounds[c]);
+            });
+
+            Item* src = items;
+            Item* dst = buffer;
+            for (size_t width = 1; width < chunkCount; width *= 2) {
+                const size_t groups = (chunkCount + 2 * width - 1) / (2 * width);
+                runParallelChunks(groups, [&](size_t g) {
+                    const size_t first = g * 2 * width;
+                    const size_t lo = bounds[first];
+                    const size_t mid = bounds[std::min(first + width, chunkCount)];
+                    const size_t hi = bounds[std::min(first + 2 * width, chunkCount)];
+                    std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo, less);
+                });
+                std::swap(src, dst);
+            }
+
+            if (src != items) {
+                std::copy(src, src + n, items);
+            }
+        }
+
+        // ============================================================
+        // 配列単位のソート
+        // ============================================================
+
+        void checkSortSize(size_t n, const std::source_location& location) {
+            if (n > static_cast<size_t>(INT_MAX)) {
+                throw HspError(ERR_OUT_OF_RANGE, "ソート対象の要素数が多すぎます", location);
+            }
+        }
+
+        template<typename Item>
+        void storeSortPermutation(const std::vector<Item>& items, std::vector<int>* perm) {
+            if (!perm) return;
+            perm->resize(items.size());
+            for (size_t i = 0; i < items.size(); ++i) {
+                (*perm)[i] = static_cast<int>(items[i].index);
+            }
+        }
+
+        // items をその場でソートする（Item はキーのみ、またはキーとインデックスの組）
+        template<typename Item>
+        void sortNumberItems(std::vector<Item>& items) {
+            const size_t n = items.size();
+            if (n <= kSortSmallThreshold) {
+                insertionSortItems(items.data(), n);
+                return;
+            }
+            std::vector<Item> buffer(n);
+            sortChunked(items.data(), buffer.data(), n,
+                [](Item* chunk, Item* scratch, size_t count) { radixSortItems(chunk, scratch, count); },
+                [](const Item& a, const Item& b) { return sortItemKey(a) < sortItemKey(b); });
+        }
+
+        // values をその場でソートし、perm が非 null なら元のインデックスを格納
+        template<typename Value, typename Key>
+        void sortNumbers(std::span<Value> values, bool descending, std::vector<int>* perm, const std::source_location& location) {
+            const size_t n = values.size();
+            checkSortSize(n, location);
+
+            if (!perm) {
+                std::vector<Key> keys(n);
+                for (size_t i = 0; i < n; ++i) {
+                    keys[i] = sortKeyOf(values[i], descending);
+                }
+                sortNumberItems(keys);
+                for (size_t i = 0; i < n; ++i) {
+                    values[i] = sortValueOf(keys[i], descending);
+                }
+                return;
+            }
+
+            std::vector<SortItem<Key>> items(n);
+            for (size_t i = 0; i < n; ++i) {
+                items[i] = { sortKeyOf(values[i], descending), static_cast<uint32_t>(i) };
+            }
+            sortNumberItems(items);
+
+            for (size_t i = 0; i < n; ++i) {
+                values[i] = sortValueOf(items[i].key, descending);
+            }
+            storeSortPermutation(items, perm);
+        }
+
+        // 文字列（ビュー）の並びをソート
+        void sortStringItems(std::vector<StrSortItem>& items, bool descending) {
+            const size_t n = items.size();
+            std::vector<StrSortItem> buffer(n >= kSortParallelThreshold ? n : 0);
+            sortChunked(items.data(), buffer.data(), n,
+                [descending](StrSortItem* chunk, StrSortItem*, size_t count) { multikeyQuicksort(chunk, count, 0, descending); },
+                [descending](const StrSortItem& a, const StrSortItem& b) {
+                    const int cmp = std::string_view(a.data, a.size).compare(std::string_view(b.data, b.size));
+                    return descending ? (cmp > 0) : (cmp < 0);
+                });
+        }
+
+        // sorted[i] = values[order[i].index] となるよう、巡回置換でその場で並べ替える
+        template<typename T, typename Item>
+        void applySortOrder(std::span<T> values, const std::vector<Item>& order) {
+            const size_t n = values.size();
+            std::vector<bool> placed(n, false);
+            for (size_t i = 0; i < n; ++i) {
+                if (placed[i] || order[i].index == i) continue;
+
+                T held = std::move(values[i]);
+                size_t j = i;
+                while (true) {
+                    placed[j] = true;
+                    const size_t from = order[j].index;
+                    if (from == i) {
+                        values[j] = std::move(held);
+                        break;
+                    }
+                    values[j] = std::move(values[from]);
+                    j = from;
+                }
+            }
+        }
+
+        void sortStrings(std::span<std::string> values, bool descending, std::vector<int>* perm, const std::source_location& location) {
+            const size_t n = values.size();
+            checkSortSize(n, location);
+
+            std::vector<StrSortItem> items(n);
+            for (size_t i = 0; i < n; ++i) {
+                items[i] = { values[i].data(), values[i].size(), static_cast<uint32_t>(i) };
+            }
+            sortStringItems(items, descending);
+
+            applySortOrder(values, items);
+            storeSortPermutation(items, perm);
+        }
+    }
+
+    // 行を "\n" で区切ってビューとして並べ替える（行ごとの std::string は作らない）
+    namespace {
+        void sortNoteLines(std::string& note, bool descending, std::vector<int>* perm, const std::source_location& location) {
+            std::vector<StrSortItem> items;
+            size_t start = 0;
+            while (true) {
+                const size_t end = note.find('\n', start);
+                const size_t stop = (end == std::string::npos) ? note.size() : end;
+                checkSortSize(items.size() + 1, location);
+                items.push_back({ note.data() + start, stop - start, static_cast<uint32_t>(items.size()) });
+                if (end == std::string::npos) break;
+                start = end + 1;
+            }
+
+            sortStringItems(items, descending);
+
+            // 行数・総バイト数は変わらない
+            std::string sorted;
+            sorted.reserve(note.size());
+            for (size_t i = 0; i < items.size(); ++i) {
+                if (i != 0) sorted.push_back('\n');
+                sorted.append(items[i].data, items[i].size);
+            }
+            note = std::move(sorted);
+            storeSortPermutation(items, perm);
+        }
+    }
+
+    // --- 並び替え情報を perm に格納 ---
+
+    void sortval(std::vector<int>& arr, SortPermutation& perm, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortNumbers<int, uint32_t>(arr, order.value_or(0) == 1, &detail::SortAccess::indices(perm), location);
+        });
+    }
+
+    void sortval(std::vector<double>& arr, SortPermutation& perm, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortNumbers<double, uint64_t>(arr, order.value_or(0) == 1, &detail::SortAccess::indices(perm), location);
+        });
+    }
+
+    void sortstr(std::vector<std::string>& arr, SortPermutation& perm, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortStrings(arr, order.value_or(0) == 1, &detail::SortAccess::indices(perm), location);
+        });
+    }
+
+    void sortnote(std::string& note, SortPermutation& perm, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortNoteLines(note, order.value_or(0) == 1, &detail::SortAccess::indices(perm), location);
+        });
+    }
+
+    // --- 並び替え情報を記録しない ---
+
+    void sortval(std::vector<int>& arr, detail::SortUntrackedTag, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortNumbers<int, uint32_t>(arr, order.value_or(0) == 1, nullptr, location);
+        });
+    }
+
+    void sortval(std::vector<double>& arr, detail::SortUntrackedTag, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortNumbers<double, uint64_t>(arr, order.value_or(0) == 1, nullptr, location);
+        });
+    }
+
+    void sortstr(std::vector<std::string>& arr, detail::SortUntrackedTag, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortStrings(arr, order.value_or(0) == 1, nullptr, location);
+        });
+    }
+
+    void sortnote(std::string& note, detail::SortUntrackedTag, OptInt order, const std::source_location& location) {
+        safe_call(location, [&] {
+            sortNoteLines(note, order.value_or(0) == 1, nullptr, location);
+        });
+    }
+
+    // --- HSP互換（最後のソート結果を sortget で参照） ---
+
+    void sortval(std::vector<int>& arr, OptInt order, const std::source_location& location) {
+        sortval(arr, g_sortPermutation, order, location);
+    }
+
+    void sortval(std::vector<double>& arr, OptInt order, const std::source_location& location) {
+        sortval(arr, g_sortPermutation, order, location);
+    }
+
+    void sortstr(std::vector<std::string>& arr, OptInt order, const std::source_location& location) {
+        sortstr(arr, g_sortPermutation, order, location);
+    }
+
+    void sortnote(std::string& note, OptInt order, const std::source_location& location) {
+        sortnote(note, g_sortPermutation, order, location);
+    }
+
+    int sortget(int index, const std::source_location& location) {
+        return safe_call(location, [&]() -> int {
+            return g_sortPermutation.get(index, location);
+        });
+    }
+
+} // namespace hsppp
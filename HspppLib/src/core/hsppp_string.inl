@@ -182,62 +182,242 @@ namespace hsppp {
             }
             return out;
         }
+
+        // ============================================================
+        // メモリマップ / 行インデックス用ヘルパー
+        // ============================================================
+
+        // 並列化する最小チャンクサイズ（これ未満のファイルは1スレッドで処理）
+        constexpr size_t kNoteIndexMinChunk = 8 * 1024 * 1024;
+
+        // ファイルを読み取り専用でメモリマップする
+        // 戻り値が破棄されるとマップを解除する。空ファイルの場合は nullptr
+        // pack:// の場合はパックのマップ（圧縮している場合は展開したバッファ）を参照する
+        std::shared_ptr<void> mapNoteFile(std::string_view filename, size_t maxSize, std::string_view& outView, const std::source_location& location) {
+            outView = {};
+            flushDeferredSave(std::string(filename), location);
+            if (internal::IsPackPath(filename)) {
+                internal::PackData data = openPackFile(filename, location);
+                if (data.bytes.empty()) {
+                    return nullptr;
+                }
+                const size_t size = (maxSize > 0) ? (std::min)(maxSize, data.bytes.size()) : data.bytes.size();
+                outView = std::string_view(reinterpret_cast<const char*>(data.bytes.data()), size);
+                return std::const_pointer_cast<void>(std::move(data.owner));
+            }
+            internal::FileRegion region;
+            uint32_t systemError = 0;
+            // 0 は無制限（負の値はファイル末尾まで）
+            const int64_t limit = maxSize > 0 ? static_cast<int64_t>(maxSize) : -1;
+
+            switch (internal::MapFileRegion(filename, 0, limit, region, systemError)) {
+                case internal::MapStatus::Ok:
+                    break;
+                case internal::MapStatus::OpenFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルが見つかりません: {}", filename), location);
+                case internal::MapStatus::SizeFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルサイズの取得に失敗: {}", filename), location);
+                case internal::MapStatus::TooLarge:
+                    throw HspError(ERR_OUT_OF_MEMORY,
+                        std::format("ファイルが大きすぎてマップできません: {}", filename), location);
+                case internal::MapStatus::MapFailed:
+                    throw HspError(ERR_FILE_IO,
+                        std::format("ファイルのマップに失敗: {}", filename), location);
+            }
+            if (!region.base) {
+                return nullptr;
+            }
+
+            outView = std::string_view(reinterpret_cast<const char*>(region.data), region.size);
+            return std::shared_ptr<void>(region.base, [length = region.mappedLength](void* p) {
+                internal::UnmapFileRegion(p, length);
+            });
+        }
     }
 
     // ============================================================
     // NotePad クラス実装
     // ============================================================
 
+    // マップ中の NotePad が共有する状態
+    // 遅延構築するものは call_once で一度だけ作るため、const のメンバ関数から同時に呼ばれても競合しない
+    // （構築中に例外が出た場合は once_flag が立たず、次の呼び出しで再び構築する）
+    struct NotePad::MapState {
+        std::shared_ptr<void> mapping;
+        std::string_view text;
+
+        // 行インデックス（kLineIndexStride 行ごとの行頭オフセット）
+        std::once_flag indexOnce;
+        std::vector<size_t> lineCheckpoints;
+        size_t newlineCount = 0;
+
+        // buffer() const / toString() が返す内容のコピー
+        std::once_flag stringOnce;
+        std::string string;
+
+        void buildLineIndex();
+        void ensureLineIndex() { std::call_once(indexOnce, [this] { buildLineIndex(); }); }
+    };
+
     NotePad::NotePad(std::string_view text)
         : m_buffer(text) {}
 
     NotePad::NotePad(std::string&& text) noexcept
         : m_buffer(std::move(text)) {}
 
+    NotePad::NotePad(NotePad&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    // ムーブ元にマップのビューが残らないようにする
+    NotePad& NotePad::operator=(NotePad&& other) noexcept {
+        if (this != &other) {
+            m_buffer = std::move(other.m_buffer);
+            m_map = std::move(other.m_map);
+            m_mapped = other.m_mapped;
+            other.resetMapping();
+        }
+        return *this;
+    }
+
+    void NotePad::resetMapping() noexcept {
+        m_map.reset();
+        m_mapped = {};
+    }
+
+    // マップ中の内容を m_buffer にコピーして通常のノートパッドに切り替える
+    void NotePad::detach() {
+        if (!isMapped()) return;
+        m_buffer.assign(m_mapped);
+        resetMapping();
+    }
+
+    // マップを保ったまま内容をコピーした文字列（マップを共有するコピーとも共有する）
+    const std::string& NotePad::mappedString() const {
+        MapState& state = *m_map;
+        std::call_once(state.stringOnce, [&state] { state.string.assign(state.text); });
+        return state.string;
+    }
+
+    // 改行を数えながら kLineIndexStride 行ごとの行頭オフセットを記録する
+    // 1パス目でチャンクごとの改行数を数え、2パス目で各チャンクが担当する行頭を記録する
+    void NotePad::MapState::buildLineIndex() {
+        const size_t chunkCount = parallelChunkCount(text.size(), kNoteIndexMinChunk);
+
+        std::vector<size_t> bounds(chunkCount + 1);
+        for (size_t c = 0; c <= chunkCount; ++c) {
+            bounds[c] = static_cast<size_t>(static_cast<uint64_t>(text.size()) * c / chunkCount);
+        }
+
+        std::vector<size_t> newlines(chunkCount);
+        runParallelChunks(chunkCount, [&](size_t c) {
+            newlines[c] = static_cast<size_t>(std::count(text.begin() + bounds[c], text.begin() + bounds[c + 1], '\n'));
+        });
+
+        std::vector<size_t> firstNewline(chunkCount);
+        size_t total = 0;
+        for (size_t c = 0; c < chunkCount; ++c) {
+            firstNewline[c] = total;
+            total += newlines[c];
+        }
+
+        // n 個目（1始まり）の改行の直後が n 行目の行頭
+        std::vector<size_t> checkpoints(total / kLineIndexStride + 1);
+        checkpoints[0] = 0;
+        runParallelChunks(chunkCount, [&](size_t c) {
+            size_t ordinal = firstNewline[c];
+            const char* p = text.data() + bounds[c];
+            const char* end = text.data() + bounds[c + 1];
+            while (p < end) {
+                const char* nl = static_cast<const char*>(std::memchr(p, '\n', static_cast<size_t>(end - p)));
+                if (!nl) break;
+                ++ordinal;
+                if (ordinal % kLineIndexStride == 0) {
+                    checkpoints[ordinal / kLineIndexStride] = static_cast<size_t>(nl - text.data()) + 1;
+                }
+                p = nl + 1;
+            }
+        });
+
+        lineCheckpoints = std::move(checkpoints);
+        newlineCount = total;
+    }
+
+    // index 行目の行頭オフセットを取得（範囲外は false）
+    bool NotePad::lineStart(size_t index, size_t& outOffset) const {
+        const std::string_view text = view();
+        if (text.empty()) return false;
+
+        size_t offset = 0;
+        size_t remaining = index;
+        if (isMapped()) {
+            m_map->ensureLineIndex();
+            if (index > m_map->newlineCount) return false;
+            offset = m_map->lineCheckpoints[index / kLineIndexStride];
+            remaining = index % kLineIndexStride;
+        }
+
+        while (remaining > 0) {
+            const size_t nl = text.find('\n', offset);
+            if (nl == std::string_view::npos) return false;
+            offset = nl + 1;
+            --remaining;
+        }
+        outOffset = offset;
+        return true;
+    }
+
     size_t NotePad::count() const noexcept {
-        if (m_buffer.empty()) return 0;
-        
-        size_t newlineCount = static_cast<size_t>(std::count(m_buffer.begin(), m_buffer.end(), '\n'));
-        
+        const std::string_view text = view();
+        if (text.empty()) return 0;
+
+        size_t newlineCount = 0;
+        if (isMapped()) {
+            // 行インデックス構築に失敗した場合（メモリ不足）は直接数える
+            try {
+                m_map->ensureLineIndex();
+                newlineCount = m_map->newlineCount;
+            } catch (...) {
+                newlineCount = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+            }
+        } else {
+            newlineCount = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+        }
+
         // 末尾が改行で終わっている場合は、その後の空行はカウントしない（HSP互換）
         // "test\ntest" → 2行
         // "test\ntest\n" → 2行（末尾改行は無視）
-        if (!m_buffer.empty() && m_buffer.back() == '\n') {
+        if (text.back() == '\n') {
             return newlineCount;
         }
         return newlineCount + 1;
     }
 
-    std::string NotePad::get(size_t index) const {
-        if (m_buffer.empty()) return "";
-
-        size_t currentLine = 0;
+    std::string_view NotePad::line(size_t index) const {
         size_t start = 0;
+        if (!lineStart(index, start)) return {};
 
-        while (start <= m_buffer.size()) {
-            size_t end = m_buffer.find('\n', start);
-            if (end == std::string::npos) {
-                end = m_buffer.size();
-            }
-
-            if (currentLine == index) {
-                size_t len = end - start;
-                // 末尾の \r を除去
-                if (len > 0 && m_buffer[start + len - 1] == '\r') {
-                    --len;
-                }
-                return m_buffer.substr(start, len);
-            }
-
-            if (end >= m_buffer.size()) break;
-            start = end + 1;
-            ++currentLine;
+        const std::string_view text = view();
+        size_t end = text.find('\n', start);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        size_t len = end - start;
+        // 末尾の \r を除去
+        if (len > 0 && text[start + len - 1] == '\r') {
+            --len;
         }
+        return text.substr(start, len);
+    }
 
-        return "";
+    std::string NotePad::get(size_t index) const {
+        return std::string(line(index));
     }
 
     NotePad& NotePad::add(std::string_view text, int index, int overwrite, [[maybe_unused]] const std::source_location& location) {
+        detach();
         size_t lineCount = count();
 
         // 末尾追加
@@ -281,6 +461,7 @@ namespace hsppp {
     }
 
     NotePad& NotePad::del(size_t index, [[maybe_unused]] const std::source_location& location) {
+        detach();
         if (m_buffer.empty()) return *this;
 
         size_t lineCount = count();
@@ -321,48 +502,48 @@ namespace hsppp {
     }
 
     int NotePad::find(std::string_view search, int mode, size_t startIndex) const {
-        if (m_buffer.empty()) return -1;
+        const std::string_view text = view();
 
-        size_t currentLine = 0;
+        // 開始行の行頭から走査する（マップ中は行インデックスで直接移動）
         size_t start = 0;
-
-        while (start <= m_buffer.size()) {
-            size_t end = m_buffer.find('\n', start);
-            if (end == std::string::npos) {
-                end = m_buffer.size();
+        if (!lineStart(startIndex, start)) return -1;
+        size_t currentLine = startIndex;
+
+        while (start <= text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string_view::npos) {
+                end = text.size();
+            }
+
+            size_t len = end - start;
+            // 末尾の \r を除去して比較
+            if (len > 0 && text[start + len - 1] == '\r') {
+                --len;
+            }
+            std::string_view line(text.data() + start, len);
+
+            bool found = false;
+            switch (mode) {
+                case 0:  // 完全一致
+                    found = (line == search);
+                    break;
+                case 1:  // 先頭一致
+                    found = (line.size() >= search.size() &&
+                             line.compare(0, search.size(), search) == 0);
+                    break;
+                case 2:  // 部分一致
+                    found = (line.find(search) != std::string_view::npos);
+                    break;
+                default:
+                    found = (line == search);
+                    break;
             }
 
-            if (currentLine >= startIndex) {
-                size_t len = end - start;
-                // 末尾の \r を除去して比較
-                if (len > 0 && m_buffer[start + len - 1] == '\r') {
-                    --len;
-                }
-                std::string_view line(m_buffer.data() + start, len);
-
-                bool found = false;
-                switch (mode) {
-                    case 0:  // 完全一致
-                        found = (line == search);
-                        break;
-                    case 1:  // 先頭一致
-                        found = (line.size() >= search.size() &&
-                                 line.compare(0, search.size(), search) == 0);
-                        break;
-                    case 2:  // 部分一致
-                        found = (line.find(search) != std::string_view::npos);
-                        break;
-                    default:
-                        found = (line == search);
-                        break;
-                }
-
-                if (found) {
-                    return static_cast<int>(currentLine);
-                }
+            if (found) {
+                return static_cast<int>(currentLine);
             }
 
-            if (end >= m_buffer.size()) break;
+            if (end >= text.size()) break;
             start = end + 1;
             ++currentLine;
         }
@@ -372,6 +553,14 @@ namespace hsppp {
 
     NotePad& NotePad::load(std::string_view filename, size_t maxSize, const std::source_location& location) {
         safe_call(location, [&] {
+            resetMapping();
+            flushDeferredSave(std::string(filename), location);
+            if (internal::IsPackPath(filename)) {
+                const internal::PackData data = openPackFile(filename, location);
+                const size_t size = (maxSize > 0) ? (std::min)(maxSize, data.bytes.size()) : data.bytes.size();
+                m_buffer.assign(reinterpret_cast<const char*>(data.bytes.data()), size);
+                return;
+            }
             std::wstring wideFilename = internal::Utf8ToWide(filename);
 
             HANDLE hFile = CreateFileW(
@@ -416,6 +605,24 @@ namespace hsppp {
         return *this;
     }
 
+    NotePad& NotePad::map(std::string_view filename, size_t maxSize, const std::source_location& location) {
+        safe_call(location, [&] {
+            std::string_view mapped;
+            std::shared_ptr<void> mapping = mapNoteFile(filename, maxSize, mapped, location);
+
+            resetMapping();
+            m_buffer.clear();
+            if (mapping) {
+                auto state = std::make_shared<MapState>();
+                state->mapping = std::move(mapping);
+                state->text = mapped;
+                m_map = std::move(state);
+                m_mapped = mapped;
+            }
+        });
+        return *this;
+    }
+
     [[nodiscard]] bool NotePad::save(std::string_view filename, const std::source_location& location) const {
         return safe_call(location, [&] {
             std::wstring wideFilename = internal::Utf8ToWide(filename);
@@ -435,11 +642,13 @@ namespace hsppp {
                     std::format("ファイルを作成できません: {}", filename), location);
             }
 
+            const std::string_view text = view();
             DWORD bytesWritten = 0;
-            BOOL success = WriteFile(hFile, m_buffer.data(), static_cast<DWORD>(m_buffer.size()), &bytesWritten, nullptr);
+            BOOL success = WriteFile(hFile, text.data(), static_cast<DWORD>(text.size()), &bytesWritten, nullptr);
             CloseHandle(hFile);
+            internal::InvalidateStatCacheFor(filename);
 
-            if (!success || bytesWritten != m_buffer.size()) {
+            if (!success || bytesWritten != text.size()) {
                 throw HspError(ERR_FILE_IO,
                     std::format("ファイルの書き込みに失敗: {}", filename), location);
             }
@@ -606,67 +815,222 @@ namespace hsppp {
     // strf - 書式付き文字列を変換
     // ============================================================
     // HSPのstrf互換実装
-    // snprintfを使用してprintf形式の書式をサポート
-    
-    namespace detail {
-        // 内部ヘルパー: バッファサイズを動的に調整してsnprintfを実行
-        template<typename... Args>
-        std::string sprintf_impl(const char* fmt, Args... args) {
-            // 最初に必要なバッファサイズを計算
-            int size = std::snprintf(nullptr, 0, fmt, args...);
-            if (size < 0) {
-                return "";  // エラー
+    // 書式は StrfFormatString でコンパイル時（リテラル）または実行時（キャッシュ付き）に解析し、
+    // 指定子ごとに to_chars / snprintf でスタックバッファへ整形して1パスで出力する
+
+    namespace {
+        using detail::StrfArg;
+        using detail::StrfSpec;
+
+        // 実行時書式の解析結果キャッシュ（スレッドごと）
+        struct StrfCacheHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view sv) const noexcept { return std::hash<std::string_view>{}(sv); }
+        };
+        constexpr size_t kStrfCacheMaxEntries = 256;
+
+        std::span<const StrfSpec> lookupStrfSpecs(std::string_view format) {
+            thread_local std::unordered_map<std::string, std::vector<StrfSpec>, StrfCacheHash, std::equal_to<>> cache;
+
+            if (auto it = cache.find(format); it != cache.end()) {
+                return it->second;
             }
-            
-            std::string result(static_cast<size_t>(size) + 1, '\0');
-            std::snprintf(result.data(), result.size(), fmt, args...);
-            result.resize(static_cast<size_t>(size));  // null終端を除去
-            return result;
+            if (cache.size() >= kStrfCacheMaxEntries) {
+                cache.clear();
+            }
+            std::vector<StrfSpec> specs;
+            size_t pos = 0;
+            StrfSpec spec{};
+            while (detail::strf_parse_next(format, pos, spec)) {
+                specs.push_back(spec);
+            }
+            return cache.emplace(std::string(format), std::move(specs)).first->second;
         }
-    }
 
-    std::string strf(const std::string& format) {
-        return format;  // 引数なしはそのまま返す
-    }
+        // リテラル部分を出力（%% は % に置き換え）
+        void appendStrfLiteral(std::string& out, std::string_view lit) {
+            size_t pos = 0;
+            while (pos < lit.size()) {
+                const size_t pct = lit.find("%%", pos);
+                if (pct == std::string_view::npos) {
+                    out.append(lit.substr(pos));
+                    return;
+                }
+                out.append(lit.substr(pos, pct + 1 - pos));
+                pos = pct + 2;
+            }
+        }
 
-    std::string strf(const std::string& format, int arg1) {
-        return detail::sprintf_impl(format.c_str(), arg1);
-    }
+        int64_t strfArgAsInt(const StrfArg& arg) noexcept {
+            switch (arg.type) {
+            case StrfArg::Type::Double:  return static_cast<int64_t>(arg.d);
+            case StrfArg::Type::String:  return 0;
+            case StrfArg::Type::Pointer: return static_cast<int64_t>(reinterpret_cast<uintptr_t>(arg.p));
+            default:                     return arg.i;
+            }
+        }
 
-    std::string strf(const std::string& format, double arg1) {
-        return detail::sprintf_impl(format.c_str(), arg1);
-    }
+        uint64_t strfArgAsUInt(const StrfArg& arg) noexcept {
+            if (arg.type == StrfArg::Type::Int && arg.size <= 4) {
+                // 32bit以下の符号付き整数は printf と同じく32bitで符号なし解釈する
+                return static_cast<uint32_t>(static_cast<int32_t>(arg.i));
+            }
+            return static_cast<uint64_t>(strfArgAsInt(arg));
+        }
 
-    std::string strf(const std::string& format, const std::string& arg1) {
-        return detail::sprintf_impl(format.c_str(), arg1.c_str());
-    }
+        double strfArgAsDouble(const StrfArg& arg) noexcept {
+            switch (arg.type) {
+            case StrfArg::Type::Double: return arg.d;
+            case StrfArg::Type::UInt:   return static_cast<double>(arg.u);
+            case StrfArg::Type::String: return 0.0;
+            case StrfArg::Type::Pointer: return 0.0;
+            default:                    return static_cast<double>(arg.i);
+            }
+        }
 
-    std::string strf(const std::string& format, int arg1, int arg2) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2);
-    }
+        // width / '-' フラグに従って空白で詰める
+        void appendStrfPadded(std::string& out, std::string_view body, const StrfSpec& spec) {
+            const size_t width = spec.width > 0 ? static_cast<size_t>(spec.width) : 0;
+            const size_t pad = body.size() < width ? width - body.size() : 0;
+            if (pad > 0 && !(spec.flags & detail::strf_flag_minus)) out.append(pad, ' ');
+            out.append(body);
+            if (pad > 0 && (spec.flags & detail::strf_flag_minus)) out.append(pad, ' ');
+        }
 
-    std::string strf(const std::string& format, int arg1, double arg2) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2);
-    }
+        // 数値を snprintf で整形（フラグ・幅・精度付きの一般経路）
+        template<typename T>
+        void appendStrfPrintf(std::string& out, const StrfSpec& spec, const char* lengthMod, char conv, T value) {
+            char fmt[32];
+            char* f = fmt;
+            *f++ = '%';
+            if (spec.flags & detail::strf_flag_minus) *f++ = '-';
+            if (spec.flags & detail::strf_flag_plus)  *f++ = '+';
+            if (spec.flags & detail::strf_flag_space) *f++ = ' ';
+            if (spec.flags & detail::strf_flag_zero)  *f++ = '0';
+            if (spec.flags & detail::strf_flag_hash)  *f++ = '#';
+            if (spec.width >= 0) {
+                f = std::to_chars(f, fmt + 16, spec.width).ptr;
+            }
+            if (spec.precision >= 0) {
+                *f++ = '.';
+                f = std::to_chars(f, fmt + 26, spec.precision).ptr;
+            }
+            for (; *lengthMod; ++lengthMod) *f++ = *lengthMod;
+            *f++ = conv;
+            *f = '\0';
+
+            char stackBuf[256];
+            const int size = std::snprintf(stackBuf, sizeof(stackBuf), fmt, value);
+            if (size < 0) {
+                return;
+            }
+            if (static_cast<size_t>(size) < sizeof(stackBuf)) {
+                out.append(stackBuf, static_cast<size_t>(size));
+                return;
+            }
+            // 大きな幅・精度指定時のみ出力先へ直接書き込む
+            const size_t oldSize = out.size();
+            out.resize(oldSize + static_cast<size_t>(size) + 1);
+            std::snprintf(out.data() + oldSize, static_cast<size_t>(size) + 1, fmt, value);
+            out.resize(oldSize + static_cast<size_t>(size));
+        }
 
-    std::string strf(const std::string& format, int arg1, const std::string& arg2) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2.c_str());
-    }
+        void appendStrfSpec(std::string& out, const StrfSpec& spec, const StrfArg& arg) {
+            const bool plain = spec.flags == 0 && spec.width < 0 && spec.precision < 0;
+            char buf[64];
 
-    std::string strf(const std::string& format, double arg1, int arg2) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2);
-    }
+            switch (spec.conv) {
+            case 'd': case 'i':
+                if (plain) {
+                    out.append(buf, std::to_chars(buf, buf + sizeof(buf), strfArgAsInt(arg)).ptr);
+                } else {
+                    appendStrfPrintf(out, spec, "ll", 'd', static_cast<long long>(strfArgAsInt(arg)));
+                }
+                return;
+
+            case 'u': case 'x': case 'X': case 'o':
+                if (plain) {
+                    const int base = (spec.conv == 'u') ? 10 : (spec.conv == 'o' ? 8 : 16);
+                    char* last = std::to_chars(buf, buf + sizeof(buf), strfArgAsUInt(arg), base).ptr;
+                    if (spec.conv == 'X') {
+                        for (char* c = buf; c != last; ++c) {
+                            if (*c >= 'a' && *c <= 'f') *c = static_cast<char>(*c - 'a' + 'A');
+                        }
+                    }
+                    out.append(buf, last);
+                } else {
+                    appendStrfPrintf(out, spec, "ll", spec.conv, static_cast<unsigned long long>(strfArgAsUInt(arg)));
+                }
+                return;
 
-    std::string strf(const std::string& format, double arg1, double arg2) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2);
+            case 'c': {
+                const char c = static_cast<char>(strfArgAsInt(arg));
+                appendStrfPadded(out, std::string_view(&c, 1), spec);
+                return;
+            }
+
+            case 's': {
+                std::string_view body;
+                if (arg.type == StrfArg::Type::String) {
+                    body = std::string_view(arg.s, arg.len);
+                } else if (arg.type == StrfArg::Type::Double) {
+                    // 数値が渡された場合は str() と同じ表記（%f は最大でも約320文字）
+                    char dblBuf[400];
+                    const int n = std::snprintf(dblBuf, sizeof(dblBuf), "%f", arg.d);
+                    body = std::string_view(dblBuf, n > 0 ? std::min<size_t>(static_cast<size_t>(n), sizeof(dblBuf) - 1) : 0);
+                    if (spec.precision >= 0 && static_cast<size_t>(spec.precision) < body.size()) {
+                        body = body.substr(0, static_cast<size_t>(spec.precision));
+                    }
+                    appendStrfPadded(out, body, spec);
+                    return;
+                } else if (arg.type == StrfArg::Type::Char) {
+                    buf[0] = static_cast<char>(arg.i);
+                    body = std::string_view(buf, 1);
+                } else {
+                    body = std::string_view(buf, std::to_chars(buf, buf + sizeof(buf), strfArgAsInt(arg)).ptr);
+                }
+                if (spec.precision >= 0 && static_cast<size_t>(spec.precision) < body.size()) {
+                    body = body.substr(0, static_cast<size_t>(spec.precision));
+                }
+                appendStrfPadded(out, body, spec);
+                return;
+            }
+
+            case 'p':
+                appendStrfPrintf(out, spec, "", 'p', arg.type == StrfArg::Type::Pointer ? arg.p : nullptr);
+                return;
+
+            default:    // f F e E g G a A
+                appendStrfPrintf(out, spec, "", spec.conv, strfArgAsDouble(arg));
+                return;
+            }
+        }
     }
 
-    std::string strf(const std::string& format, int arg1, int arg2, int arg3) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2, arg3);
+    namespace detail {
+        void strf_vformat_to(std::string& out, std::string_view format, bool parsed,
+                             std::span<const StrfSpec> specs, std::span<const StrfArg> args) {
+            if (!parsed) {
+                specs = lookupStrfSpecs(format);
+            }
+            out.reserve(out.size() + format.size() + specs.size() * 8);
+
+            size_t litBegin = 0;
+            for (size_t n = 0; n < specs.size(); ++n) {
+                const StrfSpec& spec = specs[n];
+                appendStrfLiteral(out, format.substr(litBegin, spec.begin - litBegin));
+                // 引数が足りない指定子は何も出力しない
+                if (n < args.size()) {
+                    appendStrfSpec(out, spec, args[n]);
+                }
+                litBegin = spec.end;
+            }
+            appendStrfLiteral(out, format.substr(litBegin));
+        }
     }
 
-    std::string strf(const std::string& format, int arg1, double arg2, const std::string& arg3) {
-        return detail::sprintf_impl(format.c_str(), arg1, arg2, arg3.c_str());
+    std::string strf(const std::string& format) {
+        return format;  // 引数なしはそのまま返す
     }
 
     // ============================================================
@@ -768,116 +1132,285 @@ namespace hsppp {
         });
     }
 
+    // ============================================================
+    // getstr / StrReader 共通スキャナ
+    // ============================================================
+
+    namespace {
+        // getstr の終端文字（CR / LF / NUL(delimiter==0) / delimiter(>0)）を探す
+        // 戻り値: 最初の終端文字の位置、見つからなければ len
+        size_t scanGetstrTerminator(const char* p, size_t len, int delimiter) noexcept {
+            const bool useNul = (delimiter == 0);
+            const bool useDelim = (delimiter > 0);
+            const uint8_t delim = static_cast<uint8_t>(delimiter);
+            size_t i = 0;
+
+#ifdef HSPPP_HAS_SSE2
+            // 16バイト単位で比較し、ヒットがあればビット位置から求める
+            const __m128i vCr = _mm_set1_epi8('\r');
+            const __m128i vLf = _mm_set1_epi8('\n');
+            // delimiter==0 なら NUL、delimiter>0 ならその文字、それ以外は CR と同じ（影響なし）
+            const __m128i vEx = _mm_set1_epi8(static_cast<char>(useNul ? 0 : (useDelim ? delim : '\r')));
+            for (; i + 16 <= len; i += 16) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                const __m128i hit = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, vCr), _mm_cmpeq_epi8(v, vLf)),
+                    _mm_cmpeq_epi8(v, vEx));
+                const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+                if (mask != 0) {
+                    return i + static_cast<size_t>(std::countr_zero(mask));
+                }
+            }
+#endif
+            for (; i < len; ++i) {
+                const uint8_t c = static_cast<uint8_t>(p[i]);
+                if (c == '\r' || c == '\n') return i;
+                if (useNul && c == 0) return i;
+                if (useDelim && c == delim) return i;
+            }
+            return len;
+        }
+
+        struct GetstrToken {
+            size_t length;      // トークン長（終端文字を含まない）
+            size_t consumed;    // 消費バイト数（getstr の戻り値）
+            bool terminated;    // 終端文字で区切られたか
+        };
+
+        // p[0, avail) から getstr と同じ規則で1トークンを切り出す
+        GetstrToken scanGetstrToken(const char* p, size_t avail, int delimiter, int64_t maxLen) noexcept {
+            const size_t limit = (maxLen <= 0) ? 0
+                : (static_cast<uint64_t>(maxLen) < avail ? static_cast<size_t>(maxLen) : avail);
+            const size_t pos = scanGetstrTerminator(p, limit, delimiter);
+            if (pos >= limit) {
+                // 最大文字数に達した、またはバッファ終端に達した
+                return { limit, limit, false };
+            }
+            // \r\n は2バイト消費
+            if (p[pos] == '\r' && pos + 1 < avail && p[pos + 1] == '\n') {
+                return { pos, pos + 2, true };
+            }
+            return { pos, pos + 1, true };
+        }
+
+        int64_t getstrFromView(std::string& dest, std::string_view src, int64_t index, int delimiter, int64_t maxLen) {
+            if (index < 0 || static_cast<size_t>(index) >= src.size()) {
+                dest.clear();
+                return 0;
+            }
+            const size_t startPos = static_cast<size_t>(index);
+            const GetstrToken tok = scanGetstrToken(src.data() + startPos, src.size() - startPos, delimiter, maxLen);
+            // assign は dest の既存容量を再利用する
+            dest.assign(src.data() + startPos, tok.length);
+            return static_cast<int64_t>(tok.consumed);
+        }
+
+        constexpr size_t kStrReaderDefaultChunk = 1024 * 1024;
+    }
+
     // ============================================================
     // getstr - バッファから文字列読み出し
     // ============================================================
     
     int64_t getstr(std::string& dest, const std::string& src, int64_t index, int delimiter, int64_t maxLen, const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
-            dest.clear();
-            
-            if (index < 0 || static_cast<size_t>(index) >= src.size()) {
-                return 0;
-            }
-            
-            size_t startPos = static_cast<size_t>(index);
-            size_t endPos = startPos;
-            size_t srcSize = src.size();
-            int64_t readCount = 0;
-            
-            // 区切り文字または改行を探す
-            while (endPos < srcSize && readCount < maxLen) {
-                uint8_t c = static_cast<uint8_t>(src[endPos]);
-                
-                // 改行コードのチェック（\r\n, \n, \r）
-                if (c == '\r') {
-                    if (endPos + 1 < srcSize && src[endPos + 1] == '\n') {
-                        // \r\n の場合は2バイト消費
-                        dest = src.substr(startPos, endPos - startPos);
-                        return static_cast<int64_t>(endPos - startPos + 2);
-                    }
-                    // \r のみ
-                    dest = src.substr(startPos, endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
-                }
-                
-                if (c == '\n') {
-                    dest = src.substr(startPos, endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
-                }
-                
-                // NULL終端（delimiter=0のデフォルト時のみ）
-                if (c == 0 && delimiter == 0) {
-                    dest = src.substr(startPos, endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
-                }
-                
-                // 区切り文字のチェック（delimiter > 0の場合）
-                if (delimiter > 0 && c == static_cast<uint8_t>(delimiter)) {
-                    dest = src.substr(startPos, endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
-                }
-                
-                ++endPos;
-                ++readCount;
-            }
-            
-            // 最大文字数に達した、または文字列の終端に達した
-            dest = src.substr(startPos, endPos - startPos);
-            return static_cast<int64_t>(endPos - startPos);
+            return getstrFromView(dest, src, index, delimiter, maxLen);
         });
     }
 
     int64_t getstr(std::string& dest, const std::vector<uint8_t>& src, int64_t index, int delimiter, int64_t maxLen, const std::source_location& location) {
         return safe_call(location, [&]() -> int64_t {
             // vector<uint8_t>をstring_viewとして扱い、同じロジックを適用
-            dest.clear();
-            
-            if (index < 0 || static_cast<size_t>(index) >= src.size()) {
-                return 0;
+            const std::string_view view(reinterpret_cast<const char*>(src.data()), src.size());
+            return getstrFromView(dest, view, index, delimiter, maxLen);
+        });
+    }
+
+    // ============================================================
+    // StrReader - getstr互換のストリーミングトークナイザ
+    // ============================================================
+
+    StrReader::StrReader(std::string_view src, int64_t index) noexcept
+        : m_view(src)
+    {
+        m_pos = (index <= 0) ? 0 : std::min(static_cast<size_t>(index), src.size());
+    }
+
+    // m_view がチャンクバッファを指している場合、ムーブ後に指し直す
+    // （短い文字列はSSOによりムーブでアドレスが変わるため）
+    StrReader::StrReader(StrReader&& other) noexcept {
+        *this = std::move(other);
+    }
+
+    StrReader& StrReader::operator=(StrReader&& other) noexcept {
+        if (this != &other) {
+            const bool ownsView = !other.m_chunk.empty() && other.m_view.data() == other.m_chunk.data();
+            m_chunk = std::move(other.m_chunk);
+            m_view = ownsView ? std::string_view(m_chunk) : other.m_view;
+            m_pos = other.m_pos;
+            m_base = other.m_base;
+            m_lastSize = other.m_lastSize;
+            m_file = std::move(other.m_file);
+            m_chunkSize = other.m_chunkSize;
+            m_fileEof = other.m_fileEof;
+
+            other.m_view = {};
+            other.m_chunk.clear();
+            other.m_pos = 0;
+            other.m_base = 0;
+            other.m_lastSize = 0;
+            other.m_fileEof = true;
+        }
+        return *this;
+    }
+
+    StrReader& StrReader::open(std::string_view filename, size_t chunkSize, const std::source_location& location) {
+        safe_call(location, [&] {
+            if (internal::IsPackPath(filename)) {
+                // パック内のファイルは全体がメモリ上にあるため、チャンクに読み込まずに直接走査する
+                internal::PackData data = openPackFile(filename, location);
+                m_view = std::string_view(reinterpret_cast<const char*>(data.bytes.data()), data.bytes.size());
+                m_file = std::const_pointer_cast<void>(std::move(data.owner));
+                m_chunkSize = (chunkSize == 0) ? kStrReaderDefaultChunk : chunkSize;
+                m_chunk.clear();
+                m_pos = 0;
+                m_base = 0;
+                m_lastSize = 0;
+                m_fileEof = true;
+                return;
             }
-            
-            size_t startPos = static_cast<size_t>(index);
-            size_t endPos = startPos;
-            size_t srcSize = src.size();
-            int64_t readCount = 0;
-            
-            while (endPos < srcSize && readCount < maxLen) {
-                uint8_t c = src[endPos];
-                
-                if (c == '\r') {
-                    if (endPos + 1 < srcSize && src[endPos + 1] == '\n') {
-                        dest.assign(reinterpret_cast<const char*>(&src[startPos]), endPos - startPos);
-                        return static_cast<int64_t>(endPos - startPos + 2);
-                    }
-                    dest.assign(reinterpret_cast<const char*>(&src[startPos]), endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
-                }
-                
-                if (c == '\n') {
-                    dest.assign(reinterpret_cast<const char*>(&src[startPos]), endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
-                }
-                
-                if (c == 0 && delimiter == 0) {
-                    dest.assign(reinterpret_cast<const char*>(&src[startPos]), endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
+            std::wstring wideFilename = internal::Utf8ToWide(filename);
+
+            HANDLE hFile = CreateFileW(
+                wideFilename.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                nullptr
+            );
+
+            if (hFile == INVALID_HANDLE_VALUE) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("ファイルが見つかりません: {}", filename), location);
+            }
+
+            m_file = std::shared_ptr<void>(hFile, [](void* h) { CloseHandle(static_cast<HANDLE>(h)); });
+            m_chunkSize = (chunkSize == 0) ? kStrReaderDefaultChunk : chunkSize;
+            m_chunk.clear();
+            m_chunk.reserve(m_chunkSize);
+            m_view = {};
+            m_pos = 0;
+            m_base = 0;
+            m_lastSize = 0;
+            m_fileEof = false;
+
+            if (!refill()) {
+                throw HspError(ERR_FILE_IO,
+                    std::format("ファイルの読み込みに失敗: {}", filename), location);
+            }
+        });
+        return *this;
+    }
+
+    // 未消費部分をチャンク先頭へ詰め、後ろに次のデータを読み足す
+    bool StrReader::refill() {
+        if (m_fileEof || !m_file) return true;
+
+        const size_t remain = m_view.size() - m_pos;
+        if (m_pos > 0 && remain > 0) {
+            std::copy(m_chunk.data() + m_pos, m_chunk.data() + m_pos + remain, m_chunk.data());
+        }
+        m_base += static_cast<int64_t>(m_pos);
+        m_pos = 0;
+
+        // 未消費部分がチャンクを埋めている場合（長いトークン）はチャンクを拡張
+        const size_t capacity = std::max(m_chunkSize, remain * 2);
+        m_chunk.resize(capacity);
+
+        size_t filled = remain;
+        while (filled < capacity) {
+            const DWORD request = static_cast<DWORD>(std::min<size_t>(capacity - filled, MAXDWORD));
+            DWORD bytesRead = 0;
+            if (!ReadFile(static_cast<HANDLE>(m_file.get()), m_chunk.data() + filled, request, &bytesRead, nullptr)) {
+                m_chunk.resize(filled);
+                m_view = m_chunk;
+                return false;
+            }
+            if (bytesRead == 0) {
+                m_fileEof = true;
+                m_file.reset();
+                break;
+            }
+            filled += bytesRead;
+        }
+
+        m_chunk.resize(filled);
+        m_view = m_chunk;
+        return true;
+    }
+
+    bool StrReader::next(std::string_view& token, int delimiter, int64_t maxLen, const std::source_location& location) {
+        return safe_call(location, [&]() -> bool {
+            if (maxLen <= 0) {
+                throw HspError(ERR_OUT_OF_RANGE, std::format("maxLen は 1 以上を指定してください: {}", maxLen), location);
+            }
+            for (;;) {
+                const size_t avail = m_view.size() - m_pos;
+                if (avail == 0 && m_fileEof) {
+                    token = {};
+                    m_lastSize = 0;
+                    return false;
                 }
-                
-                if (delimiter > 0 && c == static_cast<uint8_t>(delimiter)) {
-                    dest.assign(reinterpret_cast<const char*>(&src[startPos]), endPos - startPos);
-                    return static_cast<int64_t>(endPos - startPos + 1);
+
+                const char* p = m_view.data() + m_pos;
+                const GetstrToken tok = scanGetstrToken(p, avail, delimiter, maxLen);
+
+                // チャンク終端でトークンが確定しない場合は補充して再走査
+                //   - 終端文字が見つからずバッファ末尾に達した
+                //   - 末尾の \r の直後が \n かどうか判定できない
+                const bool hitChunkEnd = !tok.terminated && tok.consumed == avail && static_cast<int64_t>(avail) < maxLen;
+                const bool pendingCr = tok.terminated && tok.consumed == avail && p[tok.length] == '\r';
+                if (!m_fileEof && (hitChunkEnd || pendingCr || avail == 0)) {
+                    if (!refill()) {
+                        throw HspError(ERR_FILE_IO, "ファイルの読み込みに失敗しました", location);
+                    }
+                    continue;
                 }
-                
-                ++endPos;
-                ++readCount;
+
+                token = std::string_view(p, tok.length);
+                m_pos += tok.consumed;
+                m_lastSize = static_cast<int64_t>(tok.consumed);
+                return tok.consumed > 0;
             }
-            
-            dest.assign(reinterpret_cast<const char*>(&src[startPos]), endPos - startPos);
-            return static_cast<int64_t>(endPos - startPos);
         });
     }
 
+    int64_t StrReader::read(std::string& dest, int delimiter, int64_t maxLen, const std::source_location& location) {
+        std::string_view token;
+        if (!next(token, delimiter, maxLen, location)) {
+            dest.clear();
+            return 0;
+        }
+        dest.assign(token.data(), token.size());
+        return m_lastSize;
+    }
+
+    StrReader& StrReader::seek(int64_t index, const std::source_location& location) {
+        safe_call(location, [&] {
+            if (m_file || !m_chunk.empty()) {
+                throw HspError(ERR_UNSUPPORTED, "ファイルから読み込み中のStrReaderはseekできません", location);
+            }
+            if (index < 0 || static_cast<size_t>(index) > m_view.size()) {
+                throw HspError(ERR_OUT_OF_RANGE, "seek位置が範囲外です", location);
+            }
+            m_pos = static_cast<size_t>(index);
+            m_lastSize = 0;
+        });
+        return *this;
+    }
+
     // ============================================================
     // split - 文字列から分割された要素を取得
     // ============================================================
@@ -1058,30 +1591,11 @@ namespace hsppp {
                 throw HspError(ERR_OUT_OF_RANGE, "noteload: 最大サイズが不正です", location);
             }
 
-            std::ifstream ifs(std::string(filename), std::ios::binary);
-            if (!ifs) {
-                throw HspError(ERR_FILE_IO, "noteload: ファイルを開けません", location);
-            }
-
-            ifs.seekg(0, std::ios::end);
-            std::streamoff size = ifs.tellg();
-            if (size < 0) size = 0;
-            ifs.seekg(0, std::ios::beg);
-
-            size_t readSize = static_cast<size_t>(size);
-            if (maxBytes >= 0 && readSize > static_cast<size_t>(maxBytes)) {
-                readSize = static_cast<size_t>(maxBytes);
-            }
-
-            std::string data(readSize, '\0');
-            if (readSize > 0) {
-                ifs.read(data.data(), static_cast<std::streamsize>(readSize));
-                if (ifs.gcount() < static_cast<std::streamsize>(readSize)) {
-                    data.resize(static_cast<size_t>(ifs.gcount()));
-                }
-            }
-
-            buffer = std::move(data);
+            // マップした内容を1回だけコピーする（ストリーム経由の読み込みを行わない）
+            std::string_view mapped;
+            const size_t limit = (maxBytes > 0) ? static_cast<size_t>(maxBytes) : 0;
+            std::shared_ptr<void> mapping = mapNoteFile(filename, limit, mapped, location);
+            buffer.assign(mapped);
         });
     }
 
@@ -1178,194 +1692,59 @@ namespace hsppp {
     // 文字列変換関数（HSP hsp3utf.as互換）
     // ============================================================
     // HSPPPは内部的にUTF-8を使用。外部DLLやCOMとの連携時に使用。
-    // Windows API (MultiByteToWideChar / WideCharToMultiByte) を使用
+    // 変換本体は Transcode.cpp（ASCII区間はSSE2で一括処理、CP932は表引き）
+    // 不正なシーケンスは例外にせず置換文字に置き換える
     // ============================================================
 
-    namespace {
-        // wstring -> u16string 変換ヘルパー
-        // wchar_tのサイズに応じて最適な変換を行う
-        std::u16string wstringToU16string(const std::wstring& wideStr) {
-            if (wideStr.empty()) {
-                return std::u16string();
-            }
-
-            // Case 1: wchar_t が 2バイト (Windows / UTF-16)
-            // メモリレイアウトが同じなので、ビット列をそのままコピーするだけでOK（爆速）
-            if constexpr (sizeof(wchar_t) == 2) {
-                return std::u16string(
-                    reinterpret_cast<const char16_t*>(wideStr.data()),
-                    wideStr.size()
-                );
-            }
-            // Case 2: wchar_t が 4バイト (Linux, macOS / UTF-32)
-            // UTF-32 -> UTF-16 への変換（サロゲートペア計算）が必要
-            else {
-                std::u16string u16str;
-                u16str.reserve(wideStr.size());
-
-                for (wchar_t wc : wideStr) {
-                    uint32_t codepoint = static_cast<uint32_t>(wc);
-
-                    if (codepoint <= 0xFFFF) {
-                        // 基本多言語面 (BMP)
-                        u16str.push_back(static_cast<char16_t>(codepoint));
-                    } else if (codepoint <= 0x10FFFF) {
-                        // サロゲートペアが必要な文字 (絵文字など)
-                        codepoint -= 0x10000;
-                        u16str.push_back(static_cast<char16_t>(0xD800 | (codepoint >> 10)));
-                        u16str.push_back(static_cast<char16_t>(0xDC00 | (codepoint & 0x3FF)));
-                    } else {
-                        // 無効なコードポイント (置換文字 U+FFFD を入れる)
-                        u16str.push_back(u'\uFFFD');
-                    }
-                }
-                return u16str;
-            }
-        }
-
-        // u16string -> wstring 変換ヘルパー
-        std::wstring u16stringToWstring(const std::u16string& u16str) {
-            if (u16str.empty()) {
-                return std::wstring();
-            }
-
-            // Case 1: wchar_t が 2バイト (Windows / UTF-16)
-            if constexpr (sizeof(wchar_t) == 2) {
-                return std::wstring(
-                    reinterpret_cast<const wchar_t*>(u16str.data()),
-                    u16str.size()
-                );
-            }
-            // Case 2: wchar_t が 4バイト (Linux, macOS / UTF-32)
-            // UTF-16 -> UTF-32 への変換（サロゲートペアの結合）が必要
-            else {
-                std::wstring wstr;
-                wstr.reserve(u16str.size());
-
-                for (size_t i = 0; i < u16str.size(); ++i) {
-                    char16_t c = u16str[i];
-
-                    if (c >= 0xD800 && c <= 0xDBFF && i + 1 < u16str.size()) {
-                        // ハイサロゲート
-                        char16_t high = c;
-                        char16_t low = u16str[i + 1];
-                        if (low >= 0xDC00 && low <= 0xDFFF) {
-                            // ローサロゲートと結合
-                            uint32_t codepoint = 0x10000 +
-                                ((static_cast<uint32_t>(high) - 0xD800) << 10) +
-                                (static_cast<uint32_t>(low) - 0xDC00);
-                            wstr.push_back(static_cast<wchar_t>(codepoint));
-                            ++i;  // ローサロゲートをスキップ
-                            continue;
-                        }
-                    }
-                    // BMPまたは単独のサロゲート（エラーケース）
-                    wstr.push_back(static_cast<wchar_t>(c));
-                }
-                return wstr;
-            }
-        }
-    }
-
     std::u16string cnvstow(const std::string& str, const std::source_location& location) {
-        return safe_call(location, [&]() -> std::u16string {
-            if (str.empty()) {
-                return std::u16string();
-            }
-
-            // UTF-8 -> UTF-16 (Windows: wchar_t = UTF-16 LE)
-            int wideLen = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), static_cast<int>(str.size()), nullptr, 0);
-            if (wideLen <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvstow: UTF-8からUTF-16への変換に失敗しました", location);
-            }
-
-            std::wstring wideStr(static_cast<size_t>(wideLen), L'\0');
-            int result = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), static_cast<int>(str.size()), wideStr.data(), wideLen);
-            if (result <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvstow: UTF-8からUTF-16への変換に失敗しました", location);
-            }
-
-            // wchar_t -> char16_t (constexpr ifで最適化)
-            return wstringToU16string(wideStr);
-        });
+        std::u16string result;
+        cnvstow_into(result, str, location);
+        return result;
     }
 
     std::string cnvwtos(const std::u16string& wstr, const std::source_location& location) {
-        return safe_call(location, [&]() -> std::string {
-            if (wstr.empty()) {
-                return std::string();
-            }
-
-            // char16_t -> wchar_t (constexpr ifで最適化)
-            std::wstring wideStr = u16stringToWstring(wstr);
-
-            // UTF-16 -> UTF-8
-            int utf8Len = WideCharToMultiByte(CP_UTF8, 0, wideStr.c_str(), static_cast<int>(wideStr.size()), nullptr, 0, nullptr, nullptr);
-            if (utf8Len <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvwtos: UTF-16からUTF-8への変換に失敗しました", location);
-            }
-
-            std::string utf8Str(static_cast<size_t>(utf8Len), '\0');
-            int result = WideCharToMultiByte(CP_UTF8, 0, wideStr.c_str(), static_cast<int>(wideStr.size()), utf8Str.data(), utf8Len, nullptr, nullptr);
-            if (result <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvwtos: UTF-16からUTF-8への変換に失敗しました", location);
-            }
-
-            return utf8Str;
-        });
+        std::string result;
+        cnvwtos_into(result, wstr, location);
+        return result;
     }
 
     std::string cnvstoa(const std::string& str, const std::source_location& location) {
-        return safe_call(location, [&]() -> std::string {
-            if (str.empty()) {
-                return std::string();
-            }
-
-            // UTF-8 -> UTF-16 -> ANSI (ShiftJIS)
-            // Step 1: UTF-8 -> UTF-16 (cnvstowを再利用)
-            std::u16string u16str = cnvstow(str, location);
-
-            // Step 1.5: u16string -> wstring (constexpr ifで最適化)
-            std::wstring wideStr = u16stringToWstring(u16str);
-
-            // Step 2: UTF-16 -> ANSI (CP_ACP = system default ANSI code page, typically ShiftJIS on Japanese Windows)
-            int ansiLen = WideCharToMultiByte(CP_ACP, 0, wideStr.c_str(), static_cast<int>(wideStr.size()), nullptr, 0, nullptr, nullptr);
-            if (ansiLen <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvstoa: UTF-16からANSIへの変換に失敗しました", location);
-            }
+        std::string result;
+        cnvstoa_into(result, str, location);
+        return result;
+    }
 
-            std::string ansiStr(static_cast<size_t>(ansiLen), '\0');
-            int result = WideCharToMultiByte(CP_ACP, 0, wideStr.c_str(), static_cast<int>(wideStr.size()), ansiStr.data(), ansiLen, nullptr, nullptr);
-            if (result <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvstoa: UTF-16からANSIへの変換に失敗しました", location);
-            }
+    std::string cnvatos(const std::string& astr, const std::source_location& location) {
+        std::string result;
+        cnvatos_into(result, astr, location);
+        return result;
+    }
 
-            return ansiStr;
+    std::u16string& cnvstow_into(std::u16string& dest, std::string_view str, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::u16string& {
+            internal::Utf8ToUtf16Into(str, dest);
+            return dest;
         });
     }
 
-    std::string cnvatos(const std::string& astr, const std::source_location& location) {
-        return safe_call(location, [&]() -> std::string {
-            if (astr.empty()) {
-                return std::string();
-            }
-
-            // ANSI (ShiftJIS) -> UTF-16 -> UTF-8
-            // Step 1: ANSI -> UTF-16
-            int wideLen = MultiByteToWideChar(CP_ACP, 0, astr.c_str(), static_cast<int>(astr.size()), nullptr, 0);
-            if (wideLen <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvatos: ANSIからUTF-16への変換に失敗しました", location);
-            }
+    std::string& cnvwtos_into(std::string& dest, std::u16string_view wstr, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::string& {
+            internal::Utf16ToUtf8Into(wstr, dest);
+            return dest;
+        });
+    }
 
-            std::wstring wideStr(static_cast<size_t>(wideLen), L'\0');
-            int result1 = MultiByteToWideChar(CP_ACP, 0, astr.c_str(), static_cast<int>(astr.size()), wideStr.data(), wideLen);
-            if (result1 <= 0) {
-                throw HspError(ERR_TYPE_MISMATCH, "cnvatos: ANSIからUTF-16への変換に失敗しました", location);
-            }
+    std::string& cnvstoa_into(std::string& dest, std::string_view str, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::string& {
+            internal::Utf8ToCp932Into(str, dest);
+            return dest;
+        });
+    }
 
-            // Step 2: UTF-16 -> UTF-8 (cnvwtosを再利用)
-            std::u16string u16str = wstringToU16string(wideStr);
-            return cnvwtos(u16str, location);
+    std::string& cnvatos_into(std::string& dest, std::string_view astr, const std::source_location& location) {
+        return safe_call(location, [&]() -> std::string& {
+            internal::Cp932ToUtf8Into(astr, dest);
+            return dest;
         });
     }
 
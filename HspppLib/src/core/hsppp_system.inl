@@ -16,17 +16,12 @@ namespace hsppp {
         // ============================================================
         // ヘルパー関数: UTF-16からUTF-8への変換
         // ============================================================
+        // NULL終端の Win32 文字列用（nullptr は空文字列）
         inline std::string WideToUtf8(const wchar_t* wideString) {
-            if (!wideString || wideString[0] == L'\0') {
+            if (!wideString) {
                 return "";
             }
-            int len = WideCharToMultiByte(CP_UTF8, 0, wideString, -1, nullptr, 0, nullptr, nullptr);
-            if (len > 0) {
-                std::string result(len - 1, '\0');
-                WideCharToMultiByte(CP_UTF8, 0, wideString, -1, result.data(), len, nullptr, nullptr);
-                return result;
-            }
-            return "";
+            return WideToUtf8(std::wstring_view(wideString));
         }
     }  // namespace internal
 
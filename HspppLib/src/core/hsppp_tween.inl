@@ -0,0 +1,353 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/hsppp_tween.inl
+// Timeline（トゥイーン管理）の実装
+//
+// トゥイーンはイージングタイプ（ease_loop の有無を含む）ごとのバケットに SoA で詰めて保持する。
+// update() はバケットごとに「経過時間を進めて進行値を計算 → Easing のバッチ評価 → 値の書き込み」を
+// 分岐なしのループで行い、完了したトゥイーンだけをスロット経由で後処理する
+
+namespace hsppp {
+
+    namespace {
+        constexpr uint32_t kNoTweenSlot = UINT32_MAX;
+        constexpr int kTweenBucketCount = kEaseTypeCount * 2;
+
+        enum TweenSlotState : uint8_t {
+            kTweenFree = 0,
+            kTweenRunning = 1,
+            kTweenWaiting = 2,
+        };
+
+        // 不明なタイプは Easing と同じくリニアとして扱う
+        int tweenBucketIndex(int type) noexcept {
+            int baseType = type & ~ease_loop;
+            if (baseType < 0 || baseType >= kEaseTypeCount) {
+                baseType = ease_linear;
+            }
+            return (type & ease_loop) != 0 ? baseType + kEaseTypeCount : baseType;
+        }
+
+        int tweenBucketType(int bucket) noexcept {
+            return bucket >= kEaseTypeCount ? (bucket - kEaseTypeCount) | ease_loop : bucket;
+        }
+    }
+
+    TweenHandle Timeline::add(double* target, double from, double to, double duration,
+                              int type, TweenOptions options, const std::source_location& location) {
+        const bool isLoop = (type & ease_loop) != 0;
+        if (!(duration >= 0.0) || (isLoop && duration == 0.0)) {
+            throw HspError(ERR_OUT_OF_RANGE, std::format("Timeline::add: 所要時間が不正です（{}）", duration), location);
+        }
+        if (!(options.delay >= 0.0) || options.repeat < -1) {
+            throw HspError(ERR_OUT_OF_RANGE, "Timeline::add: delay または repeat が不正です", location);
+        }
+
+        return safe_call(location, [&] {
+            uint32_t slotIndex;
+            if (!m_freeSlots.empty()) {
+                slotIndex = m_freeSlots.back();
+                m_freeSlots.pop_back();
+            } else {
+                slotIndex = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+            Slot& slot = m_slots[slotIndex];
+            slot.to = to;
+            slot.repeat = options.repeat;
+            slot.onComplete = std::move(options.on_complete);
+            ++m_count;
+
+            // 前のトゥイーンが有効なら完了まで待機（完了済み・無効なハンドルならすぐに開始）
+            if (active(options.after)) {
+                const uint32_t leader = options.after.slot;
+                slot.state = kTweenWaiting;
+                slot.position = static_cast<uint32_t>(m_pending.size());
+                slot.leader = leader;
+                slot.nextFollower = m_slots[leader].firstFollower;
+                m_slots[leader].firstFollower = slotIndex;
+                m_pending.push_back({ slotIndex, target, from, duration, options.delay, type });
+            } else {
+                start(slotIndex, target, from, duration, -options.delay, type);
+            }
+            return TweenHandle{ slotIndex, m_slots[slotIndex].generation };
+        });
+    }
+
+    void Timeline::start(uint32_t slotIndex, double* target, double from, double duration, double elapsed, int type) {
+        if (m_buckets.empty()) {
+            m_buckets.resize(kTweenBucketCount);
+        }
+        const int bucketIndex = tweenBucketIndex(type);
+        Bucket& bucket = m_buckets[static_cast<size_t>(bucketIndex)];
+        Slot& slot = m_slots[slotIndex];
+        slot.state = kTweenRunning;
+        slot.bucket = static_cast<uint8_t>(bucketIndex);
+        slot.position = static_cast<uint32_t>(bucket.slot.size());
+
+        bucket.elapsed.push_back(elapsed);
+        bucket.duration.push_back(duration);
+        bucket.invDuration.push_back(duration > 0.0 ? 1.0 / duration : 0.0);
+        bucket.from.push_back(from);
+        bucket.delta.push_back(slot.to - from);
+        bucket.value.push_back(from);
+        bucket.target.push_back(target);
+        bucket.slot.push_back(slotIndex);
+    }
+
+    void Timeline::update(double dt) {
+        m_finished.clear();
+
+        for (int b = 0; b < static_cast<int>(m_buckets.size()); ++b) {
+            Bucket& bucket = m_buckets[static_cast<size_t>(b)];
+            const size_t count = bucket.slot.size();
+            if (count == 0) {
+                continue;
+            }
+            double* elapsed = bucket.elapsed.data();
+            double* value = bucket.value.data();
+            const double* invDuration = bucket.invDuration.data();
+            const double* from = bucket.from.data();
+            const double* delta = bucket.delta.data();
+
+            // 進行値（遅延中は 0）
+            for (size_t i = 0; i < count; ++i) {
+                const double e = elapsed[i] + dt;
+                elapsed[i] = e;
+                value[i] = std::max(e, 0.0) * invDuration[i];
+            }
+
+            const Easing curve(0.0, 1.0, tweenBucketType(b));
+            curve.evaluate(bucket.value, bucket.value);
+
+            for (size_t i = 0; i < count; ++i) {
+                value[i] = from[i] + delta[i] * value[i];
+            }
+
+            // 書き込みは開始後のみ（遅延中のトゥイーンが同じ変数を使う前のトゥイーンを上書きしないように）
+            double* const* target = bucket.target.data();
+            for (size_t i = 0; i < count; ++i) {
+                if (target[i] != nullptr && elapsed[i] >= 0.0) {
+                    *target[i] = value[i];
+                }
+            }
+
+            if (b < kEaseTypeCount) {
+                const double* duration = bucket.duration.data();
+                for (size_t i = 0; i < count; ++i) {
+                    if (elapsed[i] >= duration[i]) {
+                        m_finished.push_back(bucket.slot[i]);
+                    }
+                }
+            }
+        }
+
+        // 完了処理（バケット内の位置はスロット経由で引くため、途中で詰め直しても問題ない）
+        for (uint32_t slotIndex : m_finished) {
+            Slot& slot = m_slots[slotIndex];
+            Bucket& bucket = m_buckets[slot.bucket];
+            const uint32_t pos = slot.position;
+            if (slot.repeat != 0) {
+                if (slot.repeat > 0) {
+                    --slot.repeat;
+                }
+                const double duration = bucket.duration[pos];
+                bucket.elapsed[pos] = duration > 0.0 ? std::fmod(bucket.elapsed[pos] - duration, duration) : 0.0;
+                continue;
+            }
+            finish(slotIndex);
+        }
+
+        // コールバックは状態の更新がすべて終わってから呼ぶ（コールバック内での add/remove を許可）
+        if (!m_callbacks.empty()) {
+            std::vector<std::function<void()>> callbacks;
+            callbacks.swap(m_callbacks);
+            for (auto& callback : callbacks) {
+                callback();
+            }
+            callbacks.clear();
+            if (m_callbacks.empty()) {
+                m_callbacks.swap(callbacks);
+            }
+        }
+    }
+
+    void Timeline::finish(uint32_t slotIndex) {
+        Slot& slot = m_slots[slotIndex];
+        Bucket& bucket = m_buckets[slot.bucket];
+        const uint32_t pos = slot.position;
+
+        // 終了値はイージング計算の丸めによらず to と一致させる
+        bucket.value[pos] = slot.to;
+        if (bucket.target[pos] != nullptr) {
+            *bucket.target[pos] = slot.to;
+        }
+        const double overshoot = bucket.elapsed[pos] - bucket.duration[pos];
+        if (slot.onComplete) {
+            m_callbacks.push_back(std::move(slot.onComplete));
+        }
+        startFollowers(slotIndex, overshoot);
+        detach(slotIndex);
+        releaseSlot(slotIndex);
+    }
+
+    void Timeline::startFollowers(uint32_t slotIndex, double overshoot) {
+        uint32_t follower = m_slots[slotIndex].firstFollower;
+        m_slots[slotIndex].firstFollower = kNoTweenSlot;
+        while (follower != kNoTweenSlot) {
+            Slot& slot = m_slots[follower];
+            const uint32_t next = slot.nextFollower;
+            const Pending pending = m_pending[slot.position];
+
+            // 待機リストから外す（末尾と入れ替え）
+            m_pending[slot.position] = m_pending.back();
+            m_slots[m_pending[slot.position].slot].position = slot.position;
+            m_pending.pop_back();
+            slot.leader = kNoTweenSlot;
+            slot.nextFollower = kNoTweenSlot;
+
+            // 前のトゥイーンの超過時間を引き継ぐ
+            start(follower, pending.target, pending.from, pending.duration, overshoot - pending.delay, pending.type);
+            follower = next;
+        }
+    }
+
+    void Timeline::detach(uint32_t slotIndex) {
+        Slot& slot = m_slots[slotIndex];
+        const uint32_t pos = slot.position;
+
+        if (slot.state == kTweenRunning) {
+            Bucket& bucket = m_buckets[slot.bucket];
+            const size_t last = bucket.slot.size() - 1;
+            if (pos != last) {
+                bucket.elapsed[pos] = bucket.elapsed[last];
+                bucket.duration[pos] = bucket.duration[last];
+                bucket.invDuration[pos] = bucket.invDuration[last];
+                bucket.from[pos] = bucket.from[last];
+                bucket.delta[pos] = bucket.delta[last];
+                bucket.value[pos] = bucket.value[last];
+                bucket.target[pos] = bucket.target[last];
+                bucket.slot[pos] = bucket.slot[last];
+                m_slots[bucket.slot[pos]].position = pos;
+            }
+            bucket.elapsed.pop_back();
+            bucket.duration.pop_back();
+            bucket.invDuration.pop_back();
+            bucket.from.pop_back();
+            bucket.delta.pop_back();
+            bucket.value.pop_back();
+            bucket.target.pop_back();
+            bucket.slot.pop_back();
+        } else if (slot.state == kTweenWaiting) {
+            m_pending[pos] = m_pending.back();
+            m_slots[m_pending[pos].slot].position = pos;
+            m_pending.pop_back();
+
+            // 前のトゥイーンの後続リストから外す
+            uint32_t* link = &m_slots[slot.leader].firstFollower;
+            while (*link != kNoTweenSlot && *link != slotIndex) {
+                link = &m_slots[*link].nextFollower;
+            }
+            if (*link == slotIndex) {
+                *link = slot.nextFollower;
+            }
+        }
+    }
+
+    void Timeline::releaseSlot(uint32_t slotIndex) {
+        Slot& slot = m_slots[slotIndex];
+        ++slot.generation;
+        slot.state = kTweenFree;
+        slot.leader = kNoTweenSlot;
+        slot.firstFollower = kNoTweenSlot;
+        slot.nextFollower = kNoTweenSlot;
+        slot.onComplete = nullptr;
+        m_freeSlots.push_back(slotIndex);
+        --m_count;
+    }
+
+    bool Timeline::remove(TweenHandle handle) {
+        if (!active(handle)) {
+            return false;
+        }
+        const uint32_t root = handle.slot;
+        detach(root);
+
+        // 後続（さらにその後続も含む）を解放する
+        // 後続は leader / firstFollower / nextFollower の木になっているため、作業用の配列を使わず
+        // 帰りがけ順に辿る（解放で消えるリンクは、そのスロットを解放する前に読んでおく）
+        const auto deepestFirst = [this](uint32_t slotIndex) {
+            while (m_slots[slotIndex].firstFollower != kNoTweenSlot) {
+                slotIndex = m_slots[slotIndex].firstFollower;
+            }
+            return slotIndex;
+        };
+        const bool hasFollowers = m_slots[root].firstFollower != kNoTweenSlot;
+        uint32_t slotIndex = hasFollowers ? deepestFirst(m_slots[root].firstFollower) : kNoTweenSlot;
+        while (slotIndex != kNoTweenSlot) {
+            const Slot& slot = m_slots[slotIndex];
+            const uint32_t next = (slot.nextFollower != kNoTweenSlot) ? deepestFirst(slot.nextFollower)
+                                : (slot.leader != root) ? slot.leader : kNoTweenSlot;
+            releaseSlot(slotIndex);
+            slotIndex = next;
+        }
+        releaseSlot(root);
+
+        // 解放した後続を待機リストからその場で取り除き、残りの位置を詰め直す
+        if (hasFollowers) {
+            std::erase_if(m_pending, [this](const Pending& pending) { return m_slots[pending.slot].state == kTweenFree; });
+            for (uint32_t i = 0; i < static_cast<uint32_t>(m_pending.size()); ++i) {
+                m_slots[m_pending[i].slot].position = i;
+            }
+        }
+        return true;
+    }
+
+    void Timeline::clear() {
+        for (Bucket& bucket : m_buckets) {
+            bucket = Bucket{};
+        }
+        m_pending.clear();
+        m_freeSlots.clear();
+        m_freeSlots.reserve(m_slots.size());
+        for (uint32_t i = static_cast<uint32_t>(m_slots.size()); i-- > 0;) {
+            Slot& slot = m_slots[i];
+            if (slot.state != kTweenFree) {
+                ++slot.generation;
+            }
+            slot.state = kTweenFree;
+            slot.leader = kNoTweenSlot;
+            slot.firstFollower = kNoTweenSlot;
+            slot.nextFollower = kNoTweenSlot;
+            slot.onComplete = nullptr;
+            m_freeSlots.push_back(i);
+        }
+        m_count = 0;
+    }
+
+    bool Timeline::active(TweenHandle handle) const noexcept {
+        return handle.slot < m_slots.size()
+            && m_slots[handle.slot].generation == handle.generation
+            && m_slots[handle.slot].state != kTweenFree;
+    }
+
+    double Timeline::value(TweenHandle handle, const std::source_location& location) const {
+        if (!active(handle)) {
+            throw HspError(ERR_INVALID_HANDLE, "Timeline::value: 無効なトゥイーンです（完了済みまたは削除済み）", location);
+        }
+        const Slot& slot = m_slots[handle.slot];
+        if (slot.state == kTweenWaiting) {
+            return m_pending[slot.position].from;
+        }
+        return m_buckets[slot.bucket].value[slot.position];
+    }
+
+    size_t Timeline::size() const noexcept {
+        return m_count;
+    }
+
+} // namespace hsppp
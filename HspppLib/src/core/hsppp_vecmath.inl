@@ -0,0 +1,152 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppLib/src/core/hsppp_vecmath.inl
+// ベクトル演算の実装（grect の行列版、点・Quad の一括変換）
+// このファイルは hsppp.cpp から #include される
+
+namespace hsppp {
+
+    // ============================================================
+    // 一括変換カーネル
+    // ============================================================
+    // SSE2 では2点（x, y, x, y）を1レジスタで処理する。
+    // 演算の順序は Mat3::transform_point / Vec2::to_point と同じにしてあり、結果はスカラー版と一致する
+
+    namespace {
+
+        static_assert(sizeof(Vec2) == sizeof(float) * 2, "Vec2 は float 2個を詰めて並べる必要がある");
+        static_assert(sizeof(Point2i) == sizeof(int) * 2, "Point2i は int 2個を詰めて並べる必要がある");
+        static_assert(sizeof(Quad) == sizeof(Point2i) * Quad::vertex_count, "Quad は Point2i 4個を詰めて並べる必要がある");
+
+        inline int roundToInt(float v) noexcept {
+            return static_cast<int>(v < 0.0f ? v - 0.5f : v + 0.5f);
+        }
+
+#ifdef HSPPP_HAS_SSE2
+        // 2点分の係数を並べた定数
+        struct TransformLanes {
+            __m128 c0, c1, t;       // x' = c0 * x + c1 * y + t（x / y 成分が交互に並ぶ）
+            __m128 w0, w1, wt;      // w = w0 * x + w1 * y + wt（射影変換のみ）
+            bool affine;
+
+            explicit TransformLanes(const Mat3& m) noexcept
+                : c0(_mm_setr_ps(m.m[0][0], m.m[1][0], m.m[0][0], m.m[1][0]))
+                , c1(_mm_setr_ps(m.m[0][1], m.m[1][1], m.m[0][1], m.m[1][1]))
+                , t(_mm_setr_ps(m.m[0][2], m.m[1][2], m.m[0][2], m.m[1][2]))
+                , w0(_mm_set1_ps(m.m[2][0]))
+                , w1(_mm_set1_ps(m.m[2][1]))
+                , wt(_mm_set1_ps(m.m[2][2]))
+                , affine(m.is_affine()) {}
+
+            // v = (x0, y0, x1, y1)
+            __m128 apply(__m128 v) const noexcept {
+                const __m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+                const __m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+                const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, c0), _mm_mul_ps(yy, c1)), t);
+                if (affine) {
+                    return r;
+                }
+                const __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, w0), _mm_mul_ps(yy, w1)), wt);
+                return _mm_div_ps(r, w);
+            }
+
+            // 整数座標2点を変換して四捨五入（0.5 は 0 から遠い方へ）
+            __m128i applyInt(__m128i p) const noexcept {
+                const __m128 r = apply(_mm_cvtepi32_ps(p));
+                const __m128 half = _mm_or_ps(_mm_and_ps(r, _mm_set1_ps(-0.0f)), _mm_set1_ps(0.5f));
+                return _mm_cvttps_epi32(_mm_add_ps(r, half));
+            }
+        };
+#endif
+
+        void transformFloatPoints(const Mat3& matrix, const Vec2* src, Vec2* dst, size_t count) noexcept {
+            size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+            const TransformLanes lanes(matrix);
+            const float* in = &src[0].x;
+            float* out = &dst[0].x;
+            for (; i + 4 <= count; i += 4) {
+                const __m128 a = _mm_loadu_ps(in + i * 2);
+                const __m128 b = _mm_loadu_ps(in + i * 2 + 4);
+                _mm_storeu_ps(out + i * 2, lanes.apply(a));
+                _mm_storeu_ps(out + i * 2 + 4, lanes.apply(b));
+            }
+#endif
+            for (; i < count; ++i) {
+                dst[i] = matrix.transform_point(src[i]);
+            }
+        }
+
+        void transformIntPoints(const Mat3& matrix, const Point2i* src, Point2i* dst, size_t count) noexcept {
+            size_t i = 0;
+#ifdef HSPPP_HAS_SSE2
+            const TransformLanes lanes(matrix);
+            const int* in = &src[0].x;
+            int* out = &dst[0].x;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2));
+                const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 2 + 4));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2), lanes.applyInt(a));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 2 + 4), lanes.applyInt(b));
+            }
+#endif
+            for (; i < count; ++i) {
+                const Vec2 p = matrix.transform_point(Vec2(src[i]));
+                dst[i] = { roundToInt(p.x), roundToInt(p.y) };
+            }
+        }
+
+        void checkTransformSpanSize(size_t dstSize, size_t srcSize, const std::source_location& location) {
+            if (dstSize != srcSize) {
+                throw HspError(ERR_OUT_OF_RANGE,
+                    std::format("transform: 出力配列の要素数が入力と一致しません（{} / {}）", dstSize, srcSize), location);
+            }
+        }
+
+    } // namespace
+
+    // ============================================================
+    // 描画命令との連携
+    // ============================================================
+
+    void grect_transform(const Mat3& matrix, int w, int h, const std::source_location& location) {
+        // 平行移動・回転・拡大率に分解して grect に渡す（せん断は無視）
+        const Point2i center = matrix.transform_point({ 0.0f, 0.0f }).to_point();
+        const double angle = std::atan2(matrix.m[1][0], matrix.m[0][0]);
+        const double scaleX = std::hypot(matrix.m[0][0], matrix.m[1][0]);
+        const double scaleY = std::hypot(matrix.m[0][1], matrix.m[1][1]);
+        grect(center.x, center.y, angle,
+              static_cast<int>(std::lround(w * scaleX)), static_cast<int>(std::lround(h * scaleY)), location);
+    }
+
+    // ============================================================
+    // 一括変換
+    // ============================================================
+
+    void transform(const Mat3& matrix, std::span<const Vec2> src, std::span<Vec2> dst, const std::source_location& location) {
+        checkTransformSpanSize(dst.size(), src.size(), location);
+        if (!src.empty()) {
+            transformFloatPoints(matrix, src.data(), dst.data(), src.size());
+        }
+    }
+
+    void transform(const Mat3& matrix, std::span<const Point2i> src, std::span<Point2i> dst, const std::source_location& location) {
+        checkTransformSpanSize(dst.size(), src.size(), location);
+        if (!src.empty()) {
+            transformIntPoints(matrix, src.data(), dst.data(), src.size());
+        }
+    }
+
+    void transform(const Mat3& matrix, std::span<const Quad> src, std::span<Quad> dst, const std::source_location& location) {
+        checkTransformSpanSize(dst.size(), src.size(), location);
+        // Quad は Point2i 4個を詰めた構造体なので、配列全体を頂点の列として変換する
+        if (!src.empty()) {
+            transformIntPoints(matrix, src.data()->v, dst.data()->v, src.size() * Quad::vertex_count);
+        }
+    }
+
+} // namespace hsppp
@@ -0,0 +1,94 @@
+// Source: https://github.com/Velgail/HspppLib
+// Distributed under the Boost Software License, Version 1.0.
+// See accompanying file LICENSE or copy at
+// https://www.boost.org/LICENSE_1_0.txt
+// SPDX-License-Identifier: BSL-1.0
+
+// HspppPack/PackMain.cpp
+// ═══════════════════════════════════════════════════════════════════
+// パックファイル作成ツール
+//   HspppPack <出力.hpk> <ディレクトリ> [--store] [--level N] [--align N]
+//     --store     圧縮せずに格納する（読み込み時にマップ上を直接参照できる）
+//     --level N   圧縮の強さ（1〜12、既定 1。大きいほど小さく、作成に時間がかかる）
+//     --align N   各ファイルの先頭の境界（2の累乗、既定 16）
+// 結果は logmes に出力し、終了コードは成功時 0・失敗時 1
+// ═══════════════════════════════════════════════════════════════════
+
+import hsppp;
+import <string>;
+import <vector>;
+using namespace hsppp;
+
+namespace {
+
+    constexpr const char* kUsage =
+        "HspppPack <出力.hpk> <ディレクトリ> [--store] [--level N] [--align N]\n"
+        "  --store     圧縮せずに格納する\n"
+        "  --level N   圧縮の強さ（1〜12、既定 1）\n"
+        "  --align N   各ファイルの先頭の境界（2の累乗、既定 16）";
+
+    // コマンドラインを引数に分ける（"..." で空白を含む引数を指定できる）
+    // 先頭の実行ファイル名は除く
+    std::vector<std::string> splitArguments(const std::string& cmdline) {
+        std::vector<std::string> args;
+        std::string current;
+        bool quoted = false;
+        bool hasToken = false;
+        for (char c : cmdline) {
+            if (c == '"') {
+                quoted = !quoted;
+                hasToken = true;
+            } else if ((c == ' ' || c == '\t') && !quoted) {
+                if (hasToken) {
+                    args.push_back(current);
+                    current.clear();
+                    hasToken = false;
+                }
+            } else {
+                current += c;
+                hasToken = true;
+            }
+        }
+        if (hasToken) {
+            args.push_back(current);
+        }
+        if (!args.empty()) {
+            args.erase(args.begin());
+        }
+        return args;
+    }
+
+}
+
+void hspMain() {
+    const std::vector<std::string> args = splitArguments(dir_cmdline());
+
+    std::vector<std::string> paths;
+    PackParams params;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if (args[i] == "--store") {
+            params.compress = false;
+        } else if (args[i] == "--level" && i + 1 < args.size()) {
+            params.level = toInt(args[++i]);
+        } else if (args[i] == "--align" && i + 1 < args.size()) {
+            params.alignment = toInt(args[++i]);
+        } else {
+            paths.push_back(args[i]);
+        }
+    }
+
+    if (paths.size() != 2) {
+        dialog(kUsage, 0, "HspppPack");
+        end(1);
+    }
+
+    try {
+        const int count = packbuild(paths[0], paths[1], params);
+        logmes(strf("%s: %d ファイルを格納しました", paths[0], count));
+    } catch (const HspError& e) {
+        logmes(e.what());
+        dialog(e.what(), 1, "HspppPack");
+        end(1);
+    }
+    end(0);
+}
@@ -101,6 +101,14 @@ namespace compile_test {
         notesave("note_test_out.txt");
 
         noteunsel();
+
+        // NotePad のメモリマップモード
+        NotePad pad;
+        pad.map("note_test.txt");
+        [[maybe_unused]] bool isMapped = pad.mapped();
+        [[maybe_unused]] std::string_view firstLine = pad.line(0);
+        [[maybe_unused]] std::string_view whole = pad.view();
+        pad.add("detached");  // ここで通常のノートパッドに切り替わる
     }
 
     // ============================================================
@@ -387,6 +395,8 @@ namespace compile_test {
         // サイズ取得
         [[maybe_unused]] int w = cel1.width();
         [[maybe_unused]] int h = cel1.height();
+        [[maybe_unused]] int cw = cel1.cell_width();
+        [[maybe_unused]] int ch = cel1.cell_height();
 
         // メソッドチェーン
         cel1.divide(8, 8);
@@ -676,6 +686,45 @@ namespace compile_test {
         hsppp::randomize(omit);            // 省略
         [[maybe_unused]] int r3 = hsppp::rnd(1000);
 
+        // rnd_fill - 配列を一括で乱数で埋める
+        std::vector<int> rndInts(16);
+        std::vector<double> rndDoubles(16);
+        hsppp::rnd_fill(rndInts, 100);
+        hsppp::rnd_fill(rndDoubles);
+
+        // rndmode - 生成方式の切り替え
+        hsppp::rndmode(rndmode_hsp);
+        hsppp::rndmode(rndmode_fast);
+
+        // Xoshiro256 - 乱数生成器
+        hsppp::Xoshiro256 engine(12345);
+        constexpr hsppp::Xoshiro256 constEngine;
+        [[maybe_unused]] uint64_t raw = engine();
+        [[maybe_unused]] uint32_t bounded = engine.bounded(6);
+        [[maybe_unused]] double unit = engine.uniform();
+        engine.seed(42);
+        engine.jump();
+        engine.long_jump();
+        [[maybe_unused]] hsppp::Xoshiro256 child = engine.split();
+        [[maybe_unused]] bool sameEngine = (engine == constEngine);
+        [[maybe_unused]] hsppp::RandomState engineState = engine.state();
+        engine.set_state(engineState);
+
+        // RandomStream - 用途ごとの独立した乱数列
+        hsppp::RandomStream gameRandom(12345);
+        hsppp::RandomStream particleRandom("particles", 12345);
+        [[maybe_unused]] int sr1 = gameRandom.rnd(6);
+        [[maybe_unused]] double sr2 = particleRandom.rndf();
+        gameRandom.fill(rndInts, 10);
+        gameRandom.fill(rndDoubles);
+        hsppp::RandomState snapshot = gameRandom.save();
+        gameRandom.restore(snapshot);
+        hsppp::RandomStream resumed(snapshot);
+        [[maybe_unused]] hsppp::RandomStream childStream = gameRandom.split();
+        [[maybe_unused]] uint64_t streamRaw = resumed.engine()();
+        gameRandom.seed(1);
+        [[maybe_unused]] bool sameStream = (gameRandom == resumed);
+
         // limit / limitf
         [[maybe_unused]] int lm1 = hsppp::limit(50, 0, 100);       // 50
         [[maybe_unused]] int lm2 = hsppp::limit(-10, 0, 100);      // 0
@@ -733,6 +782,153 @@ namespace compile_test {
         [[maybe_unused]] double ef3 = hsppp::geteasef(1.0, 1.0);
         [[maybe_unused]] double ef4 = hsppp::geteasef(0.5, omit);  // 最大値省略（1.0）
         [[maybe_unused]] double ef5 = hsppp::geteasef(0.5);  // 最大値省略
+
+        // Easing - グローバル状態を使わないイージング曲線
+        constexpr hsppp::Easing easeDefault;
+        constexpr hsppp::Easing easeMove(0.0, 640.0, ease_quad_out);
+        [[maybe_unused]] constexpr int easeType = easeMove.type();
+        [[maybe_unused]] constexpr double easeMin = easeMove.min_value();
+        [[maybe_unused]] constexpr double easeMax = easeMove.max_value();
+        [[maybe_unused]] double ev1 = easeMove.evaluate(0.5);
+        [[maybe_unused]] double ev2 = easeMove(0.5);
+        [[maybe_unused]] double ev3 = easeDefault(0.25);
+
+        // Easing::evaluate - バッチ評価
+        std::vector<double> easeT = {0.0, 0.25, 0.5, 1.0};
+        std::vector<double> easeOut(easeT.size());
+        easeMove.evaluate(easeT, easeOut);
+        easeMove.evaluate(easeT, easeT);  // その場評価
+
+        // EasingTable - 整数版の参照テーブル
+        hsppp::EasingTable table(easeMove);
+        hsppp::EasingTable table100(hsppp::Easing(0, 255, ease_bounce_out | ease_loop), 100);
+        [[maybe_unused]] int et1 = table(2048);
+        [[maybe_unused]] int et2 = table100(150);
+        [[maybe_unused]] int etMax = table.max_value();
+        [[maybe_unused]] const std::vector<int>& etValues = table.values();
+        [[maybe_unused]] const hsppp::Easing& etEasing = table.easing();
+    }
+
+    // ============================================================
+    // トゥイーン（Timeline）のテスト
+    // ============================================================
+    void test_tween_functions() {
+        hsppp::Timeline timeline;
+        double x = 0.0;
+        double y = 0.0;
+
+        // add - 基本形・タイプ指定・オプション指定
+        hsppp::TweenHandle h1 = timeline.add(&x, 0.0, 100.0, 1.0);
+        hsppp::TweenHandle h2 = timeline.add(&y, 0.0, 50.0, 0.5, ease_quad_out);
+        [[maybe_unused]] hsppp::TweenHandle h3 = timeline.add(&x, 100.0, 0.0, 1.0, ease_bounce_out, { .delay = 0.25, .after = h1 });
+        [[maybe_unused]] hsppp::TweenHandle h4 = timeline.add(&y, 0.0, 10.0, 0.5, ease_linear | ease_loop);
+        [[maybe_unused]] hsppp::TweenHandle h5 = timeline.add(nullptr, 0.0, 1.0, 2.0, ease_cubic_inout,
+            { .repeat = -1, .on_complete = [] {} });
+        hsppp::TweenOptions options;
+        options.repeat = 2;
+        [[maybe_unused]] hsppp::TweenHandle h6 = timeline.add(&x, 0.0, 1.0, 1.0, ease_linear, options);
+
+        // update / 状態取得
+        timeline.update(1.0 / 60.0);
+        [[maybe_unused]] bool isActive = timeline.active(h2);
+        [[maybe_unused]] double current = timeline.value(h2);
+        [[maybe_unused]] size_t count = timeline.size();
+        [[maybe_unused]] bool isEmpty = timeline.empty();
+        [[maybe_unused]] bool valid = h1.valid();
+        [[maybe_unused]] bool same = (h1 == h2);
+
+        // remove / clear
+        [[maybe_unused]] bool removed = timeline.remove(h1);
+        timeline.clear();
+    }
+
+    // ============================================================
+    // ベクトル演算のテスト
+    // ============================================================
+    void test_vecmath_functions() {
+        // constexpr で使える
+        constexpr hsppp::Vec2 a(3.0f, 4.0f);
+        constexpr hsppp::Vec2 b = a * 2.0f + hsppp::Vec2(1.0f, 1.0f);
+        static_assert(b.x == 7.0f && b.y == 9.0f);
+        static_assert(a.length_sq() == 25.0f && a.dot(b) == 57.0f);
+        constexpr hsppp::Mat3 moved = hsppp::Mat3::translation(10.0f, 20.0f) * hsppp::Mat3::scaling(2.0f, 2.0f);
+        static_assert(moved.transform_point(a) == hsppp::Vec2(16.0f, 28.0f));
+        static_assert(moved.inverse().transform_point(hsppp::Vec2(16.0f, 28.0f)) == a);
+        constexpr hsppp::Vec4 c(1.0f, 2.0f, 3.0f, 4.0f);
+        static_assert(c.dot(c) == 30.0f && c.zw() == hsppp::Vec2(3.0f, 4.0f));
+
+        [[maybe_unused]] float len = a.length();
+        [[maybe_unused]] hsppp::Vec2 unit = a.normalized();
+        [[maybe_unused]] hsppp::Vec2 turned = a.rotated(hsppp::deg2rad(90.0));
+        [[maybe_unused]] hsppp::Point2i pt = a.to_point();
+        const hsppp::Mat3 m = hsppp::Mat3::translation(320.0f, 240.0f) * hsppp::Mat3::rotation(0.5);
+
+        // 一括変換
+        std::vector<hsppp::Vec2> points(100), moved2(100);
+        std::vector<hsppp::Point2i> ipoints(100);
+        std::vector<hsppp::Quad> quads(10);
+        hsppp::transform(m, points, moved2);
+        hsppp::transform(m, points, points);          // 同じ配列に上書き
+        hsppp::transform(m, ipoints, ipoints);
+        hsppp::transform(m, quads, quads);
+
+        // 描画命令との連携
+        [[maybe_unused]] hsppp::Quad q = hsppp::rect_quad(m, 64.0f, 32.0f);
+        hsppp::grect_transform(m, 64, 32);
+    }
+
+    // ============================================================
+    // 当たり判定のテスト
+    // ============================================================
+    void test_collision_functions() {
+        constexpr hsppp::Aabb a = hsppp::Aabb::from_size({ 0.0f, 0.0f }, { 16.0f, 16.0f });
+        constexpr hsppp::Aabb b = hsppp::Aabb::from_center({ 20.0f, 8.0f }, { 16.0f, 16.0f });
+        static_assert(a.overlaps(b) && !a.overlaps(b.moved({ 4.0f, 0.0f })));
+        static_assert(a.contains({ 0.0f, 0.0f }) && !a.contains({ 16.0f, 0.0f }));
+
+        Cel sprite = loadCel("sprite.png");
+        sprite.divide(4, 4);
+        [[maybe_unused]] hsppp::Aabb hitbox = hsppp::cel_hitbox(sprite, 100.0f, 80.0f, 2.0f);
+
+        std::vector<hsppp::Aabb> boxes(100, a);
+        std::vector<hsppp::Vec2> positions(100);
+        std::vector<uint32_t> found;
+        std::vector<hsppp::CollisionPair> pairs;
+
+        hsppp::SpatialHash hash(32.0f);
+        hash.reserve(200);
+        hash.insert(boxes);
+        [[maybe_unused]] uint32_t body = hash.insert(hitbox);
+        hash.update(body, b);
+        hash.update(boxes, 0);
+        hash.move_to(positions);
+        hash.find_pairs(pairs);
+        hash.query(a, found);
+        hash.query(boxes, pairs);
+        [[maybe_unused]] float cell = hash.cell_size();
+        [[maybe_unused]] hsppp::Aabb first = hash[0];
+        [[maybe_unused]] std::span<const float> lefts = hash.lefts();
+        hash.clear();
+
+        hsppp::SweepAndPrune sweep;
+        sweep.insert(boxes);
+        sweep.move_to(positions, 10);
+        sweep.find_pairs(pairs);
+        sweep.query(b, found);
+        [[maybe_unused]] size_t count = sweep.size();
+
+        // ピクセル単位の判定
+        Cel masked = loadCel("sprite.png", {}, hsppp::MaskParams{ .alpha_threshold = 1, .color_key = 0x000000 });
+        masked.divide(4, 4);
+        [[maybe_unused]] hsppp::PixelMask cellMask = hsppp::cel_mask(masked, 5);
+        std::vector<hsppp::PixelMask> cellMasks = hsppp::cel_masks(masked);
+        [[maybe_unused]] hsppp::PixelMask fileMask = hsppp::load_mask("sprite.png", { .alpha_threshold = 128 });
+        std::vector<uint32_t> pixels(16 * 16, 0xFF000000u);
+        hsppp::PixelMask bgraMask = hsppp::PixelMask::from_bgra(pixels, 16, 16);
+        [[maybe_unused]] bool hit = bgraMask.overlaps(0, 0, cellMasks[0], 8, 8);
+        [[maybe_unused]] bool solid = bgraMask.test(3, 4);
+        [[maybe_unused]] hsppp::Aabb tight = bgraMask.bounds();
+        [[maybe_unused]] std::span<const uint64_t> bits = bgraMask.row(0);
     }
 
     // ============================================================
@@ -770,6 +966,31 @@ namespace compile_test {
         [[maybe_unused]] int idx0 = hsppp::sortget(0);  // 30のソート前位置
         [[maybe_unused]] int idx1 = hsppp::sortget(1);
         [[maybe_unused]] int idx2 = hsppp::sortget(2);
+
+        // SortPermutation - 呼び出しごとの並び替え情報（スレッドセーフ）
+        hsppp::SortPermutation perm;
+        hsppp::sortval(testArr, perm);
+        hsppp::sortval(doubleArr, perm, hsppp::sort_descending);
+        hsppp::sortstr(strArr, perm);
+        hsppp::sortnote(note, perm, 1);
+        [[maybe_unused]] int permIdx = perm.get(0);
+        [[maybe_unused]] int permRaw = perm[0];
+        [[maybe_unused]] size_t permSize = perm.size();
+        [[maybe_unused]] const std::vector<int>& permIndices = perm.indices();
+
+        // 並び替え情報を記録しないソート
+        hsppp::sortval(testArr, hsppp::sort_untracked);
+        hsppp::sortval(doubleArr, hsppp::sort_untracked, 1);
+        hsppp::sortstr(strArr, hsppp::sort_untracked);
+        hsppp::sortnote(note, hsppp::sort_untracked);
+
+        // sort_by_key - 複数の配列を同じ順序で並べ替え
+        std::vector<int> scores = {80, 95, 70};
+        std::vector<std::string> names = {"A", "B", "C"};
+        std::vector<double> times = {1.0, 2.0, 3.0};
+        [[maybe_unused]] hsppp::SortPermutation byScore = hsppp::sort_by_key(scores, hsppp::sort_descending, names, times);
+        hsppp::sort_by_key(names, hsppp::sort_ascending, scores);
+        byScore.apply(times);
     }
 
     // ============================================================
@@ -811,6 +1032,11 @@ namespace compile_test {
         [[maybe_unused]] std::string s2 = hsppp::str(3.14);      // double版
         [[maybe_unused]] std::string s3 = hsppp::str(-42);
         [[maybe_unused]] std::string s4 = hsppp::str(0.0);
+        std::string numBuf;
+        hsppp::str_into(numBuf, 123);                                   // 容量を再利用
+        hsppp::str_into(numBuf, 3.14);
+        hsppp::str_into(numBuf, int64_t{1} << 40);
+        [[maybe_unused]] int i6 = hsppp::toInt(std::string_view("42"));  // string_view も可
 
         // strlen
         [[maybe_unused]] int64_t len1 = hsppp::strlen("Hello");
@@ -843,6 +1069,19 @@ namespace compile_test {
         hsppp::syscolor(5);   // ウィンドウ背景
         hsppp::syscolor(8);   // ウィンドウテキスト
         hsppp::syscolor(15);  // 3D表面
+
+        // 配列の一括変換
+        std::vector<int> hue = { 0, 64, 128 }, sat = { 255, 255, 0 }, val = { 255, 128, 200 };
+        std::vector<int> rgb(3);
+        std::vector<uint32_t> bgra(3);
+        hsppp::hsv_to_rgb(hue, sat, val, rgb);
+        hsppp::rgb_to_hsv(rgb, hue, sat, val);
+        [[maybe_unused]] auto palette = hsppp::hsv_palette(255, 255);
+        hsppp::rgb_to_bgra(rgb, bgra);
+        hsppp::rgb_to_bgra(rgb, bgra, 128);
+        hsppp::bgra_to_rgb(bgra, rgb);
+        hsppp::premultiply_bgra(bgra);
+        hsppp::unpremultiply_bgra(bgra);
     }
 
     // ============================================================
@@ -887,6 +1126,12 @@ namespace compile_test {
         [[maybe_unused]] std::string fmt7 = hsppp::strf("Two: %d, %d", 1, 2);          // "Two: 1, 2"
         [[maybe_unused]] std::string fmt8 = hsppp::strf("Mix: %d, %f", 10, 2.5);       // "Mix: 10, 2.500000"
         [[maybe_unused]] std::string fmt9 = hsppp::strf("Three: %d, %d, %d", 1, 2, 3); // "Three: 1, 2, 3"
+        [[maybe_unused]] std::string fmt10 = hsppp::strf("%s %d %u %.1f %c", "a", 1, 2u, 3.0, 'x');   // 任意個・任意型
+        [[maybe_unused]] std::string fmt11 = hsppp::strf("%lld", int64_t{1} << 40);                   // 64bit整数
+        std::string runtimeFmt = "HP %d/%d";
+        [[maybe_unused]] std::string fmt12 = hsppp::strf(runtimeFmt, 10, 20);                         // 実行時書式
+        std::string fmtDest;
+        hsppp::strf_into(fmtDest, "Score: %d", 100);                                                  // バッファ再利用
 
         // getpath - パスの一部を取得
         std::string testPath = "c:\\disk\\test.bmp";
@@ -931,6 +1176,16 @@ namespace compile_test {
         std::vector<uint8_t> vecBuf = {'A', 'B', 'C', ',', 'D', 'E', 'F', 0};
         [[maybe_unused]] int64_t vlen1 = hsppp::getstr(destStr, vecBuf, 0, ',');     // "ABC", 4
 
+        // StrReader - ストリーミングトークナイザ
+        hsppp::StrReader reader(strBuf);
+        std::string_view token;
+        while (reader.next(token, ',')) {}                                        // "ABC", "DEF", "GHI"
+        hsppp::StrReader vecReader(vecBuf);
+        [[maybe_unused]] int64_t rlen1 = vecReader.read(destStr, ',');           // "ABC", 4
+        [[maybe_unused]] int64_t rpos = vecReader.index();                       // 4
+        [[maybe_unused]] bool reof = vecReader.eof();
+        vecReader.seek(0);
+
         // split - 文字列を分割
         std::vector<std::string> result1 = hsppp::split("12,34,56", ",");        // {"12", "34", "56"}
         [[maybe_unused]] size_t splitCount = result1.size();                      // 3
@@ -971,6 +1226,14 @@ namespace compile_test {
         std::string original = reinterpret_cast<const char*>(u8"テスト文字列");
         [[maybe_unused]] std::string roundTrip1 = hsppp::cnvwtos(hsppp::cnvstow(original));  // UTF-8 -> UTF-16 -> UTF-8
         [[maybe_unused]] std::string roundTrip2 = hsppp::cnvatos(hsppp::cnvstoa(original));  // UTF-8 -> ANSI -> UTF-8
+
+        // バッファ再利用版（_into）
+        std::u16string u16Buf;
+        std::string strBuf;
+        [[maybe_unused]] std::u16string& u16Ref = hsppp::cnvstow_into(u16Buf, std::string_view("Hello"));
+        [[maybe_unused]] std::string& utf8Ref = hsppp::cnvwtos_into(strBuf, std::u16string_view(u16Buf));
+        [[maybe_unused]] std::string& ansiRef = hsppp::cnvstoa_into(strBuf, original);
+        [[maybe_unused]] std::string& utf8Ref2 = hsppp::cnvatos_into(strBuf, ansi_2);
     }
 
     // ============================================================
@@ -1137,12 +1400,27 @@ namespace compile_test {
         // exist - ファイルサイズ取得
         [[maybe_unused]] int64_t size1 = exist("nonexistent_file_12345.txt");  // -1が返る
 
+        // exist_many - 複数ファイルの情報をまとめて取得
+        const std::vector<std::string> statPaths = { "a.png", "b.png", "pack://c.png" };
+        [[maybe_unused]] std::vector<FileStat> stats1 = exist_many(statPaths);
+        std::vector<FileStat> stats2;
+        exist_many(std::span<const std::string>(statPaths).first(2), stats2);
+        [[maybe_unused]] bool statOk = !stats2.empty() && stats2[0].exists() && stats2[0].size + stats2[0].mtime >= 0
+                                       && !stats2[0].directory;
+
         // dirlist - ディレクトリ一覧取得
         [[maybe_unused]] std::vector<std::string> list1 = dirlist("*.*");       // すべてのファイル
         [[maybe_unused]] std::vector<std::string> list2 = dirlist("*.txt", 0);  // .txtファイル
         [[maybe_unused]] std::vector<std::string> list3 = dirlist("*", 1);      // ディレクトリ除外
         [[maybe_unused]] std::vector<std::string> list4 = dirlist("*", 5);      // ディレクトリのみ
 
+        // dirwalk - ディレクトリ以下の並列走査
+        [[maybe_unused]] std::vector<DirEntry> walk1 = dirwalk("assets");
+        [[maybe_unused]] std::vector<DirEntry> walk2 = dirwalk("assets", DirWalkParams{ .mode = 1, .pattern = "*.png;*.jpg" });
+        [[maybe_unused]] int64_t walked = dirwalk("assets", [](const DirEntry& e) {
+            return e.size + e.mtime >= 0 && !e.directory && !e.hidden && !e.path.empty();
+        }, { .recursive = false, .threads = 2, .queue_capacity = 256 });
+
         // dialog - ダイアログ（シグネチャのみ確認）
         [[maybe_unused]] DialogResult res3 = dialog("test", 0);
         [[maybe_unused]] std::string res4 = dialog("txt", 16);
@@ -1167,6 +1445,137 @@ namespace compile_test {
         [[maybe_unused]] int64_t bs4 = bsave("test.bin", vecBuf);
         [[maybe_unused]] int64_t bs5 = bsave("test.bin", vecBuf, 32);
         [[maybe_unused]] int64_t bs6 = bsave("test.bin", vecBuf, 32, 0);
+        [[maybe_unused]] int64_t bs7 = bsave("test.bin", strBuf, {}, {}, SaveParams{ .atomic = true, .flush = true });
+        [[maybe_unused]] int64_t bs8 = bsave("test.bin", vecBuf, 32, 0, SaveParams{ .deferred = true });
+        bflush();
+
+        // peek / poke シグネチャ
+        [[maybe_unused]] int pk1 = peek(vecBuf, 0) + wpeek(vecBuf, 0) + lpeek(vecBuf, 0);
+        [[maybe_unused]] int pk2 = peek(strBuf, 0) + wpeek(strBuf, 0) + lpeek(strBuf, 0);
+        poke(vecBuf, 0, 255);
+        poke(vecBuf, 0, "text");
+        wpoke(strBuf, 0, 0x1234);
+        lpoke(strBuf, 0, -1);
+
+        // BufferReader / BufferWriter
+        struct CompileRecord { int32_t id; float x; float y; };
+        std::vector<uint8_t> serialized;
+        BufferWriter bufWriter(serialized, std::endian::big);
+        bufWriter.write<uint32_t>(0x48535050).write(1.5).write(CompileRecord{ 1, 2.0f, 3.0f });
+        bufWriter.write_varint(300).write_svarint(-5).write_string("name").write_array(std::vector<int16_t>{ 1, 2, 3 });
+        bufWriter.write_bytes(std::span<const uint8_t>(vecBuf)).write_at<uint32_t>(0, 0).seek(bufWriter.size());
+        BufferReader bufReader(serialized, std::endian::big);
+        [[maybe_unused]] uint32_t magic = bufReader.read<uint32_t>();
+        double readDouble = 0.0;
+        bufReader.read(readDouble);
+        [[maybe_unused]] CompileRecord record = bufReader.read<CompileRecord>();
+        [[maybe_unused]] uint64_t readVarint = bufReader.read_varint();
+        [[maybe_unused]] int64_t readSvarint = bufReader.read_svarint();
+        [[maybe_unused]] std::string_view readName = bufReader.read_string(4);
+        std::vector<int16_t> readShorts;
+        bufReader.read_array(readShorts, 3);
+        [[maybe_unused]] std::span<const uint8_t> readRaw = bufReader.read_bytes(bufReader.remaining());
+        [[maybe_unused]] uint16_t readAt = bufReader.read_at<uint16_t>(0);
+        [[maybe_unused]] bool bufDone = bufReader.eof() && bufReader.position() == bufReader.size()
+                                        && bufReader.order() == std::endian::big;
+        bufReader.seek(0).skip(4);
+        [[maybe_unused]] BufferReader textReader(strBuf);
+
+        // bmap シグネチャ
+        [[maybe_unused]] MappedFile map1 = bmap("test.bin");
+        [[maybe_unused]] MappedFile map2 = bmap("test.bin", 4096);
+        [[maybe_unused]] MappedFile map3 = bmap("test.bin", 4096, 32);
+        [[maybe_unused]] MappedFile map4 = MappedFile::open("test.bin", {}, 32);
+        [[maybe_unused]] std::span<const uint8_t> mapBytes = map1.data();
+        [[maybe_unused]] std::string_view mapText = map1.view();
+        [[maybe_unused]] size_t mapSize = map1.size();
+        [[maybe_unused]] int64_t mapOffset = map2.offset() + map2.file_size();
+        for ([[maybe_unused]] uint8_t b : map3) {}
+        map4.close();
+
+        // bload_async / bsave_async シグネチャ
+        FileRequest req1 = bload_async("test.bin");
+        [[maybe_unused]] FileRequest req2 = bload_async("test.bin", 32, 0, [](FileRequest& r) { (void)r.take(); });
+        [[maybe_unused]] FileRequest req3 = bsave_async("test.bin", vecBuf);
+        [[maybe_unused]] FileRequest req4 = bsave_async("test.bin", std::move(vecBuf), 32);
+        [[maybe_unused]] FileRequest req5 = bsave_async("test.bin", strBuf, {}, {}, nullptr);
+        [[maybe_unused]] FileRequest req6 = FileRequest::load("test.bin");
+        [[maybe_unused]] int reqStat = req1.stat();
+        [[maybe_unused]] bool reqReady = req1.ready();
+        [[maybe_unused]] int64_t reqBytes = req1.wait();
+        [[maybe_unused]] std::span<const uint8_t> reqData = req1.data();
+        [[maybe_unused]] std::string_view reqText = req1.view();
+        [[maybe_unused]] int reqError = req1.error_code();
+        [[maybe_unused]] std::string reqMessage = req1.error_message();
+        [[maybe_unused]] double reqLatency = req1.latency_ms();
+        [[maybe_unused]] bool reqConsts = (fileio_none != fileio_pending) && (fileio_done != fileio_error);
+        [[maybe_unused]] FileIoStats ioStats = fileio_stats();
+        [[maybe_unused]] double ioWait = ioStats.average_wait_ms + ioStats.max_latency_ms;
+        fileio_reset_stats();
+
+        // bcopy / bcopy_async シグネチャ
+        bcopy("a.bin", "b.bin", CopyParams{ .chunk_size = 1024 * 1024, .clone = false, .native = true, .flush = true });
+        FileRequest copyReq1 = bcopy_async("a.bin", "b.bin");
+        [[maybe_unused]] FileRequest copyReq2 = bcopy_async("a.bin", "b.bin", [](FileRequest& r) { (void)r.wait(); },
+            [](FileRequest& r) { [[maybe_unused]] double ratio = static_cast<double>(r.processed()) / static_cast<double>(r.total()); },
+            { .native = false });
+        [[maybe_unused]] FileRequest copyReq3 = FileRequest::copy("a.bin", "b.bin", nullptr, nullptr, {});
+        copyReq1.cancel();
+
+        // パックファイル シグネチャ
+        [[maybe_unused]] int packed1 = packbuild("assets.hpk", "assets");
+        [[maybe_unused]] int packed2 = packbuild("assets.hpk", "assets", PackParams{ .compress = false, .alignment = 4096 });
+        [[maybe_unused]] int packed3 = packbuild("assets.hpk", "assets", PackParams{ .level = 9 });
+        packopen("assets.hpk");
+        [[maybe_unused]] int64_t packedSize = exist("pack://image/player.png");
+        packclose("assets.hpk");
+        packclose();
+
+        // filewatch シグネチャ
+        FileWatch watch1 = filewatch("assets");
+        FileWatch watch2 = filewatch("assets", [](std::span<const FileChange> changes) {
+            for (const FileChange& change : changes) {
+                [[maybe_unused]] bool gone = change.action == filechange_removed || change.action == filechange_overflow;
+                [[maybe_unused]] bool changed = change.action == filechange_added || change.action == filechange_modified;
+                [[maybe_unused]] const std::string& changedPath = change.path;
+            }
+        }, WatchParams{ .recursive = false, .pattern = "*.png", .debounce_ms = 100, .reload = false });
+        [[maybe_unused]] FileWatch watch3 = FileWatch::open("assets", nullptr, { .debounce_ms = 0 });
+        [[maybe_unused]] bool watchActive = watch1.active();
+        [[maybe_unused]] std::string watchDir = watch1.directory();
+        [[maybe_unused]] int64_t watchCounts = watch2.change_count() + watch2.reload_count();
+        watch1.close();
+
+        // Compressor / Decompressor シグネチャ
+        std::vector<uint8_t> packedBuf;
+        Compressor comp1(packedBuf);
+        Compressor comp2(packedBuf, CompressParams{ .level = 9, .block_size = 65536, .threads = 0, .checksum = false });
+        comp1.write(std::span<const uint8_t>(packedBuf.data(), 0));
+        comp1.write(std::string_view("text"));
+        comp1.finish();
+        [[maybe_unused]] bool compOpen = comp2.is_open();
+        [[maybe_unused]] int64_t compBytes = comp2.bytes_in() + comp2.bytes_out();
+        Compressor comp3;
+        comp3.open("test.lz4", { .level = 3 });
+        [[maybe_unused]] Compressor comp4 = std::move(comp3);
+        Decompressor decomp1(packedBuf);
+        [[maybe_unused]] Decompressor decomp2(std::span<const uint8_t>(packedBuf));
+        Decompressor decomp3;
+        decomp3.open("test.lz4");
+        [[maybe_unused]] Decompressor decomp4 = std::move(decomp3);
+        uint8_t chunk[64];
+        [[maybe_unused]] size_t decompRead = decomp1.read(chunk);
+        std::span<const uint8_t> decompBlock;
+        [[maybe_unused]] bool decompMore = decomp1.next(decompBlock);
+        [[maybe_unused]] int64_t decompAll = decomp1.read_all(vecBuf) + decomp1.read_all(strBuf);
+        [[maybe_unused]] bool decompEof = decomp1.eof();
+        [[maybe_unused]] int64_t decompBytes = decomp1.bytes_in() + decomp1.bytes_out();
+        [[maybe_unused]] std::vector<uint8_t> compressed = compress(vecBuf, { .level = 12 });
+        [[maybe_unused]] std::vector<uint8_t> restored = decompress(compressed);
+        [[maybe_unused]] int64_t cs1 = bsave_compressed("test.lz4", vecBuf);
+        [[maybe_unused]] int64_t cs2 = bsave_compressed("test.lz4", strBuf, { .threads = 4 }, { .atomic = true });
+        [[maybe_unused]] int64_t cl1 = bload_compressed("test.lz4", vecBuf);
+        [[maybe_unused]] int64_t cl2 = bload_compressed("test.lz4", strBuf);
 
         // dialog（シグネチャのみ確認）
         dialog("メッセージ");
@@ -1343,6 +1752,9 @@ namespace hsppp_test {
         compile_test::test_interrupt_functions();
         compile_test::test_math_functions();
         compile_test::test_easing_functions();
+        compile_test::test_tween_functions();
+        compile_test::test_vecmath_functions();
+        compile_test::test_collision_functions();
         compile_test::test_sort_functions();
         compile_test::test_debug_functions();
         compile_test::test_conversion_functions();
@@ -10,6 +10,10 @@
 // APIがクラッシュせずに動作することを確認する
 // ═══════════════════════════════════════════════════════════════════
 
+#include <filesystem>   // テスト用ディレクトリの後片付け（hsppp にディレクトリの削除がないため）
+#include <system_error>
+#include <limits>       // NaN の座標を持つ矩形のテスト
+
 import hsppp;
 using namespace hsppp;
 
@@ -448,6 +452,25 @@ namespace hsppp_test {
         check(strtrim("   ") == "", "strtrim all spaces");
         check(strtrim("", 0, ' ') == "", "strtrim empty string");
 
+        // --- toInt / toDouble / str テスト ---
+        check(toInt("123") == 123, "toInt basic");
+        check(toInt("  -42abc") == -42, "toInt partial parse");
+        check(toInt("+7") == 7, "toInt plus sign");
+        check(toInt("abc") == 0, "toInt invalid");
+        check(toInt("3000000000") == 0, "toInt overflow");
+        check(toDouble("1.5e3") == 1500.0, "toDouble exponent");
+        check(toDouble(" -0.25x") == -0.25, "toDouble partial parse");
+        check(toDouble("0x10") == 16.0, "toDouble hex");
+        check(toDouble("xyz") == 0.0, "toDouble invalid");
+        check(str(123) == "123", "str int");
+        check(str(int64_t{-9000000000}) == "-9000000000", "str int64");
+        check(str(3.14) == "3.140000", "str double");
+        {
+            std::string dest = "previous";
+            check(str_into(dest, 42) == "42", "str_into int");
+            check(str_into(dest, 0.5) == "0.500000", "str_into double");
+        }
+
         // --- strf テスト ---
         check(strf("Hello") == "Hello", "strf no args");
         check(strf("Value: %d", 123) == "Value: 123", "strf int");
@@ -455,6 +478,95 @@ namespace hsppp_test {
         check(strf("Padded: %05d", 42) == "Padded: 00042", "strf padded");
         check(strf("Two: %d, %d", 1, 2) == "Two: 1, 2", "strf two ints");
         check(strf("Three: %d, %d, %d", 1, 2, 3) == "Three: 1, 2, 3", "strf three ints");
+        check(strf("%d %d %d %d", 1, 2, 3, 4) == "1 2 3 4", "strf four args");
+        check(strf("%s=%.2f%%", "rate", 12.5) == "rate=12.50%", "strf string and percent");
+        check(strf("%-4s|%4s|", "ab", "cd") == "ab  |  cd|", "strf string width");
+        check(strf("%X", -1) == "FFFFFFFF", "strf 32bit hex");
+        check(strf("%d", 2.9) == "2", "strf double to int");
+        {
+            std::string runtimeFormat = "HP %d/%d";
+            check(strf(runtimeFormat, 10, 20) == "HP 10/20", "strf runtime format");
+            check(strf(runtimeFormat, 30, 40) == "HP 30/40", "strf runtime format cached");
+            std::string dest;
+            check(strf_into(dest, "%s:%d", "x", 5) == "x:5", "strf_into");
+        }
+
+        // --- getstr / StrReader テスト ---
+        {
+            std::string dest;
+            std::string csv = "ABC,DEF\r\nGHI";
+            check(getstr(dest, csv, 0, ',') == 4 && dest == "ABC", "getstr delimiter");
+            check(getstr(dest, csv, 4, ',') == 5 && dest == "DEF", "getstr CRLF");
+            check(getstr(dest, csv, 9, ',') == 3 && dest == "GHI", "getstr end of buffer");
+            check(getstr(dest, csv, 0, 0, 2) == 2 && dest == "AB", "getstr maxLen");
+
+            StrReader reader(csv);
+            std::string_view token;
+            check(reader.next(token, ',') && token == "ABC", "StrReader first token");
+            check(reader.next(token, ',') && token == "DEF" && reader.strsize() == 5, "StrReader CRLF token");
+            check(reader.index() == 9, "StrReader index");
+            check(reader.read(dest, ',') == 3 && dest == "GHI", "StrReader read");
+            check(reader.eof() && !reader.next(token), "StrReader eof");
+
+            bool threw = false;
+            try {
+                StrReader zeroReader(csv);
+                (void)zeroReader.next(token, ',', 0);
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_OUT_OF_RANGE);
+            }
+            check(threw, "StrReader maxLen zero");
+
+            // 16バイトを超える行（ベクトル化経路）
+            std::string longLine(40, 'x');
+            std::string longBuf = longLine + "\n" + longLine;
+            StrReader longReader(longBuf);
+            check(longReader.next(token) && token == longLine && longReader.index() == 41, "StrReader long line");
+        }
+
+        // --- 文字コード変換テスト ---
+        {
+            const std::string jp = reinterpret_cast<const char*>(u8"日本語テキスト ABC");
+            check(cnvwtos(cnvstow(jp)) == jp, "cnvstow/cnvwtos roundtrip");
+            check(cnvstow(reinterpret_cast<const char*>(u8"あ\U0001F600")) == u"あ\U0001F600", "cnvstow surrogate pair");
+            check(cnvstoa(reinterpret_cast<const char*>(u8"あｱ")) == "\x82\xA0\xB1", "cnvstoa CP932");
+            check(cnvatos("\x82\xA0\xB1") == reinterpret_cast<const char*>(u8"あｱ"), "cnvatos CP932");
+            check(cnvatos(cnvstoa(jp)) == jp, "cnvstoa/cnvatos roundtrip");
+            check(cnvstow("A\xFF" "B") == u"A\uFFFDB", "cnvstow invalid UTF-8");
+            check(cnvstoa(reinterpret_cast<const char*>(u8"\U0001F600")) == "?", "cnvstoa unmappable");
+
+            std::u16string wide;
+            std::string narrow;
+            check(cnvstow_into(wide, "Hello") == u"Hello", "cnvstow_into");
+            check(cnvwtos_into(narrow, wide) == "Hello", "cnvwtos_into");
+        }
+
+        // --- NotePad テスト ---
+        {
+            NotePad pad("line0\r\nline1\nline2\n");
+            check(pad.count() == 3, "NotePad count");
+            check(pad.line(1) == "line1" && pad.get(0) == "line0", "NotePad line");
+            check(pad.find("line2", 0, 1) == 2, "NotePad find with start");
+
+            // メモリマップ（行インデックスの区切りを跨ぐ行数）
+            NotePad source;
+            for (int i = 0; i < 200; ++i) {
+                source.add(str(i));
+            }
+            (void)source.save("hsppp_notepad_map_test.txt");
+            NotePad mapped;
+            mapped.map("hsppp_notepad_map_test.txt");
+            check(mapped.mapped() && mapped.count() == 200, "NotePad map count");
+            check(mapped.line(0) == "0" && mapped.line(64) == "64" && mapped.line(199) == "199", "NotePad map line");
+            check(mapped.find("150", 0, 100) == 150, "NotePad map find");
+            const NotePad& constMapped = mapped;
+            check(constMapped.toString().size() == mapped.size() && &constMapped.toString() == &constMapped.buffer() && mapped.mapped(),
+                  "NotePad map const toString keeps mapping");
+            mapped.del(0);
+            check(!mapped.mapped() && mapped.line(0) == "1", "NotePad map detach on del");
+            deletefile("hsppp_notepad_map_test.txt");
+        }
 
         // --- getpath テスト ---
         std::string testPath = "c:\\disk\\test.bmp";
@@ -474,6 +586,1303 @@ namespace hsppp_test {
         return allPassed;
     }
 
+    // ============================================================
+    // 乱数テスト（再現性・統計的な簡易検査）
+    // ============================================================
+    bool test_random_functions_runtime() {
+        bool allPassed = true;
+
+        // 同じシードで同じ乱数列
+        randomize(2024);
+        int first[8];
+        for (int& v : first) {
+            v = rnd(1000);
+        }
+        randomize(2024);
+        bool reproducible = true;
+        for (int v : first) {
+            reproducible &= (rnd(1000) == v);
+        }
+        check(reproducible, "randomize reproducible");
+
+        // rnd_fill は rnd を繰り返し呼んだ場合と同じ値
+        std::vector<int> filled(257);
+        randomize(7);
+        rnd_fill(filled, 37);
+        randomize(7);
+        bool fillMatches = true;
+        for (int v : filled) {
+            fillMatches &= (rnd(37) == v);
+        }
+        check(fillMatches, "rnd_fill matches rnd");
+
+        // 範囲と一様性（6面のさいころ 60万回でカイ二乗、自由度5 の 0.1% 点 20.5 未満）
+        std::vector<int> dice(600'000);
+        rnd_fill(dice, 6);
+        int counts[6] = {};
+        bool inRange = true;
+        for (int v : dice) {
+            inRange &= (v >= 0 && v < 6);
+            if (v >= 0 && v < 6) {
+                ++counts[v];
+            }
+        }
+        double chiSquare = 0.0;
+        for (int c : counts) {
+            const double diff = c - 100'000.0;
+            chiSquare += diff * diff / 100'000.0;
+        }
+        check(inRange && chiSquare < 20.5, "rnd uniformity");
+
+        std::vector<double> unit(100'000);
+        rnd_fill(unit);
+        double sum = 0.0;
+        bool unitRange = true;
+        for (double v : unit) {
+            unitRange &= (v >= 0.0 && v < 1.0);
+            sum += v;
+        }
+        check(unitRange && abs(sum / static_cast<double>(unit.size()) - 0.5) < 0.01, "rnd_fill double");
+
+        // HSP互換モード（C ランタイム rand() と同じ乱数列）
+        randomize(1);
+        rndmode(rndmode_hsp);
+        check(rnd(32768) == 41 && rnd(32768) == 18467 && rnd(32768) == 6334 && rnd(100) == 0, "rndmode_hsp sequence");
+        rndmode(rndmode_fast);
+
+        // jump / split で分けた乱数列は元の列と異なる
+        Xoshiro256 parent(99);
+        Xoshiro256 child = parent.split();
+        check(child != parent && child() != parent(), "Xoshiro256 split");
+
+        // RandomStream: グローバルな rnd と独立、保存・復元で同じ乱数列を再生
+        RandomStream stream(2024);
+        randomize(2024);
+        bool sameAsRnd = true;
+        for (int i = 0; i < 8; ++i) {
+            sameAsRnd &= (stream.rnd(1000) == rnd(1000));
+        }
+        check(sameAsRnd, "RandomStream matches rnd for same seed");
+
+        RandomState snapshot = stream.save();
+        int recorded[16];
+        for (int& v : recorded) {
+            v = stream.rnd(100);
+            (void)rnd(100);  // グローバルな乱数を消費しても影響しない
+        }
+        stream.restore(snapshot);
+        bool replayed = true;
+        for (int v : recorded) {
+            replayed &= (stream.rnd(100) == v);
+        }
+        check(replayed, "RandomStream save/restore replay");
+        check(RandomStream(snapshot).save() == snapshot, "RandomStream from state");
+        check(RandomStream("particles", 1) != RandomStream("ai", 1), "RandomStream named streams differ");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // 色変換テスト（hsvcolor との一致、BGRA、乗算済みアルファ）
+    // ============================================================
+    bool test_color_functions_runtime() {
+        bool allPassed = true;
+
+        // 一括変換・色相テーブルは hsvcolor で設定される色と一致する
+        const int satValues[] = { 0, 1, 128, 255 };
+        const int valValues[] = { 0, 77, 255 };
+        bool matchesHsvcolor = true;
+        bool paletteMatches = true;
+        std::vector<int> hue(192), sat(192), val(192), rgb(192);
+        for (int h = 0; h < 192; ++h) {
+            hue[h] = h;
+        }
+        for (int s : satValues) {
+            for (int v : valValues) {
+                for (int h = 0; h < 192; ++h) {
+                    sat[h] = s;
+                    val[h] = v;
+                }
+                hsv_to_rgb(hue, sat, val, rgb);
+                const auto palette = hsv_palette(s, v);
+                for (int h = 0; h < 192; h += 7) {
+                    hsvcolor(h, s, v);
+                    const int expected = (ginfo_r() << 16) | (ginfo_g() << 8) | ginfo_b();
+                    matchesHsvcolor &= (rgb[h] == expected);
+                    paletteMatches &= (palette[h] == rgb[h]);
+                }
+            }
+        }
+        check(matchesHsvcolor, "hsv_to_rgb matches hsvcolor");
+        check(paletteMatches, "hsv_palette matches hsv_to_rgb");
+
+        // 純色の色相は往復で元に戻る
+        std::vector<int> backH(192), backS(192), backV(192);
+        for (int h = 0; h < 192; ++h) {
+            sat[h] = 255;
+            val[h] = 255;
+        }
+        hsv_to_rgb(hue, sat, val, rgb);
+        rgb_to_hsv(rgb, backH, backS, backV);
+        bool roundTrip = true;
+        for (int h = 0; h < 192; ++h) {
+            roundTrip &= (backH[h] == h && backS[h] == 255 && backV[h] == 255);
+        }
+        check(roundTrip, "rgb_to_hsv round trip");
+
+        // RGB ⇔ BGRA
+        std::vector<int> colors = { 0x123456, 0xFF0000, 0x00FF00, 0x0000FF, 0x7F7F7F };
+        std::vector<uint32_t> bgra(colors.size());
+        rgb_to_bgra(colors, bgra, 0x80);
+        check(bgra[0] == 0x80123456u && bgra[4] == 0x807F7F7Fu, "rgb_to_bgra");
+        std::vector<int> back(colors.size());
+        bgra_to_rgb(bgra, back);
+        bool unpacked = true;
+        for (size_t i = 0; i < colors.size(); ++i) {
+            unpacked &= (back[i] == colors[i]);
+        }
+        check(unpacked, "bgra_to_rgb");
+
+        // 乗算済みアルファ（端数は四捨五入、アルファ 0 は 0）
+        std::vector<uint32_t> pixels = { 0x80FF8001u, 0xFF123456u, 0x00FFFFFFu, 0x01FFFFFFu, 0x80FF8001u };
+        premultiply_bgra(pixels);
+        check(pixels[0] == 0x80804001u && pixels[1] == 0xFF123456u && pixels[2] == 0u && pixels[3] == 0x01010101u,
+              "premultiply_bgra");
+        unpremultiply_bgra(pixels);
+        check(pixels[0] == 0x80FF8002u && pixels[1] == 0xFF123456u && pixels[2] == 0u && pixels[3] == 0x01FFFFFFu,
+              "unpremultiply_bgra");
+
+        bool sizeChecked = false;
+        try {
+            std::vector<int> shorter(2);
+            bgra_to_rgb(bgra, shorter);
+        } catch (const HspError&) {
+            sizeChecked = true;
+        }
+        check(sizeChecked, "color span size mismatch throws");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // イージング関数テスト（Easing / EasingTable）
+    // ============================================================
+    bool test_easing_functions_runtime() {
+        bool allPassed = true;
+
+        // バッチ評価は1点評価・geteasef と同じ値になる（SIMD区間と端数の両方を含む要素数）
+        std::vector<double> t = { -0.5, 0.0, 0.1, 0.25, 0.4, 0.5, 0.6, 0.75, 0.9, 1.0, 1.5 };
+        std::vector<double> out(t.size());
+        bool batchMatches = true;
+        for (int type = ease_linear; type <= ease_shake_inout; ++type) {
+            for (int flags : { 0, ease_loop }) {
+                const Easing easing(10.0, 250.0, type | flags);
+                easing.evaluate(t, out);
+                setease(10.0, 250.0, type | flags);
+                for (size_t i = 0; i < t.size(); ++i) {
+                    batchMatches &= (out[i] == easing(t[i]));
+                    batchMatches &= (out[i] == geteasef(t[i]));
+                }
+            }
+        }
+        check(batchMatches, "Easing::evaluate matches geteasef");
+
+        // その場評価
+        std::vector<double> inplace = t;
+        const Easing quad(0.0, 100.0, ease_quad_in);
+        quad.evaluate(inplace, inplace);
+        check(inplace[4] == quad(0.4) && inplace[10] == 100.0, "Easing::evaluate in-place");
+
+        // 要素数の不一致はエラー
+        bool threw = false;
+        try {
+            std::vector<double> small(2);
+            quad.evaluate(t, small);
+        } catch (const HspError&) {
+            threw = true;
+        }
+        check(threw, "Easing::evaluate size mismatch throws");
+
+        // 整数テーブルは getease と同じ値
+        const Easing bounce(0.0, 400.0, ease_bounce_out);
+        const EasingTable table(bounce, 4096);
+        setease(0.0, 400.0, ease_bounce_out);
+        bool tableMatches = true;
+        for (int p = -16; p <= 4096 + 16; ++p) {
+            tableMatches &= (table(p) == getease(p, 4096));
+        }
+        check(tableMatches, "EasingTable matches getease");
+
+        const EasingTable loopTable(Easing(0.0, 100.0, ease_linear | ease_loop), 100);
+        check(loopTable(50) == 50 && loopTable(150) == 50 && loopTable(250) == 50, "EasingTable loop");
+        check(loopTable(-50) == -50, "EasingTable loop negative progress");
+
+        // Easing はグローバル状態を変更しない
+        setease(0.0, 1.0, ease_linear);
+        [[maybe_unused]] double unused = Easing(0.0, 500.0, ease_cubic_in)(0.5);
+        check(geteasef(0.5) == 0.5, "Easing does not touch setease state");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // トゥイーンテスト（Timeline）
+    // ============================================================
+    bool test_tween_functions_runtime() {
+        bool allPassed = true;
+
+        // 基本: 値の書き込みと完了コールバック
+        Timeline timeline;
+        double x = -1.0;
+        int completed = 0;
+        TweenHandle move = timeline.add(&x, 0.0, 100.0, 1.0, ease_linear, { .on_complete = [&] { ++completed; } });
+        timeline.update(0.5);
+        check(x == 50.0 && timeline.value(move) == 50.0, "Timeline update writes target");
+        timeline.update(0.5);
+        check(x == 100.0 && completed == 1 && !timeline.active(move) && timeline.empty(), "Timeline completion");
+
+        // スロット再利用時に古いハンドルは無効
+        TweenHandle reused = timeline.add(nullptr, 0.0, 1.0, 1.0);
+        check(reused.slot == move.slot && !timeline.active(move) && timeline.active(reused), "Timeline slot recycling");
+        timeline.clear();
+
+        // 連続再生: 前のトゥイーンの超過時間を引き継ぎ、遅延中は書き込まない
+        double y = 0.0;
+        TweenHandle first = timeline.add(&y, 0.0, 10.0, 1.0);
+        TweenHandle second = timeline.add(&y, 10.0, 20.0, 1.0, ease_linear, { .delay = 0.5, .after = first });
+        timeline.update(1.25);
+        check(y == 10.0 && timeline.active(second), "Timeline sequence waits for delay");
+        timeline.update(0.5);
+        check(y == 12.5, "Timeline sequence carries overshoot");
+        timeline.update(1.0);
+        check(y == 20.0 && timeline.empty(), "Timeline sequence completion");
+
+        // ease_loop は完了しない
+        double z = 0.0;
+        TweenHandle loop = timeline.add(&z, 0.0, 100.0, 1.0, ease_linear | ease_loop);
+        timeline.update(1.5);
+        check(z == 50.0 && timeline.active(loop), "Timeline ease_loop");
+
+        // remove は後続も削除
+        TweenHandle follower = timeline.add(&z, 0.0, 1.0, 1.0, ease_linear, { .after = loop });
+        check(timeline.remove(loop) && !timeline.active(follower) && timeline.empty(), "Timeline remove cascades");
+        check(!timeline.remove(loop), "Timeline remove stale handle");
+
+        // 後続の木の途中を削除しても、他の後続待ちは残って順に開始する
+        double chain = 0.0;
+        double other = 0.0;
+        TweenHandle head = timeline.add(&chain, 0.0, 1.0, 1.0);
+        TweenHandle branch = timeline.add(&chain, 1.0, 2.0, 1.0, ease_linear, { .after = head });
+        TweenHandle leaf1 = timeline.add(&chain, 2.0, 3.0, 1.0, ease_linear, { .after = branch });
+        TweenHandle leaf2 = timeline.add(&chain, 2.0, 4.0, 1.0, ease_linear, { .after = branch });
+        TweenHandle leaf3 = timeline.add(&chain, 3.0, 5.0, 1.0, ease_linear, { .after = leaf1 });
+        TweenHandle sibling = timeline.add(&other, 0.0, 1.0, 1.0, ease_linear, { .after = head });
+        check(timeline.remove(branch) && !timeline.active(leaf1) && !timeline.active(leaf2) && !timeline.active(leaf3)
+              && timeline.active(head) && timeline.active(sibling), "Timeline remove follower subtree");
+        timeline.update(1.5);
+        timeline.update(0.25);
+        check(chain == 1.0 && other == 0.75, "Timeline remaining follower starts");
+        timeline.update(1.0);
+        check(other == 1.0 && timeline.empty(), "Timeline remove subtree completion");
+
+        // repeat
+        double w = 0.0;
+        timeline.add(&w, 0.0, 1.0, 1.0, ease_linear, { .repeat = 1 });
+        timeline.update(1.0);
+        check(timeline.size() == 1, "Timeline repeat restarts");
+        timeline.update(1.0);
+        check(w == 1.0 && timeline.empty(), "Timeline repeat completes");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // ベクトル演算テスト（一括変換とスカラー版の一致、gsquare 連携）
+    // ============================================================
+    bool test_vecmath_functions_runtime() {
+        bool allPassed = true;
+
+        const Mat3 affine = Mat3::translation(320.0f, 240.0f) * Mat3::rotation(0.7) * Mat3::scaling(1.5f, 0.75f);
+        const Mat3 projective(1.0f, 0.2f, 3.0f, 0.1f, 1.0f, 4.0f, 0.001f, 0.002f, 1.0f);
+        const Mat3* matrices[] = { &affine, &projective };
+
+        // 端数の要素数（SIMD の端数処理）でもスカラー版と完全に一致する
+        std::vector<Vec2> points(1003), moved(1003);
+        std::vector<Point2i> ipoints(1003), imoved(1003);
+        for (size_t i = 0; i < points.size(); ++i) {
+            const int x = static_cast<int>((i * 7919) % 2001) - 1000;
+            const int y = static_cast<int>((i * 104729) % 2001) - 1000;
+            points[i] = Vec2(x * 0.37f, y * 0.61f);
+            ipoints[i] = Point2i(x, y);
+        }
+        for (const Mat3* m : matrices) {
+            transform(*m, points, moved);
+            transform(*m, ipoints, imoved);
+            bool floatMatches = true;
+            bool intMatches = true;
+            for (size_t i = 0; i < points.size(); ++i) {
+                floatMatches &= (moved[i] == m->transform_point(points[i]));
+                const Point2i expected = m->transform_point(Vec2(ipoints[i])).to_point();
+                intMatches &= (imoved[i].x == expected.x && imoved[i].y == expected.y);
+            }
+            check(floatMatches, m->is_affine() ? "transform Vec2 (affine)" : "transform Vec2 (projective)");
+            check(intMatches, m->is_affine() ? "transform Point2i (affine)" : "transform Point2i (projective)");
+        }
+
+        // 同じ配列への上書き
+        std::vector<Vec2> inPlace = points;
+        transform(affine, inPlace, inPlace);
+        bool inPlaceMatches = true;
+        for (size_t i = 0; i < points.size(); ++i) {
+            inPlaceMatches &= (inPlace[i] == affine.transform_point(points[i]));
+        }
+        check(inPlaceMatches, "transform in place");
+
+        // rect_quad: 90度回転（画面上で時計回り）した 20x10 の矩形
+        const Quad q = rect_quad(Mat3::translation(100.0f, 50.0f) * Mat3::rotation(deg2rad(90.0)), 20.0f, 10.0f);
+        check(q[0].x == 105 && q[0].y == 40 && q[1].x == 105 && q[1].y == 60 &&
+              q[2].x == 95 && q[2].y == 60 && q[3].x == 95 && q[3].y == 40, "rect_quad rotation");
+
+        std::vector<Quad> quads(3, Quad(0, 0, 10, 0, 10, 10, 0, 10));
+        transform(Mat3::translation(5.0f, -5.0f), quads, quads);
+        check(quads[2][2].x == 15 && quads[2][2].y == 5, "transform Quad");
+
+        // 逆行列・四捨五入
+        const Vec2 back = affine.inverse().transform_point(affine.transform_point(Vec2(12.0f, 34.0f)));
+        check(abs(back.x - 12.0f) < 1e-3f && abs(back.y - 34.0f) < 1e-3f, "Mat3 inverse");
+        check(Vec2(-1.5f, 2.5f).to_point().x == -2 && Vec2(-1.5f, 2.5f).to_point().y == 3, "Vec2 to_point rounding");
+
+        bool sizeChecked = false;
+        try {
+            std::vector<Vec2> shorter(2);
+            transform(affine, points, shorter);
+        } catch (const HspError&) {
+            sizeChecked = true;
+        }
+        check(sizeChecked, "transform size mismatch throws");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // 当たり判定テスト（総当たりとの一致）
+    // ============================================================
+    bool test_collision_functions_runtime() {
+        bool allPassed = true;
+
+        // 大きさのまちまちな矩形（セルより大きいもの・大きさ0のもの・辺が接するものを含む）
+        std::vector<Aabb> boxes;
+        for (uint32_t i = 0; i < 400; ++i) {
+            const float x = static_cast<float>((i * 7919u) % 1000u);
+            const float y = static_cast<float>((i * 104729u) % 1000u);
+            const float w = static_cast<float>(1u + (i * 31u) % 40u);
+            const float h = static_cast<float>(1u + (i * 17u) % 40u);
+            boxes.push_back(Aabb::from_size({ x, y }, { w, h }));
+        }
+        boxes.push_back({ 100.0f, 100.0f, 900.0f, 900.0f });
+        boxes.push_back({ -50.0f, -50.0f, 2000.0f, 60.0f });
+        boxes.push_back({ 64.0f, 64.0f, 64.0f, 80.0f });
+        boxes.push_back({ 32.0f, 32.0f, 64.0f, 64.0f });
+        boxes.push_back({ 64.0f, 32.0f, 96.0f, 64.0f });
+
+        SpatialHash hash(32.0f);
+        SweepAndPrune sweep;
+        hash.insert(boxes);
+        sweep.insert(boxes);
+
+        const size_t n = boxes.size();
+        auto matchesBruteForce = [&](const std::vector<CollisionPair>& pairs) {
+            std::vector<char> seen(n * n, 0);
+            for (const CollisionPair& p : pairs) {
+                if (p.a >= p.b || p.b >= n || seen[p.a * n + p.b]) {
+                    return false;
+                }
+                seen[p.a * n + p.b] = 1;
+            }
+            for (size_t a = 0; a < n; ++a) {
+                for (size_t b = a + 1; b < n; ++b) {
+                    if ((seen[a * n + b] != 0) != boxes[a].overlaps(boxes[b])) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        };
+        auto queryMatches = [&](const std::vector<uint32_t>& found, const Aabb& area) {
+            std::vector<char> seen(n, 0);
+            for (uint32_t body : found) {
+                if (body >= n || seen[body]) {
+                    return false;
+                }
+                seen[body] = 1;
+            }
+            for (size_t body = 0; body < n; ++body) {
+                if ((seen[body] != 0) != area.overlaps(boxes[body])) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        std::vector<CollisionPair> pairs;
+        hash.find_pairs(pairs);
+        check(matchesBruteForce(pairs), "SpatialHash find_pairs");
+        sweep.find_pairs(pairs);
+        check(matchesBruteForce(pairs), "SweepAndPrune find_pairs");
+
+        // 位置だけを動かしたあとも一致する
+        std::vector<Vec2> positions(n);
+        for (size_t i = 0; i < n; ++i) {
+            positions[i] = boxes[i].position() + Vec2(static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) - 2.0f);
+            boxes[i] = Aabb::from_size(positions[i], boxes[i].size());
+        }
+        hash.move_to(positions);
+        sweep.move_to(positions);
+        hash.find_pairs(pairs);
+        check(matchesBruteForce(pairs), "SpatialHash find_pairs after move_to");
+        sweep.find_pairs(pairs);
+        check(matchesBruteForce(pairs), "SweepAndPrune find_pairs after move_to");
+
+        std::vector<uint32_t> found;
+        const Aabb areas[] = { { 200.0f, 300.0f, 260.0f, 340.0f }, { -10.0f, -10.0f, 5.0f, 5.0f }, { 0.0f, 0.0f, 1000.0f, 1000.0f } };
+        bool hashQuery = true;
+        bool sweepQuery = true;
+        for (const Aabb& area : areas) {
+            hash.query(area, found);
+            hashQuery &= queryMatches(found, area);
+            sweep.query(area, found);
+            sweepQuery &= queryMatches(found, area);
+        }
+        check(hashQuery, "SpatialHash query");
+        check(sweepQuery, "SweepAndPrune query");
+
+        // 複数範囲の検索は (範囲の番号, ボディ番号) を返す
+        hash.query(std::span<const Aabb>(areas), pairs);
+        bool areaIndices = !pairs.empty();
+        for (const CollisionPair& p : pairs) {
+            areaIndices &= (p.a < 3 && areas[p.a].overlaps(boxes[p.b]));
+        }
+        check(areaIndices, "SpatialHash query multiple areas");
+
+        check(Aabb(0.0f, 0.0f, 10.0f, 10.0f).overlaps({ 9.0f, 9.0f, 20.0f, 20.0f }) &&
+              !Aabb(0.0f, 0.0f, 10.0f, 10.0f).overlaps({ 10.0f, 0.0f, 20.0f, 10.0f }), "Aabb overlaps excludes touching edges");
+
+        bool rangeChecked = false;
+        try {
+            hash.update(static_cast<uint32_t>(n), Aabb());
+        } catch (const HspError&) {
+            rangeChecked = true;
+        }
+        check(rangeChecked, "AabbList update out of range throws");
+
+        bool cellSizeChecked = false;
+        try {
+            SpatialHash invalid(0.0f);
+        } catch (const HspError&) {
+            cellSizeChecked = true;
+        }
+        check(cellSizeChecked, "SpatialHash invalid cell size throws");
+
+        // NaN の座標を持つ矩形があっても並べ替えが壊れず、その矩形はどれとも重ならない
+        boxes.push_back({ std::numeric_limits<float>::quiet_NaN(), 0.0f, 10.0f, 10.0f });
+        sweep.insert(boxes.back());
+        sweep.find_pairs(pairs);
+        bool nanIgnored = true;
+        for (const CollisionPair& p : pairs) {
+            nanIgnored &= (p.a != n && p.b != n);
+        }
+        check(nanIgnored && pairs.size() > 0, "SweepAndPrune ignores NaN bounds");
+
+        // ピクセル単位の判定（64 ビットの境界をまたぐ幅と位置で総当たりと一致する）
+        auto makePixels = [](int w, int h, uint32_t seed) {
+            std::vector<uint32_t> pixels(static_cast<size_t>(w) * h);
+            for (size_t i = 0; i < pixels.size(); ++i) {
+                const uint32_t v = static_cast<uint32_t>(i) * 2654435761u + seed;
+                pixels[i] = (v >> 27) < 3 ? 0xFF204060u : (v >> 27) == 3 ? 0xFF000000u : 0x40FFFFFFu;
+            }
+            return pixels;
+        };
+        const std::vector<uint32_t> spritePixels = makePixels(150, 9, 1);
+        const std::vector<uint32_t> bulletPixels = makePixels(70, 5, 7);
+        const PixelMask sprite = PixelMask::from_bgra(spritePixels, 150, 9, { .alpha_threshold = 128, .color_key = 0x000000 });
+        const PixelMask bullet = PixelMask::from_bgra(bulletPixels, 70, 5, { .alpha_threshold = 128, .color_key = 0x000000 });
+        auto solidAt = [](const std::vector<uint32_t>& pixels, int w, int h, int x, int y) {
+            if (x < 0 || y < 0 || x >= w || y >= h) {
+                return false;
+            }
+            const uint32_t p = pixels[static_cast<size_t>(y) * w + x];
+            return (p >> 24) >= 128 && (p & 0xFFFFFF) != 0;
+        };
+
+        bool maskBits = true;
+        for (int y = 0; y < 9; ++y) {
+            for (int x = 0; x < 150; ++x) {
+                maskBits &= (sprite.test(x, y) == solidAt(spritePixels, 150, 9, x, y));
+            }
+        }
+        check(maskBits, "PixelMask from_bgra alpha and color key");
+
+        bool maskOverlaps = true;
+        for (int by = -5; by <= 9; ++by) {
+            for (int bx = -72; bx <= 152; bx += 3) {
+                bool expected = false;
+                for (int y = 0; y < 9 && !expected; ++y) {
+                    for (int x = 0; x < 150 && !expected; ++x) {
+                        expected = solidAt(spritePixels, 150, 9, x, y) && solidAt(bulletPixels, 70, 5, x - bx, y - by);
+                    }
+                }
+                maskOverlaps &= (sprite.overlaps(0, 0, bullet, bx, by) == expected);
+                maskOverlaps &= (bullet.overlaps(bx + 10, by - 20, sprite, 10, -20) == expected);
+            }
+        }
+        check(maskOverlaps, "PixelMask overlaps matches per-pixel test");
+
+        const PixelMask dot = PixelMask::from_bits(1, 1, { 1 });
+        check(!PixelMask().overlaps(0, 0, dot, 0, 0) && PixelMask().empty() && !dot.empty(), "PixelMask empty never overlaps");
+        check(dot.bounds() == Aabb(0.0f, 0.0f, 1.0f, 1.0f), "PixelMask bounds");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // ソート関数テスト（実行時検証）
+    // ============================================================
+    bool test_sort_functions_runtime() {
+        bool allPassed = true;
+
+        // --- sortval (int) ---
+        std::vector<int> ints = { 30, -5, 10, -5, 0 };
+        sortval(ints);
+        check(ints == std::vector<int>{ -5, -5, 0, 10, 30 }, "sortval int ascending");
+        check(sortget(0) == 1 && sortget(1) == 3 && sortget(4) == 0, "sortget stable order");
+        sortval(ints, 1);
+        check(ints == std::vector<int>{ 30, 10, 0, -5, -5 }, "sortval int descending");
+        check(sortget(3) == 3 && sortget(4) == 4, "sortget stable descending");
+
+        // --- sortval (double) ---
+        std::vector<double> doubles = { 1.5, -2.25, 1e300, -1e-300, 0.0 };
+        sortval(doubles);
+        check(doubles == std::vector<double>{ -2.25, -1e-300, 0.0, 1.5, 1e300 }, "sortval double ascending");
+
+        // 基数ソート経路（挿入ソートの閾値を超える要素数）
+        std::vector<int> many(1000);
+        for (size_t i = 0; i < many.size(); ++i) {
+            many[i] = static_cast<int>((i * 7919) % 1000) - 500;
+        }
+        sortval(many);
+        bool manySorted = true;
+        for (size_t i = 1; i < many.size(); ++i) {
+            manySorted &= (many[i - 1] <= many[i]);
+        }
+        check(manySorted && many.front() == -500 && many.back() == 499, "sortval int radix");
+        check(sortget(0) == 0, "sortget radix");
+
+        // --- sortstr ---
+        std::vector<std::string> strs = { "pear", "apple", "", "app", "pear" };
+        sortstr(strs);
+        check(strs == std::vector<std::string>{ "", "app", "apple", "pear", "pear" }, "sortstr ascending");
+        check(sortget(3) == 0 && sortget(4) == 4, "sortstr stable");
+        sortstr(strs, 1);
+        check(strs == std::vector<std::string>{ "pear", "pear", "apple", "app", "" }, "sortstr descending");
+
+        // --- sortnote ---
+        std::string note = "banana\napple\ncherry";
+        sortnote(note);
+        check(note == "apple\nbanana\ncherry", "sortnote ascending");
+        check(sortget(0) == 1, "sortnote sortget");
+
+        // --- SortPermutation / sort_untracked ---
+        std::vector<int> values = { 3, 1, 2 };
+        SortPermutation perm;
+        sortval(values, perm);
+        check(perm.size() == 3 && perm[0] == 1 && perm[1] == 2 && perm[2] == 0, "SortPermutation indices");
+        check(sortget(0) == 1, "SortPermutation leaves sortget untouched");
+        std::vector<int> untracked = { 9, 8, 7 };
+        sortval(untracked, sort_untracked);
+        check(untracked == std::vector<int>{ 7, 8, 9 } && sortget(0) == 1, "sort_untracked");
+
+        // --- sort_by_key ---
+        std::vector<int> scores = { 70, 95, 80 };
+        std::vector<std::string> names = { "C", "A", "B" };
+        std::vector<double> times = { 3.0, 1.0, 2.0 };
+        SortPermutation byScore = sort_by_key(scores, sort_descending, names, times);
+        check(scores == std::vector<int>{ 95, 80, 70 }, "sort_by_key keys");
+        check(names == std::vector<std::string>{ "A", "B", "C" } && times == std::vector<double>{ 1.0, 2.0, 3.0 }, "sort_by_key values");
+        check(byScore[0] == 1, "sort_by_key permutation");
+
+        return allPassed;
+    }
+
+    // ============================================================
+    // ファイル関数テスト（実行時検証）
+    // ============================================================
+    bool test_file_functions_runtime() {
+        bool allPassed = true;
+        const std::string path = "hsppp_file_test.bin";
+
+        // 割り当て粒度（64KB）を跨ぐ大きさ
+        std::vector<uint8_t> source(70000);
+        for (size_t i = 0; i < source.size(); ++i) {
+            source[i] = static_cast<uint8_t>(i * 13 + 7);
+        }
+        check(bsave(path, source) == static_cast<int64_t>(source.size()), "bsave size");
+
+        // --- bmap ---
+        {
+            MappedFile whole = bmap(path);
+            check(whole.size() == source.size() && whole.file_size() == static_cast<int64_t>(source.size()), "bmap whole size");
+            check(std::vector<uint8_t>(whole.begin(), whole.end()) == source, "bmap whole content");
+
+            // 粒度に揃わない位置から
+            MappedFile part = bmap(path, 65530, 100);
+            check(part.size() == 100 && part.offset() == 65530, "bmap offset/size");
+            check(part[0] == source[65530] && part[99] == source[65629], "bmap offset content");
+
+            std::vector<uint8_t> loaded;
+            bload(path, loaded, 100, 65530);
+            check(std::vector<uint8_t>(part.begin(), part.end()) == loaded, "bmap matches bload");
+
+            // 末尾を超える範囲は切り詰める
+            check(bmap(path, 69990, 1000).size() == 10, "bmap clamp to end");
+            check(bmap(path, 80000).empty(), "bmap past end");
+
+            MappedFile shared = part;
+            part.close();
+            check(part.empty() && shared.size() == 100 && shared[1] == source[65531], "bmap copy shares mapping");
+            MappedFile moved = std::move(shared);
+            check(shared.empty() && moved.data().size() == 100, "bmap move");
+
+            bool threw = false;
+            try {
+                (void)bmap("hsppp_file_test_missing.bin");
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "bmap missing file");
+        }
+
+        // --- bload_async / bsave_async ---
+        {
+            const std::string asyncPath = "hsppp_file_async_test.bin";
+            int callbacks = 0;
+            FileRequest saved = bsave_async(asyncPath, source, {}, {}, [&](FileRequest& request) {
+                callbacks += (request.stat() == fileio_done) ? 1 : 100;
+            });
+            check(saved.wait() == static_cast<int64_t>(source.size()), "bsave_async wait");
+            check(saved.stat() == fileio_done && saved.ready(), "bsave_async stat");
+
+            FileRequest loaded = bload_async(asyncPath);
+            check(loaded.wait() == static_cast<int64_t>(source.size()), "bload_async wait");
+            check(std::vector<uint8_t>(loaded.data().begin(), loaded.data().end()) == source, "bload_async content");
+            check(loaded.latency_ms() >= 0.0 && loaded.filename() == asyncPath, "bload_async info");
+
+            FileRequest part = bload_async(asyncPath, 16, 65530);
+            part.wait();
+            check(part.size() == 16 && part.data()[0] == source[65530], "bload_async size/offset");
+
+            std::vector<uint8_t> taken = loaded.take();
+            check(taken.size() == source.size() && loaded.data().empty(), "FileRequest take");
+
+            FileRequest text = bsave_async(asyncPath, std::string_view("hello"));
+            text.wait();
+            check(bload_async(asyncPath).wait() == 5, "bsave_async string");
+
+            // 同じファイルへの書き込みは投入順に1つずつ実行される
+            std::vector<FileRequest> sameFile;
+            for (int i = 0; i < 16; ++i) {
+                sameFile.push_back(bsave_async(asyncPath, std::string(static_cast<size_t>(i + 1), static_cast<char>('a' + i))));
+            }
+            bool allSaved = true;
+            for (FileRequest& request : sameFile) {
+                allSaved = allSaved && request.wait() > 0;
+            }
+            std::string lastSaved;
+            bload(asyncPath, lastSaved);
+            check(allSaved && lastSaved == std::string(16, 'p'), "bsave_async same file in order");
+
+            FileRequest missing = bload_async("hsppp_file_test_missing.bin", {}, {}, [&](FileRequest& request) {
+                callbacks += (request.stat() == fileio_error) ? 10 : 100;
+            });
+            bool threw = false;
+            try {
+                missing.wait();
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw && missing.stat() == fileio_error && missing.error_code() == ERR_FILE_IO, "bload_async missing file");
+
+            // 完了通知はメインスレッドの割り込み処理で配送される
+            await(0);
+            check(callbacks == 11, "FileRequest callbacks");
+            check(FileRequest().stat() == fileio_none, "FileRequest default");
+
+            const FileIoStats stats = fileio_stats();
+            check(stats.submitted >= 6 && stats.threads >= 1, "fileio_stats");
+            deletefile(asyncPath);
+        }
+
+        // --- bcopy / bcopy_async ---
+        {
+            const std::string bigPath = "hsppp_copy_test_src.bin";
+            const std::string copyPath = "hsppp_copy_test_dest.bin";
+            std::vector<uint8_t> big(1024 * 1024 + 123);
+            for (size_t i = 0; i < big.size(); ++i) {
+                big[i] = static_cast<uint8_t>(i * 7 + (i >> 16));
+            }
+            bsave(bigPath, big);
+
+            bcopy(path, copyPath);
+            std::vector<uint8_t> copied;
+            bload(copyPath, copied);
+            check(copied == source, "bcopy");
+            bcopy(bigPath, copyPath, CopyParams{ .native = false });
+            bload(copyPath, copied);
+            check(copied == big, "bcopy read/write");
+
+            int progressCalls = 0;
+            int64_t lastProgress = 0;
+            bool progressOrdered = true;
+            int completed = 0;
+            FileRequest request = bcopy_async(bigPath, copyPath, [&](FileRequest& r) {
+                completed += (r.stat() == fileio_done) ? 1 : 100;
+            }, [&](FileRequest& r) {
+                ++progressCalls;
+                progressOrdered = progressOrdered && r.processed() >= lastProgress && r.total() == static_cast<int64_t>(big.size());
+                lastProgress = r.processed();
+            }, { .chunk_size = 65536 });
+            check(request.wait() == static_cast<int64_t>(big.size()) && request.filename() == copyPath, "bcopy_async wait");
+            await(0);
+            check(completed == 1 && progressCalls >= 1 && progressOrdered, "bcopy_async callbacks");
+            check(request.processed() == request.total() && request.total() == static_cast<int64_t>(big.size()), "bcopy_async progress");
+            bload(copyPath, copied);
+            check(copied == big, "bcopy_async content");
+
+            // 中止した要求は失敗し、途中まで書いたコピー先は残らない
+            const std::string canceledPath = "hsppp_copy_test_canceled.bin";
+            FileRequest canceled = bcopy_async(bigPath, canceledPath, nullptr, nullptr, { .chunk_size = 65536, .native = false });
+            canceled.cancel();
+            bool threw = false;
+            try {
+                canceled.wait();
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(canceled.stat() == fileio_done || (threw && exist(canceledPath) == -1), "bcopy_async cancel");
+            if (exist(canceledPath) >= 0) {
+                deletefile(canceledPath);
+            }
+
+            threw = false;
+            try {
+                bcopy_async("hsppp_copy_test_missing.bin", copyPath).wait();
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "bcopy_async missing source");
+
+            threw = false;
+            try {
+                bcopy(bigPath, copyPath, CopyParams{ .chunk_size = 1 });
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_OUT_OF_RANGE);
+            }
+            check(threw, "bcopy chunk_size range");
+
+            deletefile(bigPath);
+            deletefile(copyPath);
+        }
+
+        // --- peek / poke ---
+        {
+            std::vector<uint8_t> bytes(8, 0);
+            poke(bytes, 0, 0x1FF);
+            wpoke(bytes, 1, 0x1234);
+            lpoke(bytes, 3, -2);
+            check(bytes[0] == 0xFF && bytes[1] == 0x34 && bytes[2] == 0x12 && bytes[3] == 0xFE && bytes[6] == 0xFF,
+                  "poke little endian");
+            check(peek(bytes, 0) == 255 && wpeek(bytes, 1) == 0x1234 && lpeek(bytes, 3) == -2, "peek little endian");
+
+            std::string text(6, '.');
+            poke(text, 1, "abc");
+            check(text == ".abc.." && peek(text, 1) == 'a', "poke text");
+
+            bool threw = false;
+            try {
+                (void)lpeek(bytes, 5);
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_BUFFER_OVERFLOW);
+            }
+            check(threw, "peek out of range");
+            threw = false;
+            try {
+                poke(text, 4, "xyz");
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_BUFFER_OVERFLOW);
+            }
+            check(threw && text == ".abc..", "poke out of range");
+        }
+
+        // --- BufferReader / BufferWriter ---
+        {
+            struct Record { int32_t id; float x; float y; uint16_t hp; };
+            const std::vector<int32_t> values = { 1, -2, 0x01020304 };
+
+            std::vector<uint8_t> data;
+            BufferWriter writer(data);
+            writer.write<uint32_t>(0);      // 後から大きさを書く
+            writer.write<int16_t>(-2).write(3.5).write(Record{ 7, 1.5f, 2.5f, 100 });
+            writer.write_varint(300).write_svarint(-65).write_string("hero");
+            writer.write_array(values);
+            writer.write_at<uint32_t>(0, static_cast<uint32_t>(data.size()));
+            check(data[4] == 0xFE && data[5] == 0xFF && writer.position() == data.size(), "BufferWriter little endian");
+
+            BufferReader reader(data);
+            check(reader.read<uint32_t>() == data.size() && reader.read<int16_t>() == -2 && reader.read<double>() == 3.5,
+                  "BufferReader values");
+            const Record record = reader.read<Record>();
+            check(record.id == 7 && record.y == 2.5f && record.hp == 100, "BufferReader struct");
+            check(reader.read_varint() == 300 && reader.read_svarint() == -65 && reader.read_string(4) == "hero",
+                  "BufferReader varint/string");
+            std::vector<int32_t> restored;
+            reader.read_array(restored, values.size());
+            check(restored == values && reader.eof(), "BufferReader array");
+
+            // 範囲外は位置を変えずに ERR_BUFFER_OVERFLOW
+            bool threw = false;
+            try {
+                (void)reader.seek(data.size() - 2).read<uint32_t>();
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_BUFFER_OVERFLOW);
+            }
+            check(threw && reader.position() == data.size() - 2, "BufferReader out of range");
+
+            // ビッグエンディアンと LEB128 の境界
+            std::vector<uint8_t> big;
+            BufferWriter(big, std::endian::big).write<uint32_t>(0x01020304).write_array(values)
+                .write_varint(0xFFFFFFFFFFFFFFFFull).write_svarint(-9223372036854775807LL - 1);
+            check(big[0] == 1 && big[3] == 4 && big.size() == 4 + 12 + 10 + 10, "BufferWriter big endian");
+            BufferReader bigReader(big, std::endian::big);
+            std::vector<int32_t> bigValues(values.size());
+            bigReader.skip(4).read_array(std::span<int32_t>(bigValues));
+            check(bigReader.read_at<uint32_t>(0) == 0x01020304 && bigValues == values, "BufferReader big endian");
+            check(bigReader.read_varint() == 0xFFFFFFFFFFFFFFFFull && bigReader.read_svarint() == -9223372036854775807LL - 1,
+                  "BufferReader varint limits");
+
+            const std::vector<uint8_t> overlong(11, 0xFF);
+            BufferReader overlongReader(overlong);
+            threw = false;
+            try {
+                (void)overlongReader.read_varint();
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_OUT_OF_RANGE);
+            }
+            check(threw && overlongReader.position() == 0, "BufferReader varint overflow");
+
+            // bool は 0 以外を true として読む
+            const std::vector<uint8_t> flags{ 0, 1, 2, 0xFF };
+            BufferReader flagReader(flags);
+            bool flagValues[3] = {};
+            const bool first = flagReader.read<bool>();
+            flagReader.read_array(std::span<bool>(flagValues));
+            check(!first && flagValues[0] && flagValues[1] && flagValues[2] && flagReader.read_at<bool>(2),
+                  "BufferReader bool");
+        }
+
+        // --- bsave(SaveParams) / bflush ---
+        {
+            const std::string savePath = "hsppp_file_save_test.bin";
+            check(bsave(savePath, std::string("hello world"), {}, {}, SaveParams{ .atomic = true, .flush = true }) == 11, "bsave atomic");
+            check(exist(savePath) == 11 && dirlist(savePath + ".*.hsppp_tmp").empty(), "bsave atomic no temp");
+            bsave(savePath, std::string("HE"), {}, 0, SaveParams{ .atomic = true });
+            std::string text;
+            bload(savePath, text);
+            check(text == "HEllo world", "bsave atomic offset");
+
+            // 同じファイルへの保存をまとめる
+            for (int i = 0; i < 8; ++i) {
+                bsave(savePath, std::string(1, static_cast<char>('0' + i)), {}, i, SaveParams{ .deferred = true });
+            }
+            bflush();
+            bload(savePath, text);
+            check(text == "01234567rld", "bsave deferred patches");
+
+            bsave(savePath, std::string("abcdef"), {}, {}, SaveParams{ .deferred = true });
+            bsave(savePath, std::string("XY"), {}, 2, SaveParams{ .deferred = true });
+            // 読み込みの前には書き出される
+            bload(savePath, text);
+            check(text == "abXYef", "bsave deferred read-your-writes");
+
+            bsave(savePath, std::string("12345678"), {}, {}, SaveParams{ .deferred = true });
+            bsave(savePath, std::string("z"), {}, 7);
+            bload(savePath, text);
+            check(text == "1234567z", "bsave deferred ordering");
+
+            // 表記の違う同じファイルも1つにまとめ、読み込みの前に書き出す
+            bsave(savePath, std::string("abcd"), {}, {}, SaveParams{ .deferred = true });
+            bsave("./" + savePath, std::string("Z"), {}, 1, SaveParams{ .deferred = true });
+            bload("./" + savePath, text);
+            check(text == "aZcd", "bsave deferred same file by another name");
+
+            // NotePad の読み込み・マップの前にも書き出される
+            bsave(savePath, std::string("note1\nnote2\n"), {}, {}, SaveParams{ .deferred = true });
+            NotePad deferredNote;
+            deferredNote.load(savePath);
+            check(deferredNote.count() == 2 && deferredNote.get(1) == "note2", "bsave deferred before NotePad::load");
+            bsave(savePath, std::string("mapped\n"), {}, {}, SaveParams{ .deferred = true });
+            deferredNote.map(savePath);
+            check(deferredNote.count() == 1 && deferredNote.line(0) == "mapped", "bsave deferred before NotePad::map");
+            deferredNote.clear();
+            deletefile(savePath);
+        }
+
+        // --- packbuild / packopen / packclose ---
+        {
+            const std::string dir = "hsppp_pack_test";
+            const std::string archive = "hsppp_pack_test.hpk";
+            mkdir(dir);
+            mkdir(dir + "/Sub");
+            bsave(dir + "/Sub/Data.bin", source);
+            bsave(dir + "/text.txt", std::string("line1\nline2\n"));
+            bsave(dir + "/empty.bin", std::string());
+            check(packbuild(archive, dir) == 3, "packbuild count");
+            // 圧縮しない・境界を指定したパック
+            const std::string storedArchive = "hsppp_pack_test_store.hpk";
+            check(packbuild(storedArchive, dir, PackParams{ .compress = false, .alignment = 4096 }) == 3, "packbuild store");
+            // 高圧縮のパックも同じように読める
+            const std::string denseArchive = "hsppp_pack_test_dense.hpk";
+            check(packbuild(denseArchive, dir, PackParams{ .level = 9 }) == 3, "packbuild level");
+
+            packopen(archive);
+            // 名前は大文字・小文字、'\\' と '/' を区別しない
+            check(exist("pack://sub/data.bin") == static_cast<int64_t>(source.size()), "pack exist");
+            check(exist("pack://SUB\\DATA.BIN") == static_cast<int64_t>(source.size()), "pack exist normalized");
+            check(exist("pack://missing.bin") == -1, "pack exist missing");
+            check(exist("pack://empty.bin") == 0, "pack exist empty");
+
+            std::vector<uint8_t> loaded;
+            check(bload("pack://Sub/Data.bin", loaded) == static_cast<int64_t>(source.size()) && loaded == source, "pack bload");
+            std::vector<uint8_t> part;
+            bload("pack://Sub/Data.bin", part, 16, 65530);
+            check(part.size() == 16 && part[0] == source[65530], "pack bload offset");
+
+            MappedFile mapped = bmap("pack://Sub/Data.bin", 100, 50);
+            check(mapped.size() == 50 && mapped.file_size() == static_cast<int64_t>(source.size()) && mapped[0] == source[100], "pack bmap");
+
+            NotePad note;
+            note.load("pack://text.txt");
+            check(note.get(0) == "line1" && note.get(1) == "line2", "pack noteload");
+            NotePad mappedNote;
+            mappedNote.map("pack://text.txt");
+            check(mappedNote.line(1) == "line2", "pack NotePad map");
+
+            StrReader reader;
+            reader.open("pack://text.txt");
+            std::string line;
+            reader.read(line);
+            check(line == "line1", "pack StrReader");
+
+            // 後から登録したパックを優先する
+            packopen(storedArchive);
+            MappedFile stored = bmap("pack://sub/data.bin");
+            check(std::vector<uint8_t>(stored.begin(), stored.end()) == source, "pack stored bmap");
+            packclose(storedArchive);
+            packopen(denseArchive);
+            std::vector<uint8_t> dense;
+            bload("pack://sub/data.bin", dense);
+            check(dense == source, "pack level bload");
+            packclose(denseArchive);
+
+            bcopy("pack://text.txt", "hsppp_pack_test_copy.txt");
+            check(exist("hsppp_pack_test_copy.txt") == 12, "pack bcopy");
+            deletefile("hsppp_pack_test_copy.txt");
+
+            bool threw = false;
+            try {
+                bsave("pack://text.txt", std::string("x"));
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_UNSUPPORTED);
+            }
+            check(threw, "pack bsave rejected");
+
+            // 登録を解除しても、読み込み済みの MappedFile は有効
+            packclose();
+            check(exist("pack://text.txt") == -1, "packclose");
+            check(mapped[49] == source[149], "pack bmap after packclose");
+
+            threw = false;
+            try {
+                packclose(archive);
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "packclose unknown");
+
+            deletefile(archive);
+            deletefile(storedArchive);
+            deletefile(denseArchive);
+            std::error_code removeError;
+            std::filesystem::remove_all(dir, removeError);     // Sub も含めて削除する
+        }
+
+        // --- dirwalk ---
+        {
+            const std::string dir = "hsppp_walk_test";
+            mkdir(dir);
+            mkdir(dir + "/a");
+            mkdir(dir + "/a/b");
+            bsave(dir + "/top.txt", std::string("12345"));
+            bsave(dir + "/a/one.png", std::string("1"));
+            bsave(dir + "/a/b/two.PNG", std::string("22"));
+            bsave(dir + "/a/b/three.dat", std::string("333"));
+
+            const std::vector<DirEntry> all = dirwalk(dir);
+            std::vector<std::string> paths;
+            for (const DirEntry& e : all) {
+                paths.push_back(e.path);
+            }
+            check(paths == std::vector<std::string>{ "a", "a/b", "a/b/three.dat", "a/b/two.PNG", "a/one.png", "top.txt" },
+                  "dirwalk sorted paths");
+            check(all[0].directory && all[0].size == 0 && !all[5].directory && all[5].size == 5 && all[5].mtime > 0,
+                  "dirwalk size/mtime");
+
+            check(dirwalk(dir, DirWalkParams{ .mode = 1, .pattern = "*.png" }).size() == 2, "dirwalk pattern");
+            check(dirwalk(dir, DirWalkParams{ .mode = 5 }).size() == 2, "dirwalk directories only");
+            check(dirwalk(dir, DirWalkParams{ .recursive = false }).size() == 2, "dirwalk non-recursive");
+
+            int64_t bytes = 0;
+            const int64_t files = dirwalk(dir, [&](const DirEntry& e) {
+                bytes += e.size;
+                return true;
+            }, { .mode = 1, .threads = 1, .queue_capacity = 1 });
+            check(files == 4 && bytes == 11, "dirwalk callback");
+            check(dirwalk(dir, [](const DirEntry&) { return false; }) == 1, "dirwalk stop");
+
+            // callback の例外は作業スレッドを止めてから呼び出し元へ届く
+            bool callbackThrew = false;
+            try {
+                (void)dirwalk(dir, [](const DirEntry&) -> bool {
+                    throw HspError(ERR_ILLEGAL_FUNCTION, "dirwalk callback test");
+                }, { .threads = 4, .queue_capacity = 1 });
+            }
+            catch (const HspError& e) {
+                callbackThrew = (e.error_code() == ERR_ILLEGAL_FUNCTION);
+            }
+            check(callbackThrew && dirwalk(dir).size() == 6, "dirwalk callback exception");
+
+            bool threw = false;
+            try {
+                (void)dirwalk("hsppp_walk_test_missing");
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "dirwalk missing root");
+
+            std::error_code removeError;
+            std::filesystem::remove_all(dir, removeError);     // a/b も含めて削除する
+        }
+
+        // --- exist_many ---
+        {
+            const std::string dir = "hsppp_stat_test";
+            mkdir(dir);
+            // 作業スレッドで分担する数のパス（偶数番目だけ作る）
+            std::vector<std::string> paths;
+            for (int i = 0; i < 200; ++i) {
+                paths.push_back(dir + "/f" + std::to_string(i) + ".bin");
+                if (i % 2 == 0) {
+                    bsave(paths.back(), std::string(static_cast<size_t>(i), 'x'));
+                }
+            }
+            paths.push_back(dir);
+            paths.push_back("pack://hsppp_stat_test_missing.bin");
+
+            const std::vector<FileStat> stats = exist_many(paths);
+            bool sizesOk = stats.size() == paths.size();
+            for (int i = 0; sizesOk && i < 200; ++i) {
+                sizesOk = (i % 2 == 0) ? (stats[i].exists() && stats[i].size == i && stats[i].mtime > 0 && !stats[i].directory)
+                                       : (!stats[i].exists() && stats[i].size == -1);
+            }
+            check(sizesOk, "exist_many sizes");
+            check(stats[200].directory && stats[200].size == 0 && !stats[201].exists(), "exist_many directory/pack");
+            check(exist(paths[10]) == stats[10].size, "exist_many matches exist");
+
+            // cache_stats を指定した filewatch の下ではキャッシュを使い、このプロセスからの書き込み・削除はすぐに反映する
+            FileWatch watch = filewatch(dir, nullptr, { .debounce_ms = 20, .cache_stats = true });
+            std::vector<FileStat> cached;
+            exist_many(paths, cached);
+            exist_many(paths, cached);
+            check(cached.size() == paths.size() && cached[10].size == 10 && cached[11].size == -1, "exist_many cached");
+            bsave(paths[11], std::string("abc"));
+            check(exist(paths[11]) == 3, "exist cache after bsave");
+            deletefile(paths[10]);
+            check(exist(paths[10]) == -1 && exist_many(paths)[10].size == -1, "exist cache after deletefile");
+            watch.close();
+            check(exist(paths[12]) == 12, "exist after filewatch close");
+
+            for (int i = 0; i < 200; ++i) {
+                if (exist(paths[i]) >= 0) {
+                    deletefile(paths[i]);
+                }
+            }
+        }
+
+        // --- filewatch ---
+        {
+            const std::string dir = "hsppp_watch_test";
+            mkdir(dir);
+            const std::string imagePath = dir + "/sprite.bmp";
+            buffer({ .width = 16, .height = 8 }).bmpsave(imagePath);
+            Cel sprite = loadCel(imagePath);
+            check(sprite.width() == 16, "filewatch cel before");
+
+            std::vector<FileChange> received;
+            FileWatch watch = filewatch(dir, [&](std::span<const FileChange> changes) {
+                received.insert(received.end(), changes.begin(), changes.end());
+            }, { .debounce_ms = 20 });
+            check(watch.active() && watch.directory() == dir, "filewatch open");
+
+            // 変更はまとめてから割り込み処理で配送され、cel は作業スレッドで読み直してから差し替えられる
+            bsave(dir + "/note.txt", std::string("a"));
+            buffer({ .width = 32, .height = 24 }).bmpsave(imagePath);
+            for (int i = 0; i < 200 && (watch.reload_count() < 1 || received.size() < 2); ++i) {
+                await(10);
+            }
+            auto changed = [&](const std::string& name, int action) {
+                for (const FileChange& c : received) {
+                    if (c.path == name && c.action == action) {
+                        return true;
+                    }
+                }
+                return false;
+            };
+            check(changed("note.txt", filechange_added), "filewatch added");
+            check(changed("sprite.bmp", filechange_modified) || changed("sprite.bmp", filechange_added), "filewatch modified");
+            check(watch.reload_count() >= 1 && sprite.width() == 32 && sprite.height() == 24, "filewatch cel reload");
+
+            received.clear();
+            deletefile(dir + "/note.txt");
+            for (int i = 0; i < 200 && received.empty(); ++i) {
+                await(10);
+            }
+            check(changed("note.txt", filechange_removed), "filewatch removed");
+            check(watch.change_count() >= 3, "filewatch change_count");
+
+            watch.close();
+            check(!watch.active(), "filewatch close");
+
+            bool threw = false;
+            try {
+                (void)filewatch("hsppp_watch_test_missing");
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "filewatch missing directory");
+
+            deletefile(imagePath);
+        }
+
+        // --- Compressor / Decompressor ---
+        {
+            // 繰り返しの多いデータ（複数ブロックにまたがる大きさ）
+            std::vector<uint8_t> data;
+            for (int i = 0; i < 300000; ++i) {
+                data.push_back(static_cast<uint8_t>((i % 251) ^ (i / 4096)));
+            }
+            const std::vector<uint8_t> fast = compress(data);
+            const std::vector<uint8_t> dense = compress(data, { .level = 9, .block_size = 65536, .threads = 0 });
+            check(fast.size() < data.size() && dense.size() <= fast.size(), "compress ratio");
+            check(fast[0] == 0x04 && fast[1] == 0x22 && fast[2] == 0x4D && fast[3] == 0x18, "compress frame magic");
+            check(decompress(fast) == data && decompress(dense) == data, "decompress round trip");
+            check(decompress(compress(std::vector<uint8_t>())).empty(), "compress empty");
+
+            // 少しずつ書き込み、少しずつ読み出す
+            std::vector<uint8_t> stream;
+            Compressor writer(stream, { .block_size = 65536 });
+            for (size_t i = 0; i < data.size(); i += 1000) {
+                const size_t n = (data.size() - i < 1000) ? data.size() - i : 1000;
+                writer.write(std::span<const uint8_t>(data).subspan(i, n));
+            }
+            writer.finish();
+            check(!writer.is_open() && writer.bytes_in() == static_cast<int64_t>(data.size())
+                  && writer.bytes_out() == static_cast<int64_t>(stream.size()), "Compressor counters");
+
+            Decompressor reader(stream);
+            std::vector<uint8_t> restored;
+            uint8_t chunk[777];
+            while (size_t n = reader.read(chunk)) {
+                restored.insert(restored.end(), chunk, chunk + n);
+            }
+            check(restored == data && reader.eof(), "Decompressor read");
+
+            // ファイル
+            const std::string compressedPath = "hsppp_compress_test.lz4";
+            const std::string text(100000, 'x');
+            check(bsave_compressed(compressedPath, text, { .level = 12 }) == exist(compressedPath), "bsave_compressed");
+            std::string loadedText = "old";
+            check(bload_compressed(compressedPath, loadedText) == static_cast<int64_t>(text.size()) && loadedText == text,
+                  "bload_compressed");
+
+            Compressor fileWriter;
+            fileWriter.open(compressedPath);
+            fileWriter.write(std::string_view("hello "));
+            fileWriter.write(std::string_view("world"));
+            fileWriter.finish();
+            Decompressor fileReader;
+            fileReader.open(compressedPath);
+            std::string hello;
+            fileReader.read_all(hello);
+            check(hello == "hello world", "Compressor file");
+
+            // 壊れたデータ・圧縮されていないデータ
+            std::vector<uint8_t> corrupt = fast;
+            corrupt[corrupt.size() / 2] ^= 0x55;
+            bool threw = false;
+            try {
+                (void)decompress(corrupt);
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "decompress corrupt");
+
+            threw = false;
+            try {
+                (void)decompress(std::vector<uint8_t>(data.begin(), data.begin() + 100));
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_FILE_IO);
+            }
+            check(threw, "decompress not lz4");
+
+            threw = false;
+            try {
+                (void)compress(data, { .level = 13 });
+            }
+            catch (const HspError& e) {
+                threw = (e.error_code() == ERR_OUT_OF_RANGE);
+            }
+            check(threw, "compress level range");
+
+            deletefile(compressedPath);
+        }
+
+        deletefile(path);
+        return allPassed;
+    }
+
     // ============================================================
     // 公開テスト関数
     // ============================================================
@@ -495,6 +1904,14 @@ namespace hsppp_test {
         test_method_chaining();
         test_input_functions();
         test_string_functions_runtime();
+        test_random_functions_runtime();
+        test_color_functions_runtime();
+        test_easing_functions_runtime();
+        test_tween_functions_runtime();
+        test_vecmath_functions_runtime();
+        test_collision_functions_runtime();
+        test_sort_functions_runtime();
+        test_file_functions_runtime();
         test_note_and_sendmsg();
 
         return s_testsPassed;
@@ -0,0 +1,92 @@
+# Source: https://github.com/Velgail/HspppLib
+# Distributed under the Boost Software License, Version 1.0.
+# See accompanying file LICENSE or copy at
+# https://www.boost.org/LICENSE_1_0.txt
+# SPDX-License-Identifier: BSL-1.0
+
+# scripts/gen_cp932_table.py
+# HspppLib/src/core/Cp932Table.inl を生成する（Python 標準の cp932 コーデックを使用）
+#
+#   python scripts/gen_cp932_table.py > HspppLib/src/core/Cp932Table.inl
+#
+# 逆変換（Unicode → CP932）は実行時にこの表から構築する。
+# 重複する文字は WideCharToMultiByte と同じく、小さいコードを優先し、
+# NEC選定IBM拡張（0xED/0xEE 行）は最後に回す。
+
+import sys
+
+LEADS = list(range(0x81, 0xA0)) + list(range(0xE0, 0xFD))
+TRAIL_FIRST, TRAIL_LAST = 0x40, 0xFC
+
+# WideCharToMultiByte の最適マッピング（表に無い Unicode → CP932）
+BEST_FIT = [
+    (0x00A2, 0x8191),  # ¢ → ￠
+    (0x00A3, 0x8192),  # £ → ￡
+    (0x00A5, 0x005C),  # ¥ → '\'
+    (0x00AC, 0x81CA),  # ¬ → ￢
+    (0x2016, 0x8161),  # ‖ → ∥
+    (0x203E, 0x007E),  # ‾ → '~'
+    (0x2212, 0x817C),  # − → －
+    (0x301C, 0x8160),  # 〜 → ～
+]
+
+
+def decode(data):
+    try:
+        return ord(data.decode("cp932"))
+    except UnicodeDecodeError:
+        return 0
+
+
+def rows(values, per_line, indent):
+    for i in range(0, len(values), per_line):
+        yield indent + ", ".join("0x%04X" % v for v in values[i:i + per_line]) + ","
+
+
+def main():
+    out = sys.stdout
+    out.write("\ufeff// Source: https://github.com/Velgail/HspppLib\n")
+    out.write("// Distributed under the Boost Software License, Version 1.0.\n")
+    out.write("// See accompanying file LICENSE or copy at\n")
+    out.write("// https://www.boost.org/LICENSE_1_0.txt\n")
+    out.write("// SPDX-License-Identifier: BSL-1.0\n\n")
+    out.write("// HspppLib/src/core/Cp932Table.inl\n")
+    out.write("// CP932 (Shift_JIS) → Unicode 変換テーブル\n")
+    out.write("// scripts/gen_cp932_table.py で生成（手動で編集しないこと）\n\n")
+    out.write("namespace hsppp::internal {\nnamespace {\n\n")
+
+    out.write("    // 1バイト文字 0x80〜0xFF（半角カナ以外。先行バイトと未定義は 0）\n")
+    out.write("    constexpr char16_t kCp932SingleByte[128] = {\n")
+    single = [0 if b in LEADS else decode(bytes([b])) for b in range(0x80, 0x100)]
+    out.write("\n".join(rows(single, 8, "        ")) + "\n    };\n\n")
+
+    out.write("    // 先行バイト 0x81〜0x9F, 0xE0〜0xFC の通し番号（非先行バイトは 0xFF）\n")
+    out.write("    constexpr uint8_t kCp932LeadIndex[256] = {\n")
+    lead_index = [LEADS.index(b) if b in LEADS else 0xFF for b in range(256)]
+    for i in range(0, 256, 16):
+        out.write("        " + ", ".join("0x%02X" % v for v in lead_index[i:i + 16]) + ",\n")
+    out.write("    };\n\n")
+
+    trail_count = TRAIL_LAST - TRAIL_FIRST + 1
+    out.write("    constexpr size_t kCp932TrailCount = %d;\n\n" % trail_count)
+    out.write("    // 2バイト文字 [先行バイト番号][後続バイト - 0x40]（未定義は 0）\n")
+    out.write("    constexpr char16_t kCp932DoubleByte[%d][kCp932TrailCount] = {\n" % len(LEADS))
+    for lead in LEADS:
+        values = [decode(bytes([lead, t])) for t in range(TRAIL_FIRST, TRAIL_LAST + 1)]
+        out.write("        { // 0x%02X\n" % lead)
+        out.write("\n".join(rows(values, 12, "            ")) + "\n        },\n")
+    out.write("    };\n\n")
+
+    out.write("    // Unicode → CP932 の最適マッピング（表の逆引きに無いもの）\n")
+    out.write("    struct Cp932BestFit {\n        char16_t unicode;\n        uint16_t code;\n    };\n")
+    out.write("    constexpr Cp932BestFit kCp932BestFit[] = {\n")
+    for u, c in BEST_FIT:
+        out.write("        { 0x%04X, 0x%04X },\n" % (u, c))
+    out.write("    };\n\n")
+
+    out.write("} // namespace\n} // namespace hsppp::internal\n")
+
+
+if __name__ == "__main__":
+    sys.stdout.reconfigure(encoding="utf-8", newline="\n")
+    main()